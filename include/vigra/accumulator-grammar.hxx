@@ -100,6 +100,8 @@ template <int INDEX>  class CoordArg;          // specifiy the index of the coor
 class RegionContour;                           // compute the contour of a 2D region
 class RegionPerimeter;                         // compute the perimeter of a 2D region
 class RegionCircularity;                       // compare perimeter of a 2D region with a circle of same area
+class RegionConvexHull;                        // compute the convex hull polygon of a 2D region
+class RegionConvexity;                         // compare area of a 2D region with the area of its convex hull
 class RegionEccentricity;                      // ecentricity of a 2D region from major and minor axis
 
 #ifdef WITH_LEMON
@@ -498,6 +500,8 @@ VIGRA_REDUCE_MODFIER(template <class> class A, A<ConvexHullFeatures>, ConvexHull
 #endif // WITH_LEMON
 VIGRA_REDUCE_MODFIER(template <class> class A, A<RegionPerimeter>, RegionPerimeter)
 VIGRA_REDUCE_MODFIER(template <class> class A, A<RegionCircularity>, RegionCircularity)
+VIGRA_REDUCE_MODFIER(template <class> class A, A<RegionConvexHull>, RegionConvexHull)
+VIGRA_REDUCE_MODFIER(template <class> class A, A<RegionConvexity>, RegionConvexity)
 VIGRA_REDUCE_MODFIER(template <class> class A, A<RegionEccentricity>, RegionEccentricity)
 VIGRA_REDUCE_MODFIER(VIGRA_VOID, Weighted<RegionEccentricity>, Weighted<RegionEccentricity>)
 
@@ -6119,23 +6119,47 @@ class RegionContour
 
         point_type offset_;
         value_type contour_;
+        bool contour_given_;
 
         Impl()
         : offset_()
         , contour_()
+        , contour_given_(false)
         {}
 
+        void reset()
+        {
+            contour_.clear();
+            contour_given_ = false;
+        }
+
         void setCoordinateOffset(point_type const & offset)
         {
             offset_ = offset;
         }
 
+            // set the contour in advance (e.g. by extractRegionContourFeatures()),
+            // so that it is not traced again during update()
+        void setContour(value_type const & contour)
+        {
+            contour_ = contour;
+            contour_ += offset_;
+            contour_given_ = true;
+        }
+
+        void setContour(value_type && contour)
+        {
+            contour_.swap(contour);
+            contour_ += offset_;
+            contour_given_ = true;
+        }
+
         template <class U, class NEXT>
         void update(CoupledHandle<U, NEXT> const & t)
         {
             VIGRA_STATIC_ASSERT((feature_RegionContour_can_only_be_computed_for_2D_arrays<
                                  CoupledHandle<U, NEXT>::dimensions>));
-            if(getDependency<Count>(*this) == 1)
+            if(getDependency<Count>(*this) == 1 && !contour_given_)
             {
                 contour_.clear();
                 extractContour(LabelHandle::getHandle(t).arrayView(), t.point(), contour_);
@@ -6163,6 +6187,121 @@ class RegionContour
 };
 
 
+/** \brief Compute the convex hull of a 2D region.
+
+    This is the convex hull of the polygon returned by RegionContour, i.e. a closed
+    polygon in counter-clockwise order (see \ref convexHull()). In contrast to
+    \ref ConvexHull, this feature only works in 2D, but does not require lemon.
+
+    AccumulatorChain must be used with CoupledIterator in order to have access to pixel coordinates.
+ */
+class RegionConvexHull
+{
+  public:
+    typedef Select<Count, RegionContour> Dependencies;
+
+    static std::string name()
+    {
+        return std::string("RegionConvexHull");
+    }
+
+    template <class T, class BASE>
+    struct Impl
+    : public BASE
+    {
+        typedef TinyVector<double, 2>                                 point_type;
+        typedef Polygon<point_type>                                   value_type;
+        typedef value_type const &                                    result_type;
+
+        value_type hull_;
+        bool hull_given_;
+
+        Impl()
+        : hull_()
+        , hull_given_(false)
+        {}
+
+        void reset()
+        {
+            hull_.clear();
+            hull_given_ = false;
+        }
+
+            // set the hull in advance (e.g. by extractRegionContourFeatures()),
+            // so that it is not computed again during update()
+        void setConvexHull(value_type const & hull)
+        {
+            hull_ = hull;
+            hull_given_ = true;
+        }
+
+        void setConvexHull(value_type && hull)
+        {
+            hull_.swap(hull);
+            hull_given_ = true;
+        }
+
+        template <class U, class NEXT>
+        void update(CoupledHandle<U, NEXT> const &)
+        {
+            if(getDependency<Count>(*this) == 1 && !hull_given_)
+            {
+                hull_.clear();
+                detail::convexHullOfContour(getDependency<RegionContour>(*this), hull_);
+            }
+        }
+
+        template <class U, class NEXT>
+        void update(CoupledHandle<U, NEXT> const & t, double)
+        {
+            update(t);
+        }
+
+        void operator+=(Impl const &)
+        {
+            vigra_precondition(false,
+                "RegionConvexHull::operator+=(): RegionConvexHull cannot be merged.");
+        }
+
+        result_type operator()() const
+        {
+            return hull_;
+        }
+    };
+};
+
+/** \brief Compute the convexity of a 2D region.
+
+    This is the ratio between the areas of the polygons returned by RegionContour
+    and RegionConvexHull (also known as <i>solidity</i>). It is 1 for convex regions
+    and decreases with the size of the concavities.
+
+    AccumulatorChain must be used with CoupledIterator in order to have access to pixel coordinates.
+ */
+class RegionConvexity
+{
+  public:
+    typedef Select<RegionContour, RegionConvexHull> Dependencies;
+
+    static std::string name()
+    {
+        return std::string("RegionConvexity");
+    }
+
+    template <class T, class BASE>
+    struct Impl
+    : public BASE
+    {
+        typedef double       value_type;
+        typedef value_type   result_type;
+
+        result_type operator()() const
+        {
+            return getDependency<RegionContour>(*this).area() / getDependency<RegionConvexHull>(*this).area();
+        }
+    };
+};
+
 /** \brief Compute the perimeter of a 2D region.
 
     This is the length of the polygon returned by RegionContour.
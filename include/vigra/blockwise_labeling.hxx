@@ -108,12 +108,38 @@ public:
 namespace blockwise_labeling_detail
 {
 
+#ifdef VIGRA_HAS_ATOMIC
+    // the block faces are merged in parallel with a lock-free union-find array
+template <class Label>
+struct BlockwiseUnions
+{
+    typedef ConcurrentUnionFindArray<Label> type;
+
+    static int numThreads(BlockwiseLabelOptions const & options)
+    {
+        return options.getNumThreads();
+    }
+};
+#else
+    // without atomics, the block faces are merged sequentially
+template <class Label>
+struct BlockwiseUnions
+{
+    typedef UnionFindArray<Label> type;
+
+    static int numThreads(BlockwiseLabelOptions const &)
+    {
+        return ParallelOptions::NoThreads;
+    }
+};
+#endif
+
 template <class Equal, class Label>
 struct BorderVisitor
 {
     Label u_label_offset;
     Label v_label_offset;
-    UnionFindArray<Label>* global_unions;
+    typename BlockwiseUnions<Label>::type* global_unions;
     Equal* equal;
 
     template <class Data, class Shape>
@@ -195,84 +221,79 @@ blockwiseLabeling(DataBlocksIterator data_blocks_begin, DataBlocksIterator data_
     }
 
     // reduce stage: merge adjacent labels if the region overlaps
-    UnionFindArray<Label> global_unions(unmerged_label_number);
+    // (all block faces are visited in parallel if the union-find array is lock-free)
+    typename BlockwiseUnions<Label>::type global_unions(unmerged_label_number);
+    ThreadPool pool(BlockwiseUnions<Label>::numThreads(options));
+    MultiArrayIndex block_count = label_offsets.size();
     if(has_background)
     {
         // merge all labels that refer to background
-        for(typename MultiArray<Dimensions, Label>::iterator offsets_it = label_offsets.begin();
-                offsets_it != label_offsets.end();
-                ++offsets_it)
-        {
-            global_unions.makeUnion(0, *offsets_it);
-        }
+        typename MultiArray<Dimensions, Label>::iterator offsets_it = label_offsets.begin();
+        parallel_foreach(pool, block_count,
+            [&](const int /*threadId*/, const MultiArrayIndex i){
+                global_unions.makeUnion(0, offsets_it[i]);
+            }
+        );
     }
 
     typedef GridGraph<Dimensions, undirected_tag> Graph;
     typedef typename Graph::edge_iterator EdgeIterator;
     Graph blocks_graph(blocks_shape, options.getNeighborhood());
+    std::vector<std::pair<Shape, Shape> > block_pairs;
+    block_pairs.reserve(blocks_graph.edgeNum());
     for(EdgeIterator it = blocks_graph.get_edge_iterator(); it != blocks_graph.get_edge_end_iterator(); ++it)
-    {
-        Shape u = blocks_graph.u(*it);
-        Shape v = blocks_graph.v(*it);
-        Shape difference = v - u;
-
-        BorderVisitor<Equal, Label> border_visitor;
-        border_visitor.u_label_offset = label_offsets[u];
-        border_visitor.v_label_offset = label_offsets[v];
-        border_visitor.global_unions = &global_unions;
-        border_visitor.equal = &equal;
-        visitBorder(data_blocks_begin[u], label_blocks_begin[u],
-                    data_blocks_begin[v], label_blocks_begin[v],
-                    difference, options.getNeighborhood(), border_visitor);
-    }
+        block_pairs.push_back(std::make_pair(blocks_graph.u(*it), blocks_graph.v(*it)));
+
+    parallel_foreach(pool, (MultiArrayIndex)block_pairs.size(),
+        [&](const int /*threadId*/, const MultiArrayIndex i){
+            Shape u = block_pairs[i].first;
+            Shape v = block_pairs[i].second;
+            Shape difference = v - u;
+
+            BorderVisitor<Equal, Label> border_visitor;
+            border_visitor.u_label_offset = label_offsets[u];
+            border_visitor.v_label_offset = label_offsets[v];
+            border_visitor.global_unions = &global_unions;
+            border_visitor.equal = &equal;
+            visitBorder(data_blocks_begin[u], label_blocks_begin[u],
+                        data_blocks_begin[v], label_blocks_begin[v],
+                        difference, options.getNeighborhood(), border_visitor);
+        }
+    );
 
     // fill mapping (local labels) -> (global labels)
     Label last_label = global_unions.makeContiguous();
     {
         typename MultiArray<Dimensions, Label>::iterator offsets_it = label_offsets.begin();
-        Label offset = *offsets_it;
-        ++offsets_it;
         typename Mapping::iterator mapping_it = mapping.begin();
-        for( ; offsets_it != label_offsets.end(); ++offsets_it, ++mapping_it)
-        {
-            mapping_it->clear();
-            Label next_offset = *offsets_it;
-            if(has_background)
-            {
-                for(Label current_label = offset; current_label != next_offset; ++current_label)
+        parallel_foreach(pool, block_count,
+            [&](const int /*threadId*/, const MultiArrayIndex i){
+                // the last block uses unmerged_label_number as its end
+                Label offset = offsets_it[i];
+                Label next_offset = i + 1 < block_count
+                                        ? offsets_it[i + 1]
+                                        : (has_background
+                                               ? unmerged_label_number
+                                               : Label(unmerged_label_number - 1));
+                std::vector<Label> & block_mapping = mapping_it[i];
+                block_mapping.clear();
+                if(has_background)
                 {
-                    mapping_it->push_back(global_unions.findLabel(current_label));
+                    for(Label current_label = offset; current_label != next_offset; ++current_label)
+                    {
+                        block_mapping.push_back(global_unions.findLabel(current_label));
+                    }
                 }
-            }
-            else
-            {
-                mapping_it->push_back(0); // local labels start at 1
-                for(Label current_label = offset + 1; current_label != next_offset + 1; ++current_label)
+                else
                 {
-                    mapping_it->push_back(global_unions.findLabel(current_label));
+                    block_mapping.push_back(0); // local labels start at 1
+                    for(Label current_label = offset + 1; current_label != next_offset + 1; ++current_label)
+                    {
+                        block_mapping.push_back(global_unions.findLabel(current_label));
+                    }
                 }
             }
-
-            offset = next_offset;
-        }
-        // last block:
-        // instead of next_offset, use last_label+1
-        mapping_it->clear();
-        if(has_background)
-        {
-            for(Label current_label = offset; current_label != unmerged_label_number; ++current_label)
-            {
-                mapping_it->push_back(global_unions.findLabel(current_label));
-            }
-        }
-        else
-        {
-            mapping_it->push_back(0);
-            for(Label current_label = offset + 1; current_label != unmerged_label_number; ++current_label)
-            {
-                mapping_it->push_back(global_unions.findLabel(current_label));
-            }
-        }
+        );
     }
     return last_label;
 }
@@ -0,0 +1,375 @@
+/************************************************************************/
+/*                                                                      */
+/*                Copyright 2026 by the VIGRA developers                */
+/*                                                                      */
+/*    This file is part of the VIGRA computer vision library.           */
+/*    The VIGRA Website is                                              */
+/*        http://hci.iwr.uni-heidelberg.de/vigra/                       */
+/*    Please direct questions, bug reports, and contributions to        */
+/*        ullrich.koethe@iwr.uni-heidelberg.de    or                    */
+/*        vigra@informatik.uni-hamburg.de                               */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+#ifndef VIGRA_BLOCKWISE_LOCALMINMAX_HXX
+#define VIGRA_BLOCKWISE_LOCALMINMAX_HXX
+
+#include "threadpool.hxx"
+#include "multi_array.hxx"
+#include "multi_array_chunked.hxx"
+#include "multi_gridgraph.hxx"
+#include "multi_blockwise.hxx"
+#include "multi_localminmax.hxx"
+#include "overlapped_blocks.hxx"
+
+#include <vector>
+#include <functional>
+#include <algorithm>
+
+namespace vigra
+{
+
+/** \addtogroup LocalMinMax
+*/
+//@{
+
+    /** Options object for localMinimaBlockwise() and localMaximaBlockwise().
+
+        It is simply a subclass of both \ref vigra::LocalMinmaxOptions
+        and \ref vigra::BlockwiseOptions. See there for
+        detailed documentation.
+    */
+class BlockwiseLocalMinmaxOptions
+: public LocalMinmaxOptions
+, public BlockwiseOptions
+{
+public:
+    typedef BlockwiseOptions::Shape Shape;
+
+    // reimplement setter functions to allow chaining
+
+    BlockwiseLocalMinmaxOptions & neighborhood(unsigned int n)
+    {
+        LocalMinmaxOptions::neighborhood(n);
+        return *this;
+    }
+
+    BlockwiseLocalMinmaxOptions & neighborhood(NeighborhoodType n)
+    {
+        LocalMinmaxOptions::neighborhood(n);
+        return *this;
+    }
+
+    BlockwiseLocalMinmaxOptions & markWith(double m)
+    {
+        LocalMinmaxOptions::markWith(m);
+        return *this;
+    }
+
+    BlockwiseLocalMinmaxOptions & threshold(double t)
+    {
+        LocalMinmaxOptions::threshold(t);
+        return *this;
+    }
+
+    BlockwiseLocalMinmaxOptions & allowAtBorder(bool f = true)
+    {
+        LocalMinmaxOptions::allowAtBorder(f);
+        return *this;
+    }
+
+    BlockwiseLocalMinmaxOptions & blockShape(const Shape & shape)
+    {
+        BlockwiseOptions::blockShape(shape);
+        return *this;
+    }
+
+    template <class T, int N>
+    BlockwiseLocalMinmaxOptions & blockShape(const TinyVector<T, N> & shape)
+    {
+        BlockwiseOptions::blockShape(shape);
+        return *this;
+    }
+
+    BlockwiseLocalMinmaxOptions & numThreads(const int n)
+    {
+        BlockwiseOptions::numThreads(n);
+        return *this;
+    }
+};
+
+namespace blockwise_localminmax_detail
+{
+
+    // Process the blocks in parallel. Each block is checked out together with a halo 
+    // of one pixel, so that its nodes see all their neighbors, and the nodes at the 
+    // border of the checked out data are exactly the nodes at the array's border.
+template <unsigned int N, class DataArray, class DestArray, class Compare>
+unsigned int
+localMinMaxBlockwise(DataArray const & data,
+                     DestArray & dest,
+                     typename MultiArrayShape<N>::type const & block_shape,
+                     BlockwiseLocalMinmaxOptions const & options,
+                     typename DataArray::value_type threshold,
+                     Compare const & compare)
+{
+    typedef typename MultiArrayShape<N>::type Shape;
+    typedef typename DataArray::value_type    DataType;
+    typedef typename DestArray::value_type    DestType;
+    typedef GridGraph<N, undirected_tag>      Graph;
+    using namespace overlapped_blocks_detail;
+
+    vigra_precondition(!options.allow_plateaus,
+        "localMinimaBlockwise(), localMaximaBlockwise(): allowPlateaus() is not supported.");
+
+    const NeighborhoodType neighborhood = detail_local_minima::neighborhoodType<N>(options.neigh,
+        "localMinimaBlockwise(), localMaximaBlockwise(): option object specifies invalid neighborhood type.");
+    const DestType marker = (DestType)options.marker;
+    const Shape shape = data.shape();
+    MultiCoordinateIterator<N> blocks(blocksShape(shape, block_shape));
+
+    ThreadPool pool(options);
+    std::vector<unsigned int> counts(std::max<std::size_t>(pool.nThreads(), 1), 0);
+    parallel_foreach(pool, blocks, blocks.getEndIterator(),
+        [&](const int threadId, const Shape block)
+        {
+            std::pair<Shape, Shape> bounds = blockBoundsAt(block, shape, block_shape);
+            std::pair<Shape, Shape> outer = overlapBoundsAt(bounds, shape, Shape(1), Shape(1));
+
+            MultiArray<N, DataType> d(outer.second - outer.first);
+            MultiArray<N, DestType> m(bounds.second - bounds.first);
+            checkoutBlock(data, outer.first, d);
+            checkoutBlock(dest, bounds.first, m);
+
+            Graph graph(d.shape(), neighborhood);
+            counts[threadId] += detail_local_minima::localMinMaxBox(graph, d, m, 
+                                                                    bounds.first - outer.first, 
+                                                                    bounds.second - outer.first,
+                                                                    graph.neighborStrideOffsets(d.stride()),
+                                                                    marker, threshold, compare, 
+                                                                    options.allow_at_border);
+            commitBlock(dest, bounds.first, m);
+        }
+    );
+
+    unsigned int count = 0;
+    for(unsigned int k = 0; k < counts.size(); ++k)
+        count += counts[k];
+    return count;
+}
+
+template <unsigned int N, class DataArray, class DestArray>
+inline unsigned int
+localMinimaBlockwise(DataArray const & data,
+                     DestArray & dest,
+                     typename MultiArrayShape<N>::type const & block_shape,
+                     BlockwiseLocalMinmaxOptions const & options)
+{
+    typedef typename DataArray::value_type T;
+    T threshold = options.use_threshold
+                           ? std::min(NumericTraits<T>::max(), (T)options.thresh)
+                           : NumericTraits<T>::max();
+    return localMinMaxBlockwise<N>(data, dest, block_shape, options, threshold, std::less<T>());
+}
+
+template <unsigned int N, class DataArray, class DestArray>
+inline unsigned int
+localMaximaBlockwise(DataArray const & data,
+                     DestArray & dest,
+                     typename MultiArrayShape<N>::type const & block_shape,
+                     BlockwiseLocalMinmaxOptions const & options)
+{
+    typedef typename DataArray::value_type T;
+    T threshold = options.use_threshold
+                           ? std::max(NumericTraits<T>::min(), (T)options.thresh)
+                           : NumericTraits<T>::min();
+    return localMinMaxBlockwise<N>(data, dest, block_shape, options, threshold, std::greater<T>());
+}
+
+} // namespace blockwise_localminmax_detail
+
+/*************************************************************/
+/*                                                           */
+/*                      localMinimaBlockwise                 */
+/*                                                           */
+/*************************************************************/
+
+/** \weakgroup ParallelProcessing
+    \sa localMinimaBlockwise <B>(...)</B>, localMaximaBlockwise <B>(...)</B>
+*/
+
+/** \brief Blockwise detection of local minima in MultiArrays and ChunkedArrays.
+
+    <b> Declarations:</b>
+
+    \code
+    namespace vigra {
+        template <unsigned int N, class T1, class S1,
+                                  class T2, class S2>
+        unsigned int
+        localMinimaBlockwise(MultiArrayView<N, T1, S1> const & data,
+                             MultiArrayView<N, T2, S2> dest,
+                             BlockwiseLocalMinmaxOptions const & options = BlockwiseLocalMinmaxOptions());
+
+        template <unsigned int N, class T1, class T2>
+        unsigned int
+        localMinimaBlockwise(ChunkedArray<N, T1> const & data,
+                             ChunkedArray<N, T2> & dest,
+                             BlockwiseLocalMinmaxOptions const & options = BlockwiseLocalMinmaxOptions());
+    }
+    \endcode
+
+    Marks the same points as \ref localMinima(), but processes the array in blocks
+    (the chunks of a ChunkedArray) in parallel. Each block is copied into memory
+    together with a halo of one pixel, so that only a few blocks must be in memory 
+    at any time. Points that are not minima keep their value in \a dest. 
+    Extremal plateaus (<tt>allowPlateaus()</tt>) are not supported, because 
+    a plateau may extend over many blocks. Use \ref localMinima() with 
+    <tt>LocalMinmaxOptions::numThreads()</tt> for plateaus in arrays that fit 
+    into memory.
+
+    Return: the number of minima found
+
+    <b> Usage: </b>
+
+    <b>\#include </b> \<vigra/blockwise_localminmax.hxx\><br>
+    Namespace: vigra
+
+    \code
+    Shape3 shape = Shape3(500);
+    Shape3 chunk_shape = Shape3(64);
+    ChunkedArrayLazy<3, float> data(shape, chunk_shape);
+    // fill data ...
+
+    ChunkedArrayLazy<3, UInt8> minima(shape, chunk_shape);
+    localMinimaBlockwise(data, minima, BlockwiseLocalMinmaxOptions().neighborhood(DirectNeighborhood));
+    \endcode
+*/
+doxygen_overloaded_function(template <...> unsigned int localMinimaBlockwise)
+
+template <unsigned int N, class T1, class S1,
+                          class T2, class S2>
+inline unsigned int
+localMinimaBlockwise(MultiArrayView<N, T1, S1> const & data,
+                     MultiArrayView<N, T2, S2> dest,
+                     BlockwiseLocalMinmaxOptions const & options = BlockwiseLocalMinmaxOptions())
+{
+    vigra_precondition(data.shape() == dest.shape(),
+        "localMinimaBlockwise(): shape mismatch between input and output.");
+    return blockwise_localminmax_detail::localMinimaBlockwise<N>(data, dest, 
+                                                    options.getBlockShapeN<N>(), options);
+}
+
+template <unsigned int N, class T1, class T2>
+inline unsigned int
+localMinimaBlockwise(ChunkedArray<N, T1> const & data,
+                     ChunkedArray<N, T2> & dest,
+                     BlockwiseLocalMinmaxOptions const & options = BlockwiseLocalMinmaxOptions())
+{
+    vigra_precondition(data.shape() == dest.shape(),
+        "localMinimaBlockwise(): shape mismatch between input and output.");
+    vigra_precondition(data.chunkShape() == dest.chunkShape(),
+        "localMinimaBlockwise(): chunk shapes do not match.");
+    vigra_precondition(options.getBlockShape().size() == 0,
+        "localMinimaBlockwise(ChunkedArray, ...): custom block shapes not supported "
+        "(always uses the array's chunk shape).");
+    return blockwise_localminmax_detail::localMinimaBlockwise<N>(data, dest, 
+                                                    data.chunkShape(), options);
+}
+
+/*************************************************************/
+/*                                                           */
+/*                      localMaximaBlockwise                 */
+/*                                                           */
+/*************************************************************/
+
+/** \brief Blockwise detection of local maxima in MultiArrays and ChunkedArrays.
+
+    <b> Declarations:</b>
+
+    \code
+    namespace vigra {
+        template <unsigned int N, class T1, class S1,
+                                  class T2, class S2>
+        unsigned int
+        localMaximaBlockwise(MultiArrayView<N, T1, S1> const & data,
+                             MultiArrayView<N, T2, S2> dest,
+                             BlockwiseLocalMinmaxOptions const & options = BlockwiseLocalMinmaxOptions());
+
+        template <unsigned int N, class T1, class T2>
+        unsigned int
+        localMaximaBlockwise(ChunkedArray<N, T1> const & data,
+                             ChunkedArray<N, T2> & dest,
+                             BlockwiseLocalMinmaxOptions const & options = BlockwiseLocalMinmaxOptions());
+    }
+    \endcode
+
+    Marks the same points as \ref localMaxima(). See \ref localMinimaBlockwise() 
+    for details.
+
+    Return: the number of maxima found
+
+    <b> Usage: </b>
+
+    <b>\#include </b> \<vigra/blockwise_localminmax.hxx\><br>
+    Namespace: vigra
+*/
+doxygen_overloaded_function(template <...> unsigned int localMaximaBlockwise)
+
+template <unsigned int N, class T1, class S1,
+                          class T2, class S2>
+inline unsigned int
+localMaximaBlockwise(MultiArrayView<N, T1, S1> const & data,
+                     MultiArrayView<N, T2, S2> dest,
+                     BlockwiseLocalMinmaxOptions const & options = BlockwiseLocalMinmaxOptions())
+{
+    vigra_precondition(data.shape() == dest.shape(),
+        "localMaximaBlockwise(): shape mismatch between input and output.");
+    return blockwise_localminmax_detail::localMaximaBlockwise<N>(data, dest, 
+                                                    options.getBlockShapeN<N>(), options);
+}
+
+template <unsigned int N, class T1, class T2>
+inline unsigned int
+localMaximaBlockwise(ChunkedArray<N, T1> const & data,
+                     ChunkedArray<N, T2> & dest,
+                     BlockwiseLocalMinmaxOptions const & options = BlockwiseLocalMinmaxOptions())
+{
+    vigra_precondition(data.shape() == dest.shape(),
+        "localMaximaBlockwise(): shape mismatch between input and output.");
+    vigra_precondition(data.chunkShape() == dest.chunkShape(),
+        "localMaximaBlockwise(): chunk shapes do not match.");
+    vigra_precondition(options.getBlockShape().size() == 0,
+        "localMaximaBlockwise(ChunkedArray, ...): custom block shapes not supported "
+        "(always uses the array's chunk shape).");
+    return blockwise_localminmax_detail::localMaximaBlockwise<N>(data, dest, 
+                                                    data.chunkShape(), options);
+}
+
+//@}
+
+} // namespace vigra
+
+#endif // VIGRA_BLOCKWISE_LOCALMINMAX_HXX
@@ -43,8 +43,13 @@
 #include "blockwise_labeling.hxx"
 #include "metaprogramming.hxx"
 #include "overlapped_blocks.hxx"
+#include "multi_watersheds.hxx"
+#include "priority_queue.hxx"
 
 #include <limits>
+#include <vector>
+#include <functional>
+#include <algorithm>
 
 namespace vigra
 {
@@ -131,6 +136,300 @@ struct UnionFindWatershedsEquality
     {};
 };
 
+    // Mark local minima (or level sets) of 'data' with 1 in 'markers'. The
+    // definitions match lemon_graph::generateWatershedSeeds().
+template <unsigned int N, class DataArray, class MarkerArray>
+void prepareBlockwiseWatershedSeeds(DataArray const & data,
+                                    MarkerArray & markers,
+                                    typename MultiArrayShape<N>::type const & block_shape,
+                                    BlockwiseLabelOptions const & options,
+                                    SeedOptions const & seed_options)
+{
+    typedef typename MultiArrayShape<N>::type Shape;
+    typedef typename DataArray::value_type    DataType;
+    typedef typename MarkerArray::value_type  MarkerType;
+    typedef GridGraph<N, undirected_tag>      Graph;
+    using namespace overlapped_blocks_detail;
+
+    vigra_precondition(seed_options.mini != SeedOptions::ExtendedMinima,
+        "seededWatershedsBlockwise(): extended minima are not supported.");
+    vigra_precondition(seed_options.mini != SeedOptions::LevelSets || seed_options.thresholdIsValid<DataType>(),
+        "seededWatershedsBlockwise(): SeedOptions.levelSets() must be specified with threshold.");
+
+    const DataType threshold = seed_options.thresholdIsValid<DataType>()
+                                  ? DataType(seed_options.thresh)
+                                  : NumericTraits<DataType>::max();
+    const Shape shape = data.shape();
+    MultiCoordinateIterator<N> blocks(blocksShape(shape, block_shape));
+
+    parallel_foreach(options.getNumThreads(), blocks, blocks.getEndIterator(),
+        [&](const int /*threadId*/, const Shape block)
+        {
+            std::pair<Shape, Shape> bounds = blockBoundsAt(block, shape, block_shape);
+            std::pair<Shape, Shape> outer = overlapBoundsAt(bounds, shape, Shape(1), Shape(1));
+            std::pair<Shape, Shape> inner(bounds.first - outer.first, bounds.second - outer.first);
+
+            MultiArray<N, DataType> d(outer.second - outer.first);
+            MultiArray<N, MarkerType> m(bounds.second - bounds.first);
+            checkoutBlock(data, outer.first, d);
+
+            if(seed_options.mini == SeedOptions::LevelSets)
+            {
+                MultiArrayView<N, DataType, StridedArrayTag> core = d.subarray(inner.first, inner.second);
+                typename MultiArrayView<N, DataType, StridedArrayTag>::iterator c = core.begin();
+                for(typename MultiArray<N, MarkerType>::iterator i = m.begin(); i != m.end(); ++i, ++c)
+                    *i = (*c <= threshold) ? 1 : 0;
+            }
+            else
+            {
+                // thanks to the halo, the nodes of the inner box see all their neighbors
+                Graph graph(d.shape(), options.getNeighborhood());
+                detail_local_minima::localMinMaxBox(graph, d, m, inner.first, inner.second, 
+                                                    graph.neighborStrideOffsets(d.stride()), MarkerType(1),
+                                                    threshold, std::less<DataType>(), true);
+            }
+            commitBlock(markers, bounds.first, m);
+        }
+    );
+}
+
+static const unsigned short seed_direction = std::numeric_limits<unsigned short>::max();
+
+    // Seeded region growing in one block with a halo of one pixel. Every 
+    // labeled pixel stores its flooding cost and the direction of the neighbor 
+    // it was flooded from. A pixel is taken over by a neighbor whose cost is
+    // strictly smaller than the cost of its current predecessor (which is the 
+    // order in which the in-memory algorithm assigns labels), and follows 
+    // its predecessor when that changes. Returns true if a pixel next to 
+    // the block border changed.
+template <unsigned int N, class CostType, class Label>
+bool seededWatershedsBlock(MultiArrayView<N, CostType> const & data,
+                           MultiArrayView<N, Label> labels,
+                           MultiArrayView<N, CostType> costs,
+                           MultiArrayView<N, unsigned short> directions,
+                           std::pair<typename MultiArrayShape<N>::type,
+                                     typename MultiArrayShape<N>::type> const & inner,
+                           bool first_visit,
+                           NeighborhoodType neighborhood,
+                           WatershedOptions const & options,
+                           bool & changed)
+{
+    typedef typename MultiArrayShape<N>::type Shape;
+    typedef GridGraph<N, undirected_tag>      Graph;
+    typedef typename Graph::Node              Node;
+    typedef typename Graph::NodeIt            GraphScanner;
+    typedef typename Graph::OutArcIt          NeighborIterator;
+
+    Graph graph(data.shape(), neighborhood);
+    MonotoneRadixQueue<MultiArrayIndex, CostType> queue;
+    const bool stopAtThreshold = (options.terminate & StopAtThreshold) != 0;
+    bool border_changed = false;
+
+    // the halo carries the current state of the neighboring blocks,
+    // the interior only needs to be pushed when the block is visited first
+    for(GraphScanner node(graph); node != lemon::INVALID; ++node)
+    {
+        if(labels[*node] != 0 && (first_visit || !within(*node, inner)))
+            queue.push(graph.id(*node), costs[*node]);
+    }
+
+    while(!queue.empty())
+    {
+        Node node = graph.nodeFromId(queue.top());
+        CostType cost = queue.topPriority();
+        queue.pop();
+
+        if(cost != costs[node])
+            continue;  // outdated entry
+        if(stopAtThreshold && cost > options.max_cost)
+            continue;
+
+        Label label = labels[node];
+        for(NeighborIterator arc(graph, node); arc != lemon::INVALID; ++arc)
+        {
+            Node target = graph.target(*arc);
+            if(!within(target, inner) || directions[target] == seed_direction)
+                continue;
+
+            const unsigned short direction = graph.oppositeIndex(arc.neighborIndex());
+            const CostType target_cost = data[target] < cost ? cost : data[target];
+            if(labels[target] != 0)
+            {
+                if(directions[target] == direction)
+                {
+                    // the predecessor changed
+                    if(labels[target] == label && costs[target] == target_cost)
+                        continue;
+                }
+                else if(!(cost < costs[target + graph.neighborOffset(directions[target])]))
+                {
+                    continue;
+                }
+            }
+            labels[target] = label;
+            costs[target] = target_cost;
+            directions[target] = direction;
+            queue.push(graph.id(target), target_cost);
+            changed = true;
+            if(!border_changed)
+                border_changed = !allLess(inner.first, target) || !allLess(target + Shape(1), inner.second);
+        }
+    }
+    return border_changed;
+}
+
+    // Blockwise seeded watersheds for MultiArrayViews and ChunkedArrays.
+    // Blocks are visited in 2^N colors such that blocks of the same color
+    // don't touch and can be processed in parallel. Blocks are revisited 
+    // when the border of a neighbor changed, until no more changes occur.
+template <unsigned int N, class DataArray, class LabelArray, class CostArray, class DirectionsArray>
+typename LabelArray::value_type
+seededWatershedsBlockwise(DataArray const & data,
+                          LabelArray & labels,
+                          CostArray & costs,
+                          DirectionsArray & directions,
+                          typename MultiArrayShape<N>::type const & block_shape,
+                          BlockwiseLabelOptions const & options,
+                          WatershedOptions const & watershed_options)
+{
+    typedef typename MultiArrayShape<N>::type Shape;
+    typedef typename DataArray::value_type    CostType;
+    typedef typename LabelArray::value_type   Label;
+    using namespace overlapped_blocks_detail;
+
+    vigra_precondition(watershed_options.method == WatershedOptions::RegionGrowing,
+        "seededWatershedsBlockwise(): only region growing is supported, use unionFindWatershedsBlockwise().");
+    vigra_precondition((watershed_options.terminate & KeepContours) == 0,
+        "seededWatershedsBlockwise(): keepContours() is not supported.");
+    vigra_precondition(watershed_options.biased_label == 0,
+        "seededWatershedsBlockwise(): biasLabel() is not supported.");
+
+    const Shape shape = data.shape();
+    const Shape blocks_shape = blocksShape(shape, block_shape);
+    ThreadPool pool(options);
+
+    MultiArray<N, Label> block_max(blocks_shape);
+    auto forEachBlock = [&](std::vector<Shape> const & blocks, std::function<void(Shape const &)> const & f)
+    {
+        parallel_foreach(pool, blocks.begin(), blocks.end(),
+            [&](const int /*threadId*/, Shape const & block)
+            {
+                f(block);
+            }
+        );
+    };
+    std::vector<Shape> all_blocks;
+    for(MultiCoordinateIterator<N> b(blocks_shape); b.isValid(); ++b)
+        all_blocks.push_back(*b);
+
+    // seed computation as in watershedsGraph(), the seeds are 
+    // marked in 'directions' before they are labeled
+    SeedOptions seed_options;
+    if(watershed_options.seed_options.mini != SeedOptions::Unspecified)
+    {
+        seed_options = watershed_options.seed_options;
+    }
+    else
+    {
+        forEachBlock(all_blocks, [&](Shape const & block)
+        {
+            std::pair<Shape, Shape> bounds = blockBoundsAt(block, shape, block_shape);
+            MultiArray<N, Label> l(bounds.second - bounds.first);
+            checkoutBlock(labels, bounds.first, l);
+            block_max[block] = l.any() ? 1 : 0;
+        });
+        if(block_max.any())
+            seed_options.mini = SeedOptions::Unspecified;
+    }
+    if(seed_options.mini != SeedOptions::Unspecified)
+    {
+        prepareBlockwiseWatershedSeeds<N>(data, directions, block_shape, options, seed_options);
+        BlockwiseLabelOptions label_options(options);
+        label_options.ignoreBackgroundValue((unsigned short)0);
+        labelMultiArrayBlockwise(directions, labels, label_options);
+    }
+
+    // initialize costs and directions of the seeds
+    forEachBlock(all_blocks, [&](Shape const & block)
+    {
+        std::pair<Shape, Shape> bounds = blockBoundsAt(block, shape, block_shape);
+        MultiArray<N, Label> l(bounds.second - bounds.first);
+        MultiArray<N, unsigned short> dir(l.shape());
+        checkoutBlock(labels, bounds.first, l);
+        for(MultiArrayIndex k = 0; k < l.size(); ++k)
+            dir[k] = l[k] != 0 ? seed_direction : 0;
+        commitBlock(directions, bounds.first, dir);
+        MultiArray<N, CostType> c(l.shape());
+        checkoutBlock(data, bounds.first, c);
+        commitBlock(costs, bounds.first, c);
+        block_max[block] = *std::max_element(l.begin(), l.end());
+    });
+    Label max_label = *std::max_element(block_max.begin(), block_max.end());
+
+    MultiArray<N, UInt8> dirty(blocks_shape, UInt8(1)),
+                         visited(blocks_shape),
+                         border_changed(blocks_shape);
+    const NeighborhoodType neighborhood = options.getNeighborhood();
+    bool any_dirty = true;
+    while(any_dirty)
+    {
+        for(int color = 0; color < (1 << N); ++color)
+        {
+            std::vector<Shape> blocks;
+            for(auto b = all_blocks.begin(); b != all_blocks.end(); ++b)
+            {
+                int block_color = 0;
+                for(unsigned int d = 0; d < N; ++d)
+                    block_color |= ((*b)[d] % 2) << d;
+                if(block_color == color && dirty[*b])
+                {
+                    blocks.push_back(*b);
+                    dirty[*b] = 0;
+                }
+            }
+
+            forEachBlock(blocks, [&](Shape const & block)
+            {
+                std::pair<Shape, Shape> bounds = blockBoundsAt(block, shape, block_shape);
+                std::pair<Shape, Shape> outer = overlapBoundsAt(bounds, shape, Shape(1), Shape(1));
+                std::pair<Shape, Shape> inner(bounds.first - outer.first, bounds.second - outer.first);
+
+                MultiArray<N, CostType> d(outer.second - outer.first), c(d.shape());
+                MultiArray<N, Label> l(d.shape());
+                MultiArray<N, unsigned short> dir(d.shape());
+                checkoutBlock(data, outer.first, d);
+                checkoutBlock(labels, outer.first, l);
+                checkoutBlock(costs, outer.first, c);
+                checkoutBlock(directions, outer.first, dir);
+
+                bool changed = false;
+                border_changed[block] = seededWatershedsBlock(d, l, c, dir, inner, visited[block] == 0,
+                                                              neighborhood, watershed_options, changed);
+                visited[block] = 1;
+                if(changed)
+                {
+                    commitBlock(labels, bounds.first, l.subarray(inner.first, inner.second));
+                    commitBlock(costs, bounds.first, c.subarray(inner.first, inner.second));
+                    commitBlock(directions, bounds.first, dir.subarray(inner.first, inner.second));
+                }
+            });
+
+            for(auto b = blocks.begin(); b != blocks.end(); ++b)
+            {
+                if(!border_changed[*b])
+                    continue;
+                Shape begin = max(*b - Shape(1), Shape(0)),
+                      end   = min(*b + Shape(2), blocks_shape);
+                for(MultiCoordinateIterator<N> n(end - begin); n.isValid(); ++n)
+                    if(begin + *n != *b)
+                        dirty[begin + *n] = 1;
+            }
+        }
+        any_dirty = dirty.any();
+    }
+    return max_label;
+}
+
 } // namespace blockwise_watersheds_detail
 
 /*************************************************************/
@@ -257,6 +556,145 @@ unionFindWatershedsBlockwise(const ChunkedArray<N, Data>& data,
     return unionFindWatershedsBlockwise(data, labels, options, directions);
 }
 
+/*************************************************************/
+/*                                                           */
+/*                      seededWatershedsBlockwise            */
+/*                                                           */
+/*************************************************************/
+
+/** \weakgroup ParallelProcessing
+    \sa seededWatershedsBlockwise <B>(...)</B>
+*/
+
+/** \brief Blockwise seeded watersheds for MultiArrays and ChunkedArrays.
+
+    <b> Declaration:</b>
+
+    \code
+    namespace vigra {
+        template <unsigned int N, class Data, class S1,
+                                  class Label, class S2>
+        Label
+        seededWatershedsBlockwise(MultiArrayView<N, Data, S1> const & data,
+                                  MultiArrayView<N, Label, S2> labels,
+                                  BlockwiseLabelOptions const & options = BlockwiseLabelOptions(),
+                                  WatershedOptions const & watershed_options = WatershedOptions());
+
+        template <unsigned int N, class Data, class Label>
+        Label
+        seededWatershedsBlockwise(const ChunkedArray<N, Data>& data,
+                                  ChunkedArray<N, Label>& labels,
+                                  BlockwiseLabelOptions const & options = BlockwiseLabelOptions(),
+                                  WatershedOptions const & watershed_options = WatershedOptions());
+
+        // provide temporary storage for the flooding state
+        template <unsigned int N, class Data, class Label>
+        Label
+        seededWatershedsBlockwise(const ChunkedArray<N, Data>& data,
+                                  ChunkedArray<N, Label>& labels,
+                                  BlockwiseLabelOptions const & options,
+                                  WatershedOptions const & watershed_options,
+                                  ChunkedArray<N, Data>& temporary_costs,
+                                  ChunkedArray<N, unsigned short>& temporary_directions);
+    }
+    \endcode
+
+    Computes the same region growing watersheds as \ref watershedsMultiArray()
+    with <tt>WatershedOptions().regionGrowing()</tt>, but processes the array in 
+    blocks (the chunks of a ChunkedArray) in parallel. Each block is flooded 
+    from its seeds and from the current labels in a one-pixel halo around it. 
+    Blocks are flooded again whenever the labels at the border of a neighboring
+    block change, until the labeling converges. The result is identical to 
+    the in-memory algorithm whenever the flooding order is unique, e.g. for
+    data without repeated values. Otherwise, pixels that are reached from two 
+    regions at exactly the same cost may be assigned to the other region.
+
+    As in \ref watershedsMultiArray(), \a labels may contain seeds, or seeds are 
+    computed according to <tt>watershed_options.seedOptions()</tt> (local minima 
+    and level sets are supported, extended minima are not). In the latter case, 
+    the seeds are labeled in a different order than by the in-memory algorithm. 
+    Of the other watershed options, only stopAtThreshold() is supported.
+    Apart from the labels, the algorithm keeps the flooding cost of each pixel
+    and the direction it was flooded from. If \a temporary_costs and 
+    \a temporary_directions are provided, these arrays are used. Pass e.g. a 
+    \ref vigra::ChunkedArrayTmpFile when the volume does not fit into memory. 
+    Otherwise, newly created \ref vigra::ChunkedArrayLazy arrays are used.
+
+    Return: the largest label
+
+    <b> Usage: </b>
+
+    <b>\#include </b> \<vigra/blockwise_watersheds.hxx\><br>
+    Namespace: vigra
+
+    \code
+    Shape3 shape = Shape3(200);
+    Shape3 chunk_shape = Shape3(64);
+    ChunkedArrayLazy<3, float> data(shape, chunk_shape);
+    // fill data ...
+
+    ChunkedArrayLazy<3, UInt32> labels(shape, chunk_shape);
+    // put seeds into labels ...
+
+    seededWatershedsBlockwise(data, labels, BlockwiseLabelOptions().neighborhood(IndirectNeighborhood));
+    \endcode
+    */
+doxygen_overloaded_function(template <...> unsigned int seededWatershedsBlockwise)
+
+template <unsigned int N, class Data, class S1,
+                          class Label, class S2>
+Label seededWatershedsBlockwise(MultiArrayView<N, Data, S1> const & data,
+                                MultiArrayView<N, Label, S2> labels,
+                                BlockwiseLabelOptions const & options = BlockwiseLabelOptions(),
+                                WatershedOptions const & watershed_options = WatershedOptions())
+{
+    typedef typename MultiArrayView<N, Data, S1>::difference_type Shape;
+    Shape shape = data.shape();
+    vigra_precondition(shape == labels.shape(), 
+        "seededWatershedsBlockwise(): shapes of data and labels do not match");
+
+    MultiArray<N, Data> costs(shape);
+    MultiArray<N, unsigned short> directions(shape);
+    MultiArrayView<N, Data> costs_view(costs);
+    MultiArrayView<N, unsigned short> directions_view(directions);
+    return blockwise_watersheds_detail::seededWatershedsBlockwise<N>(data, labels, costs_view, directions_view,
+                                                   options.getBlockShapeN<N>(), options, watershed_options);
+}
+
+template <unsigned int N, class Data, class Label>
+Label seededWatershedsBlockwise(const ChunkedArray<N, Data>& data,
+                                ChunkedArray<N, Label>& labels,
+                                BlockwiseLabelOptions const & options,
+                                WatershedOptions const & watershed_options,
+                                ChunkedArray<N, Data>& temporary_costs,
+                                ChunkedArray<N, unsigned short>& temporary_directions)
+{
+    typedef typename ChunkedArray<N, Data>::shape_type Shape;
+    Shape shape = data.shape();
+    vigra_precondition(shape == labels.shape() && shape == temporary_directions.shape(),
+        "seededWatershedsBlockwise(): shapes of data and labels do not match");
+    Shape chunk_shape = data.chunkShape();
+    vigra_precondition(chunk_shape == labels.chunkShape() && chunk_shape == temporary_directions.chunkShape(),
+        "seededWatershedsBlockwise(): chunk shapes do not match");
+    vigra_precondition(shape == temporary_costs.shape() && chunk_shape == temporary_costs.chunkShape(),
+        "seededWatershedsBlockwise(): shape or chunk shape of temporary_costs does not match data");
+
+    return blockwise_watersheds_detail::seededWatershedsBlockwise<N>(data, labels, temporary_costs, temporary_directions,
+                                                   chunk_shape, options, watershed_options);
+}
+
+template <unsigned int N, class Data, class Label>
+inline Label
+seededWatershedsBlockwise(const ChunkedArray<N, Data>& data,
+                          ChunkedArray<N, Label>& labels,
+                          BlockwiseLabelOptions const & options = BlockwiseLabelOptions(),
+                          WatershedOptions const & watershed_options = WatershedOptions())
+{
+    ChunkedArrayLazy<N, Data> costs(data.shape(), data.chunkShape());
+    ChunkedArrayLazy<N, unsigned short> directions(data.shape(), data.chunkShape());
+    return seededWatershedsBlockwise(data, labels, options, watershed_options, costs, directions);
+}
+
 //@}
 
 } // namespace vigra
@@ -39,7 +39,9 @@
 
 /*std*/
 #include <algorithm>
+#include <memory>
 #include <set>
+#include <vector>
 
 /*vigra*/
 #include "accumulator.hxx"
@@ -47,17 +49,121 @@
 #include "multi_distance.hxx"
 #include "multi_resize.hxx"
 #include "graph_algorithms.hxx"
+#include "threadpool.hxx"
 
 
 namespace vigra
 {
 
+namespace detail {
 
-template <class Graph, class WeightType,
-          class EdgeMap, class Shape>
+    // Per-thread scratch space for the region-wise path searches. The grid graph,
+    // its edge weights and the path finder are only reallocated when a region's
+    // bounding box doesn't fit into the current graph, so that regions are processed
+    // in the top-left corner [0, box) of a graph that grows monotonically.
+template <unsigned int N, class WeightType>
+class EccentricityWorkspace
+{
+  public:
+    typedef GridGraph<N, undirected_tag>                 Graph;
+    typedef typename Graph::Node                         Node;
+    typedef typename Graph::Edge                         Edge;
+    typedef typename Graph::OutArcIt                     OutArcIt;
+    typedef typename Graph::template EdgeMap<WeightType> WeightMap;
+    typedef ShortestPathDijkstra<Graph, WeightType>      PathFinder;
+
+    void reserve(Node const & box)
+    {
+        if(graph_.get() != 0 && allLessEqual(box, graph_->shape()))
+            return;
+        Node shape = graph_.get() == 0
+                         ? box
+                         : max(box, graph_->shape());
+        pathFinder_.reset();
+        weights_.reset();
+        graph_.reset(new Graph(shape, IndirectNeighborhood));
+        weights_.reset(new WeightMap(*graph_));
+        pathFinder_.reset(new PathFinder(*graph_));
+    }
+
+        // set the weights of all edges within [0, box) to f(u, v)
+    template <class FUNCTOR>
+    void setWeights(Node const & box, FUNCTOR const & f)
+    {
+        MultiCoordinateIterator<N> p(box),
+                                   end = p.getEndIterator();
+        for(; p != end; ++p)
+        {
+            for(OutArcIt arc(*graph_, *p); arc != lemon::INVALID; ++arc)
+            {
+                const Node t(graph_->target(*arc));
+                if(allLess(t, box))
+                    (*weights_)[Edge(*arc)] = f(*p, t);
+            }
+        }
+    }
+
+    WeightMap const & weights() const
+    {
+        return *weights_;
+    }
+
+    PathFinder & pathFinder()
+    {
+        return *pathFinder_;
+    }
+
+  private:
+    std::unique_ptr<Graph>      graph_;
+    std::unique_ptr<WeightMap>  weights_;
+    std::unique_ptr<PathFinder> pathFinder_;
+};
+
+    // Collect the non-empty regions, largest bounding box first, such that
+    // the workspaces rarely need to grow and the expensive regions are
+    // scheduled early.
+template <unsigned int N, class T, class ACCUMULATOR>
+void
+eccentricityRegionOrder(ACCUMULATOR const & r, ArrayVector<T> & regions)
+{
+    using namespace acc;
+    typedef typename MultiArrayShape<N>::type Shape;
+
+    ArrayVector<std::pair<MultiArrayIndex, T> > sizes;
+    for (T i=0; i <= r.maxRegionLabel(); ++i)
+    {
+        if(get<Count>(r, i) == 0)
+            continue;
+        Shape box = get<Coord<Maximum> >(r, i) + Shape(1) - get<Coord<Minimum> >(r, i);
+        sizes.push_back(std::make_pair(-prod(box), i));
+    }
+    std::sort(sizes.begin(), sizes.end());
+    regions.resize(sizes.size());
+    for(std::size_t k=0; k < sizes.size(); ++k)
+        regions[k] = sizes[k].second;
+}
+
+    // Call f(threadId, k) for k in [0, n), handing out one item at a time
+    // so that a few huge regions don't stall an entire chunk of small ones.
+template <class FUNCTOR>
+void
+eccentricityParallelForEach(ThreadPool & pool, std::ptrdiff_t n, FUNCTOR const & f)
+{
+    threading::atomic_long next(0);
+    parallel_foreach(pool, std::max<std::ptrdiff_t>(pool.nThreads(), 1),
+        [&](int threadId, std::ptrdiff_t)
+        {
+            for(std::ptrdiff_t k = next.fetch_add(1); k < n; k = next.fetch_add(1))
+                f(threadId, k);
+        });
+}
+
+} // namespace detail
+
+template <class PathFinder, class EdgeMap, class Shape>
 TinyVector<MultiArrayIndex, Shape::static_size>
-eccentricityCentersOneRegionImpl(ShortestPathDijkstra<Graph, WeightType> & pathFinder,
-                        const EdgeMap & weights, WeightType maxWeight,
+eccentricityCentersOneRegionImpl(PathFinder & pathFinder,
+                        const EdgeMap & weights, typename PathFinder::WeightType maxWeight,
                         Shape anchor, Shape const & start, Shape const & stop)
 {
     int maxIterations = 4;
@@ -75,62 +181,61 @@ eccentricityCentersOneRegionImpl(ShortestPathDijkstra<Graph, WeightType> & pathF
     return path[roundi(path.arcLengthQuantile(0.5))];
 }
 
-template <unsigned int N, class T, class S, class Graph,
-          class ACCUMULATOR, class DIJKSTRA, class Array>
+template <unsigned int N, class T, class S, class ACCUMULATOR,
+          class Array, class Workspace>
 void
 eccentricityCentersImpl(const MultiArrayView<N, T, S> & src,
-                        Graph const & g,
                         ACCUMULATOR const & r,
-                        DIJKSTRA & pathFinder,
-                        Array & centers)
+                        ArrayVector<T> const & regions,
+                        Array & centers,
+                        ThreadPool & pool,
+                        std::vector<Workspace> & workspaces)
 {
     using namespace acc;
     typedef typename MultiArrayShape<N>::type Shape;
-    typedef typename Graph::Node Node;
-    typedef typename Graph::EdgeIt EdgeIt;
     typedef float WeightType;
 
-    typename Graph::template EdgeMap<WeightType> weights(g);
-    WeightType maxWeight = 0.0,
-               minWeight = N;
-    {
-        AccumulatorChainArray<CoupledArrays<N, WeightType, T>,
-                              Select< DataArg<1>, LabelArg<2>, Maximum> > a;
+    const WeightType minWeight = N;
+    AccumulatorChainArray<CoupledArrays<N, WeightType, T>,
+                          Select< DataArg<1>, LabelArg<2>, Maximum> > a;
 
-        MultiArray<N, WeightType> distances(src.shape());
-        boundaryMultiDistance(src, distances, true);
-        extractFeatures(distances, src, a);
-        for (EdgeIt edge(g); edge != lemon::INVALID; ++edge)
-        {
-            const Node u(g.u(*edge)), v(g.v(*edge));
-            const T label = src[u];
-            if(label != src[v])
-            {
-                weights[*edge] = NumericTraits<WeightType>::max();
-            }
-            else
-            {
-                WeightType weight = norm(u - v) *
-                                  (get<Maximum>(a, label) + minWeight - 0.5*(distances[u] + distances[v]));
-                weights[*edge] = weight;
-                maxWeight = std::max(weight, maxWeight);
-            }
-        }
-    }
-    maxWeight *= src.size();
+    MultiArray<N, WeightType> distances(src.shape());
+    boundaryMultiDistance(src, distances, true);
+    extractFeatures(distances, src, a);
 
     T maxLabel = r.maxRegionLabel();
     centers.resize(maxLabel+1);
 
-    for (T i=0; i <= maxLabel; ++i)
-    {
-        if(get<Count>(r, i) == 0)
-            continue;
-        centers[i] = eccentricityCentersOneRegionImpl(pathFinder, weights, maxWeight,
-                                             get<RegionAnchor>(r, i),
-                                             get<Coord<Minimum> >(r, i),
-                                             get<Coord<Maximum> >(r, i) + Shape(1));
-    }
+    detail::eccentricityParallelForEach(pool, regions.size(),
+        [&](int threadId, std::ptrdiff_t k)
+        {
+            const T label = regions[k];
+            const Shape start = get<Coord<Minimum> >(r, label),
+                        box   = get<Coord<Maximum> >(r, label) + Shape(1) - start;
+            const WeightType maxDistance = get<Maximum>(a, label);
+            WeightType maxWeight = 0.0;
+
+            Workspace & workspace = workspaces[threadId];
+            workspace.reserve(box);
+            workspace.setWeights(box,
+                [&](Shape const & u, Shape const & v) -> WeightType
+                {
+                    const Shape gu(u + start), gv(v + start);
+                    if(src[gu] != label || src[gv] != label)
+                        return NumericTraits<WeightType>::max();
+                    WeightType weight = norm(u - v) *
+                                      (maxDistance + minWeight - 0.5*(distances[gu] + distances[gv]));
+                    maxWeight = std::max(weight, maxWeight);
+                    return weight;
+                });
+            // no path within the region can be longer than this
+            maxWeight *= prod(box);
+
+            centers[label] = start +
+                eccentricityCentersOneRegionImpl(workspace.pathFinder(), workspace.weights(), maxWeight,
+                                                 Shape(get<RegionAnchor>(r, label) - start),
+                                                 Shape(), box);
+        });
 }
 
 /** \addtogroup DistanceTransform
@@ -147,13 +252,21 @@ eccentricityCentersImpl(const MultiArrayView<N, T, S> & src,
             template <unsigned int N, class T, class S, class Array>
             void
             eccentricityCenters(MultiArrayView<N, T, S> const & src,
-                                Array & centers);
+                                Array & centers,
+                                ParallelOptions const & options = ParallelOptions().numThreads(ParallelOptions::NoThreads));
         }
         \endcode
 
         \param[in] src : labeled array
         \param[out] centers : list of eccentricity centers (required interface:
                                <tt>centers[k] = TinyVector<int, N>()</tt> must be supported)
+        \param[in] options : number of threads to be used (default: <tt>ParallelOptions::NoThreads</tt>, i.e. sequential)
+
+        When <tt>options</tt> request threads, the regions are processed independently 
+        on a \ref vigra::ThreadPool. Each path
+        search only covers the region's bounding box, and each thread reuses its graph
+        and search buffers for all regions it handles. The result does not depend on
+        the number of threads.
 
         <b> Usage:</b>
 
@@ -172,21 +285,23 @@ eccentricityCentersImpl(const MultiArrayView<N, T, S> & src,
 template <unsigned int N, class T, class S, class Array>
 void
 eccentricityCenters(const MultiArrayView<N, T, S> & src,
-                    Array & centers)
+                    Array & centers,
+                    ParallelOptions const & options = ParallelOptions().numThreads(ParallelOptions::NoThreads))
 {
     using namespace acc;
-    typedef GridGraph<N> Graph;
-    typedef float WeightType;
-
-    Graph g(src.shape(), IndirectNeighborhood);
-    ShortestPathDijkstra<Graph, WeightType> pathFinder(g);
+    typedef detail::EccentricityWorkspace<N, float> Workspace;
 
     AccumulatorChainArray<CoupledArrays<N, T>,
                           Select< DataArg<1>, LabelArg<1>,
                                   Count, BoundingBox, RegionAnchor> > a;
     extractFeatures(src, a);
 
-    eccentricityCentersImpl(src, g, a, pathFinder, centers);
+    ArrayVector<T> regions;
+    detail::eccentricityRegionOrder<N>(a, regions);
+
+    ThreadPool pool(options);
+    std::vector<Workspace> workspaces(std::max<std::size_t>(pool.nThreads(), 1));
+    eccentricityCentersImpl(src, a, regions, centers, pool, workspaces);
 }
 
     /** \brief Computes the (approximate) eccentricity transform on each region of a labeled image.
@@ -200,14 +315,16 @@ eccentricityCenters(const MultiArrayView<N, T, S> & src,
             template <unsigned int N, class T, class S>
             void
             eccentricityTransformOnLabels(MultiArrayView<N, T> const & src,
-                                          MultiArrayView<N, S> dest);
+                                          MultiArrayView<N, S> dest,
+                                          ParallelOptions const & options = ParallelOptions().numThreads(ParallelOptions::NoThreads));
 
             // also return the eccentricity center of each region
             template <unsigned int N, class T, class S, class Array>
             void
             eccentricityTransformOnLabels(MultiArrayView<N, T> const & src,
                                           MultiArrayView<N, S> dest,
-                                          Array & centers);
+                                          Array & centers,
+                                          ParallelOptions const & options = ParallelOptions().numThreads(ParallelOptions::NoThreads));
         }
         \endcode
 
@@ -215,6 +332,10 @@ eccentricityCenters(const MultiArrayView<N, T, S> & src,
         \param[out] dest : eccentricity transform of src
         \param[out] centers : (optional) list of eccentricity centers (required interface:
                                <tt>centers[k] = TinyVector<int, N>()</tt> must be supported)
+        \param[in] options : number of threads to be used (default: <tt>ParallelOptions::NoThreads</tt>, i.e. sequential)
+
+        Like \ref eccentricityCenters(), the regions may be processed in parallel, and
+        each region's distances are computed within its bounding box only.
 
         <b> Usage:</b>
 
@@ -232,57 +353,76 @@ eccentricityCenters(const MultiArrayView<N, T, S> & src,
         \endcode
     */
 template <unsigned int N, class T, class S, class Array>
-void
+typename enable_if<!IsSameType<Array, ParallelOptions>::value>::type
 eccentricityTransformOnLabels(MultiArrayView<N, T> const & src,
                               MultiArrayView<N, S> dest,
-                              Array & centers)
+                              Array & centers,
+                              ParallelOptions const & options = ParallelOptions().numThreads(ParallelOptions::NoThreads))
 {
     using namespace acc;
     typedef typename MultiArrayShape<N>::type Shape;
-    typedef GridGraph<N> Graph;
-    typedef typename Graph::Node Node;
-    typedef typename Graph::EdgeIt EdgeIt;
     typedef float WeightType;
+    typedef detail::EccentricityWorkspace<N, WeightType> Workspace;
 
     vigra_precondition(src.shape() == dest.shape(),
         "eccentricityTransformOnLabels(): Shape mismatch between src and dest.");
 
-    Graph g(src.shape(), IndirectNeighborhood);
-    ShortestPathDijkstra<Graph, WeightType> pathFinder(g);
-
-    using namespace acc;
     AccumulatorChainArray<CoupledArrays<N, T>,
                           Select< DataArg<1>, LabelArg<1>,
                                   Count, BoundingBox, RegionAnchor> > a;
     extractFeatures(src, a);
 
-    eccentricityCentersImpl(src, g, a, pathFinder, centers);
+    ArrayVector<T> regions;
+    detail::eccentricityRegionOrder<N>(a, regions);
 
-    typename Graph::template EdgeMap<WeightType> weights(g);
-    for (EdgeIt edge(g); edge != lemon::INVALID; ++edge)
-    {
-        const Node u(g.u(*edge)), v(g.v(*edge));
-        const T label = src[u];
-        if(label != src[v])
-            weights[*edge] = NumericTraits<WeightType>::max();
-        else
-            weights[*edge] = norm(u - v);
-    }
-    ArrayVector<Shape> filtered_centers;
-    for (T i=0; i <= a.maxRegionLabel(); ++i)
-        if(get<Count>(a, i) > 0)
-            filtered_centers.push_back(centers[i]);
-    pathFinder.runMultiSource(weights, filtered_centers.begin(), filtered_centers.end());
-    dest = pathFinder.distances();
+    ThreadPool pool(options);
+    std::vector<Workspace> workspaces(std::max<std::size_t>(pool.nThreads(), 1));
+    eccentricityCentersImpl(src, a, regions, centers, pool, workspaces);
+
+    detail::eccentricityParallelForEach(pool, regions.size(),
+        [&](int threadId, std::ptrdiff_t k)
+        {
+            typedef typename Workspace::PathFinder PathFinder;
+
+            const T label = regions[k];
+            const Shape start = get<Coord<Minimum> >(a, label),
+                        box   = get<Coord<Maximum> >(a, label) + Shape(1) - start;
+
+            Workspace & workspace = workspaces[threadId];
+            workspace.reserve(box);
+            workspace.setWeights(box,
+                [&](Shape const & u, Shape const & v) -> WeightType
+                {
+                    if(src[u + start] != label || src[v + start] != label)
+                        return NumericTraits<WeightType>::max();
+                    return norm(u - v);
+                });
+
+            PathFinder & pathFinder = workspace.pathFinder();
+            pathFinder.run(Shape(), box, workspace.weights(), Shape(centers[label] - start),
+                           lemon::INVALID, WeightType(std::sqrt((double)N) * prod(box)));
+
+            MultiCoordinateIterator<N> p(box),
+                                       end = p.getEndIterator();
+            for(; p != end; ++p)
+            {
+                if(src[*p + start] != label)
+                    continue;
+                dest[*p + start] = pathFinder.predecessors()[*p] != lemon::INVALID
+                                       ? pathFinder.distances()[*p]
+                                       : NumericTraits<WeightType>::max();
+            }
+        });
 }
 
 template <unsigned int N, class T, class S>
 inline void
 eccentricityTransformOnLabels(MultiArrayView<N, T> const & src,
-                              MultiArrayView<N, S> dest)
+                              MultiArrayView<N, S> dest,
+                              ParallelOptions const & options = ParallelOptions().numThreads(ParallelOptions::NoThreads))
 {
     ArrayVector<TinyVector<MultiArrayIndex, N> > centers;
-    eccentricityTransformOnLabels(src, dest, centers);
+    eccentricityTransformOnLabels(src, dest, centers, options);
 }
 
 //@}
@@ -43,9 +43,13 @@
 /*std*/
 #include <algorithm>
 #include <vector>
+#include <deque>
 #include <functional>
 #include <set>
 #include <iomanip>
+#include <cstring>
+#include <limits>
+#include <type_traits>
 
 /*vigra*/
 #include "graphs.hxx"
@@ -54,7 +58,9 @@
 #include "priority_queue.hxx"
 #include "union_find.hxx"
 #include "adjacency_list_graph.hxx"
+#include "static_adjacency_list_graph.hxx"
 #include "graph_maps.hxx"
+#include "threadpool.hxx"
 
 #include "timing.hxx"
 //#include "openmp_helper.hxx"
@@ -213,6 +219,355 @@ namespace vigra{
         }
     }
 
+    namespace detail_graph_algorithms{
+
+        // adjacency of the regions u < v via the edge with the given id
+        struct RegionAdjacencyTuple{
+            Int64 u, v, edge;
+
+            bool operator<(const RegionAdjacencyTuple & other) const{
+                return u < other.u || (u == other.u && 
+                      (v < other.v || (v == other.v && edge < other.edge)));
+            }
+        };
+
+        /* Collect the adjacencies of the regions in a label array in a single parallel
+           pass and sort them by label pair. On return, 'hasLabel' marks the labels occurring 
+           in the array, 'uvIds' contains the unique label pairs (u < v) of adjacent regions in 
+           lexicographic order, and the ids of the grid graph edges between the regions of pair e are
+           affiliatedEdgeIds[affiliatedEdgeOffsets[e]], ..., affiliatedEdgeIds[affiliatedEdgeOffsets[e+1]-1]
+           in ascending order.
+        */
+        template<unsigned int DIM, class T, class S>
+        void regionAdjacency(
+            const GridGraph<DIM, boost_graph::undirected_tag> & graph,
+            const MultiArrayView<DIM, T, S> & labels,
+            const Int64 ignoreLabel,
+            const ParallelOptions & options,
+            std::vector<bool> & hasLabel,
+            std::vector<std::pair<Int64, Int64> > & uvIds,
+            std::vector<Int64> & affiliatedEdgeOffsets,
+            std::vector<Int64> & affiliatedEdgeIds
+        ){
+            typedef GridGraph<DIM, boost_graph::undirected_tag> Graph;
+            typedef typename Graph::shape_type    Shape;
+            typedef typename Graph::IncBackEdgeIt IncBackEdgeIt;
+            typedef RegionAdjacencyTuple          Tuple;
+
+            vigra_precondition(graph.shape() == labels.shape(),
+                "makeRegionAdjacencyGraph(): shape mismatch between graph and labels.");
+
+            ThreadPool pool(options);
+            const size_t nThreads = std::max<size_t>(pool.nThreads(), 1);
+
+            // single pass over the label array, every grid graph edge is 
+            // visited once from its node with larger id
+            std::vector<std::vector<Tuple> > threadTuples(nThreads);
+            std::vector<std::vector<bool> >  threadHasLabel(nThreads);
+            Shape lineStarts(labels.shape());
+            lineStarts[0] = 1;
+            parallel_foreach(pool, prod(lineStarts),
+                [&](const int threadId, const MultiArrayIndex k){
+                    std::vector<Tuple> & tuples = threadTuples[threadId];
+                    std::vector<bool>  & has    = threadHasLabel[threadId];
+                    Shape p(SkipInitialization);
+                    detail::ScanOrderToCoordinate<DIM>::exec(k, lineStarts, p);
+                    for(p[0] = 0; p[0] < labels.shape(0); ++p[0]){
+                        const Int64 lp = static_cast<Int64>(labels[p]);
+                        if(ignoreLabel != -1 && lp == ignoreLabel)
+                            continue;
+                        vigra_precondition(lp >= 0,
+                            "makeRegionAdjacencyGraph(): labels must be non-negative.");
+                        if((size_t)lp >= has.size())
+                            has.resize(lp+1, false);
+                        has[lp] = true;
+                        for(IncBackEdgeIt e(graph, p); e != lemon::INVALID; ++e){
+                            const Int64 lq = static_cast<Int64>(labels[graph.runningNode(e)]);
+                            if(lq == lp || (ignoreLabel != -1 && lq == ignoreLabel))
+                                continue;
+                            const Tuple t = { std::min(lp, lq), std::max(lp, lq), (Int64)graph.id(*e) };
+                            tuples.push_back(t);
+                        }
+                    }
+                }
+            );
+
+            size_t labelCount = 0;
+            for(size_t t = 0; t < nThreads; ++t)
+                labelCount = std::max(labelCount, threadHasLabel[t].size());
+            hasLabel.assign(labelCount, false);
+            for(size_t t = 0; t < nThreads; ++t){
+                for(size_t l = 0; l < threadHasLabel[t].size(); ++l)
+                    if(threadHasLabel[t][l])
+                        hasLabel[l] = true;
+                std::vector<bool>().swap(threadHasLabel[t]);
+            }
+
+            // distribute the tuples into buckets of consecutive lower labels
+            const size_t nBuckets = 4*nThreads;
+            auto bucketOf = [&](const Tuple & t){
+                return (size_t)((double)t.u / labelCount * nBuckets);
+            };
+            std::vector<std::vector<size_t> > bucketCounts(nThreads, std::vector<size_t>(nBuckets, 0));
+            parallel_foreach(pool, nThreads,
+                [&](const int, const size_t t){
+                    for(size_t i = 0; i < threadTuples[t].size(); ++i)
+                        ++bucketCounts[t][bucketOf(threadTuples[t][i])];
+                }
+            );
+            std::vector<std::vector<Tuple> > buckets(nBuckets);
+            for(size_t b = 0; b < nBuckets; ++b){
+                size_t size = 0;
+                for(size_t t = 0; t < nThreads; ++t){
+                    const size_t count = bucketCounts[t][b];
+                    bucketCounts[t][b] = size;
+                    size += count;
+                }
+                buckets[b].resize(size);
+            }
+            parallel_foreach(pool, nThreads,
+                [&](const int, const size_t t){
+                    for(size_t i = 0; i < threadTuples[t].size(); ++i){
+                        const size_t b = bucketOf(threadTuples[t][i]);
+                        buckets[b][bucketCounts[t][b]++] = threadTuples[t][i];
+                    }
+                    std::vector<Tuple>().swap(threadTuples[t]);
+                }
+            );
+
+            // sort the buckets and count their unique label pairs
+            std::vector<size_t> edgeBegin(nBuckets+1, 0), tupleBegin(nBuckets+1, 0);
+            parallel_foreach(pool, nBuckets,
+                [&](const int, const size_t b){
+                    std::vector<Tuple> & bucket = buckets[b];
+                    std::sort(bucket.begin(), bucket.end());
+                    size_t count = 0;
+                    for(size_t i = 0; i < bucket.size(); ++i)
+                        if(i == 0 || bucket[i].u != bucket[i-1].u || bucket[i].v != bucket[i-1].v)
+                            ++count;
+                    edgeBegin[b+1] = count;
+                }
+            );
+            for(size_t b = 0; b < nBuckets; ++b){
+                edgeBegin[b+1]  += edgeBegin[b];
+                tupleBegin[b+1] = tupleBegin[b] + buckets[b].size();
+            }
+
+            // emit the label pairs and the affiliated edges in CSR form
+            uvIds.resize(edgeBegin[nBuckets]);
+            affiliatedEdgeOffsets.resize(edgeBegin[nBuckets] + 1);
+            affiliatedEdgeIds.resize(tupleBegin[nBuckets]);
+            affiliatedEdgeOffsets.back() = tupleBegin[nBuckets];
+            parallel_foreach(pool, nBuckets,
+                [&](const int, const size_t b){
+                    std::vector<Tuple> & bucket = buckets[b];
+                    size_t e = edgeBegin[b], k = tupleBegin[b];
+                    for(size_t i = 0; i < bucket.size(); ++i, ++k){
+                        if(i == 0 || bucket[i].u != bucket[i-1].u || bucket[i].v != bucket[i-1].v){
+                            uvIds[e] = std::make_pair(bucket[i].u, bucket[i].v);
+                            affiliatedEdgeOffsets[e] = k;
+                            ++e;
+                        }
+                        affiliatedEdgeIds[k] = bucket[i].edge;
+                    }
+                    std::vector<Tuple>().swap(bucket);
+                }
+            );
+        }
+    } // namespace detail_graph_algorithms
+
+    /// \brief make a region adjacency graph from a label array in a single parallel pass
+    ///
+    /// This is a faster alternative to the generic version for labels on a GridGraph.
+    /// The adjacencies are collected per thread, sorted in parallel and the RAG
+    /// edges are added in lexicographic order of their label pairs. Instead of one vector
+    /// per RAG edge, the affiliated edges are returned in compressed sparse row form:
+    /// the ids of the grid graph edges belonging to RAG edge \a e are
+    /// <tt>affiliatedEdgeIds[affiliatedEdgeOffsets[rag.id(e)]]</tt>, ..., 
+    /// <tt>affiliatedEdgeIds[affiliatedEdgeOffsets[rag.id(e)+1]-1]</tt> in ascending order
+    /// (use <tt>graphIn.edgeFromId()</tt> to get the corresponding edges).
+    ///
+    /// \param graphIn  : undirected grid graph
+    /// \param labels   : label array with the shape of graphIn
+    /// \param[out] rag  : region adjacency graph, node ids are the labels
+    /// \param[out] affiliatedEdgeOffsets : offsets into affiliatedEdgeIds, size <tt>rag.edgeNum()+1</tt>
+    /// \param[out] affiliatedEdgeIds : ids of the grid graph edges of all RAG edges
+    /// \param      ignoreLabel : optional label to ignore (default: -1 means no label will be ignored)
+    /// \param      options : number of threads to be used
+    ///
+    template<unsigned int DIM, class T, class S>
+    void makeRegionAdjacencyGraph(
+        const GridGraph<DIM, boost_graph::undirected_tag> & graphIn,
+        const MultiArrayView<DIM, T, S> & labels,
+        AdjacencyListGraph & rag,
+        std::vector<Int64> & affiliatedEdgeOffsets,
+        std::vector<Int64> & affiliatedEdgeIds,
+        const Int64 ignoreLabel=-1,
+        const ParallelOptions & options = ParallelOptions()
+    ){
+        std::vector<bool> hasLabel;
+        std::vector<std::pair<Int64, Int64> > uvIds;
+        detail_graph_algorithms::regionAdjacency(graphIn, labels, ignoreLabel, options,
+                                                 hasLabel, uvIds, 
+                                                 affiliatedEdgeOffsets, affiliatedEdgeIds);
+
+        // the edges arrive in sorted order, so that every insertion 
+        // into the adjacency sets appends at the end
+        rag = AdjacencyListGraph(hasLabel.size(), uvIds.size());
+        for(size_t l = 0; l < hasLabel.size(); ++l)
+            if(hasLabel[l])
+                rag.addNode(l);
+        for(size_t e = 0; e < uvIds.size(); ++e)
+            rag.addEdge(rag.nodeFromId(uvIds[e].first), rag.nodeFromId(uvIds[e].second));
+    }
+
+    /// \brief make an immutable region adjacency graph from a label array in a single parallel pass
+    ///
+    /// Same as the \ref AdjacencyListGraph version above, but the RAG is
+    /// stored in compressed sparse row form (see \ref StaticAdjacencyListGraph), 
+    /// which avoids the per-node adjacency sets entirely.
+    ///
+    template<unsigned int DIM, class T, class S>
+    void makeRegionAdjacencyGraph(
+        const GridGraph<DIM, boost_graph::undirected_tag> & graphIn,
+        const MultiArrayView<DIM, T, S> & labels,
+        StaticAdjacencyListGraph & rag,
+        std::vector<Int64> & affiliatedEdgeOffsets,
+        std::vector<Int64> & affiliatedEdgeIds,
+        const Int64 ignoreLabel=-1,
+        const ParallelOptions & options = ParallelOptions()
+    ){
+        std::vector<bool> hasLabel;
+        std::vector<std::pair<Int64, Int64> > uvIds;
+        detail_graph_algorithms::regionAdjacency(graphIn, labels, ignoreLabel, options,
+                                                 hasLabel, uvIds, 
+                                                 affiliatedEdgeOffsets, affiliatedEdgeIds);
+        std::vector<Int64> nodeIds;
+        for(size_t l = 0; l < hasLabel.size(); ++l)
+            if(hasLabel[l])
+                nodeIds.push_back(l);
+        rag.assign(nodeIds.begin(), nodeIds.end(), uvIds);
+    }
+
+    /// \brief the statistics of the affiliated edge features computed by ragEdgeFeatures()
+    enum RagEdgeAccumulator { RagEdgeMean, RagEdgeSum, RagEdgeMin, RagEdgeMax };
+
+    namespace detail_graph_algorithms{
+
+    // accumulate scalar edge features with one of the RagEdgeAccumulator statistics
+    class RagEdgeFeatureAccumulator
+    {
+      public:
+        RagEdgeFeatureAccumulator(RagEdgeAccumulator kind)
+        : kind_(kind),
+          value_(0.0),
+          count_(0)
+        {
+            reset();
+        }
+
+        void reset()
+        {
+            value_ = kind_ == RagEdgeMin
+                        ? std::numeric_limits<double>::infinity()
+                        : kind_ == RagEdgeMax
+                            ? -std::numeric_limits<double>::infinity()
+                            : 0.0;
+            count_ = 0;
+        }
+
+        void operator()(double v)
+        {
+            if(kind_ == RagEdgeMin)
+                value_ = std::min(value_, v);
+            else if(kind_ == RagEdgeMax)
+                value_ = std::max(value_, v);
+            else
+                value_ += v;
+            ++count_;
+        }
+
+        double result() const
+        {
+            return kind_ == RagEdgeMean && count_ > 0
+                       ? value_ / count_
+                       : value_;
+        }
+
+      private:
+        RagEdgeAccumulator kind_;
+        double value_;
+        std::size_t count_;
+    };
+
+    } // namespace detail_graph_algorithms
+
+    /// \brief accumulate graph edge features over the affiliated edges of each RAG edge
+    ///
+    /// \param rag : region adjacency graph
+    /// \param graph : the graph the RAG was built from
+    /// \param affiliatedEdges : RAG edge map holding the graph edges of each RAG edge (see makeRegionAdjacencyGraph())
+    /// \param edgeFeatures : scalar graph edge map, either explicit or implicit (see \ref ImplicitEdgeMap)
+    /// \param accumulator : RagEdgeMean, RagEdgeSum, RagEdgeMin, or RagEdgeMax
+    /// \param[out] ragEdgeFeatures : RAG edge map receiving the results
+    template<class RAG, class GRAPH, class AFF_EDGES, class EDGE_FEATURES, class RAG_EDGE_FEATURES>
+    void ragEdgeFeatures(
+        const RAG & rag,
+        const GRAPH & /* graph */,
+        const AFF_EDGES & affiliatedEdges,
+        const EDGE_FEATURES & edgeFeatures,
+        RagEdgeAccumulator accumulator,
+        RAG_EDGE_FEATURES & ragEdgeFeatures
+    ){
+        typedef typename RAG::EdgeIt RagEdgeIt;
+        typedef typename RAG_EDGE_FEATURES::Value ResultType;
+
+        detail_graph_algorithms::RagEdgeFeatureAccumulator acc(accumulator);
+        for(RagEdgeIt e(rag); e != lemon::INVALID; ++e){
+            acc.reset();
+            for(std::size_t k = 0; k < affiliatedEdges[*e].size(); ++k)
+                acc(edgeFeatures[affiliatedEdges[*e][k]]);
+            ragEdgeFeatures[*e] = static_cast<ResultType>(acc.result());
+        }
+    }
+
+    /// \brief accumulate graph edge features for a RAG with affiliated edges in compressed sparse row form
+    ///
+    /// Same as above, but for the affiliated edges returned by the parallel versions of
+    /// makeRegionAdjacencyGraph(). The RAG edges are processed in parallel, so that
+    /// implicit edge features (see \ref ImplicitEdgeMap) are also computed in parallel.
+    template<class RAG, class GRAPH, class EDGE_FEATURES, class RAG_EDGE_FEATURES>
+    void ragEdgeFeatures(
+        const RAG & rag,
+        const GRAPH & graph,
+        const std::vector<Int64> & affiliatedEdgeOffsets,
+        const std::vector<Int64> & affiliatedEdgeIds,
+        const EDGE_FEATURES & edgeFeatures,
+        RagEdgeAccumulator accumulator,
+        RAG_EDGE_FEATURES & ragEdgeFeatures,
+        const ParallelOptions & options = ParallelOptions()
+    ){
+        typedef typename RAG::Edge RagEdge;
+        typedef typename RAG_EDGE_FEATURES::Value ResultType;
+
+        vigra_precondition(affiliatedEdgeOffsets.size() == (std::size_t)rag.maxEdgeId()+2,
+            "ragEdgeFeatures(): affiliatedEdgeOffsets must have size rag.maxEdgeId()+2.");
+
+        const detail_graph_algorithms::RagEdgeFeatureAccumulator prototype(accumulator);
+        ThreadPool pool(options);
+        parallel_foreach(pool, rag.maxEdgeId()+1,
+            [&](int, Int64 id)
+            {
+                const RagEdge e(rag.edgeFromId(id));
+                if(e == lemon::INVALID)
+                    return;
+                detail_graph_algorithms::RagEdgeFeatureAccumulator acc(prototype);
+                for(Int64 k = affiliatedEdgeOffsets[id]; k < affiliatedEdgeOffsets[id+1]; ++k)
+                    acc(edgeFeatures[graph.edgeFromId(affiliatedEdgeIds[k])]);
+                ragEdgeFeatures[e] = static_cast<ResultType>(acc.result());
+            });
+    }
+
     template<unsigned int DIM, class DTAG, class AFF_EDGES>
     size_t affiliatedEdgesSerializationSize(
         const GridGraph<DIM,DTAG> &,
@@ -293,18 +648,32 @@ namespace vigra{
 
 
     /// \brief shortest path computer
-    template<class GRAPH,class WEIGHT_TYPE>
+    ///
+    /// The priority queue is a template parameter. Besides the default
+    /// \ref ChangeablePriorityQueue (an indexed binary heap), the monotone queues 
+    /// \ref ChangeableBucketQueue (for integer weights) and \ref ChangeableRadixHeap 
+    /// (for integer and floating point weights) can be used, which are 
+    /// considerably faster for large graphs:
+    /// \code
+    /// ShortestPathDijkstra<GridGraph<3>, UInt32, ChangeableBucketQueue<UInt32> > pathFinder(graph);
+    /// ShortestPathDijkstra<GridGraph<3>, float,  ChangeableRadixHeap<float> >    pathFinder(graph);
+    /// \endcode
+    /// Nodes with equal distance may be visited in a different order, but the 
+    /// distances are the same for all queues.
+    template<class GRAPH,class WEIGHT_TYPE,
+             class PRIORITY_QUEUE = ChangeablePriorityQueue<WEIGHT_TYPE> >
     class ShortestPathDijkstra{
     public:
         typedef GRAPH Graph;
 
+        typedef typename Graph::index_type index_type;
         typedef typename Graph::Node Node;
         typedef typename Graph::NodeIt NodeIt;
         typedef typename Graph::Edge Edge;
         typedef typename Graph::OutArcIt OutArcIt;
 
         typedef WEIGHT_TYPE WeightType;
-        typedef ChangeablePriorityQueue<WeightType>           PqType;
+        typedef PRIORITY_QUEUE                                PqType;
         typedef typename Graph:: template NodeMap<Node>       PredecessorsMap;
         typedef typename Graph:: template NodeMap<WeightType> DistanceMap;
         typedef ArrayVector<Node>                             DiscoveryOrder;
@@ -314,7 +683,8 @@ namespace vigra{
         :   graph_(g),
             pq_(g.maxNodeId()+1),
             predMap_(g),
-            distMap_(g)
+            distMap_(g),
+            remainingTargets_(0)
         {
         }
 
@@ -382,6 +752,38 @@ namespace vigra{
             runImpl(weights, target, maxDistance);
         }
 
+        /// \brief run shortest path until all of several targets are reached
+        ///
+        /// \param weights : edge weights encoding the distance between adjacent nodes (must be non-negative) 
+        /// \param source  : source node where shortest path should start
+        /// \param target_begin, target_end : range of target nodes
+        /// \param maxDistance  : path search is terminated when the path length exceeds <tt>maxDistance</tt>
+        ///
+        /// The search stops as soon as the distances of all targets are final. Afterwards,
+        /// <tt>target()</tt> is the target reached last, or <tt>lemon::INVALID</tt> if some 
+        /// targets are unreachable.
+        template<class WEIGHTS, class ITER>
+        void runMultiTarget(const WEIGHTS & weights, const Node & source,
+                            ITER target_begin, ITER target_end,
+                            WeightType maxDistance=NumericTraits<WeightType>::max())
+        {
+            this->initializeMaps(source);
+            runMultiTargetImpl(weights, target_begin, target_end, maxDistance);
+        }
+
+        /// \brief run shortest path to several targets again
+        ///
+        /// This differs from <tt>runMultiTarget()</tt> only by initialization, 
+        /// see <tt>reRun()</tt>. 
+        template<class WEIGHTS, class ITER>
+        void reRunMultiTarget(const WEIGHTS & weights, const Node & source,
+                              ITER target_begin, ITER target_end,
+                              WeightType maxDistance=NumericTraits<WeightType>::max())
+        {
+            this->reInitializeMaps(source);
+            runMultiTargetImpl(weights, target_begin, target_end, maxDistance);
+        }
+
         /// \brief run shortest path with given edge weights from multiple sources.
         ///
         /// This is otherwise identical to standard <tt>run()</tt>, except that 
@@ -456,6 +858,33 @@ namespace vigra{
 
     private:
 
+        template<class WEIGHTS, class ITER>
+        void runMultiTargetImpl(const WEIGHTS & weights,
+                                ITER target_begin, ITER target_end,
+                                WeightType maxDistance)
+        {
+            if(isTarget_.size() == 0)
+                isTarget_.resize(graph_.maxNodeId()+1, false);
+            remainingTargets_ = 0;
+            Node lastTarget(lemon::INVALID);
+            for(ITER t = target_begin; t != target_end; ++t)
+            {
+                if(!isTarget_[graph_.id(*t)])
+                {
+                    isTarget_[graph_.id(*t)] = true;
+                    ++remainingTargets_;
+                }
+            }
+            runImpl(weights, lemon::INVALID, maxDistance);
+            if(remainingTargets_ > 0)
+                target_ = lemon::INVALID;
+            else
+                target_ = discoveryOrder_.back();
+            remainingTargets_ = 0;
+            for(ITER t = target_begin; t != target_end; ++t)
+                isTarget_[graph_.id(*t)] = false;
+        }
+
         template<class WEIGHTS>
         void runImpl(const WEIGHTS & weights,
                      const Node & target = lemon::INVALID, 
@@ -474,23 +903,25 @@ namespace vigra{
             WeightType maxDistance=NumericTraits<WeightType>::max())
         {
             target_ = lemon::INVALID;
+            OutArcVisitor<Graph> visitNeighbors(graph_);
             while(!pq_.empty() ){ //&& !finished){
-                const Node topNode(graph_.nodeFromId(pq_.top()));
+                const index_type topNodeId = pq_.top();
+                const Node topNode(graph_.nodeFromId(topNodeId));
                 if(distMap_[topNode] > maxDistance)
                     break; // distance threshold exceeded
                 pq_.pop();
                 discoveryOrder_.push_back(topNode);
                 if(topNode == target)
                     break;
+                if(remainingTargets_ > 0 && isTarget_[topNodeId] && --remainingTargets_ == 0)
+                    break;
                 // loop over all neigbours
-                for(OutArcIt outArcIt(graph_,topNode);outArcIt!=lemon::INVALID;++outArcIt){
-                    const Node otherNode = graph_.target(*outArcIt);
-                    const size_t otherNodeId = graph_.id(otherNode);
+                const WeightType topDist = distMap_[topNode];
+                visitNeighbors(topNode, topNodeId, [&](const Node & otherNode, index_type otherNodeId, const Edge & edge){
                     const WeightType otherNodeWeight = nodeWeights[otherNode];
                     if(pq_.contains(otherNodeId)){
-                        const Edge edge(*outArcIt);
                         const WeightType currentDist     = distMap_[otherNode];
-                        const WeightType alternativeDist = distMap_[topNode]+edgeWeights[edge]+otherNodeWeight;
+                        const WeightType alternativeDist = topDist+edgeWeights[edge]+otherNodeWeight;
                         if(alternativeDist<currentDist){
                             pq_.push(otherNodeId,alternativeDist);
                             distMap_[otherNode]=alternativeDist;
@@ -498,8 +929,7 @@ namespace vigra{
                         }
                     }
                     else if(predMap_[otherNode]==lemon::INVALID){
-                        const Edge edge(*outArcIt);
-                        const WeightType initialDist = distMap_[topNode]+edgeWeights[edge]+otherNodeWeight;
+                        const WeightType initialDist = topDist+edgeWeights[edge]+otherNodeWeight;
                         if(initialDist<=maxDistance)
                         {
                             pq_.push(otherNodeId,initialDist);
@@ -507,7 +937,7 @@ namespace vigra{
                             predMap_[otherNode]=topNode;
                         }
                     }
-                }
+                });
             }
             while(!pq_.empty() ){
                 const Node topNode(graph_.nodeFromId(pq_.top()));
@@ -581,11 +1011,385 @@ namespace vigra{
         PredecessorsMap predMap_;
         DistanceMap     distMap_;
         DiscoveryOrder  discoveryOrder_;
+        std::vector<bool> isTarget_;
+        size_t          remainingTargets_;
 
         Node source_;
         Node target_;
     };
 
+    /// \brief parallel shortest path computer using delta-stepping
+    ///
+    /// Computes the same distances as \ref ShortestPathDijkstra, but settles all nodes
+    /// whose tentative distance falls into the same bucket <tt>[i*delta, (i+1)*delta)</tt>
+    /// at once and relaxes their outgoing edges on a \ref ThreadPool 
+    /// (Meyer and Sanders: <i>"Delta-stepping: a parallelizable shortest path algorithm"</i>, 
+    /// J. Algorithms 49(1), 2003). 
+    ///
+    /// The weights only need to support <tt>weights[edge]</tt>, so implicit edge maps 
+    /// like \ref OnTheFlyEdgeMap2, which compute the weight from a node map on access, 
+    /// can be passed instead of a materialized edge map:
+    /// \code
+    /// typedef GridGraph<3, undirected_tag> Graph;
+    /// Graph graph(shape);
+    /// MultiArray<3, float> nodeWeights(shape);
+    /// ...
+    /// OnTheFlyEdgeMap2<Graph, MultiArrayView<3, float>, MeanFunctor<float>, float> 
+    ///     weights(graph, nodeWeights, MeanFunctor<float>());
+    /// ShortestPathDeltaStepping<Graph, float> pathFinder(graph, ParallelOptions().numThreads(8));
+    /// pathFinder.run(weights, source);
+    /// \endcode
+    ///
+    /// When several shortest paths lead to a node, the predecessor is the neighbor with the 
+    /// smallest distance and, among those, the one with the smallest ID. This coincides with 
+    /// the choice of \ref ShortestPathDijkstra unless several of these neighbors have 
+    /// the same distance. The result does not depend on the number of threads, except for
+    /// ties across edges of weight zero.
+    ///
+    /// In contrast to \ref ShortestPathDijkstra, the search cannot stop at a target node,
+    /// and <tt>discoveryOrder()</tt> is not available.
+    template<class GRAPH,class WEIGHT_TYPE>
+    class ShortestPathDeltaStepping{
+    public:
+        typedef GRAPH Graph;
+
+        typedef typename Graph::Node Node;
+        typedef typename Graph::NodeIt NodeIt;
+        typedef typename Graph::Edge Edge;
+        typedef typename Graph::EdgeIt EdgeIt;
+        typedef typename Graph::OutArcIt OutArcIt;
+
+        typedef WEIGHT_TYPE WeightType;
+        typedef typename Graph:: template NodeMap<Node>       PredecessorsMap;
+        typedef typename Graph:: template NodeMap<WeightType> DistanceMap;
+
+        /// \brief constructor from graph
+        ///
+        /// \param g : the graph
+        /// \param options : number of threads to be used (default: the number of cores)
+        ShortestPathDeltaStepping(const Graph & g,
+                                  ParallelOptions const & options = ParallelOptions())
+        :   graph_(g),
+            options_(options),
+            predMap_(g),
+            distMap_(g),
+            requestedDelta_(0),
+            delta_(0)
+        {}
+
+        /// \brief set the bucket width
+        ///
+        /// Edges with weight <tt><= delta</tt> are relaxed repeatedly within a bucket,
+        /// heavier edges only once per bucket. Small values mean less redundant work, 
+        /// but less parallelism. If <tt>delta <= 0</tt> (the default), the mean weight 
+        /// of a sample of edges is used.
+        void setDelta(WeightType delta)
+        {
+            requestedDelta_ = delta;
+        }
+
+        /// \brief get the bucket width used by the last run
+        WeightType delta() const
+        {
+            return delta_;
+        }
+
+        /// \brief run shortest path given edge weights
+        ///
+        /// \param weights : edge weights encoding the distance between adjacent nodes (must be non-negative) 
+        /// \param source  : source node where shortest path should start
+        /// \param maxDistance  : nodes farther away than <tt>maxDistance</tt> are not visited
+        ///
+        /// Unvisited nodes get the predecessor <tt>lemon::INVALID</tt> and 
+        /// the distance <tt>NumericTraits<WeightType>::max()</tt>.
+        template<class WEIGHTS>
+        void run(const WEIGHTS & weights, const Node & source,
+                 WeightType maxDistance=NumericTraits<WeightType>::max())
+        {
+            runMultiSource(weights, &source, &source+1, maxDistance);
+        }
+
+        /// \brief run shortest path given edge weights from multiple sources
+        template<class WEIGHTS, class ITER>
+        void runMultiSource(const WEIGHTS & weights, ITER source_begin, ITER source_end,
+                            WeightType maxDistance=NumericTraits<WeightType>::max())
+        {
+            ZeroNodeMap<Graph, WEIGHT_TYPE> zeroNodeMap;
+            runImpl(weights, zeroNodeMap, source_begin, source_end, maxDistance);
+        }
+
+        /// \brief run shortest path given edge and node weights from multiple sources
+        ///
+        /// Like in \ref ShortestPathDijkstra, the weight of a node is added 
+        /// when the node is entered.
+        template<class EDGE_WEIGHTS, class NODE_WEIGHTS, class ITER>
+        void runMultiSource(const EDGE_WEIGHTS & edgeWeights, const NODE_WEIGHTS & nodeWeights,
+                            ITER source_begin, ITER source_end,
+                            WeightType maxDistance=NumericTraits<WeightType>::max())
+        {
+            runImpl(edgeWeights, nodeWeights, source_begin, source_end, maxDistance);
+        }
+
+        /// \brief get the graph
+        const Graph & graph()const{
+            return graph_;
+        }
+
+        /// \brief get the source node (<tt>lemon::INVALID</tt> after <tt>runMultiSource()</tt>)
+        const Node & source()const{
+            return source_;
+        }
+
+        /// \brief get the predecessors node map (after a call of run)
+        const PredecessorsMap & predecessors()const{
+            return predMap_;
+        }
+        
+        /// \brief get the distances node map (after a call of run)
+        const DistanceMap & distances()const{
+            return distMap_;
+        }
+        
+        /// \brief get the distance to a target node (after a call of run)
+        WeightType distance(const Node & target)const{
+            return distMap_[target];
+        }
+
+    private:
+
+        struct Request
+        {
+            Int64 node, predecessor;
+            WeightType distance, predecessorDistance;
+        };
+
+            // Each node belongs to the thread that owns its ID range. Only the owner 
+            // changes the node's distance and puts it into buckets, so that requests 
+            // can be applied without locks.
+        struct Owner
+        {
+            std::deque<std::vector<Int64> > buckets; // buckets[k] is bucket currentBucket_+k
+            std::vector<Int64> frontier, settled;
+        };
+
+        Int64 owner(Int64 node) const
+        {
+            return node * (Int64)owners_.size() / (graph_.maxNodeId()+1);
+        }
+
+        void insert(Owner & o, Int64 node, WeightType distance)
+        {
+            std::size_t k = static_cast<std::size_t>(distance / delta_) - currentBucket_;
+            if(o.buckets.size() <= k)
+                o.buckets.resize(k+1);
+            o.buckets[k].push_back(node);
+        }
+
+            // skip empty buckets, return false when all buckets are exhausted
+        bool nextBucket()
+        {
+            while(true)
+            {
+                bool pending = false;
+                for(std::size_t o=0; o<owners_.size(); ++o)
+                {
+                    if(owners_[o].buckets.size() == 0)
+                        continue;
+                    if(owners_[o].buckets.front().size() > 0)
+                        return true;
+                    pending = true;
+                }
+                if(!pending)
+                    return false;
+                for(std::size_t o=0; o<owners_.size(); ++o)
+                    if(owners_[o].buckets.size() > 0)
+                        owners_[o].buckets.pop_front();
+                ++currentBucket_;
+            }
+        }
+
+            // move the nodes of the current bucket that have not yet been relaxed
+            // with their present distance into frontier_
+        bool collectFrontier(ThreadPool & pool)
+        {
+            parallel_foreach(pool, owners_.size(),
+                [this](int, std::size_t k)
+                {
+                    Owner & o = owners_[k];
+                    o.frontier.clear();
+                    if(o.buckets.size() == 0)
+                        return;
+                    std::vector<Int64> & bucket = o.buckets.front();
+                    for(std::size_t i=0; i<bucket.size(); ++i)
+                    {
+                        const Int64 node = bucket[i];
+                        if(dist_[node] < relaxedAt_[node])
+                        {
+                            relaxedAt_[node] = dist_[node];
+                            o.frontier.push_back(node);
+                            o.settled.push_back(node);
+                        }
+                    }
+                    bucket.clear();
+                });
+            frontier_.clear();
+            for(std::size_t o=0; o<owners_.size(); ++o)
+                frontier_.insert(frontier_.end(), owners_[o].frontier.begin(), owners_[o].frontier.end());
+            return frontier_.size() > 0;
+        }
+
+        template<class EDGE_WEIGHTS, class NODE_WEIGHTS>
+        void relax(ThreadPool & pool,
+                   const EDGE_WEIGHTS & edgeWeights, const NODE_WEIGHTS & nodeWeights,
+                   bool light, WeightType maxDistance)
+        {
+            parallel_foreach(pool, frontier_.size(),
+                [&](int threadId, std::size_t k)
+                {
+                    const Int64 u = frontier_[k];
+                    const WeightType du = dist_[u];
+                    std::vector<std::vector<Request> > & requests = requests_[threadId];
+                    for(OutArcIt arc(graph_, graph_.nodeFromId(u)); arc != lemon::INVALID; ++arc)
+                    {
+                        const Node target(graph_.target(*arc));
+                        const WeightType w = edgeWeights[Edge(*arc)] + nodeWeights[target];
+                        if((w <= delta_) != light)
+                            continue;
+                        const WeightType d = du + w;
+                        const Int64 v = graph_.id(target);
+                        if(d <= dist_[v] && d <= maxDistance)
+                        {
+                            Request r = { v, u, d, du };
+                            requests[owner(v)].push_back(r);
+                        }
+                    }
+                });
+            parallel_foreach(pool, owners_.size(),
+                [this](int, std::size_t o)
+                {
+                    for(std::size_t t=0; t<requests_.size(); ++t)
+                    {
+                        std::vector<Request> & requests = requests_[t][o];
+                        for(std::size_t i=0; i<requests.size(); ++i)
+                        {
+                            Request const & r = requests[i];
+                            if(r.distance < dist_[r.node])
+                            {
+                                dist_[r.node] = r.distance;
+                                pred_[r.node] = r.predecessor;
+                                predDist_[r.node] = r.predecessorDistance;
+                                insert(owners_[o], r.node, r.distance);
+                            }
+                            else if(r.distance == dist_[r.node] && 
+                                    r.predecessorDistance < r.distance &&
+                                    (r.predecessorDistance < predDist_[r.node] ||
+                                     (r.predecessorDistance == predDist_[r.node] && r.predecessor < pred_[r.node])))
+                            {
+                                // tie: prefer the earliest settled predecessor, like Dijkstra
+                                pred_[r.node] = r.predecessor;
+                                predDist_[r.node] = r.predecessorDistance;
+                            }
+                        }
+                        requests.clear();
+                    }
+                });
+        }
+
+        template<class EDGE_WEIGHTS, class NODE_WEIGHTS>
+        WeightType estimateDelta(const EDGE_WEIGHTS & edgeWeights, const NODE_WEIGHTS & nodeWeights) const
+        {
+            const int maxSamples = 4096;
+            double sum = 0.0;
+            int count = 0;
+            for(EdgeIt e(graph_); e != lemon::INVALID && count < maxSamples; ++e, ++count)
+                sum += edgeWeights[*e] + nodeWeights[graph_.v(*e)];
+            WeightType delta = count > 0
+                                   ? NumericTraits<WeightType>::fromRealPromote(sum / count)
+                                   : WeightType();
+            return delta > WeightType()
+                       ? delta
+                       : NumericTraits<WeightType>::one();
+        }
+
+        template<class EDGE_WEIGHTS, class NODE_WEIGHTS, class ITER>
+        void runImpl(const EDGE_WEIGHTS & edgeWeights, const NODE_WEIGHTS & nodeWeights,
+                     ITER source_begin, ITER source_end, WeightType maxDistance)
+        {
+            ThreadPool pool(options_);
+            const std::size_t nThreads = std::max<std::size_t>(pool.nThreads(), 1);
+            const std::size_t nNodes   = graph_.maxNodeId()+1;
+
+            delta_ = requestedDelta_ > WeightType()
+                         ? requestedDelta_
+                         : estimateDelta(edgeWeights, nodeWeights);
+
+            dist_.assign(nNodes, NumericTraits<WeightType>::max());
+            relaxedAt_.assign(nNodes, NumericTraits<WeightType>::max());
+            predDist_.assign(nNodes, NumericTraits<WeightType>::max());
+            pred_.assign(nNodes, -1);
+            owners_.clear();
+            owners_.resize(nThreads);
+            requests_.assign(nThreads, std::vector<std::vector<Request> >(nThreads));
+            currentBucket_ = 0;
+
+            source_ = lemon::INVALID;
+            if(std::distance(source_begin, source_end) == 1)
+                source_ = *source_begin;
+            for(; source_begin != source_end; ++source_begin)
+            {
+                const Int64 s = graph_.id(*source_begin);
+                dist_[s] = WeightType();
+                pred_[s] = s;
+                predDist_[s] = WeightType();
+                insert(owners_[owner(s)], s, WeightType());
+            }
+
+            while(nextBucket())
+            {
+                // light edges may lead back into the current bucket
+                while(collectFrontier(pool))
+                    relax(pool, edgeWeights, nodeWeights, true, maxDistance);
+
+                // heavy edges only lead to later buckets, relax them once per settled node
+                frontier_.clear();
+                for(std::size_t o=0; o<owners_.size(); ++o)
+                {
+                    std::vector<Int64> & settled = owners_[o].settled;
+                    std::sort(settled.begin(), settled.end());
+                    settled.erase(std::unique(settled.begin(), settled.end()), settled.end());
+                    frontier_.insert(frontier_.end(), settled.begin(), settled.end());
+                    settled.clear();
+                }
+                relax(pool, edgeWeights, nodeWeights, false, maxDistance);
+            }
+
+            parallel_foreach(pool, nNodes,
+                [this](int, std::size_t k)
+                {
+                    const Node node(graph_.nodeFromId(k));
+                    if(node == lemon::INVALID)
+                        return;
+                    distMap_[node] = dist_[k];
+                    predMap_[node] = pred_[k] >= 0
+                                         ? graph_.nodeFromId(pred_[k])
+                                         : Node(lemon::INVALID);
+                });
+        }
+
+        const Graph  &  graph_;
+        ParallelOptions options_;
+        PredecessorsMap predMap_;
+        DistanceMap     distMap_;
+        WeightType      requestedDelta_, delta_;
+        Node            source_;
+
+        std::vector<WeightType> dist_, relaxedAt_, predDist_;
+        std::vector<Int64>      pred_, frontier_;
+        std::vector<Owner>      owners_;
+        std::vector<std::vector<std::vector<Request> > > requests_;
+        std::size_t             currentBucket_;
+    };
+
     /// \brief get the length in node units of a path
     template<class NODE,class PREDECESSORS>
     size_t pathLength(
@@ -683,8 +1487,71 @@ namespace vigra{
             }
         }
     }
-    
+    
+
+    namespace detail_graph_algorithms{
+
+    // propagate the seed labels along the shortest path trees
+    template<class GRAPH, class PREDECESSORS, class SEED_NODE_MAP>
+    void labelsFromPredecessors(
+        const GRAPH & graph,
+        const PREDECESSORS & predMap,
+        SEED_NODE_MAP & seeds
+    ){
+        typedef typename GRAPH::Node Node;
+        typedef typename GRAPH::NodeIt NodeIt;
+        for(NodeIt n(graph);n!=lemon::INVALID;++n){
+            Node node(*n);
+            if(seeds[node]==0){
+                Node pred=predMap[node];
+                while(seeds[pred]==0){
+                    pred=predMap[pred];
+                }
+                seeds[node]=seeds[pred];
+            }
+        }
+    }
+
+    } // namespace detail_graph_algorithms
+
+    template<
+    class GRAPH, 
+    class EDGE_WEIGHTS, 
+    class NODE_WEIGHTS,
+    class SEED_NODE_MAP,
+    class WEIGHT_TYPE
+    >
+    void shortestPathSegmentation(
+        const GRAPH & graph,
+        const EDGE_WEIGHTS & edgeWeights,
+        const NODE_WEIGHTS & nodeWeights,
+        SEED_NODE_MAP & seeds
+    ){
+
+        typedef GRAPH Graph;
+        typedef typename Graph::Node Node;
+        typedef typename Graph::NodeIt NodeIt;
+        typedef WEIGHT_TYPE WeightType;
+
+        // find seeds
+        std::vector<Node> seededNodes;
+        for(NodeIt n(graph);n!=lemon::INVALID;++n){
+            const Node node(*n);
+            // not a seed
+            if(seeds[node]!=0){
+                seededNodes.push_back(node);
+            }
+        }
+
+        // do shortest path
+        typedef ShortestPathDijkstra<Graph, WeightType> Sp;
+        Sp sp(graph);
+        sp.runMultiSource(edgeWeights, nodeWeights, seededNodes.begin(), seededNodes.end());
+        // do the labeling
+        detail_graph_algorithms::labelsFromPredecessors(graph, sp.predecessors(), seeds);
+    }
 
+    /// \brief parallel version of shortestPathSegmentation() using \ref ShortestPathDeltaStepping
     template<
     class GRAPH, 
     class EDGE_WEIGHTS, 
@@ -696,7 +1563,8 @@ namespace vigra{
         const GRAPH & graph,
         const EDGE_WEIGHTS & edgeWeights,
         const NODE_WEIGHTS & nodeWeights,
-        SEED_NODE_MAP & seeds
+        SEED_NODE_MAP & seeds,
+        ParallelOptions const & options
     ){
 
         typedef GRAPH Graph;
@@ -704,33 +1572,17 @@ namespace vigra{
         typedef typename Graph::NodeIt NodeIt;
         typedef WEIGHT_TYPE WeightType;
 
-        // find seeds
         std::vector<Node> seededNodes;
         for(NodeIt n(graph);n!=lemon::INVALID;++n){
             const Node node(*n);
-            // not a seed
             if(seeds[node]!=0){
                 seededNodes.push_back(node);
             }
         }
 
-        // do shortest path
-        typedef ShortestPathDijkstra<Graph, WeightType> Sp;
-        typedef typename Sp::PredecessorsMap PredecessorsMap;
-        Sp sp(graph);
+        ShortestPathDeltaStepping<Graph, WeightType> sp(graph, options);
         sp.runMultiSource(edgeWeights, nodeWeights, seededNodes.begin(), seededNodes.end());
-        const PredecessorsMap & predMap = sp.predecessors();
-        // do the labeling
-        for(NodeIt n(graph);n!=lemon::INVALID;++n){
-            Node node(*n);
-            if(seeds[node]==0){
-                Node pred=predMap[node];
-                while(seeds[pred]==0){
-                    pred=predMap[pred];
-                }
-                seeds[node]=seeds[pred];
-            }
-        }
+        detail_graph_algorithms::labelsFromPredecessors(graph, sp.predecessors(), seeds);
     }
 
     namespace detail_watersheds_segmentation{
@@ -1006,6 +1858,521 @@ namespace vigra{
 
 
 
+    /// \brief options for the parallel versions of felzenszwalbSegmentation()
+    ///
+    /// In addition to the number of threads (inherited from \ref ParallelOptions), 
+    /// this specifies the stopping condition and whether the block-parallel
+    /// approximation is to be used for \ref GridGraph.
+    class FelzenszwalbOptions
+    : public ParallelOptions
+    {
+      public:
+        FelzenszwalbOptions()
+        : ParallelOptions(),
+          nodeNumStopCond_(-1),
+          blockShape_()
+        {}
+
+        /// \brief number of threads (see \ref ParallelOptions)
+        FelzenszwalbOptions & numThreads(const int n)
+        {
+            ParallelOptions::numThreads(n);
+            return *this;
+        }
+
+        /// \brief stop merging when the number of regions reaches this value
+        ///
+        /// Like in the serial version, \a k is increased by 20% and the 
+        /// sweep is repeated until the condition is met. Only supported for 
+        /// the exact algorithm. Default: -1 (don't stop early)
+        FelzenszwalbOptions & nodeNumStopCond(int n)
+        {
+            nodeNumStopCond_ = n;
+            return *this;
+        }
+
+        int getNodeNumStopCond() const
+        {
+            return nodeNumStopCond_;
+        }
+
+        /// \brief use the block-parallel approximation with blocks of the given shape
+        ///
+        /// The \ref GridGraph is split into blocks which are segmented independently
+        /// in parallel. Afterwards, the edges between blocks are processed in sorted order,
+        /// using the same merge criterion. The result is an approximation because 
+        /// within-block merges have been decided without knowledge of cheaper
+        /// edges crossing the block border. If <tt>blockShape.size() == 1</tt>, square 
+        /// blocks are used. Default: empty (use the exact algorithm)
+        FelzenszwalbOptions & blockShape(ArrayVector<MultiArrayIndex> const & blockShape)
+        {
+            blockShape_ = blockShape;
+            return *this;
+        }
+
+        template <class T, int N>
+        FelzenszwalbOptions & blockShape(TinyVector<T, N> const & blockShape)
+        {
+            blockShape_ = ArrayVector<MultiArrayIndex>(blockShape.begin(), blockShape.end());
+            return *this;
+        }
+
+        FelzenszwalbOptions & blockShape(MultiArrayIndex blockShape)
+        {
+            blockShape_ = ArrayVector<MultiArrayIndex>(1, blockShape);
+            return *this;
+        }
+
+        bool useBlocks() const
+        {
+            return blockShape_.size() > 0;
+        }
+
+        template <int N>
+        TinyVector<MultiArrayIndex, N> getBlockShapeN() const
+        {
+            if(blockShape_.size() == 1)
+                return TinyVector<MultiArrayIndex, N>(blockShape_[0]);
+            vigra_precondition(blockShape_.size() == (std::size_t)N,
+                "FelzenszwalbOptions::getBlockShapeN(): dimension mismatch between N and stored block shape.");
+            return TinyVector<MultiArrayIndex, N>(blockShape_.begin());
+        }
+
+      private:
+        int nodeNumStopCond_;
+        ArrayVector<MultiArrayIndex> blockShape_;
+    };
+
+    namespace detail_graph_algorithms{
+
+    // Map a weight to an unsigned integer with the same ordering, 
+    // so that it can be used as radix sort key. Types without such a 
+    // mapping (e.g. long double, whose representation is not portable)
+    // have 'isValid' set to VigraFalseType and are sorted by comparison.
+    template<class T, 
+             bool IS_INTEGRAL = NumericTraits<T>::isIntegral::value && !std::is_floating_point<T>::value>
+    struct RadixSortKey
+    {
+        typedef VigraFalseType isValid;
+    };
+
+    template<class T>
+    struct RadixSortKey<T, true>
+    {
+        typedef VigraTrueType isValid;
+        typedef typename IfBool<(sizeof(T) <= 4), UInt32, UInt64>::type type;
+        typedef typename IfBool<(sizeof(T) <= 4), Int32, Int64>::type    signed_type;
+
+        static type get(T v)
+        {
+            if(NumericTraits<T>::isSigned::value)
+                return static_cast<type>(static_cast<signed_type>(v)) ^ (type(1) << (8*sizeof(type)-1));
+            else
+                return static_cast<type>(v);
+        }
+    };
+
+    // negative IEEE floats are ordered in reverse, so flip them
+    template<>
+    struct RadixSortKey<float, false>
+    {
+        typedef VigraTrueType isValid;
+        typedef UInt32 type;
+
+        static type get(float v)
+        {
+            type bits;
+            std::memcpy(&bits, &v, sizeof(bits));
+            return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+        }
+    };
+
+    template<>
+    struct RadixSortKey<double, false>
+    {
+        typedef VigraTrueType isValid;
+        typedef UInt64 type;
+
+        static type get(double v)
+        {
+            type bits;
+            std::memcpy(&bits, &v, sizeof(bits));
+            return (bits >> 63) ? ~bits : (bits | (type(1) << 63));
+        }
+    };
+
+    // Stable LSD radix sort of 'values' by 'keys' with 8-bit digits. Each pass 
+    // splits the data into one chunk per thread, counts the digits per chunk
+    // and scatters the chunks in parallel. Passes where all keys share the
+    // digit are skipped.
+    template<class KEY, class VALUE>
+    void radixSortByKey(std::vector<KEY> & keys, std::vector<VALUE> & values, ThreadPool & pool)
+    {
+        const std::size_t n = keys.size();
+        const std::size_t nChunks = std::max<std::size_t>(1, std::min<std::size_t>(pool.nThreads(), n / 4096));
+        const std::size_t chunkSize = (n + nChunks - 1) / nChunks;
+        std::vector<KEY>   tmpKeys(n);
+        std::vector<VALUE> tmpValues(n);
+        std::vector<std::size_t> offsets(nChunks*256);
+
+        for(unsigned int shift = 0; shift < 8*sizeof(KEY); shift += 8)
+        {
+            std::fill(offsets.begin(), offsets.end(), 0);
+            parallel_foreach(pool, nChunks,
+                [&](int, std::size_t c)
+                {
+                    std::size_t * count = &offsets[c*256];
+                    for(std::size_t i = c*chunkSize; i < std::min(n, (c+1)*chunkSize); ++i)
+                        ++count[(keys[i] >> shift) & 255];
+                });
+
+            bool trivial = false;
+            std::size_t sum = 0;
+            for(int d = 0; d < 256; ++d)
+            {
+                std::size_t total = 0;
+                for(std::size_t c = 0; c < nChunks; ++c)
+                {
+                    std::size_t count = offsets[c*256+d];
+                    offsets[c*256+d] = sum + total;
+                    total += count;
+                }
+                if(total == n)
+                    trivial = true;
+                sum += total;
+            }
+            if(trivial)
+                continue;
+
+            parallel_foreach(pool, nChunks,
+                [&](int, std::size_t c)
+                {
+                    std::size_t * offset = &offsets[c*256];
+                    for(std::size_t i = c*chunkSize; i < std::min(n, (c+1)*chunkSize); ++i)
+                    {
+                        std::size_t pos = offset[(keys[i] >> shift) & 255]++;
+                        tmpKeys[pos]   = keys[i];
+                        tmpValues[pos] = values[i];
+                    }
+                });
+            keys.swap(tmpKeys);
+            values.swap(tmpValues);
+        }
+    }
+
+    // edges as node id pairs with weights, in the order of processing
+    template<class WEIGHT_TYPE>
+    struct FelzenszwalbEdges
+    {
+        std::vector<Int64>       u, v;
+        std::vector<WEIGHT_TYPE> w;
+
+        std::size_t size() const
+        {
+            return w.size();
+        }
+
+        void push_back(Int64 uId, Int64 vId, WEIGHT_TYPE weight)
+        {
+            u.push_back(uId);
+            v.push_back(vId);
+            w.push_back(weight);
+        }
+
+        void append(FelzenszwalbEdges const & other)
+        {
+            u.insert(u.end(), other.u.begin(), other.u.end());
+            v.insert(v.end(), other.v.begin(), other.v.end());
+            w.insert(w.end(), other.w.begin(), other.w.end());
+        }
+
+        // sort by weight, equal weights keep their order
+        void sort(ThreadPool & pool)
+        {
+            const std::size_t n = size();
+            std::vector<std::size_t> order(n);
+            sortOrder(order, pool, typename RadixSortKey<WEIGHT_TYPE>::isValid());
+
+            FelzenszwalbEdges sorted;
+            sorted.u.resize(n);
+            sorted.v.resize(n);
+            sorted.w.resize(n);
+            parallel_foreach(pool, n,
+                [&](int, std::size_t i)
+                {
+                    sorted.u[i] = u[order[i]];
+                    sorted.v[i] = v[order[i]];
+                    sorted.w[i] = w[order[i]];
+                });
+            u.swap(sorted.u);
+            v.swap(sorted.v);
+            w.swap(sorted.w);
+        }
+
+      private:
+        void sortOrder(std::vector<std::size_t> & order, ThreadPool & pool, VigraTrueType)
+        {
+            typedef RadixSortKey<WEIGHT_TYPE> Key;
+            std::vector<typename Key::type> keys(order.size());
+            parallel_foreach(pool, order.size(),
+                [&](int, std::size_t i)
+                {
+                    keys[i]  = Key::get(w[i]);
+                    order[i] = i;
+                });
+            radixSortByKey(keys, order, pool);
+        }
+
+        void sortOrder(std::vector<std::size_t> & order, ThreadPool &, VigraFalseType)
+        {
+            for(std::size_t i = 0; i < order.size(); ++i)
+                order[i] = i;
+            std::stable_sort(order.begin(), order.end(),
+                [this](std::size_t a, std::size_t b)
+                {
+                    return w[a] < w[b];
+                });
+        }
+    };
+
+    // The union-find sweep of felzenszwalbSegmentation() over sorted edges. Only the
+    // entries of the edges' end nodes are accessed, so that sweeps over disjoint node
+    // sets can run in parallel. Returns the number of merges.
+    template<class WEIGHT_TYPE>
+    std::size_t felzenszwalbSweep(
+        FelzenszwalbEdges<WEIGHT_TYPE> const & edges,
+        float k,
+        UnionFindArray<UInt64> & ufdArray,
+        std::vector<WEIGHT_TYPE> & internalDiff,
+        std::vector<WEIGHT_TYPE> & nodeSizeAcc,
+        std::size_t nodeNum,
+        int nodeNumStopCond
+    ){
+        typedef WEIGHT_TYPE WeightType;
+        std::size_t merges = 0;
+        for(std::size_t i=0;i<edges.size();++i){
+            const std::size_t rui = ufdArray.findIndex(edges.u[i]);
+            const std::size_t rvi = ufdArray.findIndex(edges.v[i]);
+            if(rui!=rvi){
+                const WeightType   w         = edges.w[i];
+                const WeightType   sizeRu    = nodeSizeAcc[rui];
+                const WeightType   sizeRv    = nodeSizeAcc[rvi];
+                const WeightType tauRu       = static_cast<WeightType>(k)/static_cast<WeightType>(sizeRu);
+                const WeightType tauRv       = static_cast<WeightType>(k)/static_cast<WeightType>(sizeRv);
+                const WeightType minIntDiff  = std::min(internalDiff[rui]+tauRu,internalDiff[rvi]+tauRv);
+                if(w<=minIntDiff){
+                    ufdArray.makeUnion(rui,rvi);
+                    ++merges;
+                    const std::size_t newRepId = ufdArray.findIndex(rui);
+                    internalDiff[newRepId]=w;
+                    nodeSizeAcc[newRepId] = sizeRu+sizeRv;
+                }
+            }
+            if(nodeNumStopCond >= 0 && nodeNum-merges==static_cast<std::size_t>(nodeNumStopCond)){
+                break;
+            }
+        }
+        return merges;
+    }
+
+    template< class GRAPH , class EDGE_WEIGHTS, class NODE_SIZE>
+    void felzenszwalbInitialize(
+        const GRAPH &         graph,
+        const NODE_SIZE    &  nodeSizes,
+        std::vector<typename EDGE_WEIGHTS::Value> & internalDiff,
+        std::vector<typename EDGE_WEIGHTS::Value> & nodeSizeAcc
+    ){
+        typedef typename EDGE_WEIGHTS::Value WeightType;
+        internalDiff.assign(graph.maxNodeId()+1, static_cast<WeightType>(0.0));
+        nodeSizeAcc.assign(graph.maxNodeId()+1, WeightType());
+        for(typename GRAPH::NodeIt n(graph);n!=lemon::INVALID;++n)
+            nodeSizeAcc[graph.id(*n)] = nodeSizes[*n];
+    }
+
+    template< class GRAPH , class NODE_LABEL_MAP>
+    void felzenszwalbLabels(
+        const GRAPH &         graph,
+        UnionFindArray<UInt64> & ufdArray,
+        NODE_LABEL_MAP     &  nodeLabeling
+    ){
+        ufdArray.makeContiguous();
+        for(typename  GRAPH::NodeIt n(graph);n!=lemon::INVALID;++n){
+            nodeLabeling[*n]=ufdArray.findLabel(graph.id(*n));
+        }
+    }
+
+    // exact algorithm: the edges are collected and radix sorted in parallel,
+    // equal weights are ordered by edge ID
+    template< class GRAPH , class EDGE_WEIGHTS, class NODE_SIZE,class NODE_LABEL_MAP>
+    void felzenszwalbSegmentationExact(
+        const GRAPH &         graph,
+        const EDGE_WEIGHTS &  edgeWeights,
+        const NODE_SIZE    &  nodeSizes,
+        float                 k,
+        NODE_LABEL_MAP     &  nodeLabeling,
+        FelzenszwalbOptions const & options
+    ){
+        typedef typename GRAPH::Edge Edge;
+        typedef typename EDGE_WEIGHTS::Value WeightType;
+
+        ThreadPool pool(options);
+
+        const Int64 chunkSize = 1 << 16;
+        const Int64 nChunks = graph.maxEdgeId() / chunkSize + 1;
+        std::vector<FelzenszwalbEdges<WeightType> > chunks(nChunks);
+        parallel_foreach(pool, nChunks,
+            [&](int, Int64 c)
+            {
+                const Int64 end = std::min<Int64>((c+1)*chunkSize, graph.maxEdgeId()+1);
+                for(Int64 id = c*chunkSize; id < end; ++id)
+                {
+                    const Edge e(graph.edgeFromId(id));
+                    if(e == lemon::INVALID)
+                        continue;
+                    chunks[c].push_back(graph.id(graph.u(e)), graph.id(graph.v(e)), edgeWeights[e]);
+                }
+            });
+        FelzenszwalbEdges<WeightType> edges;
+        for(Int64 c = 0; c < nChunks; ++c)
+        {
+            edges.append(chunks[c]);
+            FelzenszwalbEdges<WeightType>().u.swap(chunks[c].u);
+            FelzenszwalbEdges<WeightType>().v.swap(chunks[c].v);
+            FelzenszwalbEdges<WeightType>().w.swap(chunks[c].w);
+        }
+        edges.sort(pool);
+
+        std::vector<WeightType> internalDiff, nodeSizeAcc;
+        felzenszwalbInitialize<GRAPH, EDGE_WEIGHTS>(graph, nodeSizes, internalDiff, nodeSizeAcc);
+        UnionFindArray<UInt64> ufdArray(graph.maxNodeId()+1);
+
+        const int nodeNumStopCond = options.getNodeNumStopCond();
+        std::size_t nodeNum = graph.nodeNum();
+        while(true){
+            nodeNum -= felzenszwalbSweep(edges, k, ufdArray, internalDiff, nodeSizeAcc, 
+                                         nodeNum, nodeNumStopCond);
+            if(nodeNumStopCond >= 0 && nodeNum>static_cast<std::size_t>(nodeNumStopCond))
+                k *= 1.2f;
+            else
+                break;
+        }
+        felzenszwalbLabels(graph, ufdArray, nodeLabeling);
+    }
+
+    } // namespace detail_graph_algorithms
+
+    /// \brief parallel Felzenszwalb segmentation
+    ///
+    /// Computes the same segmentation as the serial felzenszwalbSegmentation() above, 
+    /// but the edges are collected and sorted in parallel with a radix sort on the 
+    /// bit patterns of the weights (which is exact for integer and floating point 
+    /// weights, no quantization is involved). Edges with equal weights are processed
+    /// in the order of their IDs, so that the result does not depend on the number 
+    /// of threads. (The serial version uses <tt>std::sort</tt>, which may order equal
+    /// weights differently.)
+    ///
+    /// For \ref GridGraph, <tt>options.blockShape()</tt> selects a block-parallel 
+    /// approximation, see \ref FelzenszwalbOptions.
+    template< class GRAPH , class EDGE_WEIGHTS, class NODE_SIZE,class NODE_LABEL_MAP>
+    void felzenszwalbSegmentation(
+        const GRAPH &         graph,
+        const EDGE_WEIGHTS &  edgeWeights,
+        const NODE_SIZE    &  nodeSizes,
+        float                 k,
+        NODE_LABEL_MAP     &  nodeLabeling,
+        FelzenszwalbOptions const & options
+    ){
+        vigra_precondition(!options.useBlocks(),
+            "felzenszwalbSegmentation(): the block-parallel approximation requires a GridGraph.");
+        detail_graph_algorithms::felzenszwalbSegmentationExact(graph, edgeWeights, nodeSizes, 
+                                                               k, nodeLabeling, options);
+    }
+
+    template< unsigned int N, class EDGE_WEIGHTS, class NODE_SIZE,class NODE_LABEL_MAP>
+    void felzenszwalbSegmentation(
+        const GridGraph<N, boost_graph::undirected_tag> & graph,
+        const EDGE_WEIGHTS &  edgeWeights,
+        const NODE_SIZE    &  nodeSizes,
+        float                 k,
+        NODE_LABEL_MAP     &  nodeLabeling,
+        FelzenszwalbOptions const & options
+    ){
+        typedef GridGraph<N, boost_graph::undirected_tag> Graph;
+        typedef typename Graph::shape_type Shape;
+        typedef typename Graph::Edge Edge;
+        typedef typename Graph::OutArcIt OutArcIt;
+        typedef typename EDGE_WEIGHTS::Value WeightType;
+        typedef detail_graph_algorithms::FelzenszwalbEdges<WeightType> Edges;
+
+        if(!options.useBlocks())
+        {
+            detail_graph_algorithms::felzenszwalbSegmentationExact(graph, edgeWeights, nodeSizes, 
+                                                                   k, nodeLabeling, options);
+            return;
+        }
+        vigra_precondition(options.getNodeNumStopCond() < 0,
+            "felzenszwalbSegmentation(): nodeNumStopCond is not supported by the block-parallel approximation.");
+
+        ThreadPool pool(options);
+        const Shape blockShape = options.template getBlockShapeN<N>();
+        vigra_precondition(allGreater(blockShape, Shape(0)),
+            "felzenszwalbSegmentation(): block shape must be positive.");
+        const Shape blocks = (graph.shape() + blockShape - Shape(1)) / blockShape;
+
+        std::vector<WeightType> internalDiff, nodeSizeAcc;
+        detail_graph_algorithms::felzenszwalbInitialize<Graph, EDGE_WEIGHTS>(graph, nodeSizes, 
+                                                                            internalDiff, nodeSizeAcc);
+        UnionFindArray<UInt64> ufdArray(graph.maxNodeId()+1);
+
+        // segment the blocks independently, collect the edges between blocks
+        std::vector<Edges> borderEdges(prod(blocks));
+        parallel_foreach(pool, prod(blocks),
+            [&](int, MultiArrayIndex b)
+            {
+                Shape blockCoord;
+                detail::ScanOrderToCoordinate<N>::exec(b, blocks, blockCoord);
+                const Shape start = blockCoord * blockShape,
+                            stop  = min(start + blockShape, graph.shape());
+                Edges innerEdges;
+                MultiCoordinateIterator<N> p(stop - start),
+                                           end = p.getEndIterator();
+                for(; p != end; ++p)
+                {
+                    const Shape node = start + *p;
+                    const Int64 u = graph.id(node);
+                    for(OutArcIt a(graph, node); a != lemon::INVALID; ++a)
+                    {
+                        const Shape t(graph.target(*a));
+                        const Int64 v = graph.id(t);
+                        if(v < u)
+                            continue; // each edge is visited from both end nodes
+                        if(allLessEqual(start, t) && allLess(t, stop))
+                            innerEdges.push_back(u, v, edgeWeights[Edge(*a)]);
+                        else
+                            borderEdges[b].push_back(u, v, edgeWeights[Edge(*a)]);
+                    }
+                }
+                ThreadPool serial(ParallelOptions().numThreads(0));
+                innerEdges.sort(serial);
+                detail_graph_algorithms::felzenszwalbSweep(innerEdges, k, ufdArray, 
+                                                           internalDiff, nodeSizeAcc, 0, -1);
+            });
+
+        // reconcile the block borders
+        Edges edges;
+        for(std::size_t b = 0; b < borderEdges.size(); ++b)
+        {
+            edges.append(borderEdges[b]);
+            Edges().u.swap(borderEdges[b].u);
+            Edges().v.swap(borderEdges[b].v);
+            Edges().w.swap(borderEdges[b].w);
+        }
+        edges.sort(pool);
+        detail_graph_algorithms::felzenszwalbSweep(edges, k, ufdArray, internalDiff, nodeSizeAcc, 0, -1);
+        detail_graph_algorithms::felzenszwalbLabels(graph, ufdArray, nodeLabeling);
+    }
+
+
     namespace detail_graph_smoothing{
 
     template<
@@ -1426,6 +2793,131 @@ namespace vigra{
         }
     }
 
+    namespace detail_graph_algorithms{
+
+    template<class NODEMAP, class FUNCTOR>
+    struct EdgeWeightFromNodeWeights
+    {
+        typedef typename NODEMAP::value_type value_type;
+
+        EdgeWeightFromNodeWeights(const NODEMAP & nodeWeights, bool euclidean, FUNCTOR const & func)
+        : nodeWeights_(&nodeWeights),
+          euclidean_(euclidean),
+          func_(func)
+        {}
+
+        template<class COORD>
+        value_type operator()(COORD const & u, COORD const & v) const
+        {
+            if(euclidean_)
+                return static_cast<value_type>(norm(u-v) * func_((*nodeWeights_)[u], (*nodeWeights_)[v]));
+            else
+                return static_cast<value_type>(func_((*nodeWeights_)[u], (*nodeWeights_)[v]));
+        }
+
+        const NODEMAP * nodeWeights_;
+        bool euclidean_;
+        FUNCTOR func_;
+    };
+
+    // same as the functor expression Param(0.5)*(Arg1()+Arg2())
+    struct NodeWeightsMean
+    {
+        template<class T>
+        double operator()(T const & a, T const & b) const
+        {
+            return 0.5*(a+b);
+        }
+    };
+
+    template<unsigned int N, class T>
+    struct EdgeWeightFromInterpolatedImage
+    {
+        EdgeWeightFromInterpolatedImage(const MultiArrayView<N, T> & interpolatedImage, bool euclidean)
+        : interpolatedImage_(interpolatedImage),
+          euclidean_(euclidean)
+        {}
+
+        template<class COORD>
+        T operator()(COORD const & u, COORD const & v) const
+        {
+            if(euclidean_)
+                return static_cast<T>(norm(u-v) * interpolatedImage_[u+v]);
+            else
+                return interpolatedImage_[u+v];
+        }
+
+        MultiArrayView<N, T> interpolatedImage_;
+        bool euclidean_;
+    };
+
+    } // namespace detail_graph_algorithms
+
+    /// \brief create implicit edge weights from node weights
+    ///
+    /// Same as \ref edgeWeightsFromNodeWeights(), but instead of filling an edge map,
+    /// this returns an \ref ImplicitEdgeMap that computes each weight on access. 
+    /// No memory is allocated per edge, which saves <tt>N*sizeof(T)</tt> bytes per
+    /// voxel for an indirect neighborhood. The result can be passed to all algorithms
+    /// that read edge weights, e.g. \ref ShortestPathDijkstra, \ref edgeWeightedWatershedsSegmentation(),
+    /// \ref felzenszwalbSegmentation() and \ref ragEdgeFeatures(). Its value type is the value 
+    /// type of \a nodeWeights, and \a nodeWeights must outlive it.
+    ///
+    /// \code
+    /// GridGraph<3> g(volume.shape(), IndirectNeighborhood);
+    /// auto weights = implicitEdgeWeightsFromNodeWeights(g, volume, true);
+    /// ShortestPathDijkstra<GridGraph<3>, float> pathFinder(g);
+    /// pathFinder.run(weights, source);
+    /// \endcode
+    template<unsigned int N, class DirectedTag,
+             class NODEMAP, class FUNCTOR>
+    inline ImplicitEdgeMap<GridGraph<N, DirectedTag>,
+                           detail_graph_algorithms::EdgeWeightFromNodeWeights<NODEMAP, FUNCTOR> >
+    implicitEdgeWeightsFromNodeWeights(
+            const GridGraph<N, DirectedTag> & g,
+            const NODEMAP  & nodeWeights,
+            bool euclidean,
+            FUNCTOR const & func)
+    {
+        vigra_precondition(nodeWeights.shape() == g.shape(), 
+             "implicitEdgeWeightsFromNodeWeights(): shape mismatch between graph and nodeWeights.");
+        typedef detail_graph_algorithms::EdgeWeightFromNodeWeights<NODEMAP, FUNCTOR> Functor;
+        return ImplicitEdgeMap<GridGraph<N, DirectedTag>, Functor>(g, Functor(nodeWeights, euclidean, func));
+    }
+
+    template<unsigned int N, class DirectedTag,
+             class NODEMAP>
+    inline ImplicitEdgeMap<GridGraph<N, DirectedTag>,
+                           detail_graph_algorithms::EdgeWeightFromNodeWeights<NODEMAP, 
+                               detail_graph_algorithms::NodeWeightsMean> >
+    implicitEdgeWeightsFromNodeWeights(
+            const GridGraph<N, DirectedTag> & g,
+            const NODEMAP  & nodeWeights,
+            bool euclidean=false)
+    {
+        return implicitEdgeWeightsFromNodeWeights(g, nodeWeights, euclidean, 
+                                                  detail_graph_algorithms::NodeWeightsMean());
+    }
+
+    /// \brief create implicit edge weights from an interpolated image
+    ///
+    /// Same as \ref edgeWeightsFromInterpolatedImage(), but returns an \ref ImplicitEdgeMap
+    /// that reads <tt>interpolatedImage[u+v]</tt> on access instead of filling an edge map.
+    template<unsigned int N, class DirectedTag, class T>
+    inline ImplicitEdgeMap<GridGraph<N, DirectedTag>,
+                           detail_graph_algorithms::EdgeWeightFromInterpolatedImage<N, T> >
+    implicitEdgeWeightsFromInterpolatedImage(
+            const GridGraph<N, DirectedTag> & g,
+            const MultiArrayView<N, T>  & interpolatedImage,
+            bool euclidean = false)
+    {
+        typedef typename MultiArrayShape<N>::type CoordType;
+        vigra_precondition(interpolatedImage.shape() == 2*g.shape()-CoordType(1), 
+             "implicitEdgeWeightsFromInterpolatedImage(): interpolated shape must be shape*2-1");
+        typedef detail_graph_algorithms::EdgeWeightFromInterpolatedImage<N, T> Functor;
+        return ImplicitEdgeMap<GridGraph<N, DirectedTag>, Functor>(g, Functor(interpolatedImage, euclidean));
+    }
+
     template<class GRAPH>
     struct ThreeCycle{
 
@@ -37,6 +37,10 @@
 #ifndef VIGRA_GRAPH_MAPS
 #define VIGRA_GRAPH_MAPS
 
+/*std*/
+#include <type_traits>
+#include <utility>
+
 /*vigra*/
 #include "multi_array.hxx"
 #include "graph_generalization.hxx"
@@ -318,6 +322,64 @@ private:
 };
 
 
+// implicit edge map:
+// the value of an edge is computed on access by
+// calling FUNCTOR with the edge's end nodes, i.e.
+// map[edge] == f(graph.u(edge), graph.v(edge)).
+// Nothing is stored per edge, so this can replace
+// an explicit EdgeMap in all algorithms that only
+// read weights[edge]. The functor usually holds
+// references to node maps, which must outlive the
+// edge map.
+template<class G,class FUNCTOR>
+class ImplicitEdgeMap{
+
+public:
+    typedef G  Graph;
+    typedef typename Graph::Node Node;
+    typedef typename Graph::Edge Key;
+    typedef typename std::decay<
+                decltype(std::declval<FUNCTOR const &>()(std::declval<Node>(), std::declval<Node>()))
+            >::type  Value;
+    typedef Value    Reference;
+    typedef Value    ConstReference;
+
+    typedef Key             key_type;
+    typedef Value           value_type;
+    typedef ConstReference  const_reference;
+
+    typedef boost_graph::readable_property_map_tag category;
+
+    ImplicitEdgeMap(const Graph & graph,const FUNCTOR & f)
+    :   graph_(&graph),
+        f_(f){
+    }
+
+    ConstReference operator[](const Key & key)const{
+        return f_(graph_->u(key),graph_->v(key));
+    }
+
+    const Graph & graph()const{
+        return *graph_;
+    }
+
+    const FUNCTOR & functor()const{
+        return f_;
+    }
+private:
+
+    const Graph * graph_;
+    FUNCTOR  f_;
+};
+
+// create an ImplicitEdgeMap, e.g. from a lambda
+template<class G,class FUNCTOR>
+inline ImplicitEdgeMap<G,FUNCTOR>
+makeImplicitEdgeMap(const G & graph,const FUNCTOR & f){
+    return ImplicitEdgeMap<G,FUNCTOR>(graph,f);
+}
+
+
 // convert 2 edge maps with a functor into a single edge map
 template<class G,class EDGE_MAP_A,class EDGE_MAP_B,class FUNCTOR,class RESULT>
 class BinaryOpEdgeMap{
@@ -293,6 +293,39 @@ struct GraphItemHelper<GRAPH,typename GRAPH::Arc>{
     }
 };
 
+    /** \brief Visit the outgoing arcs of a node.
+
+        Calls <tt>f(target, targetId, edge)</tt> for every out-arc of \a node. Algorithms 
+        use this instead of <tt>OutArcIt</tt> in their inner loops, so that graphs can
+        provide faster traversal by specialization (see \ref GridGraph).
+    */
+template<class GRAPH>
+class OutArcVisitor
+{
+  public:
+    typedef typename GRAPH::index_type index_type;
+    typedef typename GRAPH::Node       Node;
+    typedef typename GRAPH::Edge       Edge;
+    typedef typename GRAPH::OutArcIt   OutArcIt;
+
+    explicit OutArcVisitor(const GRAPH & g)
+    : graph_(g)
+    {}
+
+    template<class FUNCTOR>
+    void operator()(const Node & node, index_type, FUNCTOR && f) const
+    {
+        for(OutArcIt a(graph_, node); a != lemon::INVALID; ++a)
+        {
+            const Node target(graph_.target(*a));
+            f(target, graph_.id(target), Edge(*a));
+        }
+    }
+
+  private:
+    const GRAPH & graph_;
+};
+
 
 
 
@@ -43,11 +43,16 @@
 /*std*/
 #include <queue>
 #include <iomanip>
+#include <vector>
+#include <iterator>
+#include <type_traits>
 
 /*vigra*/
 #include "priority_queue.hxx"
 #include "metrics.hxx"
 #include "merge_graph_adaptor.hxx"
+#include "multi_array.hxx"
+#include "threadpool.hxx"
 
 namespace vigra{
 
@@ -1043,6 +1048,739 @@ hierarchicalClustering(GRAPH const & graph,
     }
 }
 
+namespace detail_hierarchical_clustering {
+
+template <class FEATURE>
+inline MultiArrayIndex
+featureSize(FEATURE const &, VigraTrueType /* scalar */)
+{
+    return 1;
+}
+
+template <class FEATURE>
+inline MultiArrayIndex
+featureSize(FEATURE const & f, VigraFalseType /* vector */)
+{
+    return std::distance(f.begin(), f.end());
+}
+
+template <class FEATURE, class ITER>
+inline void
+copyFeature(FEATURE const & f, ITER d, VigraTrueType /* scalar */)
+{
+    *d = f;
+}
+
+template <class FEATURE, class ITER>
+inline void
+copyFeature(FEATURE const & f, ITER d, VigraFalseType /* vector */)
+{
+    std::copy(f.begin(), f.end(), d);
+}
+
+    // entry of the lazy priority queue: an entry is stale when the 
+    // edge is no longer active or was re-queued with a newer version
+template <class T>
+struct LazyQueueEntry
+{
+    T      weight;
+    Int64  edge;
+    UInt32 version;
+
+    bool operator>(LazyQueueEntry const & other) const
+    {
+        return weight > other.weight || 
+               (weight == other.weight && edge > other.edge);
+    }
+};
+
+} // namespace detail_hierarchical_clustering
+
+/** \brief Hierarchical clustering engine with lazy priority updates.
+
+    <b>\#include</b> \<vigra/hierarchical_clustering.hxx\><br/>
+    Namespace: vigra
+
+    Computes the same cluster distances and merge rules as \ref hierarchicalClustering(),
+    but without \ref MergeGraphAdaptor and cluster operator callbacks: 
+    node sizes, node features, edge weights and edge lengths are copied into flat
+    arrays indexed by node and edge ID, clusters are tracked by a union-find forest,
+    and each cluster keeps a plain list of incident edge IDs that is only cleaned 
+    up when the cluster participates in a merge. The priority queue is never updated
+    in place. Instead, every weight change pushes a new entry stamped with the 
+    edge's version number, and outdated entries are discarded when they reach the top.
+
+    When node features and node sizes are ignored (<tt>nodeFeatureImportance(0.0)</tt> and
+    <tt>sizeImportance(0.0)</tt>), the cluster distance is just the length-weighted 
+    mean edge weight. Then, only edges whose weight actually changed in a merge 
+    (i.e. parallel edges that were combined) are re-queued, instead of all 
+    edges incident to the merged cluster.
+
+    Ties between equal cluster distances may be broken differently than in
+    \ref hierarchicalClustering(), and the representative of each cluster 
+    is chosen differently, so that the resulting labels agree up to renaming.
+
+    Usage:
+    \code
+    FastHierarchicalClustering<AdjacencyListGraph> clustering(rag, 
+                                       ClusteringOptions().minRegionCount(20));
+    clustering.cluster(edgeWeights, edgeLengths, nodeFeatures, nodeSizes);
+
+    for(AdjacencyListGraph::NodeIt node(rag); node != lemon::INVALID; ++node)
+        labels[*node] = clustering.reprNodeId(rag.id(*node));
+    \endcode
+*/
+template <class GRAPH, class T = float>
+class FastHierarchicalClustering
+{
+  public:
+    typedef GRAPH                                   Graph;
+    typedef typename Graph::Node                    Node;
+    typedef typename Graph::Edge                    Edge;
+    typedef T                                       ValueType;
+    typedef Int64                                   index_type;
+
+    /// \brief construct clustering of \a graph with the given options
+    FastHierarchicalClustering(Graph const & graph,
+                               ClusteringOptions const & options = ClusteringOptions())
+    : graph_(graph),
+      options_(options),
+      metric_(options.nodeFeatureMetric_),
+      nodeNum_(0)
+    {}
+
+    /// \brief run the clustering 
+    template <class EDGE_WEIGHT_MAP,  class EDGE_LENGTH_MAP,
+              class NODE_FEATURE_MAP, class NODE_SIZE_MAP>
+    void cluster(EDGE_WEIGHT_MAP const & edgeWeights, EDGE_LENGTH_MAP const & edgeLengths,
+                 NODE_FEATURE_MAP const & nodeFeatures, NODE_SIZE_MAP const & nodeSizes)
+    {
+        initialize(edgeWeights, edgeLengths, nodeFeatures, nodeSizes);
+        clusterSerial();
+    }
+
+    /** \brief run the clustering in parallel rounds
+
+        In every round, all edges which are the cheapest edge of both their end nodes
+        (ties are broken by edge ID) are contracted concurrently, and the affected 
+        edges are updated concurrently afterwards. Contractions within a round
+        are independent, because every cluster takes part in at most one of them.
+
+        When node features and sizes are ignored (mean edge weight policy), 
+        the cluster distance is reducible, i.e. a merge never creates a cheaper 
+        edge, so that the resulting hierarchy is the same as the serial one. 
+        In order to also stop at exactly the same clustering when 
+        <tt>minRegionCount()</tt> is given, the rounds then continue until 
+        <tt>maxMergeDistance()</tt> is reached, and the merges are replayed in 
+        order of increasing distance up to the requested cluster count. 
+        In this case, \ref ucmTransform() reports the distances of all merges.
+        For other policies, rounds stop at the requested cluster count (dropping 
+        the most expensive contractions of the last round), and the result 
+        approximates the serial one.
+    */
+    template <class EDGE_WEIGHT_MAP,  class EDGE_LENGTH_MAP,
+              class NODE_FEATURE_MAP, class NODE_SIZE_MAP>
+    void cluster(EDGE_WEIGHT_MAP const & edgeWeights, EDGE_LENGTH_MAP const & edgeLengths,
+                 NODE_FEATURE_MAP const & nodeFeatures, NODE_SIZE_MAP const & nodeSizes,
+                 ParallelOptions const & parallelOptions)
+    {
+        initialize(edgeWeights, edgeLengths, nodeFeatures, nodeSizes);
+        clusterParallel(parallelOptions);
+    }
+
+    /// \brief get the representative node id of the cluster containing node \a id
+    index_type reprNodeId(index_type id) const
+    {
+        while(nodeParent_[id] != id)
+            id = nodeParent_[id];
+        return id;
+    }
+
+    /// \brief number of clusters
+    index_type nodeNum() const
+    {
+        return nodeNum_;
+    }
+
+    /** \brief get the ultrametric contour map
+
+        Every edge of the graph receives the cluster distance at which its end nodes
+        were merged, or the current cluster distance of the corresponding cluster 
+        boundary if they were not merged.
+    */
+    template <class EDGE_MAP>
+    void ucmTransform(EDGE_MAP & edgeMap) const
+    {
+        for(typename Graph::EdgeIt iter(graph_); iter != lemon::INVALID; ++iter)
+        {
+            index_type edge = graph_.id(*iter);
+            while(edgeState_[edge] == MergedEdge)
+                edge = edgeParent_[edge];
+            edgeMap[*iter] = edgeState_[edge] == ContractedEdge
+                                 ? edgeMergeWeight_[edge]
+                                 : edgeCost(edge);
+        }
+    }
+
+    /// \brief get the graph
+    Graph const & graph() const
+    {
+        return graph_;
+    }
+
+  private:
+    enum EdgeState { MissingEdge, ActiveEdge, MergedEdge, ContractedEdge };
+
+    typedef detail_hierarchical_clustering::LazyQueueEntry<ValueType> QueueEntry;
+    typedef std::priority_queue<QueueEntry, std::vector<QueueEntry>, 
+                                std::greater<QueueEntry> >  Queue;
+
+    index_type findNode(index_type id)
+    {
+        while(nodeParent_[id] != id)
+        {
+            nodeParent_[id] = nodeParent_[nodeParent_[id]];
+            id = nodeParent_[id];
+        }
+        return id;
+    }
+
+    index_type oppositeNode(index_type edge, index_type node)
+    {
+        index_type u = findNode(edgeU_[edge]);
+        return u == node ? findNode(edgeV_[edge]) : u;
+    }
+
+    bool meanPolicy() const
+    {
+        return options_.nodeFeatureImportance_ == 0.0 && options_.sizeImportance_ == 0.0;
+    }
+
+        // same formula as cluster_operators::EdgeWeightNodeFeatures
+    ValueType edgeCost(index_type edge) const
+    {
+        if(meanPolicy())
+            return edgeWeight_[edge];
+        const index_type u = reprNodeId(edgeU_[edge]),
+                         v = reprNodeId(edgeV_[edge]);
+        const ValueType beta = options_.nodeFeatureImportance_;
+        const ValueType wardFac = 2.0 / (nodeWardTerm_[u] + nodeWardTerm_[v]);
+        const ValueType fromNodeDist = beta == 0.0
+                                          ? ValueType()
+                                          : metric_(nodeFeatures_.bindOuter(u), nodeFeatures_.bindOuter(v));
+        return ((1.0-beta)*edgeWeight_[edge] + beta*fromNodeDist)*wardFac;
+    }
+
+    void updateWardTerm(index_type node)
+    {
+        const ValueType wardness = options_.sizeImportance_;
+        const float size = nodeSize_[node];
+        nodeWardTerm_[node] = 1.0/std::pow(size,wardness);
+    }
+
+    void push(index_type edge)
+    {
+        QueueEntry entry = { edgeCost(edge), edge, ++edgeVersion_[edge] };
+        queue_.push(entry);
+    }
+
+    struct BatchItem
+    {
+        index_type edge, u, v;
+    };
+
+    template <class EDGE_WEIGHT_MAP,  class EDGE_LENGTH_MAP,
+              class NODE_FEATURE_MAP, class NODE_SIZE_MAP>
+    void initialize(EDGE_WEIGHT_MAP const & edgeWeights, EDGE_LENGTH_MAP const & edgeLengths,
+                    NODE_FEATURE_MAP const & nodeFeatures, NODE_SIZE_MAP const & nodeSizes);
+
+    void clusterSerial();
+
+    void clusterParallel(ParallelOptions const & parallelOptions);
+
+    void contractEdge(index_type edge, ValueType weight);
+
+    void mergeNodes(index_type u, index_type v)
+    {
+        MultiArrayView<1, float> featuresU = nodeFeatures_.bindOuter(u),
+                                 featuresV = nodeFeatures_.bindOuter(v);
+        featuresU *= nodeSize_[u];
+        featuresV *= nodeSize_[v];
+        featuresU += featuresV;
+        nodeSize_[u] += nodeSize_[v];
+        featuresU /= nodeSize_[u];
+        featuresV /= nodeSize_[v];
+        updateWardTerm(u);
+    }
+
+        // same update as cluster_operators::EdgeWeightNodeFeatures::mergeEdges()
+    void mergeEdges(index_type f, index_type e)
+    {
+        ValueType wf = edgeWeight_[f], we = edgeWeight_[e];
+        wf *= edgeLength_[f];
+        we *= edgeLength_[e];
+        wf += we;
+        edgeLength_[f] += edgeLength_[e];
+        wf /= edgeLength_[f];
+        edgeWeight_[f] = wf;
+        edgeState_[e] = MergedEdge;
+        edgeParent_[e] = f;
+    }
+
+    Graph const &              graph_;
+    ClusteringOptions          options_;
+    metrics::Metric<float>     metric_;
+
+    index_type                 nodeNum_;
+    std::vector<index_type>    nodeParent_;
+    std::vector<ValueType>     nodeSize_;
+    std::vector<double>        nodeWardTerm_;
+    MultiArray<2, float>       nodeFeatures_;
+    std::vector<std::vector<index_type> > incidentEdges_;
+
+    std::vector<index_type>    edgeU_, edgeV_, edgeParent_;
+    std::vector<ValueType>     edgeWeight_, edgeLength_, edgeMergeWeight_;
+    std::vector<UInt32>        edgeVersion_;
+    std::vector<unsigned char> edgeState_;
+
+    Queue                      queue_;
+    std::vector<index_type>    neighborEdge_, changedEdges_;
+
+    // state of the parallel rounds
+    std::vector<ValueType>     edgeCost_;
+    std::vector<index_type>    nodeMinEdge_;
+    std::vector<unsigned char> roundMerged_;
+};
+
+template <class GRAPH, class T>
+template <class EDGE_WEIGHT_MAP,  class EDGE_LENGTH_MAP,
+          class NODE_FEATURE_MAP, class NODE_SIZE_MAP>
+void 
+FastHierarchicalClustering<GRAPH, T>::initialize(
+    EDGE_WEIGHT_MAP const & edgeWeights, EDGE_LENGTH_MAP const & edgeLengths,
+    NODE_FEATURE_MAP const & nodeFeatures, NODE_SIZE_MAP const & nodeSizes)
+{
+    typedef typename NODE_FEATURE_MAP::Value FeatureType;
+    typedef typename IfBool<std::is_arithmetic<FeatureType>::value, 
+                            VigraTrueType, VigraFalseType>::type IsScalar;
+
+    const index_type maxNodeId = graph_.maxNodeId(),
+                     maxEdgeId = graph_.maxEdgeId();
+
+    // copy node properties into flat arrays
+    typename Graph::NodeIt firstNode(graph_);
+    const MultiArrayIndex featureSize = firstNode != lemon::INVALID
+            ? detail_hierarchical_clustering::featureSize(nodeFeatures[*firstNode], IsScalar())
+            : 1;
+    nodeNum_ = 0;
+    nodeParent_.resize(maxNodeId+1);
+    nodeSize_.assign(maxNodeId+1, ValueType());
+    nodeWardTerm_.assign(maxNodeId+1, 1.0);
+    nodeFeatures_.reshape(Shape2(featureSize, maxNodeId+1));
+    std::vector<std::vector<index_type> >(maxNodeId+1).swap(incidentEdges_);
+    neighborEdge_.assign(maxNodeId+1, -1);
+    for(index_type k = 0; k <= maxNodeId; ++k)
+        nodeParent_[k] = k;
+    for(typename Graph::NodeIt node(graph_); node != lemon::INVALID; ++node)
+    {
+        const index_type id = graph_.id(*node);
+        nodeSize_[id] = nodeSizes[*node];
+        updateWardTerm(id);
+        detail_hierarchical_clustering::copyFeature(nodeFeatures[*node], 
+                                                    nodeFeatures_.bindOuter(id).begin(), IsScalar());
+        incidentEdges_[id].reserve(graph_.degree(*node));
+        ++nodeNum_;
+    }
+
+    // copy edge properties into flat arrays
+    edgeU_.assign(maxEdgeId+1, -1);
+    edgeV_.assign(maxEdgeId+1, -1);
+    edgeParent_.assign(maxEdgeId+1, -1);
+    edgeWeight_.assign(maxEdgeId+1, ValueType());
+    edgeLength_.assign(maxEdgeId+1, ValueType());
+    edgeMergeWeight_.assign(maxEdgeId+1, ValueType());
+    edgeVersion_.assign(maxEdgeId+1, 0);
+    edgeState_.assign(maxEdgeId+1, MissingEdge);
+    for(typename Graph::EdgeIt edge(graph_); edge != lemon::INVALID; ++edge)
+    {
+        const index_type id = graph_.id(*edge);
+        edgeU_[id] = graph_.id(graph_.u(*edge));
+        edgeV_[id] = graph_.id(graph_.v(*edge));
+        edgeParent_[id] = id;
+        edgeWeight_[id] = edgeWeights[*edge];
+        edgeLength_[id] = edgeLengths[*edge];
+        edgeState_[id] = ActiveEdge;
+        incidentEdges_[edgeU_[id]].push_back(id);
+        incidentEdges_[edgeV_[id]].push_back(id);
+    }
+}
+
+template <class GRAPH, class T>
+void 
+FastHierarchicalClustering<GRAPH, T>::clusterSerial()
+{
+    const index_type maxEdgeId = graph_.maxEdgeId();
+    std::vector<QueueEntry> entries;
+    entries.reserve(graph_.edgeNum());
+    for(index_type id = 0; id <= maxEdgeId; ++id)
+    {
+        if(edgeState_[id] != ActiveEdge)
+            continue;
+        QueueEntry entry = { edgeCost(id), id, edgeVersion_[id] };
+        entries.push_back(entry);
+    }
+    queue_ = Queue(std::greater<QueueEntry>(), std::move(entries));
+
+    while(nodeNum_ > (index_type)options_.nodeNumStopCond_ && !queue_.empty())
+    {
+        const QueueEntry top = queue_.top();
+        if(edgeState_[top.edge] != ActiveEdge || edgeVersion_[top.edge] != top.version)
+        {
+            queue_.pop();   // stale entry
+            continue;
+        }
+        if(top.weight >= options_.maxMergeWeight_)
+            break;
+        queue_.pop();
+        contractEdge(top.edge, top.weight);
+        if(options_.verbose_)
+            std::cout<<"\rNodes: "<<std::setw(10)<<nodeNum_<<std::flush;
+    }
+    if(options_.verbose_)
+        std::cout<<"\n";
+}
+
+template <class GRAPH, class T>
+void 
+FastHierarchicalClustering<GRAPH, T>::contractEdge(index_type edge, ValueType weight)
+{
+    index_type u = findNode(edgeU_[edge]),
+               v = findNode(edgeV_[edge]);
+    edgeState_[edge] = ContractedEdge;
+    edgeMergeWeight_[edge] = weight;
+
+    // the node with more incident edges survives
+    if(incidentEdges_[u].size() < incidentEdges_[v].size())
+        std::swap(u, v);
+    nodeParent_[v] = u;
+    --nodeNum_;
+
+    mergeNodes(u, v);
+
+    // merge incident edge lists: drop stale entries and combine parallel edges
+    std::vector<index_type> & edgesU = incidentEdges_[u],
+                            & edgesV = incidentEdges_[v];
+    std::size_t k = 0;
+    for(std::size_t i = 0; i < edgesU.size(); ++i)
+    {
+        const index_type e = edgesU[i];
+        if(edgeState_[e] != ActiveEdge)
+            continue;
+        neighborEdge_[oppositeNode(e, u)] = e;
+        edgesU[k++] = e;
+    }
+    edgesU.resize(k);
+    changedEdges_.clear();
+    for(std::size_t i = 0; i < edgesV.size(); ++i)
+    {
+        const index_type e = edgesV[i];
+        if(edgeState_[e] != ActiveEdge)
+            continue;
+        const index_type y = oppositeNode(e, u),
+                         f = neighborEdge_[y];
+        if(f == -1)
+        {
+            neighborEdge_[y] = e;
+            edgesU.push_back(e);
+            continue;
+        }
+        mergeEdges(f, e);
+        changedEdges_.push_back(f);
+    }
+    std::vector<index_type>().swap(edgesV);
+
+    for(std::size_t i = 0; i < edgesU.size(); ++i)
+        neighborEdge_[oppositeNode(edgesU[i], u)] = -1;
+
+    // re-queue edges whose cluster distance changed
+    if(meanPolicy())
+    {
+        for(std::size_t i = 0; i < changedEdges_.size(); ++i)
+            push(changedEdges_[i]);
+    }
+    else
+    {
+        for(std::size_t i = 0; i < edgesU.size(); ++i)
+            push(edgesU[i]);
+    }
+}
+
+template <class GRAPH, class T>
+void 
+FastHierarchicalClustering<GRAPH, T>::clusterParallel(ParallelOptions const & parallelOptions)
+{
+    typedef std::pair<index_type, index_type> NeighborEdge;
+
+    ThreadPool pool(parallelOptions);
+    const size_t nThreads = std::max<size_t>(pool.nThreads(), 1);
+
+    const index_type maxNodeId = graph_.maxNodeId(),
+                     maxEdgeId = graph_.maxEdgeId(),
+                     stopCount = (index_type)options_.nodeNumStopCond_;
+    // with a reducible distance, merges can be replayed to stop exactly at stopCount
+    const bool replay = meanPolicy();
+
+    edgeCost_.resize(maxEdgeId+1);
+    parallel_foreach(pool, maxEdgeId+1,
+        [&](int, index_type e){
+            if(edgeState_[e] == ActiveEdge)
+                edgeCost_[e] = edgeCost(e);
+        });
+    nodeMinEdge_.assign(maxNodeId+1, -1);
+    roundMerged_.assign(maxNodeId+1, 0);
+
+    std::vector<index_type> activeNodes;
+    activeNodes.reserve(nodeNum_);
+    for(typename Graph::NodeIt node(graph_); node != lemon::INVALID; ++node)
+        activeNodes.push_back(graph_.id(*node));
+
+    std::vector<BatchItem> batch, merges;
+    std::vector<std::vector<BatchItem> >    threadBatch(nThreads);
+    std::vector<std::vector<NeighborEdge> > threadNeighbors(nThreads);
+    // parallel edges to be combined, stored as <group size, edge, edge, ...>
+    std::vector<std::vector<index_type> >   threadGroups(nThreads);
+    std::vector<index_type>                 groupStarts;
+
+    auto oppositeNode = [this](index_type edge, index_type node)
+    {
+        const index_type u = reprNodeId(edgeU_[edge]);
+        return u == node ? reprNodeId(edgeV_[edge]) : u;
+    };
+    auto cheaper = [this](index_type e, index_type f)
+    {
+        return edgeCost_[e] < edgeCost_[f] || (edgeCost_[e] == edgeCost_[f] && e < f);
+    };
+
+    while(replay || nodeNum_ > stopCount)
+    {
+        // find the cheapest edge of every cluster and drop stale entries from the edge lists
+        parallel_foreach(pool, activeNodes.size(),
+            [&](int, index_type k){
+                const index_type node = activeNodes[k];
+                std::vector<index_type> & edges = incidentEdges_[node];
+                index_type best = -1;
+                std::size_t j = 0;
+                for(std::size_t i = 0; i < edges.size(); ++i)
+                {
+                    const index_type e = edges[i];
+                    if(edgeState_[e] != ActiveEdge)
+                        continue;
+                    edges[j++] = e;
+                    if(best == -1 || cheaper(e, best))
+                        best = e;
+                }
+                edges.resize(j);
+                nodeMinEdge_[node] = best;
+            });
+
+        // select the edges which are the cheapest edge of both their end nodes
+        parallel_foreach(pool, activeNodes.size(),
+            [&](int threadId, index_type k){
+                const index_type u = activeNodes[k],
+                                 e = nodeMinEdge_[u];
+                if(e == -1 || edgeCost_[e] >= options_.maxMergeWeight_)
+                    return;
+                const index_type v = oppositeNode(e, u);
+                if(u < v && nodeMinEdge_[v] == e)
+                {
+                    const BatchItem item = { e, u, v };
+                    threadBatch[threadId].push_back(item);
+                }
+            });
+        batch.clear();
+        for(size_t t = 0; t < nThreads; ++t)
+        {
+            batch.insert(batch.end(), threadBatch[t].begin(), threadBatch[t].end());
+            threadBatch[t].clear();
+        }
+        if(batch.empty())
+            break;
+        if(!replay && nodeNum_ - (index_type)batch.size() < stopCount)
+        {
+            std::sort(batch.begin(), batch.end(), 
+                [&](BatchItem const & a, BatchItem const & b){ return cheaper(a.edge, b.edge); });
+            batch.resize(nodeNum_ - stopCount);
+        }
+
+        // contract the selected edges, the node with more incident edges survives
+        parallel_foreach(pool, batch.size(),
+            [&](int, index_type k){
+                BatchItem & item = batch[k];
+                edgeState_[item.edge] = ContractedEdge;
+                edgeMergeWeight_[item.edge] = edgeCost_[item.edge];
+                if(incidentEdges_[item.u].size() < incidentEdges_[item.v].size())
+                    std::swap(item.u, item.v);
+                nodeParent_[item.v] = item.u;
+                roundMerged_[item.u] = 1;
+                mergeNodes(item.u, item.v);
+            });
+        nodeNum_ -= batch.size();
+        if(replay)
+            merges.insert(merges.end(), batch.begin(), batch.end());
+
+        // merge the edge lists and find parallel edges; edges between two merged
+        // clusters are combined by the cluster with smaller id
+        parallel_foreach(pool, batch.size(),
+            [&](int threadId, index_type k){
+                const index_type u = batch[k].u,
+                                 v = batch[k].v;
+                std::vector<NeighborEdge> & neighbors = threadNeighbors[threadId];
+                std::vector<index_type> & groups = threadGroups[threadId];
+                neighbors.clear();
+                for(int n = 0; n < 2; ++n)
+                {
+                    std::vector<index_type> const & edges = incidentEdges_[n == 0 ? u : v];
+                    for(std::size_t i = 0; i < edges.size(); ++i)
+                        if(edgeState_[edges[i]] == ActiveEdge)
+                            neighbors.push_back(NeighborEdge(oppositeNode(edges[i], u), edges[i]));
+                }
+                std::vector<index_type>().swap(incidentEdges_[v]);
+                std::sort(neighbors.begin(), neighbors.end());
+
+                std::vector<index_type> & edges = incidentEdges_[u];
+                edges.clear();
+                for(std::size_t i = 0; i < neighbors.size();)
+                {
+                    std::size_t j = i + 1;
+                    while(j < neighbors.size() && neighbors[j].first == neighbors[i].first)
+                        ++j;
+                    edges.push_back(neighbors[i].second);
+                    if(j - i > 1 && (roundMerged_[neighbors[i].first] == 0 || u < neighbors[i].first))
+                    {
+                        groups.push_back(j - i);
+                        for(std::size_t g = i; g < j; ++g)
+                            groups.push_back(neighbors[g].second);
+                    }
+                    i = j;
+                }
+            });
+
+        // combine parallel edges
+        groupStarts.clear();
+        for(size_t t = 0; t < nThreads; ++t)
+            for(std::size_t i = 0; i < threadGroups[t].size(); i += threadGroups[t][i] + 1)
+                groupStarts.push_back(t + nThreads*i);
+        parallel_foreach(pool, groupStarts.size(),
+            [&](int, index_type k){
+                const index_type * group = &threadGroups[groupStarts[k] % nThreads][groupStarts[k] / nThreads];
+                for(index_type g = 2; g <= group[0]; ++g)
+                    mergeEdges(group[1], group[g]);
+                if(replay)
+                    edgeCost_[group[1]] = edgeCost(group[1]);
+            });
+        for(size_t t = 0; t < nThreads; ++t)
+            threadGroups[t].clear();
+
+        // update the distances of all edges incident to merged clusters
+        if(!replay)
+        {
+            parallel_foreach(pool, batch.size(),
+                [&](int, index_type k){
+                    const index_type u = batch[k].u;
+                    std::vector<index_type> const & edges = incidentEdges_[u];
+                    for(std::size_t i = 0; i < edges.size(); ++i)
+                    {
+                        const index_type y = oppositeNode(edges[i], u);
+                        if(roundMerged_[y] == 0 || u < y)
+                            edgeCost_[edges[i]] = edgeCost(edges[i]);
+                    }
+                });
+        }
+
+        for(std::size_t k = 0; k < batch.size(); ++k)
+            roundMerged_[batch[k].u] = 0;
+        activeNodes.erase(std::remove_if(activeNodes.begin(), activeNodes.end(),
+                                         [this](index_type n){ return nodeParent_[n] != n; }),
+                          activeNodes.end());
+        if(options_.verbose_)
+            std::cout<<"\rNodes: "<<std::setw(10)<<nodeNum_<<std::flush;
+    }
+    if(options_.verbose_)
+        std::cout<<"\n";
+
+    if(replay && nodeNum_ < stopCount)
+    {
+        // merges happen in order of increasing distance in the serial algorithm
+        std::stable_sort(merges.begin(), merges.end(), 
+            [&](BatchItem const & a, BatchItem const & b){ return cheaper(a.edge, b.edge); });
+        nodeNum_ = graph_.nodeNum();
+        for(index_type k = 0; k <= maxNodeId; ++k)
+            nodeParent_[k] = k;
+        for(std::size_t k = 0; k < merges.size() && nodeNum_ > stopCount; ++k, --nodeNum_)
+            nodeParent_[findNode(merges[k].v)] = findNode(merges[k].u);
+    }
+}
+
+
+/** \brief Reduce the number of nodes in a graph by iteratively contracting
+    the cheapest edge, using the \ref FastHierarchicalClustering engine.
+
+    The arguments and the cluster distance are the same as in \ref hierarchicalClustering(). 
+    The labels may differ by a renaming of the clusters and in the resolution of ties.
+
+    <b>\#include</b> \<vigra/hierarchical_clustering.hxx\><br>
+    Namespace: vigra
+*/
+template <class GRAPH,
+          class EDGE_WEIGHT_MAP,  class EDGE_LENGTH_MAP,
+          class NODE_FEATURE_MAP, class NOSE_SIZE_MAP,
+          class NODE_LABEL_MAP>
+void
+fastHierarchicalClustering(GRAPH const & graph,
+                           EDGE_WEIGHT_MAP const & edgeWeights, EDGE_LENGTH_MAP const & edgeLengths,
+                           NODE_FEATURE_MAP const & nodeFeatures, NOSE_SIZE_MAP const & nodeSizes,
+                           NODE_LABEL_MAP & labelMap,
+                           ClusteringOptions options = ClusteringOptions())
+{
+    FastHierarchicalClustering<GRAPH> clustering(graph, options);
+    clustering.cluster(edgeWeights, edgeLengths, nodeFeatures, nodeSizes);
+
+    for(typename GRAPH::NodeIt node(graph); node != lemon::INVALID; ++node)
+    {
+        labelMap[*node] = clustering.reprNodeId(graph.id(*node));
+    }
+}
+
+/** \brief Parallel variant of \ref fastHierarchicalClustering().
+
+    Contracts independent local-minimum edges in parallel rounds, see 
+    \ref FastHierarchicalClustering::cluster() for details. The result is 
+    the same as the serial one when node features and sizes are ignored.
+
+    <b>\#include</b> \<vigra/hierarchical_clustering.hxx\><br>
+    Namespace: vigra
+*/
+template <class GRAPH,
+          class EDGE_WEIGHT_MAP,  class EDGE_LENGTH_MAP,
+          class NODE_FEATURE_MAP, class NOSE_SIZE_MAP,
+          class NODE_LABEL_MAP>
+void
+fastHierarchicalClustering(GRAPH const & graph,
+                           EDGE_WEIGHT_MAP const & edgeWeights, EDGE_LENGTH_MAP const & edgeLengths,
+                           NODE_FEATURE_MAP const & nodeFeatures, NOSE_SIZE_MAP const & nodeSizes,
+                           NODE_LABEL_MAP & labelMap,
+                           ClusteringOptions options,
+                           ParallelOptions const & parallelOptions)
+{
+    FastHierarchicalClustering<GRAPH> clustering(graph, options);
+    clustering.cluster(edgeWeights, edgeLengths, nodeFeatures, nodeSizes, parallelOptions);
+
+    for(typename GRAPH::NodeIt node(graph); node != lemon::INVALID; ++node)
+    {
+        labelMap[*node] = clustering.reprNodeId(graph.id(*node));
+    }
+}
+
 //@}
 
 } // namespace vigra
@@ -0,0 +1,862 @@
+/************************************************************************/
+/*                                                                      */
+/*                Copyright 2026 by the VIGRA developers                */
+/*                                                                      */
+/*    This file is part of the VIGRA computer vision library.           */
+/*    The VIGRA Website is                                              */
+/*        http://hci.iwr.uni-heidelberg.de/vigra/                       */
+/*    Please direct questions, bug reports, and contributions to        */
+/*        ullrich.koethe@iwr.uni-heidelberg.de    or                    */
+/*        vigra@informatik.uni-hamburg.de                               */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+
+#ifndef VIGRA_INCREMENTAL_SEGMENTATION_HXX
+#define VIGRA_INCREMENTAL_SEGMENTATION_HXX
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "multi_array.hxx"
+#include "multi_iterator.hxx"
+#include "multi_gridgraph.hxx"
+#include "multi_labeling.hxx"
+#include "multi_watersheds.hxx"
+#include "priority_queue.hxx"
+#include "adjacency_list_graph.hxx"
+
+namespace vigra
+{
+
+namespace incremental_segmentation_detail
+{
+
+    // The region affected by an edit: the edited box, all pixels connected to it
+    // via labels occurring in the box or adjacent to it, and the pixels with label 0
+    // adjacent to these.
+template <unsigned int N, class Label>
+struct AffectedRegion
+{
+    typedef typename MultiArrayShape<N>::type   Shape;
+
+    std::vector<Shape> pixels;      // in discovery order, edited box first
+    std::vector<Label> oldLabels;   // labels of 'pixels' before the edit
+    std::vector<bool>  floodZero;   // label 0 pixels that propagate the search
+    std::vector<Label> labels;      // affected labels in ascending order (without 0)
+    Shape begin, end;               // bounding box of 'pixels'
+
+    bool isAffected(Int64 label) const
+    {
+        return label > 0 && std::binary_search(labels.begin(), labels.end(), Label(label));
+    }
+};
+
+    // Breadth-first search from the pixels region.pixels[first], ... Pixels in the 
+    // box [roiBegin, roiEnd), pixels with affected labels, and label 0 pixels marked 
+    // in 'floodZero' propagate the search, other pixels with label 0 are only included.
+    // Visited pixels are marked with the largest representable label.
+template <unsigned int N, class Label, class S>
+void
+growAffectedRegion(GridGraph<N, undirected_tag> const & g,
+                   MultiArrayView<N, Label, S> labels,
+                   typename MultiArrayShape<N>::type const & roiBegin,
+                   typename MultiArrayShape<N>::type const & roiEnd,
+                   AffectedRegion<N, Label> & region,
+                   std::size_t first)
+{
+    typedef GridGraph<N, undirected_tag>        Graph;
+    typedef typename Graph::shape_type          Shape;
+    typedef typename Graph::OutArcIt            neighbor_iterator;
+
+    const Label visited = NumericTraits<Label>::max();
+
+    for(std::size_t k = first; k < region.pixels.size(); ++k)
+    {
+        Shape p = region.pixels[k];
+        bool inBox = allLessEqual(roiBegin, p) && allLess(p, roiEnd);
+        if(region.oldLabels[k] == 0 && !inBox && !region.floodZero[k])
+            continue;
+        for(neighbor_iterator arc(g, p); arc != lemon::INVALID; ++arc)
+        {
+            Shape q(g.target(*arc));
+            Label l = labels[q];
+            if(l == visited || (l != 0 && !region.isAffected(l)))
+                continue;
+            region.pixels.push_back(q);
+            region.oldLabels.push_back(l);
+            region.floodZero.push_back(l == 0 && region.oldLabels[k] == 0 && region.floodZero[k]);
+            labels[q] = visited;
+            region.begin = min(region.begin, q);
+            region.end = max(region.end, q + Shape(1));
+        }
+    }
+}
+
+    // Find the affected region by a breadth-first search starting at the box
+    // [roiBegin, roiEnd). The largest representable label must not occur in 'labels'.
+template <unsigned int N, class Label, class S>
+void
+findAffectedRegion(GridGraph<N, undirected_tag> const & g,
+                   MultiArrayView<N, Label, S> labels,
+                   typename MultiArrayShape<N>::type const & roiBegin,
+                   typename MultiArrayShape<N>::type const & roiEnd,
+                   AffectedRegion<N, Label> & region,
+                   const char * message)
+{
+    typedef GridGraph<N, undirected_tag>        Graph;
+    typedef typename Graph::shape_type          Shape;
+    typedef typename Graph::OutArcIt            neighbor_iterator;
+
+    const Label visited = NumericTraits<Label>::max();
+
+    // the labels in the edited box and of its neighbors
+    for(MultiCoordinateIterator<N> p(roiEnd - roiBegin), end(p.getEndIterator()); p != end; ++p)
+    {
+        Shape q(roiBegin + *p);
+        Label l = labels[q];
+        vigra_precondition(l != visited, message);
+        if(l != 0)
+            region.labels.push_back(l);
+        for(neighbor_iterator arc(g, q); arc != lemon::INVALID; ++arc)
+        {
+            l = labels[g.target(*arc)];
+            vigra_precondition(l != visited, message);
+            if(l != 0)
+                region.labels.push_back(l);
+        }
+    }
+    std::sort(region.labels.begin(), region.labels.end());
+    region.labels.erase(std::unique(region.labels.begin(), region.labels.end()), region.labels.end());
+
+    region.begin = roiBegin;
+    region.end = roiEnd;
+    for(MultiCoordinateIterator<N> p(roiEnd - roiBegin), end(p.getEndIterator()); p != end; ++p)
+    {
+        region.pixels.push_back(roiBegin + *p);
+        region.oldLabels.push_back(labels[roiBegin + *p]);
+        region.floodZero.push_back(false);
+        labels[roiBegin + *p] = visited;
+    }
+    growAffectedRegion(g, labels, roiBegin, roiEnd, region, 0);
+}
+
+    // Rebuild 'rag' from its edges between unaffected regions and the adjacencies
+    // of the (relabeled) affected region. Node ids are the labels.
+template <unsigned int N, class Label, class S>
+void
+updateRegionAdjacencyGraph(GridGraph<N, undirected_tag> const & g,
+                           MultiArrayView<N, Label, S> const & labels,
+                           AffectedRegion<N, Label> const & region,
+                           AdjacencyListGraph & rag,
+                           Int64 ignoreLabel)
+{
+    typedef GridGraph<N, undirected_tag>        Graph;
+    typedef typename Graph::OutArcIt            neighbor_iterator;
+    typedef AdjacencyListGraph::NodeIt          RagNodeIt;
+    typedef AdjacencyListGraph::EdgeIt          RagEdgeIt;
+
+    std::vector<Int64> nodes;
+    std::vector<std::pair<Int64, Int64> > edges;
+    for(std::size_t k = 0; k < region.pixels.size(); ++k)
+    {
+        const Int64 lp = static_cast<Int64>(labels[region.pixels[k]]);
+        if(lp == ignoreLabel)
+            continue;
+        nodes.push_back(lp);
+        for(neighbor_iterator arc(g, region.pixels[k]); arc != lemon::INVALID; ++arc)
+        {
+            const Int64 lq = static_cast<Int64>(labels[g.target(*arc)]);
+            if(lq != lp && lq != ignoreLabel)
+                edges.push_back(std::make_pair(std::min(lp, lq), std::max(lp, lq)));
+        }
+    }
+    std::sort(nodes.begin(), nodes.end());
+    nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    AdjacencyListGraph result(rag.nodeNum() + nodes.size(), rag.edgeNum() + edges.size());
+    for(RagNodeIt n(rag); n != lemon::INVALID; ++n)
+        if(!region.isAffected(rag.id(*n)))
+            result.addNode(rag.id(*n));
+    for(std::size_t k = 0; k < nodes.size(); ++k)
+        result.addNode(nodes[k]);
+    for(RagEdgeIt e(rag); e != lemon::INVALID; ++e)
+    {
+        const Int64 u = rag.id(rag.u(*e)), v = rag.id(rag.v(*e));
+        if(!region.isAffected(u) && !region.isAffected(v))
+            result.addEdge(result.nodeFromId(u), result.nodeFromId(v));
+    }
+    for(std::size_t k = 0; k < edges.size(); ++k)
+        result.addEdge(result.nodeFromId(edges[k].first), result.nodeFromId(edges[k].second));
+    rag = result;
+}
+
+template <unsigned int N, class T, class S1, class Label, class S2>
+Label
+labelMultiArrayIncremental(MultiArrayView<N, T, S1> const & data,
+                           MultiArrayView<N, Label, S2> labels,
+                           typename MultiArrayShape<N>::type const & roiBegin,
+                           typename MultiArrayShape<N>::type const & roiEnd,
+                           Label maxLabel,
+                           LabelOptions const & options,
+                           AffectedRegion<N, Label> & region)
+{
+    typedef typename MultiArrayShape<N>::type   Shape;
+
+    vigra_precondition(data.shape() == labels.shape(),
+        "labelMultiArrayIncremental(): shape mismatch between input and output.");
+    vigra_precondition(allLessEqual(Shape(), roiBegin) && allLessEqual(roiEnd, labels.shape()),
+        "labelMultiArrayIncremental(): ROI outside the array.");
+    if(!allLess(roiBegin, roiEnd))
+        return maxLabel;
+
+    const Label unassigned = NumericTraits<Label>::max();
+    GridGraph<N, undirected_tag> graph(labels.shape(), options.getNeighborhood());
+    findAffectedRegion(graph, labels, roiBegin, roiEnd, region,
+        "labelMultiArrayIncremental(): the largest label value is reserved.");
+
+    // The components of the affected region never touch other pixels of the
+    // same value, so that labeling its bounding box finds them exactly.
+    MultiArray<N, UInt32> local(region.end - region.begin);
+    UInt32 count = labelMultiArray(data.subarray(region.begin, region.end), local, options);
+
+    // components keep an old label found outside the edited box, if possible,
+    // then reuse the remaining affected labels, and finally get new ones
+    std::vector<Label> newLabels(count + 1, unassigned);
+    std::vector<bool> reused(region.labels.size(), false);
+    newLabels[0] = 0;
+    for(std::size_t k = 0; k < region.pixels.size(); ++k)
+    {
+        Shape const & p = region.pixels[k];
+        UInt32 c = local[p - region.begin];
+        Label old = region.oldLabels[k];
+        if(newLabels[c] != unassigned || old == 0 || (allLessEqual(roiBegin, p) && allLess(p, roiEnd)))
+            continue;
+        std::size_t j = std::lower_bound(region.labels.begin(), region.labels.end(), old) - region.labels.begin();
+        if(!reused[j])
+        {
+            reused[j] = true;
+            newLabels[c] = old;
+        }
+    }
+    std::size_t nextReused = 0;
+    for(std::size_t k = 0; k < region.pixels.size(); ++k)
+    {
+        Label & l = newLabels[local[region.pixels[k] - region.begin]];
+        if(l != unassigned)
+            continue;
+        while(nextReused < reused.size() && reused[nextReused])
+            ++nextReused;
+        if(nextReused < reused.size())
+        {
+            reused[nextReused] = true;
+            l = region.labels[nextReused];
+        }
+        else
+        {
+            vigra_precondition(maxLabel < unassigned - 1,
+                "labelMultiArrayIncremental(): label type too small for the number of regions.");
+            l = ++maxLabel;
+        }
+    }
+    for(std::size_t k = 0; k < region.pixels.size(); ++k)
+        labels[region.pixels[k]] = newLabels[local[region.pixels[k] - region.begin]];
+    return maxLabel;
+}
+
+    // the flooding priority of a pixel with the given label, as in seededWatersheds()
+template <class T, class Label>
+inline T
+watershedPriority(T value, Label label, WatershedOptions const & options)
+{
+    return static_cast<Int64>(label) == static_cast<Int64>(options.biased_label)
+               ? static_cast<T>(value * options.bias)
+               : value;
+}
+
+    // Repeat the flooding of the unchanged region 'label' that contains 'pixels'.
+    // For these pixels, return the level of the neighbor from which the flooding
+    // reached them ('arrival', the lowest value for seeds) and their own flooding 
+    // level ('level'). Pixels that are not reached get the highest value.
+template <unsigned int N, class T, class S1, class Label, class S2, class S3>
+void
+watershedRegionLevels(GridGraph<N, undirected_tag> const & g,
+                      MultiArrayView<N, T, S1> const & data,
+                      MultiArrayView<N, Label, S2> labels,
+                      MultiArrayView<N, Label, S3> const & seeds,
+                      WatershedOptions const & options,
+                      Label label,
+                      std::vector<typename MultiArrayShape<N>::type> const & pixels,
+                      std::vector<T> & arrival,
+                      std::vector<T> & level)
+{
+    typedef GridGraph<N, undirected_tag>        Graph;
+    typedef typename Graph::shape_type          Shape;
+    typedef typename Graph::OutArcIt            neighbor_iterator;
+
+    enum { Outside, Unreached, Reached };
+    const Label visited = NumericTraits<Label>::max();
+
+    // find the region by a breadth-first search, temporarily marking its pixels
+    std::vector<Shape> region;
+    Shape begin(labels.shape()), end;
+    for(std::size_t k = 0; k < pixels.size(); ++k)
+    {
+        if(labels[pixels[k]] != label)
+            continue;
+        labels[pixels[k]] = visited;
+        region.push_back(pixels[k]);
+    }
+    for(std::size_t k = 0; k < region.size(); ++k)
+    {
+        begin = min(begin, region[k]);
+        end = max(end, region[k] + Shape(1));
+        for(neighbor_iterator arc(g, region[k]); arc != lemon::INVALID; ++arc)
+        {
+            Shape q(g.target(*arc));
+            if(labels[q] != label)
+                continue;
+            labels[q] = visited;
+            region.push_back(q);
+        }
+    }
+    for(std::size_t k = 0; k < region.size(); ++k)
+        labels[region[k]] = label;
+
+    // flood it from its seeds as seededWatersheds() did
+    MultiArray<N, UInt8> state(end - begin, (UInt8)Outside);
+    MultiArray<N, T> arrivalLevel(end - begin, NumericTraits<T>::max()),
+                     floodLevel(end - begin, NumericTraits<T>::max());
+    PriorityQueue<Shape, T, true> pqueue;
+    for(std::size_t k = 0; k < region.size(); ++k)
+    {
+        Shape p(region[k] - begin);
+        state[p] = Unreached;
+        if(seeds[region[k]] == 0)
+            continue;
+        state[p] = Reached;
+        arrivalLevel[p] = NumericTraits<T>::min();
+        floodLevel[p] = watershedPriority(data[region[k]], label, options);
+        pqueue.push(region[k], floodLevel[p]);
+    }
+    while(!pqueue.empty())
+    {
+        Shape node = pqueue.top();
+        T cost = pqueue.topPriority();
+        pqueue.pop();
+
+        if((options.terminate & StopAtThreshold) && (cost > options.max_cost))
+            break;
+
+        for(neighbor_iterator arc(g, node); arc != lemon::INVALID; ++arc)
+        {
+            Shape q(g.target(*arc));
+            if(!(allLessEqual(begin, q) && allLess(q, end)) || state[q - begin] != Unreached)
+                continue;
+            state[q - begin] = Reached;
+            arrivalLevel[q - begin] = cost;
+            floodLevel[q - begin] = std::max(watershedPriority(data[q], label, options), cost);
+            pqueue.push(q, floodLevel[q - begin]);
+        }
+    }
+
+    arrival.resize(pixels.size());
+    level.resize(pixels.size());
+    for(std::size_t k = 0; k < pixels.size(); ++k)
+    {
+        arrival[k] = arrivalLevel[pixels[k] - begin];
+        level[k] = floodLevel[pixels[k] - begin];
+    }
+}
+
+template <unsigned int N, class T, class S1, class Label, class S2, class S3>
+Label
+watershedsMultiArrayIncremental(MultiArrayView<N, T, S1> const & data,
+                                MultiArrayView<N, Label, S2> labels,
+                                MultiArrayView<N, Label, S3> const & seeds,
+                                typename MultiArrayShape<N>::type const & roiBegin,
+                                typename MultiArrayShape<N>::type const & roiEnd,
+                                Label maxLabel,
+                                NeighborhoodType neighborhood,
+                                WatershedOptions const & options,
+                                AffectedRegion<N, Label> & region)
+{
+    typedef GridGraph<N, undirected_tag>        Graph;
+    typedef typename Graph::shape_type          Shape;
+    typedef typename Graph::OutArcIt            neighbor_iterator;
+
+    vigra_precondition(data.shape() == labels.shape() && data.shape() == seeds.shape(),
+        "watershedsMultiArrayIncremental(): shape mismatch between input and output.");
+    vigra_precondition(allLessEqual(Shape(), roiBegin) && allLessEqual(roiEnd, labels.shape()),
+        "watershedsMultiArrayIncremental(): ROI outside the array.");
+    vigra_precondition(options.method == WatershedOptions::RegionGrowing,
+        "watershedsMultiArrayIncremental(): only the region growing method is supported.");
+    if(!allLess(roiBegin, roiEnd))
+        return maxLabel;
+
+    enum { Fixed, Free, Contour };
+    const Label visited = NumericTraits<Label>::max();
+    const bool keepContours = (options.terminate & KeepContours) != 0,
+               stopAtThreshold = (options.terminate & StopAtThreshold) != 0;
+
+    Graph graph(labels.shape(), neighborhood);
+    findAffectedRegion(graph, labels, roiBegin, roiEnd, region,
+        "watershedsMultiArrayIncremental(): the largest label value is reserved.");
+
+    Shape begin, end;
+    MultiArray<N, Label> local;
+    MultiArray<N, UInt8> state;
+    MultiArray<N, T> level, arrival;
+    for(;;)
+    {
+        // flood the affected region from its seeds in its bounding box
+        begin = max(region.begin - Shape(1), Shape());
+        end = min(region.end + Shape(1), labels.shape());
+        local = labels.subarray(begin, end);
+        state.reshape(end - begin, (UInt8)Fixed);
+        level.reshape(end - begin, NumericTraits<T>::max());
+        arrival.reshape(end - begin, NumericTraits<T>::max());
+
+        PriorityQueue<Shape, T, true> pqueue;
+        std::vector<std::pair<Label, MultiArrayIndex> > border;
+        for(std::size_t k = 0; k < region.pixels.size(); ++k)
+        {
+            Shape const & p = region.pixels[k];
+            Label seed = seeds[p];
+            state[p - begin] = Free;
+            local[p - begin] = seed;
+            for(neighbor_iterator arc(graph, p); arc != lemon::INVALID; ++arc)
+            {
+                Label l = labels[graph.target(*arc)];
+                if(l != 0 && l != visited)
+                    border.push_back(std::make_pair(l, 
+                        detail::CoordinateToScanOrder<N>::exec(end - begin, graph.target(*arc) - begin)));
+            }
+            if(seed == 0)
+                continue;
+            level[p - begin] = watershedPriority(data[p], seed, options);
+            for(neighbor_iterator arc(graph, p); arc != lemon::INVALID; ++arc)
+            {
+                if(seeds[graph.target(*arc)] == 0)
+                {
+                    // register all seeds that have an unlabeled neighbor
+                    pqueue.push(p - begin, level[p - begin]);
+                    break;
+                }
+            }
+        }
+
+        // the fixed labels around the region take part at the levels 
+        // at which they were originally flooded
+        std::sort(border.begin(), border.end());
+        border.erase(std::unique(border.begin(), border.end()), border.end());
+        std::vector<Shape> pixels;
+        std::vector<T> borderArrival, borderLevel;
+        for(std::size_t k = 0; k < border.size(); )
+        {
+            std::size_t kend = k;
+            pixels.clear();
+            for(; kend < border.size() && border[kend].first == border[k].first; ++kend)
+            {
+                Shape q;
+                detail::ScanOrderToCoordinate<N>::exec(border[kend].second, end - begin, q);
+                pixels.push_back(q + begin);
+            }
+            watershedRegionLevels(graph, data, labels, seeds, options, border[k].first, 
+                                  pixels, borderArrival, borderLevel);
+            for(std::size_t j = 0; j < pixels.size(); ++j)
+            {
+                Shape q(pixels[j] - begin);
+                arrival[q] = borderArrival[j];
+                level[q] = borderLevel[j];
+                if(borderLevel[j] < NumericTraits<T>::max())
+                    pqueue.push(q, borderLevel[j]);
+            }
+            k = kend;
+        }
+
+        Graph localGraph(end - begin, neighborhood);
+        while(!pqueue.empty())
+        {
+            Shape node = pqueue.top();
+            T cost = pqueue.topPriority();
+            pqueue.pop();
+
+            if(stopAtThreshold && (cost > options.max_cost))
+                break;
+            if(state[node] == Contour)
+                continue;
+
+            Label label = local[node];
+            for(neighbor_iterator arc(localGraph, node); arc != lemon::INVALID; ++arc)
+            {
+                Shape q(localGraph.target(*arc));
+                if(state[q] == Fixed)
+                    continue;
+                Label neighborLabel = local[q];
+                if(neighborLabel == 0)
+                {
+                    local[q] = label;
+                    level[q] = std::max(watershedPriority(data[q + begin], label, options), cost);
+                    pqueue.push(q, level[q]);
+                }
+                else if(keepContours && label != neighborLabel && state[q] != Contour &&
+                        cost < watershedPriority(data[q + begin], neighborLabel, options))
+                {
+                    state[q] = Contour;
+                }
+            }
+        }
+
+        // Outside pixels which the new flooding reaches earlier than the original
+        // one must be re-flooded as well, together with their regions. The same 
+        // holds for label 0 pixels it reaches, and for contours it may create.
+        std::vector<Shape> starts;
+        std::vector<Label> newLabels;
+        for(std::size_t k = 0; k < region.pixels.size(); ++k)
+        {
+            Shape p(region.pixels[k] - begin);
+            Label label = local[p];
+            if(state[p] == Contour || label == 0 || (stopAtThreshold && level[p] > options.max_cost))
+                continue;
+            for(neighbor_iterator arc(graph, region.pixels[k]); arc != lemon::INVALID; ++arc)
+            {
+                Shape q(graph.target(*arc));
+                Label l = labels[q];
+                if(l == visited)
+                    continue;
+                if(l == 0 || region.isAffected(l) ||
+                   level[p] < arrival[q - begin] ||
+                   (keepContours && l != label && level[p] < watershedPriority(data[q], l, options)))
+                {
+                    starts.push_back(q);
+                    if(l != 0)
+                        newLabels.push_back(l);
+                }
+            }
+        }
+        if(starts.empty())
+            break;
+
+        region.labels.insert(region.labels.end(), newLabels.begin(), newLabels.end());
+        std::sort(region.labels.begin(), region.labels.end());
+        region.labels.erase(std::unique(region.labels.begin(), region.labels.end()), region.labels.end());
+        std::size_t first = region.pixels.size();
+        for(std::size_t k = 0; k < starts.size(); ++k)
+        {
+            Label l = labels[starts[k]];
+            if(l == visited)
+                continue;
+            region.pixels.push_back(starts[k]);
+            region.oldLabels.push_back(l);
+            region.floodZero.push_back(l == 0 && !keepContours);
+            labels[starts[k]] = visited;
+            region.begin = min(region.begin, starts[k]);
+            region.end = max(region.end, starts[k] + Shape(1));
+        }
+        growAffectedRegion(graph, labels, roiBegin, roiEnd, region, first);
+    }
+
+    for(std::size_t k = 0; k < region.pixels.size(); ++k)
+    {
+        Shape p(region.pixels[k] - begin);
+        Label l = state[p] == Contour ? 0 : local[p];
+        labels[region.pixels[k]] = l;
+        maxLabel = std::max(maxLabel, l);
+    }
+    return maxLabel;
+}
+
+} // namespace incremental_segmentation_detail
+
+/** \addtogroup Labeling
+*/
+//@{
+
+/********************************************************/
+/*                                                      */
+/*              labelMultiArrayIncremental              */
+/*                                                      */
+/********************************************************/
+
+/** \brief Update a connected components labeling after the data changed in a box.
+
+    <b> Declarations:</b>
+
+    \code
+    namespace vigra {
+        template <unsigned int N, class T, class S1, class Label, class S2>
+        Label
+        labelMultiArrayIncremental(MultiArrayView<N, T, S1> const & data,
+                                   MultiArrayView<N, Label, S2> labels,
+                                   typename MultiArrayShape<N>::type const & roiBegin,
+                                   typename MultiArrayShape<N>::type const & roiEnd,
+                                   Label maxLabel,
+                                   LabelOptions const & options = LabelOptions());
+
+        template <unsigned int N, class T, class S1, class Label, class S2>
+        Label
+        labelMultiArrayIncremental(MultiArrayView<N, T, S1> const & data,
+                                   MultiArrayView<N, Label, S2> labels,
+                                   typename MultiArrayShape<N>::type const & roiBegin,
+                                   typename MultiArrayShape<N>::type const & roiEnd,
+                                   Label maxLabel,
+                                   AdjacencyListGraph & rag,
+                                   LabelOptions const & options = LabelOptions(),
+                                   Int64 ignoreLabel = -1);
+    }
+    \endcode
+
+    The array \a labels must hold the result of \ref labelMultiArray() with the same
+    \a options for the previous contents of \a data, and \a maxLabel its largest label.
+    When \a data has since been modified in the box <tt>[roiBegin, roiEnd)</tt> only, 
+    this function recomputes just the components which may have changed, i.e. those
+    occurring in the box or adjacent to it. The components are found by a flood fill from
+    the box, so that the work is proportional to their size (and their bounding box)
+    rather than to the size of the array. The relabeled components are equal to the
+    ones \ref labelMultiArray() would find for the new data, and all other pixels 
+    keep their labels.
+
+    Labels of the affected components are reused: a component keeps its old label 
+    if it still contains pixels with that label outside the box (when a component is
+    split, only the first part encountered keeps the label), other components receive 
+    the remaining old labels and then new labels <tt>maxLabel+1</tt>, ... The labels 
+    are thus no longer contiguous in general. The function returns the new largest label.
+    The largest value representable by <tt>Label</tt> is used internally and must not
+    occur in \a labels.
+
+    The second version also updates the region adjacency graph \a rag that was built from
+    \a labels by \ref makeRegionAdjacencyGraph() (its node ids are the labels). Nodes
+    and edges of unaffected regions are kept, whereas the nodes and edges of the affected
+    regions are recomputed from the adjacencies of the relabeled pixels. The node
+    ids remain equal to the labels, but edge ids are not preserved. As in 
+    makeRegionAdjacencyGraph(), \a ignoreLabel (if not -1) excludes a label from the graph.
+
+    <b> Usage:</b>
+
+    <b>\#include</b> \<vigra/incremental_segmentation.hxx\><br>
+    Namespace: vigra
+
+    \code
+    MultiArray<3, UInt8>  data(Shape3(512, 512, 512));
+    MultiArray<3, UInt32> labels(data.shape());
+    ... // fill data
+    
+    UInt32 maxLabel = labelMultiArray(data, labels);
+
+    // edit a small box of the data
+    Shape3 roiBegin(100, 100, 100), roiEnd(120, 110, 105);
+    data.subarray(roiBegin, roiEnd) = 1;
+
+    // and update the labeling accordingly
+    maxLabel = labelMultiArrayIncremental(data, labels, roiBegin, roiEnd, maxLabel);
+    \endcode
+*/
+doxygen_overloaded_function(template <...> unsigned int labelMultiArrayIncremental)
+
+template <unsigned int N, class T, class S1, class Label, class S2>
+inline Label
+labelMultiArrayIncremental(MultiArrayView<N, T, S1> const & data,
+                           MultiArrayView<N, Label, S2> labels,
+                           typename MultiArrayShape<N>::type const & roiBegin,
+                           typename MultiArrayShape<N>::type const & roiEnd,
+                           Label maxLabel,
+                           LabelOptions const & options = LabelOptions())
+{
+    incremental_segmentation_detail::AffectedRegion<N, Label> region;
+    return incremental_segmentation_detail::labelMultiArrayIncremental(
+                     data, labels, roiBegin, roiEnd, maxLabel, options, region);
+}
+
+template <unsigned int N, class T, class S1, class Label, class S2>
+inline Label
+labelMultiArrayIncremental(MultiArrayView<N, T, S1> const & data,
+                           MultiArrayView<N, Label, S2> labels,
+                           typename MultiArrayShape<N>::type const & roiBegin,
+                           typename MultiArrayShape<N>::type const & roiEnd,
+                           Label maxLabel,
+                           AdjacencyListGraph & rag,
+                           LabelOptions const & options = LabelOptions(),
+                           Int64 ignoreLabel = -1)
+{
+    incremental_segmentation_detail::AffectedRegion<N, Label> region;
+    maxLabel = incremental_segmentation_detail::labelMultiArrayIncremental(
+                     data, labels, roiBegin, roiEnd, maxLabel, options, region);
+    if(region.pixels.size() > 0)
+    {
+        GridGraph<N, undirected_tag> graph(labels.shape(), options.getNeighborhood());
+        incremental_segmentation_detail::updateRegionAdjacencyGraph(graph, labels, region, rag, ignoreLabel);
+    }
+    return maxLabel;
+}
+
+//@}
+
+/** \addtogroup Superpixels
+*/
+//@{
+
+/********************************************************/
+/*                                                      */
+/*            watershedsMultiArrayIncremental           */
+/*                                                      */
+/********************************************************/
+
+/** \brief Update a seeded watershed segmentation after a local edit.
+
+    <b> Declarations:</b>
+
+    \code
+    namespace vigra {
+        template <unsigned int N, class T, class S1, class Label, class S2, class S3>
+        Label
+        watershedsMultiArrayIncremental(MultiArrayView<N, T, S1> const & data,
+                                        MultiArrayView<N, Label, S2> labels,
+                                        MultiArrayView<N, Label, S3> const & seeds,
+                                        typename MultiArrayShape<N>::type const & roiBegin,
+                                        typename MultiArrayShape<N>::type const & roiEnd,
+                                        Label maxLabel,
+                                        NeighborhoodType neighborhood = DirectNeighborhood,
+                                        WatershedOptions const & options = WatershedOptions());
+
+        template <unsigned int N, class T, class S1, class Label, class S2, class S3>
+        Label
+        watershedsMultiArrayIncremental(MultiArrayView<N, T, S1> const & data,
+                                        MultiArrayView<N, Label, S2> labels,
+                                        MultiArrayView<N, Label, S3> const & seeds,
+                                        typename MultiArrayShape<N>::type const & roiBegin,
+                                        typename MultiArrayShape<N>::type const & roiEnd,
+                                        Label maxLabel,
+                                        AdjacencyListGraph & rag,
+                                        NeighborhoodType neighborhood = DirectNeighborhood,
+                                        WatershedOptions const & options = WatershedOptions(),
+                                        Int64 ignoreLabel = -1);
+    }
+    \endcode
+
+    The array \a labels must hold a segmentation of \a data, typically the result of
+    \ref watershedsMultiArray(), and \a seeds the (possibly edited) seeds of all regions,
+    where non-zero values are the seed labels, and \a maxLabel the largest label in 
+    \a labels. After the boundary indicator \a data or the seeds have been modified 
+    in the box <tt>[roiBegin, roiEnd)</tt>, this function re-floods only the affected 
+    region. Initially, this is the box and all regions occurring 
+    in the box or adjacent to it, which are found by a flood fill from the box (regions 
+    are assumed to be connected, which holds for watersheds of connected seeds).
+
+    Within the affected region, all labels are erased, the seeds are inserted, and the
+    region is flooded like \ref watershedsMultiArray() with the given \a neighborhood and 
+    \a options (which must select the region growing method) would do. The pixels around 
+    the region keep their labels and take part in the flooding at the level at which the 
+    original flooding reached them. These levels are recomputed by flooding their regions 
+    again. When the new flooding reaches an outside pixel earlier than the original one, 
+    or reaches an unlabeled pixel, the region of that pixel (or the connected unlabeled 
+    pixels) are added to the affected region, and the flooding is repeated. In 
+    particular, a new seed may take over pixels of regions further away, and removing 
+    the seed of a region lets its neighbors take over.
+
+    The result is therefore the same as that of watershedsMultiArray() for the edited 
+    data and seeds, except for the order in which pixels of equal priority are processed. 
+    It is identical when no ties occur, e.g. for floating point data with distinct values.
+    With <tt>keepContours()</tt>, contours are only recomputed in the affected region 
+    and may additionally differ where the original contours depended on such ties.
+    The work is proportional to the size of the affected regions and of their neighbors 
+    (and their bounding boxes) rather than to the size of the array. As in 
+    \ref labelMultiArrayIncremental(), the function returns the new largest label, 
+    i.e. the maximum of \a maxLabel and the labels of the re-flooded region. The largest 
+    value representable by <tt>Label</tt> is used internally and must not occur in 
+    \a labels or \a seeds.
+
+    The second version also updates the region adjacency graph \a rag as described for
+    \ref labelMultiArrayIncremental().
+
+    <b> Usage:</b>
+
+    <b>\#include</b> \<vigra/incremental_segmentation.hxx\><br>
+    Namespace: vigra
+
+    \code
+    MultiArray<3, float>  gradMag(Shape3(512, 512, 512));
+    MultiArray<3, UInt32> seeds(gradMag.shape()), labels(gradMag.shape());
+    ... // compute the boundary indicator and seeds
+
+    labels = seeds;
+    UInt32 maxLabel = watershedsMultiArray(gradMag, labels);
+
+    // the user splits a region by placing a new seed
+    Shape3 roiBegin(100, 100, 100), roiEnd(101, 101, 101);
+    seeds[roiBegin] = maxLabel + 1;
+    maxLabel = watershedsMultiArrayIncremental(gradMag, labels, seeds, roiBegin, roiEnd, maxLabel);
+    \endcode
+*/
+doxygen_overloaded_function(template <...> unsigned int watershedsMultiArrayIncremental)
+
+template <unsigned int N, class T, class S1, class Label, class S2, class S3>
+inline Label
+watershedsMultiArrayIncremental(MultiArrayView<N, T, S1> const & data,
+                                MultiArrayView<N, Label, S2> labels,
+                                MultiArrayView<N, Label, S3> const & seeds,
+                                typename MultiArrayShape<N>::type const & roiBegin,
+                                typename MultiArrayShape<N>::type const & roiEnd,
+                                Label maxLabel,
+                                NeighborhoodType neighborhood = DirectNeighborhood,
+                                WatershedOptions const & options = WatershedOptions())
+{
+    incremental_segmentation_detail::AffectedRegion<N, Label> region;
+    return incremental_segmentation_detail::watershedsMultiArrayIncremental(
+                     data, labels, seeds, roiBegin, roiEnd, maxLabel, neighborhood, options, region);
+}
+
+template <unsigned int N, class T, class S1, class Label, class S2, class S3>
+inline Label
+watershedsMultiArrayIncremental(MultiArrayView<N, T, S1> const & data,
+                                MultiArrayView<N, Label, S2> labels,
+                                MultiArrayView<N, Label, S3> const & seeds,
+                                typename MultiArrayShape<N>::type const & roiBegin,
+                                typename MultiArrayShape<N>::type const & roiEnd,
+                                Label maxLabel,
+                                AdjacencyListGraph & rag,
+                                NeighborhoodType neighborhood = DirectNeighborhood,
+                                WatershedOptions const & options = WatershedOptions(),
+                                Int64 ignoreLabel = -1)
+{
+    incremental_segmentation_detail::AffectedRegion<N, Label> region;
+    maxLabel = incremental_segmentation_detail::watershedsMultiArrayIncremental(
+                     data, labels, seeds, roiBegin, roiEnd, maxLabel, neighborhood, options, region);
+    if(region.pixels.size() > 0)
+    {
+        GridGraph<N, undirected_tag> graph(labels.shape(), neighborhood);
+        incremental_segmentation_detail::updateRegionAdjacencyGraph(graph, labels, region, rag, ignoreLabel);
+    }
+    return maxLabel;
+}
+
+//@}
+
+} // namespace vigra
+
+#endif // VIGRA_INCREMENTAL_SEGMENTATION_HXX
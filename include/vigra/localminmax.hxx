@@ -494,18 +494,20 @@ class LocalMinmaxOptions
 {
   public:
     double marker, thresh;
-    int neigh;
+    int neigh, num_threads;
     bool use_threshold, allow_at_border, allow_plateaus;
     
         /**\brief Construct default options object.
          *
             Defaults are: marker value '1', no threshold, indirect neighborhood, 
-                          don't allow extrema at border and extremal plateaus.
+                          don't allow extrema at border and extremal plateaus,
+                          run in the calling thread.
          */
     LocalMinmaxOptions()
     : marker(1.0), 
       thresh(0.0),
       neigh(1),
+      num_threads(0),
       use_threshold(false),
       allow_at_border(false),
       allow_plateaus(false)
@@ -580,6 +582,22 @@ class LocalMinmaxOptions
         allow_plateaus = f;
         return *this;
     }
+
+        /**\brief Use the given number of threads.
+
+            Only the functions for \ref vigra::MultiArrayView use threads. The array is
+            split into slabs along its last dimension, and plateaus are merged across 
+            the slabs with a \ref vigra::ConcurrentUnionFindArray. The value 
+            <tt>ParallelOptions::Auto</tt> (-1) selects the number of hardware threads. 
+            The result doesn't depend on the number of threads.
+        
+            Default: 0 (run in the calling thread)
+         */
+    LocalMinmaxOptions & numThreads(int n)
+    {
+        num_threads = n;
+        return *this;
+    }
 };
 
 
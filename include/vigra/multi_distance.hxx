@@ -47,6 +47,8 @@
 #include "metaprogramming.hxx"
 #include "multi_pointoperators.hxx"
 #include "functorexpression.hxx"
+#include "multi_array_chunked.hxx"
+#include "threadpool.hxx"
 
 #include "multi_gridgraph.hxx"     //for boundaryGraph & boundaryMultiDistance
 #include "union_find.hxx"        //for boundaryGraph & boundaryMultiDistance
@@ -76,10 +78,29 @@ struct DistParabolaStackEntry
 /*                                                      */
 /********************************************************/
 
+    /* Arithmetic type for evaluating the lower envelope: single precision lines
+       are evaluated in float, so that the final loop can be vectorized.
+    */
+template <class Value>
+struct DistParabolaEvalType
+{
+    typedef double type;
+};
+
+template <>
+struct DistParabolaEvalType<float>
+{
+    typedef float type;
+};
+
+    /* The stack of parabolas is passed in by the caller so that it can be
+       reused for all lines of an array (its capacity is retained by clear()).
+    */
 template <class SrcIterator, class SrcAccessor,
-          class DestIterator, class DestAccessor >
+          class DestIterator, class DestAccessor, class Value>
 void distParabola(SrcIterator is, SrcIterator iend, SrcAccessor sa,
-                  DestIterator id, DestAccessor da, double sigma )
+                  DestIterator id, DestAccessor da, double sigma,
+                  std::vector<DistParabolaStackEntry<Value> > & _stack)
 {
     // We assume that the data in the input is distance squared and treat it as such
     double w = iend - is;
@@ -89,9 +110,8 @@ void distParabola(SrcIterator is, SrcIterator iend, SrcAccessor sa,
     double sigma2 = sigma * sigma;
     double sigma22 = 2.0 * sigma2;
 
-    typedef typename SrcAccessor::value_type SrcType;
-    typedef DistParabolaStackEntry<SrcType> Influence;
-    std::vector<Influence> _stack;
+    typedef DistParabolaStackEntry<Value> Influence;
+    _stack.clear();
     _stack.push_back(Influence(sa(is), 0.0, 0.0, w));
 
     ++is;
@@ -125,16 +145,31 @@ void distParabola(SrcIterator is, SrcIterator iend, SrcAccessor sa,
 
     // Now we have the stack indicating which rows are influenced by (and therefore
     // closest to) which row. We can go through the stack and calculate the
-    // distance squared for each element of the column.
-    typename std::vector<Influence>::iterator it = _stack.begin();
-    for(current = 0.0; current < w; ++current, ++id)
+    // distance squared for each element of the column. Each parabola covers a
+    // contiguous span of the line, which is filled by a branch-free inner loop.
+    typedef typename DistParabolaEvalType<Value>::type EvalType;
+    EvalType s2 = EvalType(sigma2);
+    MultiArrayIndex i = 0, end = MultiArrayIndex(w);
+    typename std::vector<Influence>::const_iterator it = _stack.begin();
+    for(; it != _stack.end() && i < end; ++it)
     {
-        while( current >= it->right)
-            ++it;
-        da.set(sigma2 * sq(current - it->center) + it->apex_height, id);
+        MultiArrayIndex span_end = std::min(end, MultiArrayIndex(std::ceil(it->right)));
+        EvalType center = EvalType(it->center),
+                 apex   = EvalType(it->apex_height);
+        for(; i < span_end; ++i, ++id)
+            da.set(s2 * sq(EvalType(i) - center) + apex, id);
     }
 }
 
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor >
+inline void distParabola(SrcIterator is, SrcIterator iend, SrcAccessor sa,
+                         DestIterator id, DestAccessor da, double sigma )
+{
+    std::vector<DistParabolaStackEntry<typename SrcAccessor::value_type> > _stack;
+    distParabola(is, iend, sa, id, da, sigma, _stack);
+}
+
 template <class SrcIterator, class SrcAccessor,
           class DestIterator, class DestAccessor>
 inline void distParabola(triple<SrcIterator, SrcIterator, SrcAccessor> src,
@@ -144,6 +179,16 @@ inline void distParabola(triple<SrcIterator, SrcIterator, SrcAccessor> src,
                  dest.first, dest.second, sigma);
 }
 
+template <class SrcIterator, class SrcAccessor,
+          class DestIterator, class DestAccessor, class Value>
+inline void distParabola(triple<SrcIterator, SrcIterator, SrcAccessor> src,
+                         pair<DestIterator, DestAccessor> dest, double sigma,
+                         std::vector<DistParabolaStackEntry<Value> > & stack)
+{
+    distParabola(src.first, src.second, src.third,
+                 dest.first, dest.second, sigma, stack);
+}
+
 /********************************************************/
 /*                                                      */
 /*        internalSeparableMultiArrayDistTmp            */
@@ -166,6 +211,8 @@ void internalSeparableMultiArrayDistTmp(
 
     // temporary array to hold the current line to enable in-place operation
     ArrayVector<TmpType> tmp( shape[0] );
+    // parabola stack, shared by all lines
+    std::vector<DistParabolaStackEntry<TmpType> > stack;
 
     typedef MultiArrayNavigator<SrcIterator, N> SNavigator;
     typedef MultiArrayNavigator<DestIterator, N> DNavigator;
@@ -191,7 +238,7 @@ void internalSeparableMultiArrayDistTmp(
 
             detail::distParabola( srcIterRange(tmp.begin(), tmp.end(),
                           typename AccessorTraits<TmpType>::default_const_accessor()),
-                          destIter( dnav.begin(), dest ), sigmas[0] );
+                          destIter( dnav.begin(), dest ), sigmas[0], stack );
     }
 
     // operate on further dimensions
@@ -210,7 +257,7 @@ void internalSeparableMultiArrayDistTmp(
 
              detail::distParabola( srcIterRange(tmp.begin(), tmp.end(),
                            typename AccessorTraits<TmpType>::default_const_accessor()),
-                           destIter( dnav.begin(), dest ), sigmas[d] );
+                           destIter( dnav.begin(), dest ), sigmas[d], stack );
         }
     }
     if(invert) transformMultiArray( di, shape, dest, di, dest, -Arg1());
@@ -233,6 +280,160 @@ inline void internalSeparableMultiArrayDistTmp( SrcIterator si, SrcShape const &
     internalSeparableMultiArrayDistTmp( si, shape, src, di, dest, sigmas, false );
 }
 
+/********************************************************/
+/*                                                      */
+/*            parallel line-wise processing             */
+/*                                                      */
+/********************************************************/
+
+    /* Call f(threadId, start) in parallel for the start coordinate of every
+       1-dimensional line along dimension d of an array with the given shape.
+       The lines of a single dimension pass are independent, so the order
+       of execution doesn't matter.
+    */
+template <int N, class F>
+void
+parallelForeachLine(ThreadPool & pool, TinyVector<MultiArrayIndex, N> const & shape,
+                    unsigned int d, F && f)
+{
+    TinyVector<MultiArrayIndex, N> line_starts(shape);
+    line_starts[d] = 1;
+    parallel_foreach(pool, prod(line_starts),
+        [&](const int thread_id, const MultiArrayIndex k)
+        {
+            TinyVector<MultiArrayIndex, N> start(SkipInitialization);
+            ScanOrderToCoordinate<N>::exec(k, line_starts, start);
+            f(thread_id, start);
+        }
+    );
+}
+
+    /* 1-dimensional view of the line along dimension d starting at 'start'.
+    */
+template <unsigned int N, class T, class S>
+inline MultiArrayView<1, T, StridedArrayTag>
+lineView(MultiArrayView<N, T, S> const & array,
+         typename MultiArrayShape<N>::type const & start, unsigned int d)
+{
+    return MultiArrayView<1, T, StridedArrayTag>(Shape1(array.shape(d)), Shape1(array.stride(d)),
+                                                 array.data() + dot(start, array.stride()));
+}
+
+    /* One pass of the separable distance transform along dimension d, lines
+       are distributed over the threads of the pool. Each thread owns a line
+       buffer to enable in-place operation and a parabola stack, both are
+       allocated once per pass.
+    */
+template <unsigned int N, class T, class S>
+void
+parallelDistParabolaPass(ThreadPool & pool, MultiArrayView<N, T, S> array,
+                         unsigned int d, double sigma)
+{
+    typedef typename NumericTraits<T>::RealPromote TmpType;
+
+    std::size_t nthreads = std::max<std::size_t>(pool.nThreads(), 1);
+    std::vector<ArrayVector<TmpType> > buffers(nthreads, ArrayVector<TmpType>(array.shape(d)));
+    std::vector<std::vector<DistParabolaStackEntry<TmpType> > > stacks(nthreads);
+    for(std::size_t k = 0; k < nthreads; ++k)
+        stacks[k].reserve(array.shape(d));
+    parallelForeachLine(pool, array.shape(), d,
+        [&](const int thread_id, typename MultiArrayShape<N>::type const & start)
+        {
+            MultiArrayView<1, T, StridedArrayTag> line = lineView(array, start, d);
+            ArrayVector<TmpType> & buffer = buffers[thread_id];
+            std::copy(line.begin(), line.end(), buffer.begin());
+            distParabola(srcIterRange(buffer.begin(), buffer.end(),
+                                      typename AccessorTraits<TmpType>::default_const_accessor()),
+                         destIter(line.begin(), typename AccessorTraits<T>::default_accessor()),
+                         sigma, stacks[thread_id]);
+        }
+    );
+}
+
+template <unsigned int N, class T, class S, class Array>
+void
+internalSeparableMultiArrayDistParallel(MultiArrayView<N, T, S> array, Array const & sigmas,
+                                        ParallelOptions const & options)
+{
+    ThreadPool pool(options);
+    for(unsigned int d = 0; d < N; ++d)
+        parallelDistParabolaPass(pool, array, d, sigmas[d]);
+}
+
+    /* Separable distance transform of a ChunkedArray. Each dimension pass
+       processes the array in columns of chunks which span the entire extent of
+       the current dimension, so that only one column must reside in memory.
+       Optionally, the square root is taken before the last pass commits its results.
+    */
+template <unsigned int N, class T1, class T2, class Array>
+void
+internalSeparableMultiDistChunked(ChunkedArray<N, T1> const & source,
+                                  ChunkedArray<N, T2> & dest, bool background,
+                                  Array const & pixelPitch,
+                                  ParallelOptions const & options,
+                                  bool take_sqrt)
+{
+    typedef typename MultiArrayShape<N>::type Shape;
+    typedef typename NumericTraits<T2>::RealPromote Real;
+
+    Shape shape = source.shape();
+    vigra_precondition(shape == dest.shape(),
+        "separableMultiDistSquared(): shape mismatch between input and output.");
+
+    double dmax = 0.0;
+    bool pixelPitchIsReal = false;
+    for(unsigned int k=0; k<N; ++k)
+    {
+        if(int(pixelPitch[k]) != pixelPitch[k])
+            pixelPitchIsReal = true;
+        dmax += sq(pixelPitch[k]*shape[k]);
+    }
+    vigra_precondition(dmax <= NumericTraits<T2>::toRealPromote(NumericTraits<T2>::max()) &&
+                       (!pixelPitchIsReal || !NumericTraits<T2>::isIntegral::value),
+        "separableMultiDistSquared(ChunkedArray): destination value type cannot represent "
+        "the squared distances, use a floating-point destination.");
+
+    using namespace vigra::functor;
+
+    T1 zero = NumericTraits<T1>::zero();
+    Real maxDist = (Real)dmax, rzero = (Real)0.0;
+
+    ThreadPool pool(options);
+    for(unsigned int d = 0; d < N; ++d)
+    {
+        Shape column_shape = dest.chunkShape();
+        column_shape[d] = shape[d];
+        MultiCoordinateIterator<N> column((shape + column_shape - Shape(1)) / column_shape),
+                                   column_end = column.getEndIterator();
+        for(; column != column_end; ++column)
+        {
+            Shape start = *column * column_shape,
+                  stop  = min(start + column_shape, shape);
+            MultiArray<N, Real> tmpArray(stop - start);
+            if(d == 0)
+            {
+                // initialize the distances by thresholding the source
+                MultiArray<N, T1> src(stop - start);
+                source.checkoutSubarray(start, src);
+                if(background == true)
+                    transformMultiArray(src, tmpArray,
+                                        ifThenElse( Arg1() == Param(zero), Param(maxDist), Param(rzero) ));
+                else
+                    transformMultiArray(src, tmpArray,
+                                        ifThenElse( Arg1() != Param(zero), Param(maxDist), Param(rzero) ));
+            }
+            else
+            {
+                dest.checkoutSubarray(start, tmpArray);
+            }
+            parallelDistParabolaPass(pool, tmpArray, d, pixelPitch[d]);
+            if(take_sqrt && d == N-1)
+                transformMultiArray(tmpArray, tmpArray, sqrt(Arg1()));
+            dest.commitSubarray(start, tmpArray);
+        }
+    }
+}
+
 } // namespace detail
 
 /** \addtogroup DistanceTransform
@@ -272,6 +473,27 @@ inline void internalSeparableMultiArrayDistTmp( SrcIterator si, SrcShape const &
         separableMultiDistSquared(MultiArrayView<N, T1, S1> const & source,
                                   MultiArrayView<N, T2, S2> dest,
                                   bool background);
+
+        // parallel version (the pixelPitch argument is optional)
+        template <unsigned int N, class T1, class S1,
+                                  class T2, class S2,
+                  class Array>
+        void
+        separableMultiDistSquared(MultiArrayView<N, T1, S1> const & source,
+                                  MultiArrayView<N, T2, S2> dest,
+                                  bool background,
+                                  Array const & pixelPitch,
+                                  ParallelOptions const & options);
+
+        // blockwise version for arrays that don't fit into memory
+        // (the pixelPitch argument is optional)
+        template <unsigned int N, class T1, class T2, class Array>
+        void
+        separableMultiDistSquared(ChunkedArray<N, T1> const & source,
+                                  ChunkedArray<N, T2> & dest,
+                                  bool background,
+                                  Array const & pixelPitch,
+                                  ParallelOptions const & options = ParallelOptions());
     }
     \endcode
 
@@ -343,6 +565,14 @@ inline void internalSeparableMultiArrayDistTmp( SrcIterator si, SrcShape const &
     <tt> NumericTraits<typename DestAccessor::value_type>::max() < N * M*M</tt>, where M is the
     size of the largest dimension of the array.
 
+    When \ref vigra::ParallelOptions are passed, the independent lines of each dimension
+    pass are distributed over the requested number of threads. The \ref vigra::ChunkedArray
+    version processes each dimension pass in columns of chunks spanning the entire
+    extent of that dimension, so that only one column (plus the source chunks during
+    the first pass) must be held in memory at any time. Its destination value type must
+    be able to represent all squared distances (use <tt>float</tt> or <tt>double</tt>
+    for large arrays or non-integer pixel pitch).
+
     <b> Usage:</b>
 
     <b>\#include</b> \<vigra/multi_distance.hxx\><br/>
@@ -387,8 +617,10 @@ void separableMultiDistSquared( SrcIterator s, SrcShape const & shape, SrcAccess
 
     using namespace vigra::functor;
 
+    // need a temporary array to avoid overflows or rounding of anisotropic distances,
+    // floating-point destinations are always processed in place
     if(dmax > NumericTraits<DestType>::toRealPromote(NumericTraits<DestType>::max())
-       || pixelPitchIsReal) // need a temporary array to avoid overflows
+       || (pixelPitchIsReal && NumericTraits<DestType>::isIntegral::value))
     {
         // Threshold the values so all objects have infinity value in the beginning
         Real maxDist = (Real)dmax, rzero = (Real)0.0;
@@ -479,6 +711,95 @@ separableMultiDistSquared(MultiArrayView<N, T1, S1> const & source,
                                destMultiArray(dest), background );
 }
 
+template <unsigned int N, class T1, class S1,
+                          class T2, class S2,
+          class Array>
+void
+separableMultiDistSquared(MultiArrayView<N, T1, S1> const & source,
+                          MultiArrayView<N, T2, S2> dest, bool background,
+                          Array const & pixelPitch,
+                          ParallelOptions const & options)
+{
+    vigra_precondition(source.shape() == dest.shape(),
+        "separableMultiDistSquared(): shape mismatch between input and output.");
+
+    typedef typename NumericTraits<T2>::RealPromote Real;
+
+    double dmax = 0.0;
+    bool pixelPitchIsReal = false;
+    for(unsigned int k=0; k<N; ++k)
+    {
+        if(int(pixelPitch[k]) != pixelPitch[k])
+            pixelPitchIsReal = true;
+        dmax += sq(pixelPitch[k]*source.shape(k));
+    }
+
+    using namespace vigra::functor;
+
+    T1 zero = NumericTraits<T1>::zero();
+    // need a temporary array to avoid overflows or rounding of anisotropic distances,
+    // floating-point destinations are always processed in place
+    if(dmax > NumericTraits<T2>::toRealPromote(NumericTraits<T2>::max())
+       || (pixelPitchIsReal && NumericTraits<T2>::isIntegral::value))
+    {
+        Real maxDist = (Real)dmax, rzero = (Real)0.0;
+        MultiArray<N, Real> tmpArray(source.shape());
+        if(background == true)
+            transformMultiArray(source, tmpArray,
+                                ifThenElse( Arg1() == Param(zero), Param(maxDist), Param(rzero) ));
+        else
+            transformMultiArray(source, tmpArray,
+                                ifThenElse( Arg1() != Param(zero), Param(maxDist), Param(rzero) ));
+
+        detail::internalSeparableMultiArrayDistParallel(tmpArray, pixelPitch, options);
+        dest = tmpArray;
+    }
+    else        // work directly on the destination array
+    {
+        T2 maxDist = T2(std::ceil(dmax)), rzero = (T2)0;
+        if(background == true)
+            transformMultiArray(source, dest,
+                                ifThenElse( Arg1() == Param(zero), Param(maxDist), Param(rzero) ));
+        else
+            transformMultiArray(source, dest,
+                                ifThenElse( Arg1() != Param(zero), Param(maxDist), Param(rzero) ));
+
+        detail::internalSeparableMultiArrayDistParallel(dest, pixelPitch, options);
+    }
+}
+
+template <unsigned int N, class T1, class S1,
+                          class T2, class S2>
+inline void
+separableMultiDistSquared(MultiArrayView<N, T1, S1> const & source,
+                          MultiArrayView<N, T2, S2> dest, bool background,
+                          ParallelOptions const & options)
+{
+    TinyVector<double, N> pixelPitch(1.0);
+    separableMultiDistSquared(source, dest, background, pixelPitch, options);
+}
+
+template <unsigned int N, class T1, class T2, class Array>
+inline void
+separableMultiDistSquared(ChunkedArray<N, T1> const & source,
+                          ChunkedArray<N, T2> & dest, bool background,
+                          Array const & pixelPitch,
+                          ParallelOptions const & options = ParallelOptions())
+{
+    detail::internalSeparableMultiDistChunked(source, dest, background, pixelPitch,
+                                              options, false);
+}
+
+template <unsigned int N, class T1, class T2>
+inline void
+separableMultiDistSquared(ChunkedArray<N, T1> const & source,
+                          ChunkedArray<N, T2> & dest, bool background,
+                          ParallelOptions const & options = ParallelOptions())
+{
+    TinyVector<double, N> pixelPitch(1.0);
+    separableMultiDistSquared(source, dest, background, pixelPitch, options);
+}
+
 /********************************************************/
 /*                                                      */
 /*             separableMultiDistance                   */
@@ -508,6 +829,26 @@ separableMultiDistSquared(MultiArrayView<N, T1, S1> const & source,
         separableMultiDistance(MultiArrayView<N, T1, S1> const & source,
                                MultiArrayView<N, T2, S2> dest,
                                bool background);
+
+        // parallel version (the pixelPitch argument is optional)
+        template <unsigned int N, class T1, class S1,
+                  class T2, class S2, class Array>
+        void
+        separableMultiDistance(MultiArrayView<N, T1, S1> const & source,
+                               MultiArrayView<N, T2, S2> dest,
+                               bool background,
+                               Array const & pixelPitch,
+                               ParallelOptions const & options);
+
+        // blockwise version for arrays that don't fit into memory
+        // (the pixelPitch argument is optional)
+        template <unsigned int N, class T1, class T2, class Array>
+        void
+        separableMultiDistance(ChunkedArray<N, T1> const & source,
+                               ChunkedArray<N, T2> & dest,
+                               bool background,
+                               Array const & pixelPitch,
+                               ParallelOptions const & options = ParallelOptions());
     }
     \endcode
 
@@ -655,6 +996,57 @@ separableMultiDistance(MultiArrayView<N, T1, S1> const & source,
                             destMultiArray(dest), background );
 }
 
+template <unsigned int N, class T1, class S1,
+          class T2, class S2, class Array>
+inline void
+separableMultiDistance(MultiArrayView<N, T1, S1> const & source,
+                       MultiArrayView<N, T2, S2> dest,
+                       bool background,
+                       Array const & pixelPitch,
+                       ParallelOptions const & options)
+{
+    separableMultiDistSquared(source, dest, background, pixelPitch, options);
+
+    // Finally, calculate the square root of the distances
+    using namespace vigra::functor;
+    transformMultiArray(dest, dest, sqrt(Arg1()));
+}
+
+template <unsigned int N, class T1, class S1,
+          class T2, class S2>
+inline void
+separableMultiDistance(MultiArrayView<N, T1, S1> const & source,
+                       MultiArrayView<N, T2, S2> dest,
+                       bool background,
+                       ParallelOptions const & options)
+{
+    TinyVector<double, N> pixelPitch(1.0);
+    separableMultiDistance(source, dest, background, pixelPitch, options);
+}
+
+template <unsigned int N, class T1, class T2, class Array>
+inline void
+separableMultiDistance(ChunkedArray<N, T1> const & source,
+                       ChunkedArray<N, T2> & dest,
+                       bool background,
+                       Array const & pixelPitch,
+                       ParallelOptions const & options = ParallelOptions())
+{
+    detail::internalSeparableMultiDistChunked(source, dest, background, pixelPitch,
+                                              options, true);
+}
+
+template <unsigned int N, class T1, class T2>
+inline void
+separableMultiDistance(ChunkedArray<N, T1> const & source,
+                       ChunkedArray<N, T2> & dest,
+                       bool background,
+                       ParallelOptions const & options = ParallelOptions())
+{
+    TinyVector<double, N> pixelPitch(1.0);
+    separableMultiDistance(source, dest, background, pixelPitch, options);
+}
+
 //%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%% BoundaryDistanceTransform %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 
 //rewrite labeled data and work with separableMultiDist
@@ -805,25 +1197,22 @@ void
 internalBoundaryMultiArrayDist(
                       MultiArrayView<N, T1, S1> const & labels,
                       MultiArrayView<N, T2, S2> dest,
-                      double dmax, bool array_border_is_active=false)
+                      double dmax, bool array_border_is_active,
+                      ParallelOptions const & options)
 {
-    typedef typename MultiArrayView<N, T1, S1>::const_traverser LabelIterator;
-    typedef typename MultiArrayView<N, T2, S2>::traverser DestIterator;
-    typedef MultiArrayNavigator<LabelIterator, N> LabelNavigator;
-    typedef MultiArrayNavigator<DestIterator, N> DNavigator;
-
+    ThreadPool pool(options);
     dest = dmax;
     for( unsigned d = 0; d < N; ++d )
     {
-        LabelNavigator lnav( labels.traverser_begin(), labels.shape(), d );
-        DNavigator dnav( dest.traverser_begin(), dest.shape(), d );
-
-        for( ; dnav.hasMore(); dnav++, lnav++ )
-        {
-            boundaryDistParabola(dnav.begin(), dnav.end(),
-                                 lnav.begin(),
-                                 dmax, array_border_is_active);
-        }
+        parallelForeachLine(pool, labels.shape(), d,
+            [&](const int /*threadId*/, typename MultiArrayShape<N>::type const & start)
+            {
+                MultiArrayView<1, T1, StridedArrayTag> label_line = lineView(labels, start, d);
+                MultiArrayView<1, T2, StridedArrayTag> line = lineView(dest, start, d);
+                boundaryDistParabola(line.begin(), line.end(), label_line.begin(),
+                                     dmax, array_border_is_active);
+            }
+        );
     }
 }
 
@@ -859,6 +1248,16 @@ enum BoundaryDistanceTag {
                               MultiArrayView<N, T2, S2> dest,
                               bool array_border_is_active=false,
                               BoundaryDistanceTag boundary=InterpixelBoundary);
+
+        // parallel version
+        template <unsigned int N, class T1, class S1,
+                  class T2, class S2>
+        void
+        boundaryMultiDistance(MultiArrayView<N, T1, S1> const & labels,
+                              MultiArrayView<N, T2, S2> dest,
+                              bool array_border_is_active,
+                              BoundaryDistanceTag boundary,
+                              ParallelOptions const & options);
     }
     \endcode
 
@@ -908,8 +1307,9 @@ template <unsigned int N, class T1, class S1,
 void
 boundaryMultiDistance(MultiArrayView<N, T1, S1> const & labels,
                       MultiArrayView<N, T2, S2> dest,
-                      bool array_border_is_active=false,
-                      BoundaryDistanceTag boundary=InterpixelBoundary)
+                      bool array_border_is_active,
+                      BoundaryDistanceTag boundary,
+                      ParallelOptions const & options)
 {
     vigra_precondition(labels.shape() == dest.shape(),
         "boundaryMultiDistance(): shape mismatch between input and output.");
@@ -923,7 +1323,7 @@ boundaryMultiDistance(MultiArrayView<N, T1, S1> const & labels,
         markRegionBoundaries(labels, boundaries, IndirectNeighborhood);
         if(array_border_is_active)
             initMultiArrayBorder(boundaries, 1, 1);
-        separableMultiDistance(boundaries, dest, true);
+        separableMultiDistance(boundaries, dest, true, options);
     }
     else
     {
@@ -942,18 +1342,30 @@ boundaryMultiDistance(MultiArrayView<N, T1, S1> const & labels,
             typedef typename NumericTraits<T2>::RealPromote Real;
             MultiArray<N, Real> tmpArray(labels.shape());
             detail::internalBoundaryMultiArrayDist(labels, tmpArray,
-                                                      dmax, array_border_is_active);
+                                                   dmax, array_border_is_active, options);
             transformMultiArray(tmpArray, dest, sqrt(Arg1()) - Param(offset) );
         }
         else
         {
             // can work directly on the destination array
-            detail::internalBoundaryMultiArrayDist(labels, dest, dmax, array_border_is_active);
+            detail::internalBoundaryMultiArrayDist(labels, dest, dmax, array_border_is_active, options);
             transformMultiArray(dest, dest, sqrt(Arg1()) - Param(offset) );
         }
     }
 }
 
+template <unsigned int N, class T1, class S1,
+                          class T2, class S2>
+inline void
+boundaryMultiDistance(MultiArrayView<N, T1, S1> const & labels,
+                      MultiArrayView<N, T2, S2> dest,
+                      bool array_border_is_active=false,
+                      BoundaryDistanceTag boundary=InterpixelBoundary)
+{
+    boundaryMultiDistance(labels, dest, array_border_is_active, boundary,
+                          ParallelOptions().numThreads(ParallelOptions::NoThreads));
+}
+
 //@}
 
 } //-- namespace vigra
@@ -2664,6 +2664,28 @@ public:
         return v + neighborOffsets_[neighborIndex];
     }
 
+        /** \brief Get the linear offsets of the neighbors of interior nodes.
+
+            Entry <tt>k</tt> is the address difference between a node and its neighbor 
+            with index <tt>k</tt> (see neighborOffset()) in an array with the given 
+            \a strides. Without \a strides, the offsets refer to node IDs. The offsets
+            are only valid for interior nodes, i.e. when <tt>get_border_type(v) == 0</tt>.
+            The indices of the back neighbors of interior nodes are 
+            <tt>(*neighborIndexArray(true))[0]</tt>.
+        */
+    ArrayVector<MultiArrayIndex> neighborStrideOffsets(shape_type const & strides) const
+    {
+        ArrayVector<MultiArrayIndex> res(neighborOffsets_.size());
+        for(unsigned int k=0; k<res.size(); ++k)
+            res[k] = dot(neighborOffsets_[k], strides);
+        return res;
+    }
+
+    ArrayVector<MultiArrayIndex> neighborStrideOffsets() const
+    {
+        return neighborStrideOffsets(detail::defaultStride(shape_));
+    }
+
     vertex_descriptor 
     source_or_target(edge_descriptor const & e, bool return_source) const
     {
@@ -2727,6 +2749,151 @@ isInside(GridGraph<N, DirectedTag> const & g,
     return allLess(v, g.shape()) && allGreaterEqual(v, typename MultiArrayShape<N>::type());
 }
 
+    /** \brief Traverse a GridGraph in scan order, one scan line at a time.
+
+        Calls <tt>f(start, length, interior)</tt> for consecutive runs of nodes along 
+        dimension 0. The runs are split such that either all nodes of a run are interior 
+        nodes (<tt>interior == true</tt>, all neighbors exist) or none is. Algorithms 
+        use this to process interior nodes with linear offsets from 
+        \ref GridGraph::neighborStrideOffsets() instead of neighbor iterators, 
+        and fall back to the iterators only near the border.
+
+        The second form only visits the nodes in the box from \a roiBegin to \a roiEnd
+        (exclusive). Whether a node is interior still refers to the entire graph.
+        Algorithms use this to distribute slabs of the graph over several threads.
+    */
+template<unsigned int N, class DirectedTag, class FUNCTOR>
+void
+scanlineTraversal(GridGraph<N, DirectedTag> const & g, 
+                  typename MultiArrayShape<N>::type const & roiBegin,
+                  typename MultiArrayShape<N>::type const & roiEnd,
+                  FUNCTOR && f)
+{
+    typedef typename MultiArrayShape<N>::type Shape;
+
+    if(!allLess(roiBegin, roiEnd))
+        return;
+
+    Shape lineShape(roiEnd - roiBegin);
+    lineShape[0] = 1;
+    const MultiArrayIndex begin = roiBegin[0], 
+                          end = roiEnd[0],
+                          interiorBegin = std::max<MultiArrayIndex>(begin, 1),
+                          interiorEnd = std::min<MultiArrayIndex>(end, g.shape()[0] - 1);
+
+    MultiCoordinateIterator<N> line(lineShape),
+                               lineEnd = line.getEndIterator();
+    for(; line != lineEnd; ++line)
+    {
+        Shape start(roiBegin + *line);
+        bool interior = interiorBegin < interiorEnd;
+        for(unsigned int d=1; d<N; ++d)
+            interior = interior && start[d] > 0 && start[d] < g.shape()[d] - 1;
+        if(interior)
+        {
+            if(begin < interiorBegin)
+                f(start, interiorBegin - begin, false);
+            start[0] = interiorBegin;
+            f(start, interiorEnd - interiorBegin, true);
+            start[0] = interiorEnd;
+            if(interiorEnd < end)
+                f(start, end - interiorEnd, false);
+        }
+        else
+        {
+            f(start, end - begin, false);
+        }
+    }
+}
+
+template<unsigned int N, class DirectedTag, class FUNCTOR>
+inline void
+scanlineTraversal(GridGraph<N, DirectedTag> const & g, FUNCTOR && f)
+{
+    scanlineTraversal(g, typename MultiArrayShape<N>::type(), g.shape(), std::forward<FUNCTOR>(f));
+}
+
+    /** \brief Visit the outgoing arcs of a GridGraph node.
+
+        Specialization of \ref OutArcVisitor that uses the precomputed 
+        neighbor offsets for interior nodes.
+    */
+template<unsigned int N, class DirectedTag>
+class OutArcVisitor<GridGraph<N, DirectedTag> >
+{
+  public:
+    typedef GridGraph<N, DirectedTag>      Graph;
+    typedef typename Graph::index_type     index_type;
+    typedef typename Graph::Node           Node;
+    typedef typename Graph::Edge           Edge;
+    typedef typename Graph::OutArcIt       OutArcIt;
+
+    explicit OutArcVisitor(Graph const & g)
+    : graph_(g),
+      idOffsets_(g.neighborStrideOffsets())
+    {}
+
+    template<class FUNCTOR>
+    void operator()(Node const & node, index_type nodeId, FUNCTOR && f) const
+    {
+        if(graph_.get_border_type(node) == 0)
+        {
+            const index_type uniqueDegree = graph_.maxUniqueDegree();
+            for(index_type k=0; k<uniqueDegree; ++k)
+                f(graph_.neighbor(node, k), nodeId + idOffsets_[k], makeEdge(node, k));
+            for(index_type k=uniqueDegree; k<(index_type)idOffsets_.size(); ++k)
+            {
+                const Node target(graph_.neighbor(node, k));
+                f(target, nodeId + idOffsets_[k], makeEdge(target, graph_.oppositeIndex(k)));
+            }
+        }
+        else
+        {
+            for(OutArcIt a(graph_, node); a != lemon::INVALID; ++a)
+            {
+                const Node target(graph_.target(*a));
+                f(target, graph_.id(target), Edge(*a));
+            }
+        }
+    }
+
+  private:
+    static Edge makeEdge(Node const & node, index_type neighborIndex)
+    {
+        Edge res(SkipInitialization);
+        res.template subarray<0, N>() = node;
+        res[N] = neighborIndex;
+        return res;
+    }
+
+    Graph const & graph_;
+    ArrayVector<MultiArrayIndex> idOffsets_;
+};
+
+namespace detail {
+
+    // true if MAP is a MultiArrayView (or derived from one, e.g. GridGraph::NodeMap),
+    // so that its elements can be accessed by linear offsets
+template<class MAP, unsigned int N>
+struct IsStridedNodeMap
+{
+    typedef char falseResult[1];
+    typedef char trueResult[2];
+
+    static falseResult * test(...);
+    template <class T, class S>
+    static trueResult * test(MultiArrayView<N, T, S> const *);
+
+    enum { resultSize = sizeof(*test(static_cast<MAP const *>(0))) };
+
+    static const bool value = (resultSize == 2);
+    typedef typename
+        IfBool<value, VigraTrueType, VigraFalseType>::type
+        type;
+};
+
+} // namespace detail
+
 //@}
 
 #ifdef WITH_BOOST_GRAPH
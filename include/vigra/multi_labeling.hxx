@@ -149,12 +149,18 @@ labelGraph(Graph const & g,
     return count;
 }
 
+namespace graph_detail {
+
+    // GridGraph labeling with arbitrary property maps
 template <unsigned int N, class DirectedTag, class T1Map, class T2Map, class Equal>
 typename T2Map::value_type
-labelGraph(GridGraph<N, DirectedTag> const & g,
-           T1Map const & data,
-           T2Map & labels,
-           Equal const & equal)
+labelGridGraph(GridGraph<N, DirectedTag> const & g,
+               T1Map const & data,
+               T2Map & labels,
+               bool withBackground,
+               typename T1Map::value_type backgroundValue,
+               Equal const & equal,
+               VigraFalseType)
 {
     typedef GridGraph<N, DirectedTag>     Graph;
     typedef typename Graph::NodeIt        graph_scanner;
@@ -169,13 +175,20 @@ labelGraph(GridGraph<N, DirectedTag> const & g,
     {
         typename T1Map::value_type center = data[*node];
 
+        // background always gets label zero
+        if(withBackground && labeling_equality::callEqual(equal, center, backgroundValue, Shape()))
+        {
+            labels[*node] = 0;
+            continue;
+        }
+
         // define tentative label for current node
         LabelType currentIndex = regions.nextFreeIndex();
 
         for (neighbor_iterator arc(g, node); arc != INVALID; ++arc)
         {
-            Shape diff = g.neighborOffset(arc.neighborIndex());
             // merge regions if colors are equal
+            Shape diff = g.neighborOffset(arc.neighborIndex());
             if(labeling_equality::callEqual(equal, center, data[g.target(*arc)], diff))
             {
                 currentIndex = regions.makeUnion(labels[g.target(*arc)], currentIndex);
@@ -195,71 +208,123 @@ labelGraph(GridGraph<N, DirectedTag> const & g,
     return count;
 }
 
-
-template <class Graph, class T1Map, class T2Map, class Equal>
+    // GridGraph labeling with MultiArrayView property maps: 
+    // interior nodes are processed with linear neighbor offsets
+template <unsigned int N, class DirectedTag, class T1Map, class T2Map, class Equal>
 typename T2Map::value_type
-labelGraphWithBackground(Graph const & g,
-                         T1Map const & data,
-                         T2Map & labels,
-                         typename T1Map::value_type backgroundValue,
-                         Equal const & equal)
+labelGridGraph(GridGraph<N, DirectedTag> const & g,
+               T1Map const & data,
+               T2Map & labels,
+               bool withBackground,
+               typename T1Map::value_type backgroundValue,
+               Equal const & equal,
+               VigraTrueType)
 {
-    typedef typename Graph::NodeIt        graph_scanner;
+    typedef GridGraph<N, DirectedTag>     Graph;
     typedef typename Graph::OutBackArcIt  neighbor_iterator;
+    typedef typename T1Map::value_type    DataType;
     typedef typename T2Map::value_type    LabelType;
+    typedef typename Graph::shape_type    Shape;
+
+    ArrayVector<MultiArrayIndex> const & backIndices = (*g.neighborIndexArray(true))[0];
+    ArrayVector<MultiArrayIndex> dataOffsets(g.neighborStrideOffsets(data.stride())),
+                                 labelOffsets(g.neighborStrideOffsets(labels.stride()));
+    const MultiArrayIndex dataStride = data.stride(0), labelStride = labels.stride(0);
 
     vigra::UnionFindArray<LabelType>  regions;
 
     // pass 1: find connected components
-    for (graph_scanner node(g); node != INVALID; ++node)
+    scanlineTraversal(g, [&](Shape const & start, MultiArrayIndex length, bool interior)
     {
-        typename T1Map::value_type center = data[*node];
-
-        // background always gets label zero
-        if(equal(center, backgroundValue))
+        DataType const * d = &data[start];
+        LabelType * l = &labels[start];
+        Shape node(start);
+        for(MultiArrayIndex x = 0; x < length; ++x, ++node[0], d += dataStride, l += labelStride)
         {
-            labels[*node] = 0;
-            continue;
-        }
+            DataType center = *d;
 
-        // define tentative label for current node
-        LabelType currentIndex = regions.nextFreeIndex();
+            // background always gets label zero
+            if(withBackground && labeling_equality::callEqual(equal, center, backgroundValue, Shape()))
+            {
+                *l = 0;
+                continue;
+            }
 
-        for (neighbor_iterator arc(g, node); arc != INVALID; ++arc)
-        {
-            // merge regions if colors are equal
-            if(equal(center, data[g.target(*arc)]))
+            // define tentative label for current node
+            LabelType currentIndex = regions.nextFreeIndex();
+
+            if(interior)
             {
-                currentIndex = regions.makeUnion(labels[g.target(*arc)], currentIndex);
+                for(unsigned int j = 0; j < backIndices.size(); ++j)
+                {
+                    const MultiArrayIndex k = backIndices[j];
+                    if(labeling_equality::callEqual(equal, center, d[dataOffsets[k]], g.neighborOffset(k)))
+                    {
+                        currentIndex = regions.makeUnion(l[labelOffsets[k]], currentIndex);
+                    }
+                }
+            }
+            else
+            {
+                for (neighbor_iterator arc(g, node); arc != INVALID; ++arc)
+                {
+                    Shape diff = g.neighborOffset(arc.neighborIndex());
+                    if(labeling_equality::callEqual(equal, center, data[g.target(*arc)], diff))
+                    {
+                        currentIndex = regions.makeUnion(labels[g.target(*arc)], currentIndex);
+                    }
+                }
             }
+            // set label of current node
+            *l = regions.finalizeIndex(currentIndex);
         }
-        // set label of current node
-        labels[*node] = regions.finalizeIndex(currentIndex);
-    }
+    });
 
     LabelType count = regions.makeContiguous();
 
     // pass 2: make component labels contiguous
-    for (graph_scanner node(g); node != INVALID; ++node)
+    scanlineTraversal(g, [&](Shape const & start, MultiArrayIndex length, bool)
     {
-        labels[*node] = regions.findLabel(labels[*node]);
-    }
+        LabelType * l = &labels[start];
+        for(MultiArrayIndex x = 0; x < length; ++x, l += labelStride)
+            *l = regions.findLabel(*l);
+    });
     return count;
 }
 
+template <unsigned int N, class T1Map, class T2Map>
+struct GridGraphLinearAccess
+{
+    static const bool value = vigra::detail::IsStridedNodeMap<T1Map, N>::value &&
+                              vigra::detail::IsStridedNodeMap<T2Map, N>::value;
+    typedef typename IfBool<value, VigraTrueType, VigraFalseType>::type type;
+};
+
+} // namespace graph_detail
+
 template <unsigned int N, class DirectedTag, class T1Map, class T2Map, class Equal>
 typename T2Map::value_type
-labelGraphWithBackground(GridGraph<N, DirectedTag> const & g,
+labelGraph(GridGraph<N, DirectedTag> const & g,
+           T1Map const & data,
+           T2Map & labels,
+           Equal const & equal)
+{
+    return graph_detail::labelGridGraph(g, data, labels, false, typename T1Map::value_type(), equal,
+                                        typename graph_detail::GridGraphLinearAccess<N, T1Map, T2Map>::type());
+}
+
+
+template <class Graph, class T1Map, class T2Map, class Equal>
+typename T2Map::value_type
+labelGraphWithBackground(Graph const & g,
                          T1Map const & data,
                          T2Map & labels,
                          typename T1Map::value_type backgroundValue,
                          Equal const & equal)
 {
-    typedef GridGraph<N, DirectedTag>     Graph;
     typedef typename Graph::NodeIt        graph_scanner;
     typedef typename Graph::OutBackArcIt  neighbor_iterator;
     typedef typename T2Map::value_type    LabelType;
-    typedef typename Graph::shape_type    Shape;
 
     vigra::UnionFindArray<LabelType>  regions;
 
@@ -269,7 +334,7 @@ labelGraphWithBackground(GridGraph<N, DirectedTag> const & g,
         typename T1Map::value_type center = data[*node];
 
         // background always gets label zero
-        if(labeling_equality::callEqual(equal, center, backgroundValue, Shape()))
+        if(equal(center, backgroundValue))
         {
             labels[*node] = 0;
             continue;
@@ -281,8 +346,7 @@ labelGraphWithBackground(GridGraph<N, DirectedTag> const & g,
         for (neighbor_iterator arc(g, node); arc != INVALID; ++arc)
         {
             // merge regions if colors are equal
-            Shape diff = g.neighborOffset(arc.neighborIndex());
-            if(labeling_equality::callEqual(equal, center, data[g.target(*arc)], diff))
+            if(equal(center, data[g.target(*arc)]))
             {
                 currentIndex = regions.makeUnion(labels[g.target(*arc)], currentIndex);
             }
@@ -301,6 +365,18 @@ labelGraphWithBackground(GridGraph<N, DirectedTag> const & g,
     return count;
 }
 
+template <unsigned int N, class DirectedTag, class T1Map, class T2Map, class Equal>
+typename T2Map::value_type
+labelGraphWithBackground(GridGraph<N, DirectedTag> const & g,
+                         T1Map const & data,
+                         T2Map & labels,
+                         typename T1Map::value_type backgroundValue,
+                         Equal const & equal)
+{
+    return graph_detail::labelGridGraph(g, data, labels, true, backgroundValue, equal,
+                                        typename graph_detail::GridGraphLinearAccess<N, T1Map, T2Map>::type());
+}
+
 
 } // namespace lemon_graph
 
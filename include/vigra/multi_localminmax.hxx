@@ -44,6 +44,8 @@
 #include "multi_gridgraph.hxx"
 #include "multi_labeling.hxx"
 #include "metaprogramming.hxx"
+#include "threadpool.hxx"
+#include "union_find.hxx"
 
 namespace vigra {
 
@@ -65,7 +67,236 @@ namespace detail_local_minima{
         }
     }; 
 
-};
+    // translate LocalMinmaxOptions::neigh into a NeighborhoodType
+template <unsigned int N>
+NeighborhoodType
+neighborhoodType(int neigh, const char * message)
+{
+    if(neigh == 0 || neigh == 2*N)
+        return DirectNeighborhood;
+    if(neigh == 1 || neigh == MetaPow<3, N>::value - 1)
+        return IndirectNeighborhood;
+    vigra_precondition(false, message);
+    return DirectNeighborhood;
+}
+
+    // Call f(threadId, roiBegin, roiEnd) in parallel for all slabs 
+    // of thickness 1 along the last dimension.
+template <unsigned int N, class FUNCTOR>
+void
+foreachSlab(ThreadPool & pool, typename MultiArrayShape<N>::type const & shape, FUNCTOR && f)
+{
+    typedef typename MultiArrayShape<N>::type Shape;
+
+    parallel_foreach(pool, N > 1 ? shape[N-1] : 1,
+        [&](int threadId, MultiArrayIndex k)
+        {
+            Shape roiBegin, roiEnd(shape);
+            if(N > 1)
+            {
+                roiBegin[N-1] = k;
+                roiEnd[N-1] = k + 1;
+            }
+            f(threadId, roiBegin, roiEnd);
+        });
+}
+
+    // Mark the extrema among the nodes of 'g' in the box from 'roiBegin' to 'roiEnd'. 
+    // 'dest' covers only this box. Interior nodes are compared with their neighbors
+    // by means of the linear offsets 'srcOffsets', border nodes via neighbor iterators.
+template <unsigned int N, class DirectedTag, class T1Map, class T2, class S2, class Compare>
+unsigned int
+localMinMaxBox(GridGraph<N, DirectedTag> const & g,
+               T1Map const & src,
+               MultiArrayView<N, T2, S2> dest,
+               typename MultiArrayShape<N>::type const & roiBegin,
+               typename MultiArrayShape<N>::type const & roiEnd,
+               ArrayVector<MultiArrayIndex> const & srcOffsets,
+               T2 marker,
+               typename T1Map::value_type threshold,
+               Compare const & compare,
+               bool allowAtBorder)
+{
+    typedef GridGraph<N, DirectedTag>          Graph;
+    typedef typename Graph::OutArcIt           neighbor_iterator;
+    typedef typename Graph::shape_type         Shape;
+    typedef typename T1Map::value_type         T1;
+
+    const MultiArrayIndex srcStride = src.stride(0), destStride = dest.stride(0);
+    const unsigned int neighborCount = srcOffsets.size();
+    unsigned int count = 0;
+
+    scanlineTraversal(g, roiBegin, roiEnd, [&](Shape const & start, MultiArrayIndex length, bool interior)
+    {
+        // runs that are not interior consist of border nodes only
+        if(!interior && !allowAtBorder)
+            return;
+
+        T1 const * s = &src[start];
+        T2 * d = &dest[start - roiBegin];
+        Shape node(start);
+        for(MultiArrayIndex x = 0; x < length; ++x, ++node[0], s += srcStride, d += destStride)
+        {
+            const T1 current = *s;
+            if(!compare(current, threshold))
+                continue;
+
+            bool isExtremum = true;
+            if(interior)
+            {
+                for(unsigned int k = 0; k < neighborCount && isExtremum; ++k)
+                    isExtremum = compare(current, s[srcOffsets[k]]);
+            }
+            else
+            {
+                for(neighbor_iterator arc(g, node); arc != lemon::INVALID && isExtremum; ++arc)
+                    isExtremum = compare(current, src[g.target(*arc)]);
+            }
+            if(isExtremum)
+            {
+                *d = marker;
+                ++count;
+            }
+        }
+    });
+    return count;
+}
+
+#ifdef VIGRA_HAS_ATOMIC
+
+    // Parallel detection of extremal plateaus: the nodes of each plateau are 
+    // merged in a ConcurrentUnionFindArray over the node IDs. A plateau is
+    // an extremum until one of its nodes proves the opposite.
+template <unsigned int N, class DirectedTag, class T1Map, class T2Map, class Compare, class Equal>
+unsigned int
+extendedLocalMinMaxParallel(ThreadPool & pool,
+                            GridGraph<N, DirectedTag> const & g,
+                            T1Map const & src,
+                            T2Map & dest,
+                            typename T2Map::value_type marker,
+                            typename T1Map::value_type threshold,
+                            Compare const & compare,
+                            Equal const & equal,
+                            bool allowAtBorder)
+{
+    typedef GridGraph<N, DirectedTag>          Graph;
+    typedef typename Graph::OutArcIt           neighbor_iterator;
+    typedef typename Graph::OutBackArcIt       back_neighbor_iterator;
+    typedef typename Graph::shape_type         Shape;
+    typedef typename T1Map::value_type         T1;
+    typedef typename T2Map::value_type         T2;
+
+    vigra_precondition(g.nodeNum() <= (MultiArrayIndex)NumericTraits<UInt32>::max(),
+        "localMinMax(): plateau detection is limited to 2^32-1 nodes.");
+
+    ArrayVector<MultiArrayIndex> const & backIndices = (*g.neighborIndexArray(true))[0];
+    ArrayVector<MultiArrayIndex> srcOffsets(g.neighborStrideOffsets(src.stride())),
+                                 idOffsets(g.neighborStrideOffsets());
+    const MultiArrayIndex srcStride = src.stride(0), destStride = dest.stride(0);
+    const unsigned int neighborCount = srcOffsets.size();
+
+    ConcurrentUnionFindArray<UInt32> regions((UInt32)g.nodeNum());
+    std::vector<threading::atomic<unsigned char> > isExtremum((std::size_t)g.nodeNum());
+    std::vector<unsigned int> counts(std::max<std::size_t>(pool.nThreads(), 1), 0);
+
+    // pass 1: merge the nodes of each plateau
+    foreachSlab<N>(pool, g.shape(), [&](int, Shape const & roiBegin, Shape const & roiEnd)
+    {
+        scanlineTraversal(g, roiBegin, roiEnd, [&](Shape const & start, MultiArrayIndex length, bool interior)
+        {
+            T1 const * s = &src[start];
+            MultiArrayIndex id = g.id(start);
+            Shape node(start);
+            for(MultiArrayIndex x = 0; x < length; ++x, ++node[0], ++id, s += srcStride)
+            {
+                isExtremum[id].store(1, threading::memory_order_relaxed);
+                const T1 current = *s;
+                if(interior)
+                {
+                    for(unsigned int j = 0; j < backIndices.size(); ++j)
+                    {
+                        const MultiArrayIndex k = backIndices[j];
+                        if(labeling_equality::callEqual(equal, current, s[srcOffsets[k]], g.neighborOffset(k)))
+                            regions.makeUnion((UInt32)id, (UInt32)(id + idOffsets[k]));
+                    }
+                }
+                else
+                {
+                    for(back_neighbor_iterator arc(g, node); arc != lemon::INVALID; ++arc)
+                    {
+                        if(labeling_equality::callEqual(equal, current, src[g.target(*arc)], 
+                                                        g.neighborOffset(arc.neighborIndex())))
+                            regions.makeUnion((UInt32)id, (UInt32)g.id(g.target(*arc)));
+                    }
+                }
+            }
+        });
+    });
+
+    // pass 2: discard the plateaus that have a better neighbor, are at the
+    //         border, or fail the threshold
+    foreachSlab<N>(pool, g.shape(), [&](int, Shape const & roiBegin, Shape const & roiEnd)
+    {
+        scanlineTraversal(g, roiBegin, roiEnd, [&](Shape const & start, MultiArrayIndex length, bool interior)
+        {
+            T1 const * s = &src[start];
+            MultiArrayIndex id = g.id(start);
+            Shape node(start);
+            for(MultiArrayIndex x = 0; x < length; ++x, ++node[0], ++id, s += srcStride)
+            {
+                const UInt32 label = regions.findIndex((UInt32)id);
+                if(!isExtremum[label].load(threading::memory_order_relaxed))
+                    continue;
+
+                const T1 current = *s;
+                bool keep = compare(current, threshold) && (interior || allowAtBorder);
+                if(interior)
+                {
+                    for(unsigned int k = 0; k < neighborCount && keep; ++k)
+                        keep = !compare(s[srcOffsets[k]], current) || 
+                               regions.findIndex((UInt32)(id + idOffsets[k])) == label;
+                }
+                else
+                {
+                    for(neighbor_iterator arc(g, node); arc != lemon::INVALID && keep; ++arc)
+                        keep = !compare(src[g.target(*arc)], current) || 
+                               regions.findIndex((UInt32)g.id(g.target(*arc))) == label;
+                }
+                if(!keep)
+                    isExtremum[label].store(0, threading::memory_order_relaxed);
+            }
+        });
+    });
+
+    // pass 3: mark the extremal plateaus, and count them at their representative
+    foreachSlab<N>(pool, g.shape(), [&](int threadId, Shape const & roiBegin, Shape const & roiEnd)
+    {
+        scanlineTraversal(g, roiBegin, roiEnd, [&](Shape const & start, MultiArrayIndex length, bool)
+        {
+            T2 * d = &dest[start];
+            MultiArrayIndex id = g.id(start);
+            for(MultiArrayIndex x = 0; x < length; ++x, ++id, d += destStride)
+            {
+                const UInt32 label = regions.findIndex((UInt32)id);
+                if(isExtremum[label].load(threading::memory_order_relaxed))
+                {
+                    *d = marker;
+                    if(label == id)
+                        ++counts[threadId];
+                }
+            }
+        });
+    });
+
+    unsigned int count = 0;
+    for(unsigned int k = 0; k < counts.size(); ++k)
+        count += counts[k];
+    return count;
+}
+
+#endif // VIGRA_HAS_ATOMIC
+
+} // namespace detail_local_minima
 
 
 namespace boost_graph {
@@ -216,6 +447,114 @@ extendedLocalMinMaxGraph(Graph const &g,
     return count;
 }
 
+namespace graph_detail {
+
+    // arbitrary graphs and property maps: sequential search
+template <class Graph, class T1Map, class T2Map, class Compare, class Equal>
+unsigned int
+localMinMaxImpl(Graph const & g,
+                T1Map const & src,
+                T2Map & dest,
+                typename T2Map::value_type marker,
+                typename T1Map::value_type threshold,
+                Compare const & compare,
+                Equal const & equal,
+                bool allowAtBorder,
+                bool allowPlateaus,
+                int,
+                VigraFalseType)
+{
+    if(allowPlateaus)
+        return extendedLocalMinMaxGraph(g, src, dest, marker, threshold, 
+                                        compare, equal, allowAtBorder);
+    else
+        return localMinMaxGraph(g, src, dest, marker, threshold, compare, allowAtBorder);
+}
+
+    // GridGraph with MultiArrayView property maps: slabs are processed in parallel,
+    // and interior nodes with linear neighbor offsets
+template <unsigned int N, class DirectedTag, class T1Map, class T2Map, class Compare, class Equal>
+unsigned int
+localMinMaxImpl(GridGraph<N, DirectedTag> const & g,
+                T1Map const & src,
+                T2Map & dest,
+                typename T2Map::value_type marker,
+                typename T1Map::value_type threshold,
+                Compare const & compare,
+                Equal const & equal,
+                bool allowAtBorder,
+                bool allowPlateaus,
+                int numThreads,
+                VigraTrueType)
+{
+    typedef typename MultiArrayShape<N>::type Shape;
+
+    ThreadPool pool(numThreads);
+    if(allowPlateaus)
+#ifdef VIGRA_HAS_ATOMIC
+        return detail_local_minima::extendedLocalMinMaxParallel(pool, g, src, dest, marker, threshold, 
+                                                                compare, equal, allowAtBorder);
+#else
+        // the parallel plateau detection needs a lock-free union-find array
+        return extendedLocalMinMaxGraph(g, src, dest, marker, threshold, 
+                                        compare, equal, allowAtBorder);
+#endif
+
+    ArrayVector<MultiArrayIndex> srcOffsets(g.neighborStrideOffsets(src.stride()));
+    std::vector<unsigned int> counts(std::max<std::size_t>(pool.nThreads(), 1), 0);
+    detail_local_minima::foreachSlab<N>(pool, g.shape(), 
+        [&](int threadId, Shape const & roiBegin, Shape const & roiEnd)
+        {
+            counts[threadId] += detail_local_minima::localMinMaxBox(g, src, dest.subarray(roiBegin, roiEnd), 
+                                                                    roiBegin, roiEnd, srcOffsets, marker, 
+                                                                    threshold, compare, allowAtBorder);
+        });
+
+    unsigned int count = 0;
+    for(unsigned int k = 0; k < counts.size(); ++k)
+        count += counts[k];
+    return count;
+}
+
+    // Find the local extrema of 'src' (i.e. nodes that compare favorably to all their 
+    // neighbors, or plateaus thereof) and mark them in 'dest'. Returns the number of extrema.
+template <class Graph, class T1Map, class T2Map, class Compare, class Equal>
+inline unsigned int
+localMinMaxSelect(Graph const & g,
+                  T1Map const & src,
+                  T2Map & dest,
+                  typename T2Map::value_type marker,
+                  typename T1Map::value_type threshold,
+                  Compare const & compare,
+                  Equal const & equal,
+                  bool allowAtBorder,
+                  bool allowPlateaus,
+                  int numThreads = 0)
+{
+    return localMinMaxImpl(g, src, dest, marker, threshold, compare, equal, 
+                           allowAtBorder, allowPlateaus, numThreads, VigraFalseType());
+}
+
+template <unsigned int N, class DirectedTag, class T1Map, class T2Map, class Compare, class Equal>
+inline unsigned int
+localMinMaxSelect(GridGraph<N, DirectedTag> const & g,
+                  T1Map const & src,
+                  T2Map & dest,
+                  typename T2Map::value_type marker,
+                  typename T1Map::value_type threshold,
+                  Compare const & compare,
+                  Equal const & equal,
+                  bool allowAtBorder,
+                  bool allowPlateaus,
+                  int numThreads = 0)
+{
+    return localMinMaxImpl(g, src, dest, marker, threshold, compare, equal, 
+                           allowAtBorder, allowPlateaus, numThreads,
+                           typename GridGraphLinearAccess<N, T1Map, T2Map>::type());
+}
+
+} // namespace graph_detail
+
 } // namespace lemon_graph
 
 template <unsigned int N, class T1, class C1, 
@@ -233,25 +572,15 @@ localMinMax(MultiArrayView<N, T1, C1> const & src,
     vigra_precondition(src.shape() == dest.shape(),
         "localMinMax(): shape mismatch between input and output.");
         
-    NeighborhoodType neighborhood = DirectNeighborhood;
-    
-    if(options.neigh == 0 || options.neigh == 2*N)
-        neighborhood = DirectNeighborhood;
-    else if(options.neigh == 1 || options.neigh == MetaPow<3, N>::value - 1)
-        neighborhood = IndirectNeighborhood;
-    else
-        vigra_precondition(false,
-            "localMinMax(): option object specifies invalid neighborhood type.");
+    NeighborhoodType neighborhood = detail_local_minima::neighborhoodType<N>(options.neigh,
+        "localMinMax(): option object specifies invalid neighborhood type.");
     
     T2 marker = (T2)options.marker;
     
     GridGraph<N, undirected_tag> graph(src.shape(), neighborhood);
-    if(options.allow_plateaus)
-        return lemon_graph::extendedLocalMinMaxGraph(graph, src, dest, marker, threshold, 
-                                            compare, equal, options.allow_at_border);
-    else
-        return lemon_graph::localMinMaxGraph(graph, src, dest, marker, threshold, 
-                                             compare, options.allow_at_border);
+    return lemon_graph::graph_detail::localMinMaxSelect(graph, src, dest, marker, threshold, 
+                                                        compare, equal, options.allow_at_border, 
+                                                        options.allow_plateaus, options.num_threads);
 }
 
 /********************************************************/
@@ -401,8 +401,10 @@ multiBinaryDilation(MultiArrayView<N, T1, S1> const & source,
     The input is a grayscale multi-dimensional array.
     
     This function may work in-place, which means that <tt>siter == diter</tt> is allowed.
-    A full-sized internal array is only allocated if working on the destination
-    array directly would cause overflow errors (i.e. if
+    Since the erosion never increases a value, the result is computed directly in the
+    destination array when its value type equals the source value type or is a
+    floating-point type. Otherwise, a full-sized internal array is only allocated if
+    working on the destination array directly would cause overflow errors (i.e. if
     <tt> typeid(typename DestAccessor::value_type) < N * M*M</tt>, where M is the
     size of the largest dimension of the array.
            
@@ -487,8 +489,14 @@ multiGrayscaleErosion( SrcIterator s, SrcShape const & shape, SrcAccessor src,
     
     ArrayVector<double> sigmas(shape.size(), sigma);
     
-    // Allocate a new temporary array if the distances squared wouldn't fit
-    if(N*MaxDim*MaxDim > MaxValue)
+    // The eroded value never exceeds the input value at the same point. Thus, when
+    // the destination can represent all source values, the result is computed
+    // directly in the destination. Otherwise, allocate a new temporary array
+    // if the distances squared wouldn't fit.
+    typedef typename SrcAccessor::value_type SrcType;
+    bool writeDirectly = IsSameType<SrcType, DestType>::value ||
+                         !NumericTraits<DestType>::isIntegral::value;
+    if(!writeDirectly && N*MaxDim*MaxDim > MaxValue)
     {
         MultiArray<SrcShape::static_size, TmpType> tmpArray(shape);
 
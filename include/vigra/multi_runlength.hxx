@@ -0,0 +1,602 @@
+/************************************************************************/
+/*                                                                      */
+/*                Copyright 2026 by the VIGRA developers                */
+/*                                                                      */
+/*    This file is part of the VIGRA computer vision library.           */
+/*    The VIGRA Website is                                              */
+/*        http://hci.iwr.uni-heidelberg.de/vigra/                       */
+/*    Please direct questions, bug reports, and contributions to        */
+/*        ullrich.koethe@iwr.uni-heidelberg.de    or                    */
+/*        vigra@informatik.uni-hamburg.de                               */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+
+
+#ifndef VIGRA_MULTI_RUNLENGTH_HXX
+#define VIGRA_MULTI_RUNLENGTH_HXX
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "multi_array.hxx"
+#include "multi_shape.hxx"
+#include "array_vector.hxx"
+#include "tinyvector.hxx"
+
+namespace vigra {
+
+/** \addtogroup Labeling
+*/
+//@{
+
+/********************************************************/
+/*                                                      */
+/*                    RunLengthArray                    */
+/*                                                      */
+/********************************************************/
+
+/** \brief Run-length encoded N-dimensional array, mainly intended for label images.
+
+    <b>\#include</b> \<vigra/multi_runlength.hxx\><br>
+    Namespace: vigra
+
+    The array is stored as a sequence of runs in scan order, where each run
+    holds a value and the scan-order index and length of a maximal sequence of
+    equal values. Runs never cross a line boundary along dimension 0, so that
+    all elements of a run share the same coordinates in dimensions 1...N-1.
+    This makes it easy to derive geometric information directly from the runs.
+
+    Segmentation results typically consist of long runs of equal labels, so that
+    this representation needs only a fraction of the memory of a
+    \ref vigra::MultiArray. Label-only operations, such as relabeling
+    (see \ref relabel()), the computation of region sizes, bounding boxes
+    and centers (see \ref runLengthRegionGeometry()), or the construction of
+    a region adjacency graph (see \ref runLengthRegionAdjacency()), can be
+    carried out on the runs without ever expanding the array.
+
+    <b>Usage:</b>
+
+    \code
+    MultiArray<3, UInt32> labels(shape);
+    ... // compute a segmentation
+
+    RunLengthArray<3, UInt32> rle(labels);
+    std::cout << "compression ratio: "
+              << double(labels.size()) / rle.runCount() << "\n";
+
+    // merge regions 2 and 3
+    ArrayVector<UInt32> mapping(rle.maxValue() + 1);
+    for(unsigned k=0; k<mapping.size(); ++k)
+        mapping[k] = k;
+    mapping[3] = 2;
+    rle.relabel(mapping);
+
+    // back to a dense array
+    rle.copyTo(labels);
+    \endcode
+*/
+template <unsigned int N, class T>
+class RunLengthArray
+{
+  public:
+        /** the array's value type
+        */
+    typedef T value_type;
+
+        /** difference type (used for multi-dimensional offsets and indices)
+        */
+    typedef typename MultiArrayShape<N>::type shape_type;
+    typedef shape_type difference_type;
+
+        /** A single run: <tt>length</tt> consecutive elements starting at
+            scan-order index <tt>begin</tt> have value <tt>value</tt>.
+        */
+    struct Run
+    {
+        MultiArrayIndex begin;
+        MultiArrayIndex length;
+        T value;
+
+        MultiArrayIndex end() const
+        {
+            return begin + length;
+        }
+    };
+
+    typedef ArrayVector<Run> RunArray;
+
+        /** iterator over the runs, in scan order
+        */
+    typedef typename RunArray::const_iterator const_run_iterator;
+
+        /** Construct an empty array.
+        */
+    RunLengthArray()
+    : shape_()
+    , runs_()
+    {}
+
+        /** Construct an array of the given shape, where all elements
+            have value <tt>init</tt>.
+        */
+    explicit RunLengthArray(shape_type const & shape, T const & init = T())
+    : shape_()
+    , runs_()
+    {
+        reshape(shape, init);
+    }
+
+        /** Construct by compressing the given array.
+        */
+    template <class U, class S>
+    explicit RunLengthArray(MultiArrayView<N, U, S> const & array)
+    : shape_()
+    , runs_()
+    {
+        assign(array);
+    }
+
+        /** Reset the array to the given shape, where all elements
+            have value <tt>init</tt>.
+        */
+    void reshape(shape_type const & shape, T const & init = T())
+    {
+        shape_ = shape;
+        runs_.clear();
+        MultiArrayIndex line_length = shape_[0],
+                        size = prod(shape_);
+        for(MultiArrayIndex k=0; k < size; k += line_length)
+        {
+            Run run = { k, line_length, init };
+            runs_.push_back(run);
+        }
+    }
+
+        /** Replace the contents with a compressed copy of <tt>array</tt>.
+        */
+    template <class U, class S>
+    void assign(MultiArrayView<N, U, S> const & array)
+    {
+        shape_ = array.shape();
+        runs_.clear();
+
+        MultiArrayIndex line_length = shape_[0],
+                        index = 0;
+        typename MultiArrayView<N, U, S>::const_iterator i = array.begin(),
+                                                         end = array.end();
+        for(; i != end; ++index, ++i)
+        {
+            T value = detail::RequiresExplicitCast<T>::cast(*i);
+            if(index % line_length == 0 || runs_.back().value != value)
+            {
+                Run run = { index, 1, value };
+                runs_.push_back(run);
+            }
+            else
+            {
+                ++runs_.back().length;
+            }
+        }
+    }
+
+        /** Expand the runs into the given array, which must have the same shape.
+        */
+    template <class U, class S>
+    void copyTo(MultiArrayView<N, U, S> array) const
+    {
+        vigra_precondition(array.shape() == shape_,
+            "RunLengthArray::copyTo(): shape mismatch.");
+        typename MultiArrayView<N, U, S>::iterator d = array.begin();
+        for(const_run_iterator r = run_begin(); r != run_end(); ++r)
+        {
+            U value = detail::RequiresExplicitCast<U>::cast(r->value);
+            for(MultiArrayIndex k=0; k < r->length; ++k, ++d)
+                *d = value;
+        }
+    }
+
+        /** Replace each value <tt>v</tt> with <tt>mapping[v]</tt>.
+
+            Neighboring runs in the same line that end up with equal values
+            are merged. <tt>mapping</tt> can be any object supporting
+            <tt>operator[]</tt>, e.g. an ArrayVector or a std::vector.
+        */
+    template <class Mapping>
+    void relabel(Mapping const & mapping)
+    {
+        if(runs_.size() == 0)
+            return;
+        MultiArrayIndex line_length = shape_[0];
+        typename RunArray::iterator out = runs_.begin();
+        out->value = mapping[out->value];
+        for(typename RunArray::iterator r = out + 1; r != runs_.end(); ++r)
+        {
+            T value = mapping[r->value];
+            if(value == out->value && r->begin % line_length != 0)
+            {
+                out->length += r->length;
+            }
+            else
+            {
+                ++out;
+                out->begin = r->begin;
+                out->length = r->length;
+                out->value = value;
+            }
+        }
+        runs_.erase(out + 1, runs_.end());
+    }
+
+        /** Read the element at the given coordinate (O(log(runCount())) complexity).
+        */
+    T operator[](shape_type const & p) const
+    {
+        vigra_precondition(isInside(p),
+            "RunLengthArray::operator[]: coordinate outside the array.");
+        return findRun(detail::CoordinateToScanOrder<N>::exec(shape_, p))->value;
+    }
+
+        /** Scan-order coordinate of the first element of a run.
+        */
+    shape_type runStart(Run const & run) const
+    {
+        shape_type res(SkipInitialization);
+        detail::ScanOrderToCoordinate<N>::exec(run.begin, shape_, res);
+        return res;
+    }
+
+        /** Iterator to the first run.
+        */
+    const_run_iterator run_begin() const
+    {
+        return runs_.begin();
+    }
+
+        /** Iterator past the last run.
+        */
+    const_run_iterator run_end() const
+    {
+        return runs_.end();
+    }
+
+        /** Number of runs.
+        */
+    MultiArrayIndex runCount() const
+    {
+        return runs_.size();
+    }
+
+        /** Shape of the (expanded) array.
+        */
+    shape_type const & shape() const
+    {
+        return shape_;
+    }
+
+        /** Number of elements of the (expanded) array.
+        */
+    MultiArrayIndex size() const
+    {
+        return prod(shape_);
+    }
+
+        /** Check whether the given coordinate is inside the array.
+        */
+    bool isInside(shape_type const & p) const
+    {
+        return allLessEqual(shape_type(), p) && allLess(p, shape_);
+    }
+
+        /** The largest value of all runs (e.g. the largest label).
+        */
+    T maxValue() const
+    {
+        vigra_precondition(runs_.size() > 0,
+            "RunLengthArray::maxValue(): array is empty.");
+        T res = runs_[0].value;
+        for(const_run_iterator r = run_begin(); r != run_end(); ++r)
+            if(res < r->value)
+                res = r->value;
+        return res;
+    }
+
+    bool operator==(RunLengthArray const & other) const
+    {
+        if(shape_ != other.shape_ || runs_.size() != other.runs_.size())
+            return false;
+        for(unsigned int k=0; k < runs_.size(); ++k)
+            if(runs_[k].begin != other.runs_[k].begin ||
+               runs_[k].length != other.runs_[k].length ||
+               runs_[k].value != other.runs_[k].value)
+                return false;
+        return true;
+    }
+
+    bool operator!=(RunLengthArray const & other) const
+    {
+        return !operator==(other);
+    }
+
+  private:
+    const_run_iterator findRun(MultiArrayIndex index) const
+    {
+        // the last run starting at or before 'index'
+        const_run_iterator r = run_begin(), e = run_end();
+        MultiArrayIndex count = e - r;
+        while(count > 0)
+        {
+            MultiArrayIndex step = count / 2;
+            const_run_iterator m = r + step;
+            if(m->begin <= index)
+            {
+                r = m + 1;
+                count -= step + 1;
+            }
+            else
+            {
+                count = step;
+            }
+        }
+        return r - 1;
+    }
+
+    shape_type shape_;
+    RunArray runs_;
+};
+
+/********************************************************/
+/*                                                      */
+/*                runLengthRegionGeometry               */
+/*                                                      */
+/********************************************************/
+
+/** \brief Size, bounding box, and center of a region, as computed by \ref runLengthRegionGeometry().
+
+    <b>\#include</b> \<vigra/multi_runlength.hxx\><br>
+    Namespace: vigra
+*/
+template <unsigned int N>
+struct RunLengthRegionGeometry
+{
+    typedef typename MultiArrayShape<N>::type shape_type;
+
+        /** number of elements in the region (zero for unused labels)
+        */
+    MultiArrayIndex count;
+
+        /** upper left and lower right corner of the bounding box
+            (both inclusive, only valid when <tt>count > 0</tt>)
+        */
+    shape_type coordMin, coordMax;
+
+        /** sum of the coordinates of all elements
+        */
+    TinyVector<double, N> coordSum;
+
+    RunLengthRegionGeometry()
+    : count(0)
+    , coordMin(NumericTraits<MultiArrayIndex>::max())
+    , coordMax(NumericTraits<MultiArrayIndex>::min())
+    , coordSum()
+    {}
+
+        /** the region's center of mass
+        */
+    TinyVector<double, N> center() const
+    {
+        return coordSum / double(count);
+    }
+};
+
+/** \brief Compute size, bounding box, and center of all regions of a run-length encoded label array.
+
+    <b> Declaration:</b>
+
+    \code
+    namespace vigra {
+        template <unsigned int N, class T>
+        void
+        runLengthRegionGeometry(RunLengthArray<N, T> const & labels,
+                                ArrayVector<RunLengthRegionGeometry<N> > & regions);
+    }
+    \endcode
+
+    <tt>regions</tt> is resized to <tt>labels.maxValue()+1</tt>, and
+    <tt>regions[l]</tt> receives the statistics of all elements with label <tt>l</tt>.
+    Since each run lies in a single line, its contribution is computed in constant
+    time, so that the complexity is O(number of runs) rather than O(number of elements).
+
+    <b> Usage:</b>
+
+    <b>\#include</b> \<vigra/multi_runlength.hxx\><br>
+    Namespace: vigra
+
+    \code
+    RunLengthArray<3, UInt32> labels(dense_labels);
+
+    ArrayVector<RunLengthRegionGeometry<3> > regions;
+    runLengthRegionGeometry(labels, regions);
+
+    std::cout << "region 1 has " << regions[1].count << " voxels and its center is at "
+              << regions[1].center() << "\n";
+    \endcode
+*/
+template <unsigned int N, class T>
+void
+runLengthRegionGeometry(RunLengthArray<N, T> const & labels,
+                        ArrayVector<RunLengthRegionGeometry<N> > & regions)
+{
+    typedef typename RunLengthArray<N, T>::const_run_iterator RunIterator;
+    typedef typename MultiArrayShape<N>::type Shape;
+
+    regions.clear();
+    if(labels.runCount() == 0)
+        return;
+    regions.resize((std::size_t)labels.maxValue() + 1);
+
+    for(RunIterator r = labels.run_begin(); r != labels.run_end(); ++r)
+    {
+        RunLengthRegionGeometry<N> & region = regions[(std::size_t)r->value];
+        Shape start = labels.runStart(*r),
+              stop  = start;
+        stop[0] += r->length - 1;
+
+        region.count += r->length;
+        region.coordMin = min(region.coordMin, start);
+        region.coordMax = max(region.coordMax, stop);
+        for(unsigned int d=1; d < N; ++d)
+            region.coordSum[d] += double(start[d]) * r->length;
+        // sum of start[0], ..., stop[0]
+        region.coordSum[0] += 0.5 * double(start[0] + stop[0]) * r->length;
+    }
+}
+
+/********************************************************/
+/*                                                      */
+/*               runLengthRegionAdjacency               */
+/*                                                      */
+/********************************************************/
+
+/** \brief Find the pairs of adjacent regions in a run-length encoded label array.
+
+    <b> Declaration:</b>
+
+    \code
+    namespace vigra {
+        template <unsigned int N, class T>
+        void
+        runLengthRegionAdjacency(RunLengthArray<N, T> const & labels,
+                                 std::vector<std::pair<Int64, Int64> > & uvIds);
+    }
+    \endcode
+
+    On return, <tt>uvIds</tt> contains the label pairs <tt>(u, v)</tt> with <tt>u < v</tt>
+    of all regions that touch each other in the direct neighborhood (i.e. share a face),
+    in lexicographic order and without duplicates. This is exactly the form expected
+    by \ref StaticAdjacencyListGraph::assign(), and the pairs can equally be added
+    to an \ref AdjacencyListGraph one by one. The function thus replaces the pass
+    over the expanded array that \ref makeRegionAdjacencyGraph() would require.
+
+    Neighbors along dimension 0 are adjacent runs in the same line. Along dimensions
+    1...N-1, the runs of each line are merged with the runs of the preceding line in that
+    dimension, so that the complexity is O(N * number of runs) plus the final sort.
+
+    <b> Usage:</b>
+
+    <b>\#include</b> \<vigra/multi_runlength.hxx\><br>
+    Namespace: vigra
+
+    \code
+    RunLengthArray<3, UInt32> labels(dense_labels);
+
+    std::vector<std::pair<Int64, Int64> > uvIds;
+    runLengthRegionAdjacency(labels, uvIds);
+
+    ArrayVector<RunLengthRegionGeometry<3> > regions;
+    runLengthRegionGeometry(labels, regions);
+    std::vector<Int64> nodeIds;
+    for(unsigned int l = 0; l < regions.size(); ++l)
+        if(regions[l].count > 0)
+            nodeIds.push_back(l);
+
+    StaticAdjacencyListGraph rag;
+    rag.assign(nodeIds.begin(), nodeIds.end(), uvIds);
+    \endcode
+*/
+template <unsigned int N, class T>
+void
+runLengthRegionAdjacency(RunLengthArray<N, T> const & labels,
+                         std::vector<std::pair<Int64, Int64> > & uvIds)
+{
+    typedef typename RunLengthArray<N, T>::const_run_iterator RunIterator;
+    typedef typename MultiArrayShape<N>::type Shape;
+
+    uvIds.clear();
+    if(labels.runCount() == 0)
+        return;
+
+    Shape const & shape = labels.shape();
+    MultiArrayIndex line_length = shape[0],
+                    line_count  = labels.size() / line_length;
+
+    // runs of line k are lines[k], ..., lines[k+1]-1
+    ArrayVector<RunIterator> lines(line_count + 1);
+    RunIterator r = labels.run_begin();
+    for(MultiArrayIndex k=0; k < line_count; ++k)
+    {
+        lines[k] = r;
+        while(r != labels.run_end() && r->begin < (k + 1) * line_length)
+            ++r;
+    }
+    lines[line_count] = labels.run_end();
+
+    for(MultiArrayIndex k=0; k < line_count; ++k)
+    {
+        // neighbors along dimension 0
+        for(r = lines[k] + 1; r != lines[k+1]; ++r)
+        {
+            Int64 u = static_cast<Int64>((r-1)->value),
+                  v = static_cast<Int64>(r->value);
+            if(u != v)
+                uvIds.push_back(std::make_pair(std::min(u, v), std::max(u, v)));
+        }
+
+        // neighbors along dimension d: merge with the runs of the preceding line
+        MultiArrayIndex line_stride = 1;
+        for(unsigned int d=1; d < N; line_stride *= shape[d], ++d)
+        {
+            if((k / line_stride) % shape[d] == 0)
+                continue;
+            RunIterator a = lines[k],
+                        b = lines[k - line_stride];
+            MultiArrayIndex offset = line_stride * line_length;
+            while(a != lines[k+1] && b != lines[k - line_stride + 1])
+            {
+                Int64 u = static_cast<Int64>(a->value),
+                      v = static_cast<Int64>(b->value);
+                if(u != v)
+                    uvIds.push_back(std::make_pair(std::min(u, v), std::max(u, v)));
+                // advance the run that ends first (both, if they end together)
+                MultiArrayIndex a_end = a->end(),
+                                b_end = b->end() + offset;
+                if(a_end <= b_end)
+                    ++a;
+                if(b_end <= a_end)
+                    ++b;
+            }
+        }
+    }
+
+    std::sort(uvIds.begin(), uvIds.end());
+    uvIds.erase(std::unique(uvIds.begin(), uvIds.end()), uvIds.end());
+}
+
+//@}
+
+} // namespace vigra
+
+#endif // VIGRA_MULTI_RUNLENGTH_HXX
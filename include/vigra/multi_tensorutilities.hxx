@@ -42,6 +42,7 @@
 #include "metaprogramming.hxx"
 #include "multi_shape.hxx"
 #include "multi_pointoperators.hxx"
+#include "threadpool.hxx"
 
 namespace vigra {
 
@@ -179,6 +180,294 @@ public:
     }
 };
 
+/********************************************************/
+/*                                                      */
+/*        batched symmetric eigen-decomposition         */
+/*                                                      */
+/********************************************************/
+
+    /* Closed-form eigen-decomposition of up to BatchSize symmetric 2x2 or 3x3
+       matrices at once. The upper triangular elements are stored as a structure
+       of arrays (one array per tensor element), so that the loops over the lanes
+       have no dependencies and can be vectorized by the compiler. Eigenvalues are
+       sorted in descending order, eigenvector k is stored in ev[k*N+i], i < N,
+       and the eigenvectors form a right-handed orthonormal basis.
+    */
+template <int N, class Real>
+struct SymmetricEigenBatch;
+
+template <class Real>
+struct SymmetricEigenBatch<2, Real>
+{
+    enum { BatchSize = 64, TensorSize = 3 };
+
+    Real a[TensorSize][BatchSize];   // a00, a01, a11
+    Real ew[2][BatchSize];
+    Real ev[4][BatchSize];
+
+    void eigenvalues(int n)
+    {
+        Real const * a00 = a[0], * a01 = a[1], * a11 = a[2];
+        for(int i=0; i<n; ++i)
+        {
+            Real t = Real(0.5)*(a00[i] + a11[i]),
+                 d = std::sqrt(sq(Real(0.5)*(a00[i] - a11[i])) + sq(a01[i]));
+            ew[0][i] = t + d;
+            ew[1][i] = t - d;
+        }
+    }
+
+    void eigenvectors(int n)
+    {
+        // both rows of (A - ew0*I) are orthogonal to the first eigenvector,
+        // use the row with larger norm
+        Real const * a00 = a[0], * a01 = a[1], * a11 = a[2];
+        for(int i=0; i<n; ++i)
+        {
+            Real x0 = a01[i],            y0 = ew[0][i] - a00[i],
+                 x1 = ew[0][i] - a11[i], y1 = a01[i];
+            Real n0 = x0*x0 + y0*y0,
+                 n1 = x1*x1 + y1*y1;
+            Real x  = n0 > n1 ? x0 : x1,
+                 y  = n0 > n1 ? y0 : y1,
+                 nn = n0 > n1 ? n0 : n1;
+            Real s  = nn > Real(0.0) ? Real(1.0) / std::sqrt(nn) : Real(0.0);
+            x = nn > Real(0.0) ? x*s : Real(1.0);
+            y = y*s;
+            ev[0][i] = x;
+            ev[1][i] = y;
+            ev[2][i] = -y;
+            ev[3][i] = x;
+        }
+    }
+};
+
+template <class Real>
+struct SymmetricEigenBatch<3, Real>
+{
+    enum { BatchSize = 64, TensorSize = 6 };
+
+    Real a[TensorSize][BatchSize];   // a00, a01, a02, a11, a12, a22
+    Real ew[3][BatchSize];
+    Real ev[9][BatchSize];
+
+    void eigenvalues(int n)
+    {
+        // same formula as symmetric3x3Eigenvalues(), but without branches
+        Real const * a00 = a[0], * a01 = a[1], * a02 = a[2],
+                   * a11 = a[3], * a12 = a[4], * a22 = a[5];
+        Real inv3 = Real(1.0 / 3.0), root3 = std::sqrt(Real(3.0));
+        for(int i=0; i<n; ++i)
+        {
+            Real c0 = a00[i]*a11[i]*a22[i] + Real(2.0)*a01[i]*a02[i]*a12[i]
+                    - a00[i]*a12[i]*a12[i] - a11[i]*a02[i]*a02[i] - a22[i]*a01[i]*a01[i];
+            Real c1 = a00[i]*a11[i] - a01[i]*a01[i] + a00[i]*a22[i] - a02[i]*a02[i]
+                    + a11[i]*a22[i] - a12[i]*a12[i];
+            Real c2 = a00[i] + a11[i] + a22[i];
+            Real c2Div3 = c2*inv3;
+            Real aDiv3 = std::min(Real(0.0), (c1 - c2*c2Div3)*inv3);
+            Real mbDiv2 = Real(0.5)*(c0 + c2Div3*(Real(2.0)*c2Div3*c2Div3 - c1));
+            Real q = std::min(Real(0.0), mbDiv2*mbDiv2 + aDiv3*aDiv3*aDiv3);
+            Real magnitude = std::sqrt(-aDiv3);
+            Real angle = std::atan2(std::sqrt(-q), mbDiv2)*inv3;
+            Real cs = std::cos(angle);
+            Real sn = std::sin(angle);
+            Real r0 = c2Div3 + Real(2.0)*magnitude*cs;
+            Real r1 = c2Div3 - magnitude*(cs + root3*sn);
+            Real r2 = c2Div3 - magnitude*(cs - root3*sn);
+            ew[0][i] = std::max(r0, std::max(r1, r2));
+            ew[1][i] = std::max(std::min(r0, r1), std::min(std::max(r0, r1), r2));
+            ew[2][i] = std::min(r0, std::min(r1, r2));
+        }
+    }
+
+    void eigenvectors(int n)
+    {
+        for(int i=0; i<n; ++i)
+        {
+            Real A[TensorSize] = { a[0][i], a[1][i], a[2][i], a[3][i], a[4][i], a[5][i] };
+            Real scale = std::max(std::abs(ew[0][i]), std::abs(ew[2][i]));
+            TinyVector<Real, 3> v0, v1, v2;
+            bool ok0 = eigenvector(A, ew[0][i], scale, v0),
+                 ok2 = eigenvector(A, ew[2][i], scale, v2);
+            if(ok0 && ok2)
+            {
+                v2 -= dot(v2, v0)*v0;
+                v2 /= norm(v2);
+                v1 = cross(v2, v0);
+            }
+            else if(ok0)
+            {
+                // ew1 == ew2: any basis of the orthogonal complement of v0 will do
+                v1 = orthogonalVector(v0);
+                v2 = cross(v0, v1);
+            }
+            else if(ok2)
+            {
+                // ew0 == ew1
+                v0 = orthogonalVector(v2);
+                v1 = cross(v2, v0);
+            }
+            else
+            {
+                // A is a multiple of the identity
+                v0 = TinyVector<Real, 3>(1.0, 0.0, 0.0);
+                v1 = TinyVector<Real, 3>(0.0, 1.0, 0.0);
+                v2 = TinyVector<Real, 3>(0.0, 0.0, 1.0);
+            }
+            for(int k=0; k<3; ++k)
+            {
+                ev[k][i]   = v0[k];
+                ev[3+k][i] = v1[k];
+                ev[6+k][i] = v2[k];
+            }
+        }
+    }
+
+        // The eigenvector is orthogonal to all rows of (A - ew*I). Take the cross
+        // product of two rows with maximal norm, fail when ew is (nearly) degenerate.
+    static bool eigenvector(Real const * A, Real ew, Real scale, TinyVector<Real, 3> & v)
+    {
+        TinyVector<Real, 3> r0(A[0] - ew, A[1], A[2]),
+                            r1(A[1], A[3] - ew, A[4]),
+                            r2(A[2], A[4], A[5] - ew);
+        TinyVector<Real, 3> c[3] = { cross(r0, r1), cross(r0, r2), cross(r1, r2) };
+        Real nn[3] = { squaredNorm(c[0]), squaredNorm(c[1]), squaredNorm(c[2]) };
+        int best = nn[0] >= nn[1]
+                       ? (nn[0] >= nn[2] ? 0 : 2)
+                       : (nn[1] >= nn[2] ? 1 : 2);
+        Real tolerance = Real(64.0)*NumericTraits<Real>::epsilon()*sq(scale);
+        if(scale == Real(0.0) || nn[best] <= sq(tolerance))
+            return false;
+        v = c[best] / std::sqrt(nn[best]);
+        return true;
+    }
+
+    static TinyVector<Real, 3> orthogonalVector(TinyVector<Real, 3> const & v)
+    {
+        // cross product with the coordinate axis that is least aligned with v
+        TinyVector<Real, 3> axis(0.0, 0.0, 0.0);
+        int k = std::abs(v[0]) <= std::abs(v[1])
+                    ? (std::abs(v[0]) <= std::abs(v[2]) ? 0 : 2)
+                    : (std::abs(v[1]) <= std::abs(v[2]) ? 1 : 2);
+        axis[k] = 1.0;
+        TinyVector<Real, 3> res = cross(v, axis);
+        return res / norm(res);
+    }
+};
+
+    /* Gather the tensors of every line along dimension 0 into batches, compute
+       their eigenvalues (and eigenvectors, if requested), and pass each batch to
+       'scatter(batch, start, n)', where 'start' is the coordinate of the batch's
+       first element and 'n' the number of valid lanes. Lines are distributed over
+       the threads, and each thread uses a batch on its own stack.
+    */
+template <class Batch, unsigned int N, class T1, class S1, class Scatter>
+void
+tensorEigenBatches(MultiArrayView<N, T1, S1> const & src, bool withEigenvectors,
+                   ParallelOptions const & options, Scatter scatter)
+{
+    typedef typename MultiArrayShape<N>::type Shape;
+
+    Shape line_starts(src.shape());
+    line_starts[0] = 1;
+    MultiArrayIndex width = src.shape(0), stride = src.stride(0);
+
+    ThreadPool pool(options);
+    parallel_foreach(pool, prod(line_starts),
+        [&](const int /* thread_id */, const MultiArrayIndex k)
+        {
+            Batch batch;
+            Shape start(SkipInitialization);
+            ScanOrderToCoordinate<N>::exec(k, line_starts, start);
+            T1 const * line = src.data() + dot(start, src.stride());
+            for(MultiArrayIndex x = 0; x < width; x += Batch::BatchSize)
+            {
+                int n = (int)std::min<MultiArrayIndex>(Batch::BatchSize, width - x);
+                for(int i=0; i<n; ++i)
+                    for(int c=0; c<Batch::TensorSize; ++c)
+                        batch.a[c][i] = line[(x+i)*stride][c];
+                batch.eigenvalues(n);
+                if(withEigenvectors)
+                    batch.eigenvectors(n);
+                start[0] = x;
+                scatter(batch, start, n);
+            }
+        }
+    );
+}
+
+    /* The 2x2 case is computed in the source's real type, the 3x3 case always
+       in double precision because the cubic formula is prone to cancellation.
+    */
+template <int N, class T>
+struct SymmetricEigenBatchType
+{
+    typedef typename NumericTraits<T>::RealPromote Real;
+    typedef SymmetricEigenBatch<N, typename IfBool<N == 2, Real, double>::type> type;
+};
+
+template <unsigned int N, class T1, class S1, class T2, class S2>
+void
+tensorEigenvaluesBatched(MultiArrayView<N, T1, S1> const & src,
+                         MultiArrayView<N, T2, S2> ew,
+                         ParallelOptions const & options)
+{
+    typedef typename SymmetricEigenBatchType<N, typename T1::value_type>::type Batch;
+    typedef typename T2::value_type DestValue;
+    typedef typename MultiArrayShape<N>::type Shape;
+
+    vigra_precondition(Batch::TensorSize == (int)T1::static_size,
+        "tensorEigenvaluesMultiArray(): Wrong number of channels in input array.");
+    vigra_precondition(N == (unsigned int)T2::static_size,
+        "tensorEigenvaluesMultiArray(): Wrong number of channels in output array.");
+
+    MultiArrayIndex stride = ew.stride(0);
+    tensorEigenBatches<Batch>(src, false, options,
+        [&](Batch const & batch, Shape const & start, int n)
+        {
+            T2 * d = ew.data() + dot(start, ew.stride());
+            for(int i=0; i<n; ++i)
+                for(unsigned int k=0; k<N; ++k)
+                    d[i*stride][k] = RequiresExplicitCast<DestValue>::cast(batch.ew[k][i]);
+        }
+    );
+}
+
+template <unsigned int N, class T1, class S1, class T2, class S2, class T3, class S3>
+void
+tensorEigensystemBatched(MultiArrayView<N, T1, S1> const & src,
+                         MultiArrayView<N, T2, S2> ew,
+                         MultiArrayView<N, T3, S3> ev,
+                         ParallelOptions const & options)
+{
+    typedef typename SymmetricEigenBatchType<N, typename T1::value_type>::type Batch;
+    typedef typename T2::value_type EwValue;
+    typedef typename T3::value_type EvValue;
+    typedef typename MultiArrayShape<N>::type Shape;
+
+    vigra_precondition(Batch::TensorSize == (int)T1::static_size,
+        "tensorEigensystemMultiArray(): Wrong number of channels in input array.");
+    vigra_precondition(N == (unsigned int)T2::static_size && N*N == (unsigned int)T3::static_size,
+        "tensorEigensystemMultiArray(): Wrong number of channels in output array.");
+
+    MultiArrayIndex ew_stride = ew.stride(0), ev_stride = ev.stride(0);
+    tensorEigenBatches<Batch>(src, true, options,
+        [&](Batch const & batch, Shape const & start, int n)
+        {
+            T2 * d = ew.data() + dot(start, ew.stride());
+            T3 * v = ev.data() + dot(start, ev.stride());
+            for(int i=0; i<n; ++i)
+            {
+                for(unsigned int k=0; k<N; ++k)
+                    d[i*ew_stride][k] = RequiresExplicitCast<EwValue>::cast(batch.ew[k][i]);
+                for(unsigned int k=0; k<N*N; ++k)
+                    v[i*ev_stride][k] = RequiresExplicitCast<EvValue>::cast(batch.ev[k][i]);
+            }
+        }
+    );
+}
+
 } // namespace detail
 
 
@@ -417,9 +706,15 @@ tensorTraceMultiArray(MultiArrayView<N, T1, S1> const & source,
     This function turns a N-D tensor (whose value_type is a vector of length N*(N+1)/2, 
     see \ref vectorToTensorMultiArray()) representing the upper triangular part of a 
     symmetric tensor into a vector-valued array holding the tensor eigenvalues (thus,
-    the destination value_type must be vectors of length N).
+    the destination value_type must be vectors of length N). The eigenvalues are
+    sorted in descending order.
     
     Currently, <tt>N <= 3</tt> is required.
+
+    For array views with <tt>N == 2</tt> or <tt>N == 3</tt>, the eigenvalues are computed
+    by closed-form formulas on batches of tensors. If <tt>options</tt> are passed,
+    lines of the array are distributed over the requested number of threads.
+    Use \ref tensorEigensystemMultiArray() to compute the eigenvectors as well.
     
     <b> Declarations:</b>
 
@@ -431,6 +726,14 @@ tensorTraceMultiArray(MultiArrayView<N, T1, S1> const & source,
         void 
         tensorEigenvaluesMultiArray(MultiArrayView<N, T1, S1> const & source,
                                     MultiArrayView<N, T2, S2> dest);
+
+        // parallel version
+        template <unsigned int N, class T1, class S1,
+                                  class T2, class S2>
+        void 
+        tensorEigenvaluesMultiArray(MultiArrayView<N, T1, S1> const & source,
+                                    MultiArrayView<N, T2, S2> dest,
+                                    ParallelOptions const & options);
     }
     \endcode
 
@@ -511,15 +814,145 @@ tensorEigenvaluesMultiArray(triple<SrcIterator, SrcShape, SrcAccessor> s,
     tensorEigenvaluesMultiArray(s.first, s.second, s.third, d.first, d.second);
 }
 
+namespace detail {
+
+template <unsigned int N, class T1, class S1,
+                          class T2, class S2, int K>
+inline void
+tensorEigenvaluesImpl(MultiArrayView<N, T1, S1> const & source,
+                      MultiArrayView<N, T2, S2> dest,
+                      ParallelOptions const &, MetaInt<K>)
+{
+    tensorEigenvaluesMultiArray(srcMultiArrayRange(source), destMultiArray(dest));
+}
+
+template <unsigned int N, class T1, class S1,
+                          class T2, class S2>
+inline void
+tensorEigenvaluesImpl(MultiArrayView<N, T1, S1> const & source,
+                      MultiArrayView<N, T2, S2> dest,
+                      ParallelOptions const & options, MetaInt<2>)
+{
+    tensorEigenvaluesBatched(source, dest, options);
+}
+
+template <unsigned int N, class T1, class S1,
+                          class T2, class S2>
+inline void
+tensorEigenvaluesImpl(MultiArrayView<N, T1, S1> const & source,
+                      MultiArrayView<N, T2, S2> dest,
+                      ParallelOptions const & options, MetaInt<3>)
+{
+    tensorEigenvaluesBatched(source, dest, options);
+}
+
+} // namespace detail
+
 template <unsigned int N, class T1, class S1,
                           class T2, class S2>
 inline void 
 tensorEigenvaluesMultiArray(MultiArrayView<N, T1, S1> const & source,
-                            MultiArrayView<N, T2, S2> dest)
+                            MultiArrayView<N, T2, S2> dest,
+                            ParallelOptions const & options)
 {
     vigra_precondition(source.shape() == dest.shape(),
         "tensorEigenvaluesMultiArray(): shape mismatch between input and output.");
-    tensorEigenvaluesMultiArray(srcMultiArrayRange(source), destMultiArray(dest));
+    detail::tensorEigenvaluesImpl(source, dest, options, MetaInt<N>());
+}
+
+template <unsigned int N, class T1, class S1,
+                          class T2, class S2>
+inline void 
+tensorEigenvaluesMultiArray(MultiArrayView<N, T1, S1> const & source,
+                            MultiArrayView<N, T2, S2> dest)
+{
+    tensorEigenvaluesMultiArray(source, dest, ParallelOptions().numThreads(ParallelOptions::NoThreads));
+}
+
+/********************************************************/
+/*                                                      */
+/*             tensorEigensystemMultiArray              */
+/*                                                      */
+/********************************************************/
+
+/** \brief Calculate the tensor eigenvalues and eigenvectors for every element of a N-D tensor array.
+
+    This function works like \ref tensorEigenvaluesMultiArray(), but additionally
+    returns the eigenvectors. The value_type of the eigenvector array must be a
+    vector of length N*N, where the elements <tt>[k*N, ..., k*N+N-1]</tt> hold the
+    unit eigenvector of the k-th eigenvalue (eigenvalues are sorted in descending order).
+    The eigenvectors form a right-handed orthonormal basis. When eigenvalues coincide,
+    an arbitrary orthonormal basis of the corresponding eigenspace is returned.
+
+    The eigen-decomposition uses closed-form formulas on batches of tensors. If 
+    <tt>options</tt> are passed, lines of the array are distributed over the requested 
+    number of threads.
+
+    Currently, <tt>N == 2</tt> or <tt>N == 3</tt> is required.
+
+    <b> Declarations:</b>
+
+    \code
+    namespace vigra {
+        template <unsigned int N, class T1, class S1,
+                                  class T2, class S2,
+                                  class T3, class S3>
+        void
+        tensorEigensystemMultiArray(MultiArrayView<N, T1, S1> const & source,
+                                    MultiArrayView<N, T2, S2> eigenvalues,
+                                    MultiArrayView<N, T3, S3> eigenvectors);
+
+        // parallel version
+        template <unsigned int N, class T1, class S1,
+                                  class T2, class S2,
+                                  class T3, class S3>
+        void
+        tensorEigensystemMultiArray(MultiArrayView<N, T1, S1> const & source,
+                                    MultiArrayView<N, T2, S2> eigenvalues,
+                                    MultiArrayView<N, T3, S3> eigenvectors,
+                                    ParallelOptions const & options);
+    }
+    \endcode
+
+    <b> Usage:</b>
+
+    <b>\#include</b> \<vigra/multi_tensorutilities.hxx\><br/>
+    Namespace: vigra
+
+    \code
+    MultiArray<3, float>                  vol(shape);
+    MultiArray<3, TinyVector<float, 6> >  hessian(shape);
+    MultiArray<3, TinyVector<float, 3> >  eigenvalues(shape);
+    MultiArray<3, TinyVector<float, 9> >  eigenvectors(shape);
+
+    hessianOfGaussianMultiArray(vol, hessian, 2.0);
+    tensorEigensystemMultiArray(hessian, eigenvalues, eigenvectors);
+    \endcode
+*/
+template <unsigned int N, class T1, class S1,
+                          class T2, class S2,
+                          class T3, class S3>
+void
+tensorEigensystemMultiArray(MultiArrayView<N, T1, S1> const & source,
+                            MultiArrayView<N, T2, S2> eigenvalues,
+                            MultiArrayView<N, T3, S3> eigenvectors,
+                            ParallelOptions const & options)
+{
+    vigra_precondition(source.shape() == eigenvalues.shape() && source.shape() == eigenvectors.shape(),
+        "tensorEigensystemMultiArray(): shape mismatch between input and output.");
+    detail::tensorEigensystemBatched(source, eigenvalues, eigenvectors, options);
+}
+
+template <unsigned int N, class T1, class S1,
+                          class T2, class S2,
+                          class T3, class S3>
+inline void
+tensorEigensystemMultiArray(MultiArrayView<N, T1, S1> const & source,
+                            MultiArrayView<N, T2, S2> eigenvalues,
+                            MultiArrayView<N, T3, S3> eigenvectors)
+{
+    tensorEigensystemMultiArray(source, eigenvalues, eigenvectors, 
+                                ParallelOptions().numThreads(ParallelOptions::NoThreads));
 }
 
 /********************************************************/
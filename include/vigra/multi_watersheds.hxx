@@ -36,8 +36,10 @@
 #ifndef VIGRA_MULTI_WATERSHEDS_HXX
 #define VIGRA_MULTI_WATERSHEDS_HXX
 
+#include <algorithm>
 #include <functional>
 #include <limits>
+#include <vector>
 #include "mathutil.hxx"
 #include "multi_array.hxx"
 #include "multi_math.hxx"
@@ -46,7 +48,9 @@
 #include "multi_labeling.hxx"
 #include "watersheds.hxx"
 #include "bucket_queue.hxx"
+#include "priority_queue.hxx"
 #include "union_find.hxx"
+#include "threadpool.hxx"
 
 namespace vigra {
 
@@ -111,7 +115,8 @@ template <class Graph, class T1Map, class T2Map>
 void
 prepareWatersheds(Graph const & g,
                   T1Map const & data,
-                  T2Map & lowestNeighborIndex)
+                  T2Map & lowestNeighborIndex,
+                  VigraFalseType)
 {
     typedef typename Graph::NodeIt    graph_scanner;
     typedef typename Graph::OutArcIt  neighbor_iterator;
@@ -136,11 +141,12 @@ prepareWatersheds(Graph const & g,
 
 
 template <class Graph, class T1Map, class T2Map, class T3Map>
-typename T2Map::value_type
+typename T3Map::value_type
 unionFindWatersheds(Graph const & g,
                     T1Map const &,
                     T2Map const & lowestNeighborIndex,
-                    T3Map & labels)
+                    T3Map & labels,
+                    VigraFalseType)
 {
     typedef typename Graph::NodeIt       graph_scanner;
     typedef typename Graph::OutBackArcIt neighbor_iterator;
@@ -181,6 +187,180 @@ unionFindWatersheds(Graph const & g,
     return count;
 }
 
+    // GridGraph with MultiArrayView property maps: 
+    // interior nodes are processed with linear neighbor offsets
+template <unsigned int N, class DirectedTag, class T1Map, class T2Map>
+void
+prepareWatersheds(GridGraph<N, DirectedTag> const & g,
+                  T1Map const & data,
+                  T2Map & lowestNeighborIndex,
+                  VigraTrueType)
+{
+    typedef GridGraph<N, DirectedTag>      Graph;
+    typedef typename Graph::shape_type     Shape;
+    typedef typename Graph::OutArcIt       neighbor_iterator;
+    typedef typename T1Map::value_type     DataType;
+    typedef typename T2Map::value_type     IndexType;
+    typedef NeighborIndexFunctor<Graph>    IndexFunctor;
+
+    ArrayVector<MultiArrayIndex> dataOffsets(g.neighborStrideOffsets(data.stride()));
+    const MultiArrayIndex dataStride = data.stride(0), indexStride = lowestNeighborIndex.stride(0);
+
+    scanlineTraversal(g, [&](Shape const & start, MultiArrayIndex length, bool interior)
+    {
+        DataType const * d = &data[start];
+        IndexType * i = &lowestNeighborIndex[start];
+        Shape node(start);
+        for(MultiArrayIndex x = 0; x < length; ++x, ++node[0], d += dataStride, i += indexStride)
+        {
+            DataType lowestValue  = *d;
+            IndexType lowestIndex = IndexFunctor::invalidIndex(g);
+
+            if(interior)
+            {
+                for(unsigned int k = 0; k < dataOffsets.size(); ++k)
+                {
+                    if(d[dataOffsets[k]] < lowestValue)
+                    {
+                        lowestValue = d[dataOffsets[k]];
+                        lowestIndex = k;
+                    }
+                }
+            }
+            else
+            {
+                for(neighbor_iterator arc(g, node); arc != INVALID; ++arc)
+                {
+                    if(data[g.target(*arc)] < lowestValue)
+                    {
+                        lowestValue = data[g.target(*arc)];
+                        lowestIndex = arc.neighborIndex();
+                    }
+                }
+            }
+            *i = lowestIndex;
+        }
+    });
+}
+
+template <class Graph, class T1Map, class T2Map>
+void
+prepareWatersheds(Graph const & g,
+                  T1Map const & data,
+                  T2Map & lowestNeighborIndex)
+{
+    prepareWatersheds(g, data, lowestNeighborIndex, VigraFalseType());
+}
+
+template <unsigned int N, class DirectedTag, class T1Map, class T2Map>
+void
+prepareWatersheds(GridGraph<N, DirectedTag> const & g,
+                  T1Map const & data,
+                  T2Map & lowestNeighborIndex)
+{
+    prepareWatersheds(g, data, lowestNeighborIndex, 
+                      typename GridGraphLinearAccess<N, T1Map, T2Map>::type());
+}
+
+template <unsigned int N, class DirectedTag, class T1Map, class T2Map, class T3Map>
+typename T3Map::value_type
+unionFindWatersheds(GridGraph<N, DirectedTag> const & g,
+                    T1Map const &,
+                    T2Map const & lowestNeighborIndex,
+                    T3Map & labels,
+                    VigraTrueType)
+{
+    typedef GridGraph<N, DirectedTag>      Graph;
+    typedef typename Graph::shape_type     Shape;
+    typedef typename Graph::OutBackArcIt   neighbor_iterator;
+    typedef typename T2Map::value_type     IndexType;
+    typedef typename T3Map::value_type     LabelType;
+    typedef NeighborIndexFunctor<Graph>    IndexFunctor;
+
+    ArrayVector<MultiArrayIndex> const & backIndices = (*g.neighborIndexArray(true))[0];
+    ArrayVector<MultiArrayIndex> indexOffsets(g.neighborStrideOffsets(lowestNeighborIndex.stride())),
+                                 labelOffsets(g.neighborStrideOffsets(labels.stride()));
+    const MultiArrayIndex indexStride = lowestNeighborIndex.stride(0), labelStride = labels.stride(0);
+    const IndexType invalidIndex = IndexFunctor::invalidIndex(g);
+
+    vigra::UnionFindArray<LabelType>  regions;
+
+    // pass 1: find connected components
+    scanlineTraversal(g, [&](Shape const & start, MultiArrayIndex length, bool interior)
+    {
+        IndexType const * i = &lowestNeighborIndex[start];
+        LabelType * l = &labels[start];
+        Shape node(start);
+        for(MultiArrayIndex x = 0; x < length; ++x, ++node[0], i += indexStride, l += labelStride)
+        {
+            // define tentative label for current node
+            LabelType currentIndex = regions.nextFreeIndex();
+
+            if(interior)
+            {
+                for(unsigned int j = 0; j < backIndices.size(); ++j)
+                {
+                    // merge regions if current target is center's lowest neighbor or vice versa
+                    const MultiArrayIndex k = backIndices[j];
+                    const IndexType targetIndex = i[indexOffsets[k]];
+                    if((*i == invalidIndex && targetIndex == invalidIndex) ||
+                       (*i == k) || (targetIndex == g.oppositeIndex(k)))
+                    {
+                        currentIndex = regions.makeUnion(l[labelOffsets[k]], currentIndex);
+                    }
+                }
+            }
+            else
+            {
+                for (neighbor_iterator arc(g, node); arc != INVALID; ++arc)
+                {
+                    const IndexType targetIndex = lowestNeighborIndex[g.target(*arc)];
+                    if((*i == invalidIndex && targetIndex == invalidIndex) ||
+                       (*i == arc.neighborIndex()) || (targetIndex == g.oppositeIndex(arc.neighborIndex())))
+                    {
+                        currentIndex = regions.makeUnion(labels[g.target(*arc)], currentIndex);
+                    }
+                }
+            }
+
+            // set label of current node
+            *l = regions.finalizeIndex(currentIndex);
+        }
+    });
+
+    LabelType count = regions.makeContiguous();
+
+    // pass 2: make component labels contiguous
+    scanlineTraversal(g, [&](Shape const & start, MultiArrayIndex length, bool)
+    {
+        LabelType * l = &labels[start];
+        for(MultiArrayIndex x = 0; x < length; ++x, l += labelStride)
+            *l = regions.findLabel(*l);
+    });
+    return count;
+}
+
+template <class Graph, class T1Map, class T2Map, class T3Map>
+typename T3Map::value_type
+unionFindWatersheds(Graph const & g,
+                    T1Map const & data,
+                    T2Map const & lowestNeighborIndex,
+                    T3Map & labels)
+{
+    return unionFindWatersheds(g, data, lowestNeighborIndex, labels, VigraFalseType());
+}
+
+template <unsigned int N, class DirectedTag, class T1Map, class T2Map, class T3Map>
+typename T3Map::value_type
+unionFindWatersheds(GridGraph<N, DirectedTag> const & g,
+                    T1Map const & data,
+                    T2Map const & lowestNeighborIndex,
+                    T3Map & labels)
+{
+    return unionFindWatersheds(g, data, lowestNeighborIndex, labels, 
+                               typename GridGraphLinearAccess<N, T2Map, T3Map>::type());
+}
+
 template <class Graph, class T1Map, class T2Map>
 typename T2Map::value_type
 generateWatershedSeeds(Graph const & g,
@@ -209,12 +389,9 @@ generateWatershedSeeds(Graph const & g,
                                 ? options.thresh
                                 : NumericTraits<DataType>::max();
 
-        if(options.mini == SeedOptions::ExtendedMinima)
-            extendedLocalMinMaxGraph(g, data, minima, MarkerType(1), threshold,
-                                     std::less<DataType>(), std::equal_to<DataType>(), true);
-        else
-            lemon_graph::localMinMaxGraph(g, data, minima, MarkerType(1), threshold,
-                             std::less<DataType>(), true);
+        localMinMaxSelect(g, data, minima, MarkerType(1), threshold,
+                          std::less<DataType>(), std::equal_to<DataType>(), true,
+                          options.mini == SeedOptions::ExtendedMinima, options.num_threads);
     }
     return labelGraphWithBackground(g, minima, seeds, MarkerType(0), std::equal_to<MarkerType>());
 }
@@ -224,20 +401,23 @@ generateWatershedSeeds(Graph const & g,
 #pragma GCC diagnostic ignored "-Wsign-compare"
 #endif
 
-template <class Graph, class T1Map, class T2Map>
+    // region growing with an arbitrary ascending priority queue of nodes
+template <class Graph, class T1Map, class T2Map, class QUEUE>
 typename T2Map::value_type
 seededWatersheds(Graph const & g,
                  T1Map const & data,
                  T2Map & labels,
-                 WatershedOptions const & options)
+                 WatershedOptions const & options,
+                 QUEUE & pqueue)
 {
     typedef typename Graph::Node        Node;
+    typedef typename Graph::Edge        Edge;
     typedef typename Graph::NodeIt      graph_scanner;
     typedef typename Graph::OutArcIt    neighbor_iterator;
     typedef typename T1Map::value_type  CostType;
     typedef typename T2Map::value_type  LabelType;
 
-    PriorityQueue<Node, CostType, true> pqueue;
+    OutArcVisitor<Graph> visitNeighbors(g);
 
     bool keepContours = ((options.terminate & KeepContours) != 0);
     LabelType maxRegionLabel = 0;
@@ -283,30 +463,30 @@ seededWatersheds(Graph const & g,
             continue;
 
         // Put the unlabeled neighbors in the priority queue.
-        for (neighbor_iterator arc(g, node); arc != INVALID; ++arc)
+        visitNeighbors(node, g.id(node), [&](Node const & target, Int64, Edge const &)
         {
-            LabelType neighborLabel = labels[g.target(*arc)];
+            LabelType neighborLabel = labels[target];
             if(neighborLabel == 0)
             {
-                labels[g.target(*arc)] = label;
+                labels[target] = label;
                 CostType priority = (label == options.biased_label)
-                                       ? data[g.target(*arc)] * options.bias
-                                       : data[g.target(*arc)];
+                                       ? data[target] * options.bias
+                                       : data[target];
                 if(priority < cost)
                     priority = cost;
-                pqueue.push(g.target(*arc), priority);
+                pqueue.push(target, priority);
             }
             else if(keepContours && (label != neighborLabel) && (neighborLabel != contourLabel))
             {
                 // The present neighbor is adjacent to more than one region
                 // => mark it as contour.
                 CostType priority = (neighborLabel == options.biased_label)
-                                       ? data[g.target(*arc)] * options.bias
-                                       : data[g.target(*arc)];
+                                       ? data[target] * options.bias
+                                       : data[target];
                 if(cost < priority) // neighbor not yet processed
-                    labels[g.target(*arc)] = contourLabel;
+                    labels[target] = contourLabel;
             }
-        }
+        });
     }
 
     if(keepContours)
@@ -327,6 +507,723 @@ seededWatersheds(Graph const & g,
     return maxRegionLabel;
 }
 
+    // Cost of a pixel in the linear region growing, when no per-seed state is needed.
+template <unsigned int N, class CostType, class LabelType>
+class WatershedLinearCost
+{
+  public:
+    typedef typename MultiArrayShape<N>::type  Shape;
+
+    explicit WatershedLinearCost(WatershedOptions const & options)
+    : bias_(options.bias),
+      biased_label_(options.biased_label)
+    {}
+
+    bool active() const
+    {
+        return false;
+    }
+
+    void addSeed(LabelType, Shape const &)
+    {}
+
+    void finalizeSeeds()
+    {}
+
+    CostType nodeCost(CostType data, LabelType label) const
+    {
+        return (label == biased_label_)
+                   ? data * bias_
+                   : data;
+    }
+
+    template <class PriorityType>
+    PriorityType priority(CostType cost, LabelType, Shape const &, Shape const &) const
+    {
+        return cost;
+    }
+
+    bool canGrow(LabelType) const
+    {
+        return true;
+    }
+
+    void grow(LabelType, double)
+    {}
+
+  private:
+    double bias_;
+    LabelType biased_label_;
+};
+
+    // Per-seed state of the linear region growing in flat arrays indexed by label:
+    // the seed centers of the compact mode and the region sizes of the 
+    // size-constrained mode.
+template <unsigned int N, class CostType, class LabelType>
+class WatershedSeedState
+: public WatershedLinearCost<N, CostType, LabelType>
+{
+  public:
+    typedef WatershedLinearCost<N, CostType, LabelType>  BaseType;
+    typedef typename BaseType::Shape                     Shape;
+    typedef TinyVector<double, N>                        Center;
+
+    WatershedSeedState(WatershedOptions const & options, LabelType maxRegionLabel)
+    : BaseType(options),
+      compactness_(options.compactness_weight),
+      max_size_(options.max_region_size),
+      threshold_((options.terminate & StopAtThreshold) != 0
+                     ? options.max_cost
+                     : std::numeric_limits<double>::infinity())
+    {
+        if(compact())
+            center_.resize(maxRegionLabel + 1, Center());
+        size_.resize(maxRegionLabel + 1, 0);
+    }
+
+    bool compact() const
+    {
+        return compactness_ > 0.0;
+    }
+
+    bool sizeLimited() const
+    {
+        return max_size_ > 0;
+    }
+
+    bool active() const
+    {
+        return true;
+    }
+
+    void addSeed(LabelType label, Shape const & p)
+    {
+        ++size_[label];
+        if(compact())
+            center_[label] += p;
+    }
+
+        // turn the coordinate sums into seed centers
+    void finalizeSeeds()
+    {
+        for(unsigned int k = 0; k < center_.size(); ++k)
+            if(size_[k] > 0)
+                center_[k] /= (double)size_[k];
+    }
+
+        // priority of the pixel at 'p + offset' when claimed by 'label'
+    template <class PriorityType>
+    PriorityType priority(CostType cost, LabelType label, 
+                          Shape const & p, Shape const & offset) const
+    {
+        if(!compact())
+            return cost;
+        return PriorityType(cost + compactness_ * norm(p + offset - center_[label]));
+    }
+
+    bool canGrow(LabelType label) const
+    {
+        return !sizeLimited() || size_[label] < max_size_;
+    }
+
+    void grow(LabelType label, double priority)
+    {
+        if(sizeLimited() && priority <= threshold_)
+            ++size_[label];
+    }
+
+  private:
+    double compactness_;
+    MultiArrayIndex max_size_;
+    double threshold_;
+    ArrayVector<Center> center_;
+    ArrayVector<MultiArrayIndex> size_;
+};
+
+    // the sequential linear region growing may claim all pixels
+struct WatershedWholeDomain
+{
+    template <class PriorityType, class LabelType>
+    bool claim(MultiArrayIndex, PriorityType, LabelType)
+    {
+        return true;
+    }
+};
+
+    // a pixel above the threshold, claimed from one of several independent domains
+template <class PriorityType, class LabelType>
+struct WatershedBarrierClaim
+{
+    MultiArrayIndex pixel;
+    PriorityType cost;    // priority of the claiming pixel, i.e. the time of the claim
+    LabelType label;
+
+    bool operator<(WatershedBarrierClaim const & o) const
+    {
+        return pixel < o.pixel ||
+               (pixel == o.pixel && (cost < o.cost ||
+                                     (cost == o.cost && label < o.label)));
+    }
+};
+
+    // the parallel linear region growing claims the pixels of its own domain
+    // and records the claims of pixels between domains
+template <class PriorityType, class LabelType>
+struct WatershedGroupDomain
+{
+    UInt32 const * domain;
+    UInt32 group;
+    std::vector<WatershedBarrierClaim<PriorityType, LabelType> > claims;
+
+    bool claim(MultiArrayIndex j, PriorityType cost, LabelType label)
+    {
+        if(domain[j] == group)
+            return true;
+        WatershedBarrierClaim<PriorityType, LabelType> c = { j, cost, label };
+        claims.push_back(c);
+        return false;
+    }
+};
+
+    // find the seeds that have an unlabeled neighbor (in scan order), 
+    // and initialize the per-seed state
+template <unsigned int N, class DirectedTag, class LabelType, class STATE>
+void
+watershedLinearSeeds(GridGraph<N, DirectedTag> const & g,
+                     LabelType const * labels,
+                     ArrayVector<MultiArrayIndex> const & offsets,
+                     STATE & state,
+                     std::vector<MultiArrayIndex> & seeds)
+{
+    typedef GridGraph<N, DirectedTag>      Graph;
+    typedef typename Graph::Node           Node;
+    typedef typename Graph::shape_type     Shape;
+    typedef typename Graph::OutArcIt       neighbor_iterator;
+
+    scanlineTraversal(g, [&](Shape const & start, MultiArrayIndex length, bool interior)
+    {
+        Node node(start);
+        MultiArrayIndex i = g.id(node);
+        for(MultiArrayIndex x = 0; x < length; ++x, ++node[0], ++i)
+        {
+            LabelType label = labels[i];
+            if(label == 0)
+                continue;
+            if(state.active())
+                state.addSeed(label, node);
+
+            bool hasUnlabeledNeighbor = false;
+            if(interior)
+            {
+                for(unsigned int k = 0; k < offsets.size() && !hasUnlabeledNeighbor; ++k)
+                    hasUnlabeledNeighbor = labels[i + offsets[k]] == 0;
+            }
+            else
+            {
+                for(neighbor_iterator arc(g, node); arc != INVALID && !hasUnlabeledNeighbor; ++arc)
+                    hasUnlabeledNeighbor = labels[g.id(g.target(*arc))] == 0;
+            }
+            if(hasUnlabeledNeighbor)
+                seeds.push_back(i);
+        }
+    });
+    state.finalizeSeeds();
+}
+
+    // flood from the given seeds, claiming only the pixels accepted by 'domain'
+template <unsigned int N, class DirectedTag, class CostType, class LabelType, 
+          class STATE, class QUEUE, class FLOOD_DOMAIN>
+void
+watershedLinearGrow(GridGraph<N, DirectedTag> const & g,
+                    CostType const * data,
+                    LabelType * labels,
+                    WatershedOptions const & options,
+                    ArrayVector<MultiArrayIndex> const & offsets,
+                    STATE & state,
+                    LabelType contourLabel,
+                    MultiArrayIndex const * seeds,
+                    MultiArrayIndex seedCount,
+                    QUEUE & pqueue,
+                    FLOOD_DOMAIN & domain)
+{
+    typedef GridGraph<N, DirectedTag>      Graph;
+    typedef typename Graph::Node           Node;
+    typedef typename Graph::shape_type     Shape;
+    typedef typename Graph::OutArcIt       neighbor_iterator;
+    typedef typename QUEUE::priority_type  PriorityType;
+
+    const bool keepContours = ((options.terminate & KeepContours) != 0),
+               stopAtThreshold = ((options.terminate & StopAtThreshold) != 0);
+    const double maxCost = options.max_cost;
+    const MultiArrayIndex * neighborOffsets = offsets.begin();
+    const unsigned int neighborCount = offsets.size();
+    const Shape noOffset;
+    // local copy of the cost function (the compiler need not reload it after each write to 'labels')
+    const WatershedLinearCost<N, CostType, LabelType> linearCost(state);
+
+    for(MultiArrayIndex s = 0; s < seedCount; ++s)
+    {
+        MultiArrayIndex i = seeds[s];
+        pqueue.push(i, state.template priority<PriorityType>(linearCost.nodeCost(data[i], labels[i]), 
+                                                             labels[i], g.nodeFromId(i), noOffset));
+    }
+
+    while(!pqueue.empty())
+    {
+        MultiArrayIndex i = pqueue.top();
+        PriorityType cost = pqueue.topPriority();
+        pqueue.pop();
+
+        if(stopAtThreshold && (cost > maxCost))
+            break;
+
+        LabelType label = labels[i];
+
+        if(label == contourLabel || !state.canGrow(label))
+            continue;
+
+        auto visit = [&](MultiArrayIndex j, Node const & p, Shape const & offset)
+        {
+            LabelType neighborLabel = labels[j];
+            if(neighborLabel == 0)
+            {
+                if(!state.canGrow(label) || !domain.claim(j, cost, label))
+                    return;
+                PriorityType priority = state.template priority<PriorityType>(linearCost.nodeCost(data[j], label), 
+                                                                              label, p, offset);
+                if(priority < cost)
+                    priority = cost;
+                labels[j] = label;
+                state.grow(label, priority);
+                pqueue.push(j, priority);
+            }
+            else if(keepContours && (label != neighborLabel) && (neighborLabel != contourLabel))
+            {
+                // The present neighbor is adjacent to more than one region
+                // => mark it as contour.
+                PriorityType priority = state.template priority<PriorityType>(linearCost.nodeCost(data[j], neighborLabel), 
+                                                                              neighborLabel, p, offset);
+                if(cost < priority) // neighbor not yet processed
+                    labels[j] = contourLabel;
+            }
+        };
+
+        // Put the unlabeled neighbors in the priority queue.
+        Node node(g.nodeFromId(i));
+        if(g.get_border_type(node) == 0)
+        {
+            for(unsigned int k = 0; k < neighborCount; ++k)
+                visit(i + neighborOffsets[k], node, g.neighborOffset(k));
+        }
+        else
+        {
+            for(neighbor_iterator arc(g, node); arc != INVALID; ++arc)
+            {
+                Node target(g.target(*arc));
+                visit(g.id(target), target, noOffset);
+            }
+        }
+    }
+}
+
+    // GridGraph with unstrided arrays: the queue holds linear indices,
+    // and interior nodes are processed with linear neighbor offsets
+template <unsigned int N, class DirectedTag, class CostType, class LabelType, 
+          class QUEUE, class STATE>
+LabelType
+seededWatershedsLinear(GridGraph<N, DirectedTag> const & g,
+                       CostType const * data,
+                       LabelType * labels,
+                       WatershedOptions const & options,
+                       QUEUE & pqueue,
+                       STATE & state,
+                       LabelType maxRegionLabel)
+{
+    ArrayVector<MultiArrayIndex> offsets(g.neighborStrideOffsets());
+    const MultiArrayIndex size = g.nodeNum();
+
+    // register all seeds that have an unlabeled neighbor
+    std::vector<MultiArrayIndex> seeds;
+    watershedLinearSeeds(g, labels, offsets, state, seeds);
+
+    // perform region growing
+    LabelType contourLabel = maxRegionLabel + 1;  // temporary contour label
+    WatershedWholeDomain domain;
+    watershedLinearGrow(g, data, labels, options, offsets, state, contourLabel, 
+                        seeds.data(), (MultiArrayIndex)seeds.size(), pqueue, domain);
+
+    if((options.terminate & KeepContours) != 0)
+    {
+        // Replace the temporary contour label with label 0.
+        for(MultiArrayIndex i = 0; i < size; ++i)
+            if(labels[i] == contourLabel)
+                labels[i] = 0;
+    }
+
+    return maxRegionLabel;
+}
+
+    // Parallel version of seededWatershedsLinear() for StopAtThreshold without contours:
+    // the pixels that may be flooded form connected components which are separated 
+    // by pixels above the threshold. The seeds of each group of components (merged 
+    // when a label has seeds in several components) are grown independently with 
+    // their own copy of 'prototype'. Pixels above the threshold between the groups 
+    // are assigned afterwards to the earliest claim, or to the smallest label.
+template <unsigned int N, class DirectedTag, class CostType, class LabelType, 
+          class QUEUE, class STATE>
+LabelType
+seededWatershedsLinearParallel(GridGraph<N, DirectedTag> const & g,
+                               CostType const * data,
+                               LabelType * labels,
+                               WatershedOptions const & options,
+                               QUEUE const & prototype,
+                               STATE & state,
+                               LabelType maxRegionLabel)
+{
+    typedef typename QUEUE::priority_type                       PriorityType;
+    typedef WatershedGroupDomain<PriorityType, LabelType>       GroupDomain;
+    typedef WatershedBarrierClaim<PriorityType, LabelType>      BarrierClaim;
+
+    ArrayVector<MultiArrayIndex> offsets(g.neighborStrideOffsets());
+    const MultiArrayIndex size = g.nodeNum();
+
+    std::vector<MultiArrayIndex> seeds;
+    watershedLinearSeeds(g, labels, offsets, state, seeds);
+
+    // find the connected components of the pixels that may be flooded
+    MultiArray<N, UInt32> domain(g.shape());
+    UInt32 componentCount = 0;
+    {
+        MultiArray<N, UInt8> floodable(g.shape());
+        for(MultiArrayIndex i = 0; i < size; ++i)
+            floodable[i] = data[i] <= options.max_cost ||
+                           (options.biased_label != 0 && 
+                            state.nodeCost(data[i], options.biased_label) <= options.max_cost);
+        componentCount = lemon_graph::labelGraphWithBackground(g, floodable, domain, 
+                                                              UInt8(0), std::equal_to<UInt8>());
+    }
+
+    // merge the components that share a label, and number the resulting groups
+    UnionFindArray<UInt32> groups(componentCount + 1);
+    ArrayVector<UInt32> labelComponent(maxRegionLabel + 1, 0);
+    for(MultiArrayIndex i : seeds)
+    {
+        UInt32 c = domain[i];
+        if(c == 0)
+            continue;  // seeds above the threshold are never expanded
+        if(labelComponent[labels[i]] == 0)
+            labelComponent[labels[i]] = c;
+        else
+            groups.makeUnion(labelComponent[labels[i]], c);
+    }
+    UInt32 groupCount = groups.makeContiguous();
+    for(MultiArrayIndex i = 0; i < size; ++i)
+        domain[i] = groups.findLabel(domain[i]);
+
+    // sort the seeds by group (counting sort, preserving the scan order)
+    ArrayVector<MultiArrayIndex> groupBegin(groupCount + 2, 0);
+    for(MultiArrayIndex i : seeds)
+        ++groupBegin[domain[i] + 1];
+    for(UInt32 k = 1; k < groupBegin.size(); ++k)
+        groupBegin[k] += groupBegin[k-1];
+    ArrayVector<MultiArrayIndex> groupSeeds(seeds.size()), next(groupBegin.begin(), groupBegin.end());
+    for(MultiArrayIndex i : seeds)
+        groupSeeds[next[domain[i]]++] = i;
+    std::vector<MultiArrayIndex>().swap(seeds);
+
+    ThreadPool pool(options.num_threads);
+    std::vector<std::vector<BarrierClaim> > claims(std::max<std::size_t>(pool.nThreads(), 1));
+    LabelType contourLabel = maxRegionLabel + 1;
+
+    // group 0 holds the seeds above the threshold
+    parallel_foreach(pool, groupCount,
+        [&](size_t thread, MultiArrayIndex k)
+        {
+            UInt32 group = UInt32(k + 1);
+            if(groupBegin[group] == groupBegin[group + 1])
+                return;
+            QUEUE pqueue(prototype);
+            GroupDomain groupDomain = { domain.data(), group, std::vector<BarrierClaim>() };
+            watershedLinearGrow(g, data, labels, options, offsets, state, contourLabel, 
+                                groupSeeds.data() + groupBegin[group], groupBegin[group + 1] - groupBegin[group],
+                                pqueue, groupDomain);
+
+            // within a group, the first claim of a pixel wins
+            std::stable_sort(groupDomain.claims.begin(), groupDomain.claims.end(),
+                [](BarrierClaim const & a, BarrierClaim const & b)
+                {
+                    return a.pixel < b.pixel;
+                });
+            std::vector<BarrierClaim> & threadClaims = claims[thread];
+            for(unsigned int c = 0; c < groupDomain.claims.size(); ++c)
+                if(c == 0 || groupDomain.claims[c].pixel != groupDomain.claims[c-1].pixel)
+                    threadClaims.push_back(groupDomain.claims[c]);
+        });
+
+    // between groups, the earliest claim (then the smallest label) wins
+    std::vector<BarrierClaim> & allClaims = claims[0];
+    for(unsigned int t = 1; t < claims.size(); ++t)
+    {
+        allClaims.insert(allClaims.end(), claims[t].begin(), claims[t].end());
+        std::vector<BarrierClaim>().swap(claims[t]);
+    }
+    // A claim is recorded only while state.canGrow(label) holds, i.e. under the same
+    // check as in the sequential flooding (the region may reach its limit later, so
+    // the check must not be repeated here). The accepted claim is accounted like a
+    // sequential claim: its priority exceeds the threshold, so it never counts 
+    // towards the region size.
+    std::sort(allClaims.begin(), allClaims.end());
+    for(unsigned int c = 0; c < allClaims.size(); ++c)
+    {
+        if(c > 0 && allClaims[c].pixel == allClaims[c-1].pixel)
+            continue;
+        MultiArrayIndex j = allClaims[c].pixel;
+        LabelType label = allClaims[c].label;
+        PriorityType priority = state.template priority<PriorityType>(state.nodeCost(data[j], label), 
+                                                                      label, g.nodeFromId(j), 
+                                                                      typename STATE::Shape());
+        if(priority < allClaims[c].cost)
+            priority = allClaims[c].cost;
+        labels[j] = label;
+        state.grow(label, priority);
+    }
+
+    return maxRegionLabel;
+}
+
+    // cost range of the region growing, as needed by HierarchicalQueue
+template <class Graph, class T1Map>
+void
+watershedCostRange(Graph const & g,
+                   T1Map const & data,
+                   WatershedOptions const & options,
+                   typename T1Map::value_type & minCost,
+                   typename T1Map::value_type & maxCost)
+{
+    typedef typename T1Map::value_type  CostType;
+
+    typename Graph::NodeIt node(g);
+    if(node == INVALID)
+    {
+        minCost = maxCost = CostType();
+        return;
+    }
+    minCost = maxCost = data[*node];
+    for (; node != INVALID; ++node)
+    {
+        if(data[*node] < minCost)
+            minCost = data[*node];
+        if(maxCost < data[*node])
+            maxCost = data[*node];
+    }
+    if(options.biased_label != 0)
+    {
+        CostType biasedMin = minCost * options.bias,
+                 biasedMax = maxCost * options.bias;
+        minCost = std::min(minCost, std::min(biasedMin, biasedMax));
+        maxCost = std::max(maxCost, std::max(biasedMin, biasedMax));
+    }
+}
+
+    // number of levels of the HierarchicalQueue, or 0 when another queue shall 
+    // be used (turboAlgorithm() is only applied when it is exact)
+template <class CostType>
+unsigned int
+watershedQueueLevels(WatershedOptions const & options,
+                     CostType minCost, CostType maxCost)
+{
+    if(options.quantized_levels > 0)
+        return options.quantized_levels;
+    if(options.bucket_count > 0 && NumericTraits<CostType>::isIntegral::value &&
+       (double)maxCost - (double)minCost < (double)options.bucket_count)
+        return options.bucket_count;
+    return 0;
+}
+
+    // generic graphs and property maps: select the queue according to the options
+template <class Graph, class T1Map, class T2Map>
+typename T2Map::value_type
+seededWatersheds(Graph const & g,
+                 T1Map const & data,
+                 T2Map & labels,
+                 WatershedOptions const & options,
+                 VigraFalseType)
+{
+    typedef typename Graph::Node        Node;
+    typedef typename T1Map::value_type  CostType;
+
+    vigra_precondition(options.compactness_weight == 0.0 && options.max_region_size == 0,
+        "watershedsGraph(): compactness() and maxRegionSize() are only supported on a GridGraph.");
+
+    CostType minCost = CostType(), maxCost = CostType();
+    if(options.bucket_count > 0 || options.quantized_levels > 0)
+        watershedCostRange(g, data, options, minCost, maxCost);
+    unsigned int levels = watershedQueueLevels(options, minCost, maxCost);
+
+    if(levels > 0)
+    {
+        HierarchicalQueue<Node, CostType> pqueue(levels, minCost, maxCost);
+        return seededWatersheds(g, data, labels, options, pqueue);
+    }
+    else if(options.radix_queue)
+    {
+        MonotoneRadixQueue<Node, CostType> pqueue;
+        return seededWatersheds(g, data, labels, options, pqueue);
+    }
+    else
+    {
+        PriorityQueue<Node, CostType, true> pqueue;
+        return seededWatersheds(g, data, labels, options, pqueue);
+    }
+}
+
+    // the flooding only runs in parallel for StopAtThreshold without contours
+inline bool
+watershedRunsInParallel(WatershedOptions const & options)
+{
+    return options.num_threads != 0 && 
+           (options.terminate & StopAtThreshold) != 0 && 
+           (options.terminate & KeepContours) == 0;
+}
+
+    // run the linear region growing sequentially or in parallel
+template <unsigned int N, class DirectedTag, class CostType, class LabelType, 
+          class QUEUE, class STATE>
+LabelType
+seededWatershedsLinearRun(GridGraph<N, DirectedTag> const & g,
+                          CostType const * data,
+                          LabelType * labels,
+                          WatershedOptions const & options,
+                          QUEUE & pqueue,
+                          STATE & state,
+                          LabelType maxRegionLabel)
+{
+    if(watershedRunsInParallel(options))
+        return seededWatershedsLinearParallel(g, data, labels, options, pqueue, state, maxRegionLabel);
+    return seededWatershedsLinear(g, data, labels, options, pqueue, state, maxRegionLabel);
+}
+
+    // the per-seed state is only maintained for the compact and 
+    // size-constrained modes
+template <unsigned int N, class DirectedTag, class CostType, class LabelType, class QUEUE>
+LabelType
+seededWatershedsLinearRun(GridGraph<N, DirectedTag> const & g,
+                          CostType const * data,
+                          LabelType * labels,
+                          WatershedOptions const & options,
+                          QUEUE & pqueue)
+{
+    const MultiArrayIndex size = g.nodeNum();
+    LabelType maxRegionLabel = size > 0
+                                   ? *std::max_element(labels, labels + size)
+                                   : LabelType();
+    if(options.compactness_weight > 0.0 || options.max_region_size > 0)
+    {
+        WatershedSeedState<N, CostType, LabelType> state(options, maxRegionLabel);
+        return seededWatershedsLinearRun(g, data, labels, options, pqueue, state, maxRegionLabel);
+    }
+    else
+    {
+        WatershedLinearCost<N, CostType, LabelType> state(options);
+        return seededWatershedsLinearRun(g, data, labels, options, pqueue, state, maxRegionLabel);
+    }
+}
+
+    // select the queue of the linear region growing, whose priorities 
+    // are in [minCost, maxCost]
+template <class PriorityType, unsigned int N, class DirectedTag, class CostType, class LabelType>
+LabelType
+seededWatershedsLinearSelectQueue(GridGraph<N, DirectedTag> const & g,
+                                  CostType const * data,
+                                  LabelType * labels,
+                                  WatershedOptions const & options,
+                                  PriorityType minCost, PriorityType maxCost)
+{
+    unsigned int levels = watershedQueueLevels(options, minCost, maxCost);
+    if(levels > 0)
+    {
+        HierarchicalQueue<MultiArrayIndex, PriorityType> pqueue(levels, minCost, maxCost);
+        return seededWatershedsLinearRun(g, data, labels, options, pqueue);
+    }
+    else if(options.radix_queue)
+    {
+        MonotoneRadixQueue<MultiArrayIndex, PriorityType> pqueue;
+        return seededWatershedsLinearRun(g, data, labels, options, pqueue);
+    }
+    else
+    {
+        PriorityQueue<MultiArrayIndex, PriorityType, true> pqueue;
+        return seededWatershedsLinearRun(g, data, labels, options, pqueue);
+    }
+}
+
+    // GridGraph with MultiArrayView property maps: use linear indices 
+    // when both arrays are unstrided
+template <unsigned int N, class DirectedTag, class T1Map, class T2Map>
+typename T2Map::value_type
+seededWatersheds(GridGraph<N, DirectedTag> const & g,
+                 T1Map const & data,
+                 T2Map & labels,
+                 WatershedOptions const & options,
+                 VigraTrueType)
+{
+    typedef typename T1Map::value_type                   CostType;
+    typedef typename T2Map::value_type                   LabelType;
+    typedef typename NumericTraits<CostType>::RealPromote CompactCostType;
+
+    bool linearOnly = options.compactness_weight > 0.0 || 
+                      options.max_region_size > 0 || 
+                      watershedRunsInParallel(options);
+
+    if(!data.isUnstrided() || !labels.isUnstrided())
+    {
+        if(!linearOnly)
+            return seededWatersheds(g, data, labels, options, VigraFalseType());
+
+        // the compact, size-constrained, and parallel modes work on unstrided copies
+        MultiArray<N, CostType> tmpData(data);
+        MultiArray<N, LabelType> tmpLabels(labels);
+        LabelType maxRegionLabel = seededWatersheds(g, tmpData, tmpLabels, options, VigraTrueType());
+        labels = tmpLabels;
+        return maxRegionLabel;
+    }
+
+    CostType minCost = CostType(), maxCost = CostType();
+    if(options.bucket_count > 0 || options.quantized_levels > 0)
+        watershedCostRange(g, data, options, minCost, maxCost);
+
+    if(options.compactness_weight > 0.0)
+    {
+        // the spatial term increases the priorities by at most the weighted image diagonal
+        CompactCostType compactMaxCost = maxCost + 
+              options.compactness_weight * norm(g.shape() - typename MultiArrayShape<N>::type(1));
+        return seededWatershedsLinearSelectQueue(g, data.data(), labels.data(), options,
+                                                 CompactCostType(minCost), compactMaxCost);
+    }
+    return seededWatershedsLinearSelectQueue(g, data.data(), labels.data(), options, minCost, maxCost);
+}
+
+template <class Graph, class T1Map, class T2Map>
+typename T2Map::value_type
+seededWatersheds(Graph const & g,
+                 T1Map const & data,
+                 T2Map & labels,
+                 WatershedOptions const & options)
+{
+    return seededWatersheds(g, data, labels, options, VigraFalseType());
+}
+
+template <unsigned int N, class DirectedTag, class T1Map, class T2Map>
+typename T2Map::value_type
+seededWatersheds(GridGraph<N, DirectedTag> const & g,
+                 T1Map const & data,
+                 T2Map & labels,
+                 WatershedOptions const & options)
+{
+    return seededWatersheds(g, data, labels, options, 
+                            typename GridGraphLinearAccess<N, T1Map, T2Map>::type());
+}
+
 #ifdef __GNUC__
 #pragma GCC diagnostic pop
 #endif
@@ -370,6 +1267,8 @@ watershedsGraph(Graph const & g,
 
         if(seed_options.mini != SeedOptions::Unspecified)
         {
+            if(seed_options.num_threads == 0)
+                seed_options.num_threads = options.num_threads;
             graph_detail::generateWatershedSeeds(g, data, labels, seed_options);
         }
 
@@ -448,10 +1347,25 @@ generateWatershedSeeds(MultiArrayView<N, T, S1> const & data,
          (remaining pixels keep label 0).
     <li> <tt>biasLabel()</tt>: Whether one region (label) is to be preferred or discouraged by biasing its cost
          with a given factor (smaller than 1 for preference, larger than 1 for discouragement).
+    <li> <tt>compactness()</tt>: Add the weighted distance from the seed center to the cost, 
+         which results in compact, superpixel-like regions (compact watersheds).
+    <li> <tt>maxRegionSize()</tt>: Stop growing a region when it reaches the given number of 
+         pixels (pixels that no region can claim keep label 0).
+    <li> <tt>numThreads()</tt>: In combination with <tt>stopAtThreshold()</tt>, flood the parts 
+         of the image that are separated by pixels above the threshold in parallel.
     </ul>
 
-    The option <tt>turboAlgorithm()</tt> is implied by method <tt>regionGrowing()</tt> (this is
-    in contrast to watershedsRegionGrowing(), which supports an additional algorithm in 2D only).
+    These three options are implemented by a common region growing on flat arrays, 
+    which uses the same priority queues as the ordinary flooding. Strided arrays are 
+    copied to temporary arrays in this case.
+
+    The region growing uses a binary heap by default. <tt>radixQueue()</tt> selects an exact
+    radix heap, and <tt>quantizedQueue()</tt> selects a faster \ref HierarchicalQueue, which only 
+    approximates the result unless the costs are integers in a range smaller than the number of 
+    levels. <tt>turboAlgorithm()</tt> uses the same queue, but only when it is exact, i.e. for 
+    integer costs in a range smaller than its <tt>bucket_count</tt>. Otherwise, it is ignored 
+    (this is in contrast to watershedsRegionGrowing(), which supports an additional algorithm 
+    in 2D only).
 
     watershedsMultiArray() returns the number of regions found (= the highest region label, because
     labels start at 1).
@@ -541,6 +1455,20 @@ generateWatershedSeeds(MultiArrayView<N, T, S1> const & data,
         // use the fast union-find algorithm with 4-neighborhood
         watershedsMultiArray(gradMag, labeling, WatershedOptions().unionFind());
     }
+
+    // example 5
+    {
+        MultiArray<2, unsigned int> labeling(src.shape());
+
+        // compact watersheds: place seeds on a regular grid ...
+        for(int y = 5; y < h; y += 10)
+            for(int x = 5; x < w; x += 10)
+                labeling(x, y) = 1 + x / 10 + (w / 10 + 1) * (y / 10);
+
+        // ... and penalize the distance from the seed with weight 0.5
+        watershedsMultiArray(gradMag, labeling, DirectNeighborhood,
+                             WatershedOptions().compactness(0.5));
+    }
     \endcode
 */
 doxygen_overloaded_function(template <...> Label watershedsMultiArray)
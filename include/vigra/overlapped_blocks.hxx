@@ -100,6 +100,40 @@ Shape blocksShape(const Shape& global_shape, const Shape& block_shape)
 
 }
 
+    // copy a subarray of a MultiArrayView or ChunkedArray into 'block'
+template <unsigned int N, class T, class S, class U>
+void checkoutBlock(MultiArrayView<N, T, S> const & array,
+                   typename MultiArrayShape<N>::type const & start,
+                   MultiArrayView<N, U> block)
+{
+    block = array.subarray(start, start + block.shape());
+}
+
+template <unsigned int N, class T, class U>
+void checkoutBlock(ChunkedArray<N, T> const & array,
+                   typename MultiArrayShape<N>::type const & start,
+                   MultiArrayView<N, U> block)
+{
+    array.checkoutSubarray(start, block);
+}
+
+    // write 'block' back into a MultiArrayView or ChunkedArray
+template <unsigned int N, class T, class S, class U, class S2>
+void commitBlock(MultiArrayView<N, T, S> array,
+                 typename MultiArrayShape<N>::type const & start,
+                 MultiArrayView<N, U, S2> const & block)
+{
+    array.subarray(start, start + block.shape()) = block;
+}
+
+template <unsigned int N, class T, class U, class S2>
+void commitBlock(ChunkedArray<N, T> & array,
+                 typename MultiArrayShape<N>::type const & start,
+                 MultiArrayView<N, U, S2> const & block)
+{
+    array.commitSubarray(start, block);
+}
+
 } // namespace overlapped_blocks_detail
 
 template <class Shape>
@@ -822,6 +822,47 @@ extractContour(MultiArrayView<2, T, S> const &label_image,
     contour_points.push_back(contour_points.front()); // make it a closed polygon
 }
 
+namespace detail {
+
+    // Andrew's Monotone Chain algorithm for points in pointYXOrdering.
+template<class Point, class PointArray>
+void convexHullOfOrderedPoints(ArrayVector<Point> const & ordered, PointArray & convex_hull)
+{
+    ArrayVector<Point> H;
+    H.reserve(ordered.size() + 1);
+    
+    int n = ordered.size(), k=0;
+    
+    // Build lower hull
+    for (int i = 0; i < n; i++) 
+    {
+        while (k >= 2 && orderedClockwise(H[k-2], H[k-1], ordered[i])) 
+        {
+            H.pop_back();
+            --k;
+        }
+        H.push_back(ordered[i]);
+        ++k;
+    }
+    
+    // Build upper hull
+    for (int i = n-2, t = k+1; i >= 0; i--) 
+    {
+        while (k >= t && orderedClockwise(H[k-2], H[k-1], ordered[i])) 
+        {
+            H.pop_back();
+            --k;
+        }
+        H.push_back(ordered[i]);
+        ++k;
+    }
+    
+    for(int i=k-1; i>=0; --i)
+        convex_hull.push_back(H[i]);
+}
+
+} // namespace detail
+
 /** \brief Compute convex hull of a 2D polygon.
 
     The input array \a points contains a (not necessarily ordered) set of 2D points
@@ -850,38 +891,64 @@ void convexHull(const PointArray1 &points, PointArray2 & convex_hull)
     ArrayVector<Point> ordered(begin, points.end());
     std::sort(ordered.begin(), ordered.end(), detail::pointYXOrdering<Point>);
     
-    ArrayVector<Point> H;
-    
-    int n = ordered.size(), k=0;
-    
-    // Build lower hull
-    for (int i = 0; i < n; i++) 
+    detail::convexHullOfOrderedPoints(ordered, convex_hull);
+}
+
+namespace detail {
+
+    // Convex hull of an interpixel contour as returned by extractContour().
+    // Since all points have integer or half-integer y-coordinates, we can replace
+    // sorting with bucketing by y-coordinate, and only the leftmost and rightmost
+    // point in each row need to be considered. The result is identical to convexHull().
+template<class Point, class PointArray>
+void convexHullOfContour(Polygon<Point> const & contour, PointArray & convex_hull)
+{
+    vigra_precondition(contour.size() >= 2,
+                       "convexHull(): at least two input points are needed.");
+
+    double ymin = contour[0][1], ymax = ymin;
+    for(unsigned int i = 1; i < contour.size(); ++i)
     {
-        while (k >= 2 && detail::orderedClockwise(H[k-2], H[k-1], ordered[i])) 
-        {
-            H.pop_back();
-            --k;
-        }
-        H.push_back(ordered[i]);
-        ++k;
+        ymin = std::min<double>(ymin, contour[i][1]);
+        ymax = std::max<double>(ymax, contour[i][1]);
     }
-    
-    // Build upper hull
-    for (int i = n-2, t = k+1; i >= 0; i--) 
+
+    int rows = (int)(2.0*(ymax - ymin)) + 1;
+    ArrayVector<int> extremes(2*rows, -1);
+    int * left = extremes.begin(),
+        * right = left + rows;
+    for(unsigned int i = 0; i < contour.size(); ++i)
     {
-        while (k >= t && detail::orderedClockwise(H[k-2], H[k-1], ordered[i])) 
+        double r = 2.0*(contour[i][1] - ymin);
+        if(r != std::floor(r))
         {
-            H.pop_back();
-            --k;
+            // not an interpixel contour => use the general algorithm
+            convexHull(contour, convex_hull);
+            return;
         }
-        H.push_back(ordered[i]);
-        ++k;
+        int row = (int)r;
+        if(left[row] < 0 || contour[i][0] < contour[left[row]][0])
+            left[row] = i;
+        if(right[row] < 0 || contour[i][0] > contour[right[row]][0])
+            right[row] = i;
     }
-    
-    for(int i=k-1; i>=0; --i)
-        convex_hull.push_back(H[i]);
+
+    ArrayVector<Point> ordered;
+    ordered.reserve(2*rows);
+    for(int row = 0; row < rows; ++row)
+    {
+        if(left[row] < 0)
+            continue;
+        ordered.push_back(contour[left[row]]);
+        if(contour[right[row]][0] != contour[left[row]][0])
+            ordered.push_back(contour[right[row]]);
+    }
+
+    convexHullOfOrderedPoints(ordered, convex_hull);
 }
 
+} // namespace detail
+
 /********************************************************************/
 /*                                                                  */
 /*                         polygon drawing                          */
@@ -40,7 +40,12 @@
 #include "config.hxx"
 #include "error.hxx"
 #include "array_vector.hxx"
+#include "numerictraits.hxx"
+#include "mathutil.hxx"
+#include <algorithm>
 #include <queue>
+#include <vector>
+#include <cstring>
 
 namespace vigra {
 
@@ -401,6 +406,120 @@ class PriorityQueue<ValueType, unsigned short, Ascending>
 
 
 
+/** \brief Monotone priority queue with quantized priorities.
+
+    This is the hierarchical queue of the classical watershed algorithm: 
+    priorities in the range <tt>[minPriority, maxPriority]</tt> are mapped linearly 
+    onto a given number of levels, and each level is a first-in first-out queue.
+    Thus, elements whose priorities fall into the same level are returned in
+    insertion order. If the priorities are integers and 
+    <tt>maxPriority - minPriority < levels</tt>, the order is exact.
+    The queue is ascending and monotone: an element pushed with a priority below
+    the level of the last element popped is appended to that level. The API is
+    compatible to \ref vigra::PriorityQueue, and \ref topPriority() returns the 
+    exact priority of the top element.
+
+    <b>\#include</b> \<vigra/priority_queue.hxx\><br>
+    Namespace: vigra
+*/
+template <class ValueType,
+          class PriorityType>
+class HierarchicalQueue
+{
+    typedef std::pair<ValueType, PriorityType> ElementType;
+
+  public:
+
+    typedef ValueType value_type;
+    typedef ValueType & reference;
+    typedef ValueType const & const_reference;
+    typedef std::size_t size_type;
+    typedef PriorityType priority_type;
+
+        /** \brief Create empty queue with \arg levels quantization levels for 
+            priorities between \arg minPriority and \arg maxPriority.
+        */
+    HierarchicalQueue(size_type levels, priority_type minPriority, priority_type maxPriority)
+    : buckets_(std::max<size_type>(levels, 1)),
+      minPriority_(minPriority),
+      scale_(maxPriority > minPriority
+                 ? (buckets_.size() - 1) / ((double)maxPriority - (double)minPriority)
+                 : 0.0),
+      current_(buckets_.size()),
+      lowest_(0),
+      head_(0),
+      size_(0)
+    {}
+
+        /** \brief Number of elements in this queue.
+        */
+    size_type size() const
+    {
+        return size_;
+    }
+
+        /** \brief Queue contains no elements.
+             Equivalent to <tt>size() == 0</tt>.
+        */
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+        /** \brief Priority of the current top element.
+        */
+    priority_type topPriority() const
+    {
+        return buckets_[current_][head_].second;
+    }
+
+        /** \brief The current top element.
+        */
+    const_reference top() const
+    {
+        return buckets_[current_][head_].first;
+    }
+
+        /** \brief Remove the current top element.
+        */
+    void pop()
+    {
+        lowest_ = current_;
+        --size_;
+        if(++head_ == buckets_[current_].size())
+        {
+            buckets_[current_].clear();
+            head_ = 0;
+            if(size_ == 0)
+                current_ = buckets_.size();
+            else
+                while(buckets_[current_].empty())
+                    ++current_;
+        }
+    }
+
+        /** \brief Insert new element \arg v with given \arg priority.
+        */
+    void push(value_type const & v, priority_type priority)
+    {
+        const double level = ((double)priority - (double)minPriority_) * scale_;
+        size_type l = level <= (double)lowest_
+                          ? lowest_
+                          : std::min<size_type>((size_type)level, buckets_.size() - 1);
+        buckets_[l].push_back(ElementType(v, priority));
+        if(l < current_)
+            current_ = l;
+        ++size_;
+    }
+
+  private:
+    std::vector<std::vector<ElementType> > buckets_;
+    priority_type minPriority_;
+    double scale_;
+    size_type current_, lowest_, head_;
+    size_type size_;
+};
+
 /** \brief Heap-based changable priority queue with a maximum number of elemements.
 
     This pq allows to change the priorities of elements in the queue
@@ -590,6 +709,508 @@ private:
 
 };
 
+/** \brief Monotone bucket queue with changeable priorities (Dial's algorithm).
+
+    Drop-in replacement for \ref ChangeablePriorityQueue in algorithms like 
+    \ref ShortestPathDijkstra where priorities are non-negative integers 
+    and the difference between the largest and smallest priority in the queue
+    is small (e.g. at most the largest edge weight in shortest path computations).
+    Elements are stored in a circular array of buckets indexed by priority, which 
+    grows automatically to cover the range of priorities currently in the queue. 
+    All operations are O(1) amortized. Changing the priority of an element pushes 
+    a new entry, and outdated entries are skipped when they reach the top.
+
+    <b>\#include</b> \<vigra/priority_queue.hxx\><br>
+    Namespace: vigra
+*/
+template<class T>
+class ChangeableBucketQueue
+{
+  public:
+
+    typedef T priority_type;
+    typedef int ValueType;
+    typedef ValueType value_type;
+    typedef ValueType const_reference;
+
+    /// Create an empty queue which can contain the indices <tt>0...maxSize</tt>
+    ChangeableBucketQueue(const size_t maxSize, const size_t bucketCount = 256)
+    : priorities_(maxSize+1),
+      contains_(maxSize+1, false),
+      buckets_(ceilPower2((UInt32)std::max<size_t>(bucketCount, 2))),
+      current_(0),
+      maxKey_(0),
+      size_(0)
+    {}
+
+    /// check if the PQ is empty
+    bool empty() const {
+        return size_ == 0;
+    }
+
+    /// return the number of elements in the PQ
+    int size() const {
+        return size_;
+    }
+
+    /// check if i is an index on the PQ
+    bool contains(const int i) const {
+        return contains_[i];
+    }
+
+    /// remove all elements
+    void clear() {
+        for(size_t b = 0; b < buckets_.size(); ++b)
+        {
+            for(size_t k = 0; k < buckets_[b].size(); ++k)
+                contains_[buckets_[b][k]] = false;
+            buckets_[b].clear();
+        }
+        size_ = 0;
+    }
+
+    /** \brief Insert an index with a given priority, or change its priority.
+    */
+    void push(const value_type i, const priority_type p) {
+        vigra_precondition(p >= 0,
+            "ChangeableBucketQueue::push(): priorities must be non-negative.");
+        const UInt64 key = static_cast<UInt64>(p);
+        if(size_ == 0)
+        {
+            current_ = key;
+            maxKey_  = key;
+        }
+        else
+        {
+            current_ = std::min(current_, key);
+            maxKey_  = std::max(maxKey_, key);
+        }
+        if(maxKey_ - current_ >= buckets_.size())
+            grow(maxKey_ - current_ + 1);
+        if(!contains_[i])
+        {
+            contains_[i] = true;
+            ++size_;
+        }
+        priorities_[i] = p;
+        buckets_[key & (buckets_.size() - 1)].push_back(i);
+    }
+
+    /// get index with top priority
+    const_reference top() {
+        findTop();
+        return buckets_[current_ & (buckets_.size() - 1)].back();
+    }
+
+    /// get top priority
+    priority_type topPriority() {
+        return priorities_[top()];
+    }
+
+    /// Remove the current top element.
+    void pop() {
+        findTop();
+        std::vector<int> & bucket = buckets_[current_ & (buckets_.size() - 1)];
+        contains_[bucket.back()] = false;
+        bucket.pop_back();
+        --size_;
+    }
+
+    /// returns the value associated with index i
+    priority_type priority(const value_type i) const {
+        return priorities_[i];
+    }
+
+  private:
+    bool valid(const int i) const {
+        return contains_[i] && static_cast<UInt64>(priorities_[i]) == current_;
+    }
+
+    void findTop() {
+        for(;; ++current_)
+        {
+            std::vector<int> & bucket = buckets_[current_ & (buckets_.size() - 1)];
+            while(!bucket.empty() && !valid(bucket.back()))
+                bucket.pop_back();
+            if(!bucket.empty())
+                return;
+        }
+    }
+
+    void grow(UInt64 range) {
+        std::vector<std::vector<int> > old(ceilPower2((UInt32)range) * 2);
+        old.swap(buckets_);
+        for(size_t b = 0; b < old.size(); ++b)
+            for(size_t k = 0; k < old[b].size(); ++k)
+            {
+                const int i = old[b][k];
+                const UInt64 key = static_cast<UInt64>(priorities_[i]);
+                // skip outdated entries
+                if(contains_[i] && (key & (old.size() - 1)) == b)
+                    buckets_[key & (buckets_.size() - 1)].push_back(i);
+            }
+    }
+
+    std::vector<T>                  priorities_;
+    std::vector<bool>               contains_;
+    std::vector<std::vector<int> >  buckets_;
+    UInt64                          current_, maxKey_;
+    int                             size_;
+};
+
+namespace detail {
+
+    // map priorities to unsigned keys with the same ordering
+template <class T, bool IS_INTEGRAL = NumericTraits<T>::isIntegral::value>
+struct RadixHeapKey
+{
+    static UInt64 get(T p)
+    {
+        if(NumericTraits<T>::isSigned::value)
+            return static_cast<UInt64>(static_cast<Int64>(p)) ^ (UInt64(1) << 63);
+        else
+            return static_cast<UInt64>(p);
+    }
+};
+
+    // the bit pattern of non-negative IEEE floats is ordered like their values,
+    // negative values are ordered in reverse. -0.0 is mapped to +0.0 because 
+    // both compare equal and must get the same key.
+template <>
+struct RadixHeapKey<float, false>
+{
+    static UInt64 get(float p)
+    {
+        if(p == 0.0f)
+            p = 0.0f;
+        UInt32 bits;
+        std::memcpy(&bits, &p, sizeof(bits));
+        return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+    }
+};
+
+template <>
+struct RadixHeapKey<double, false>
+{
+    static UInt64 get(double p)
+    {
+        if(p == 0.0)
+            p = 0.0;
+        UInt64 bits;
+        std::memcpy(&bits, &p, sizeof(bits));
+        return (bits >> 63) ? ~bits : (bits | (UInt64(1) << 63));
+    }
+};
+
+inline int radixHeapBucket(UInt64 diff)
+{
+#if defined(__GNUC__)
+    return diff == 0 ? 0 : 64 - __builtin_clzll(diff);
+#else
+    int b = 0;
+    for(; diff != 0; diff >>= 1)
+        ++b;
+    return b;
+#endif
+}
+
+} // namespace detail
+
+/** \brief Monotone radix heap with changeable priorities.
+
+    Drop-in replacement for \ref ChangeablePriorityQueue in algorithms like 
+    \ref ShortestPathDijkstra where priorities are non-negative and no element 
+    is ever pushed with a priority below the current top priority. Priorities 
+    can be integers or <tt>float</tt>/<tt>double</tt> (the bit patterns of 
+    non-negative floating point numbers are ordered like their values, so that 
+    the queue is exact for arbitrary floating point weights).
+    Element keys are kept in 65 buckets according to the highest bit in which they
+    differ from the current minimum, so that every element is moved at most
+    64 times in its lifetime. Changing the priority of an element pushes 
+    a new entry, and outdated entries are skipped when they are encountered.
+
+    <b>\#include</b> \<vigra/priority_queue.hxx\><br>
+    Namespace: vigra
+*/
+template<class T>
+class ChangeableRadixHeap
+{
+    typedef detail::RadixHeapKey<T> Key;
+    typedef std::pair<UInt64, int>  Entry;
+
+  public:
+
+    typedef T priority_type;
+    typedef int ValueType;
+    typedef ValueType value_type;
+    typedef ValueType const_reference;
+
+    /// Create an empty queue which can contain the indices <tt>0...maxSize</tt>
+    ChangeableRadixHeap(const size_t maxSize)
+    : priorities_(maxSize+1),
+      contains_(maxSize+1, false),
+      buckets_(65),
+      last_(0),
+      size_(0)
+    {}
+
+    /// check if the PQ is empty
+    bool empty() const {
+        return size_ == 0;
+    }
+
+    /// return the number of elements in the PQ
+    int size() const {
+        return size_;
+    }
+
+    /// check if i is an index on the PQ
+    bool contains(const int i) const {
+        return contains_[i];
+    }
+
+    /// remove all elements
+    void clear() {
+        for(size_t b = 0; b < buckets_.size(); ++b)
+        {
+            for(size_t k = 0; k < buckets_[b].size(); ++k)
+                contains_[buckets_[b][k].second] = false;
+            buckets_[b].clear();
+        }
+        size_ = 0;
+    }
+
+    /** \brief Insert an index with a given priority, or change its priority.
+
+        The priority must not be smaller than the current top priority.
+    */
+    void push(const value_type i, const priority_type p) {
+        vigra_precondition(p >= 0,
+            "ChangeableRadixHeap::push(): priorities must be non-negative.");
+        const UInt64 key = Key::get(p);
+        if(size_ == 0 && key < last_)
+        {
+            clear();       // drop outdated entries, which would be misplaced
+            last_ = key;   // restart with an empty queue
+        }
+        vigra_precondition(key >= last_,
+            "ChangeableRadixHeap::push(): priority is smaller than the top priority.");
+        if(!contains_[i])
+        {
+            contains_[i] = true;
+            ++size_;
+        }
+        priorities_[i] = p;
+        buckets_[detail::radixHeapBucket(key ^ last_)].push_back(Entry(key, i));
+    }
+
+    /// get index with top priority
+    const_reference top() {
+        findTop();
+        return buckets_[0].back().second;
+    }
+
+    /// get top priority
+    priority_type topPriority() {
+        return priorities_[top()];
+    }
+
+    /// Remove the current top element.
+    void pop() {
+        findTop();
+        contains_[buckets_[0].back().second] = false;
+        buckets_[0].pop_back();
+        if(--size_ == 0)
+            clear();   // only outdated entries are left
+    }
+
+    /// returns the value associated with index i
+    priority_type priority(const value_type i) const {
+        return priorities_[i];
+    }
+
+  private:
+    bool valid(Entry const & e) const {
+        return contains_[e.second] && Key::get(priorities_[e.second]) == e.first;
+    }
+
+    void findTop() {
+        std::vector<Entry> & bucket0 = buckets_[0];
+        while(!bucket0.empty() && !valid(bucket0.back()))
+            bucket0.pop_back();
+        while(bucket0.empty())
+        {
+            // redistribute the first non-empty bucket around its minimum
+            size_t b = 1;
+            while(buckets_[b].empty())
+                ++b;
+            std::vector<Entry> & bucket = buckets_[b];
+            UInt64 minKey = NumericTraits<UInt64>::max();
+            size_t k = 0;
+            for(size_t j = 0; j < bucket.size(); ++j)
+            {
+                if(!valid(bucket[j]))
+                    continue;
+                bucket[k++] = bucket[j];
+                minKey = std::min(minKey, bucket[j].first);
+            }
+            bucket.resize(k);
+            if(k == 0)
+                continue;
+            last_ = minKey;
+            for(size_t j = 0; j < bucket.size(); ++j)
+                buckets_[detail::radixHeapBucket(bucket[j].first ^ last_)].push_back(bucket[j]);
+            bucket.clear();
+        }
+    }
+
+    std::vector<T>                    priorities_;
+    std::vector<bool>                 contains_;
+    std::vector<std::vector<Entry> >  buckets_;
+    UInt64                            last_;
+    int                               size_;
+};
+
+
+/** \brief Monotone radix heap with first-in first-out order of equal priorities.
+
+    Exact counterpart of \ref vigra::HierarchicalQueue for arbitrary integer and 
+    floating point priorities (including negative ones). Like there, no element must 
+    be pushed with a priority below the priority of the last element popped.
+    Elements with equal priorities are returned in insertion order, which makes
+    algorithms like seeded watersheds independent of heap implementation details.
+    The API is compatible to \ref vigra::PriorityQueue (ascending).
+
+    <b>\#include</b> \<vigra/priority_queue.hxx\><br>
+    Namespace: vigra
+*/
+template <class ValueType,
+          class PriorityType>
+class MonotoneRadixQueue
+{
+    typedef detail::RadixHeapKey<PriorityType> Key;
+
+    struct Entry
+    {
+        UInt64       key, order;
+        ValueType    value;
+        PriorityType priority;
+
+        Entry(UInt64 k, UInt64 o, ValueType const & v, PriorityType p)
+        : key(k), order(o), value(v), priority(p)
+        {}
+
+        bool operator<(Entry const & other) const
+        {
+            return order < other.order;
+        }
+    };
+
+  public:
+
+    typedef ValueType value_type;
+    typedef ValueType & reference;
+    typedef ValueType const & const_reference;
+    typedef std::size_t size_type;
+    typedef PriorityType priority_type;
+
+        /** \brief Create empty queue.
+        */
+    MonotoneRadixQueue()
+    : buckets_(65),
+      last_(0),
+      head_(0),
+      count_(0),
+      size_(0)
+    {}
+
+        /** \brief Number of elements in this queue.
+        */
+    size_type size() const
+    {
+        return size_;
+    }
+
+        /** \brief Queue contains no elements.
+             Equivalent to <tt>size() == 0</tt>.
+        */
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+        /** \brief Priority of the current top element.
+        */
+    priority_type topPriority()
+    {
+        findTop();
+        return buckets_[0][head_].priority;
+    }
+
+        /** \brief The current top element.
+        */
+    const_reference top()
+    {
+        findTop();
+        return buckets_[0][head_].value;
+    }
+
+        /** \brief Remove the current top element.
+        */
+    void pop()
+    {
+        findTop();
+        --size_;
+        if(++head_ == buckets_[0].size())
+        {
+            buckets_[0].clear();
+            head_ = 0;
+        }
+    }
+
+        /** \brief Insert new element \arg v with given \arg priority.
+
+            The priority must not be smaller than the priority of the last element popped,
+            unless the queue is empty.
+        */
+    void push(value_type const & v, priority_type priority)
+    {
+        const UInt64 key = Key::get(priority);
+        if(size_ == 0)
+            last_ = 0;   // restart with an empty queue
+        vigra_precondition(key >= last_,
+            "MonotoneRadixQueue::push(): priority is smaller than the last popped priority.");
+        buckets_[detail::radixHeapBucket(key ^ last_)].push_back(Entry(key, count_++, v, priority));
+        ++size_;
+    }
+
+  private:
+        // redistribute the first non-empty bucket around its minimum,
+        // equal keys enter bucket 0 in insertion order
+    void findTop()
+    {
+        if(!buckets_[0].empty())
+            return;
+        size_t b = 1;
+        while(buckets_[b].empty())
+            ++b;
+        std::vector<Entry> & bucket = buckets_[b];
+        UInt64 minKey = bucket[0].key;
+        for(size_t j = 1; j < bucket.size(); ++j)
+            minKey = std::min(minKey, bucket[j].key);
+        last_ = minKey;
+        for(size_t j = 0; j < bucket.size(); ++j)
+            buckets_[detail::radixHeapBucket(bucket[j].key ^ last_)].push_back(bucket[j]);
+        bucket.clear();
+        std::sort(buckets_[0].begin(), buckets_[0].end());
+    }
+
+    std::vector<std::vector<Entry> > buckets_;
+    UInt64    last_;
+    size_type head_;
+    UInt64    count_;
+    size_type size_;
+};
 
 } // namespace vigra
 
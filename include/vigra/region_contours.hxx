@@ -0,0 +1,336 @@
+/************************************************************************/
+/*                                                                      */
+/*                Copyright 2026 by the VIGRA developers                */
+/*                                                                      */
+/*    This file is part of the VIGRA computer vision library.           */
+/*    The VIGRA Website is                                              */
+/*        http://hci.iwr.uni-heidelberg.de/vigra/                       */
+/*    Please direct questions, bug reports, and contributions to        */
+/*        ullrich.koethe@iwr.uni-heidelberg.de    or                    */
+/*        vigra@informatik.uni-hamburg.de                               */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+
+#ifndef VIGRA_REGION_CONTOURS_HXX
+#define VIGRA_REGION_CONTOURS_HXX
+
+#include "multi_array.hxx"
+#include "polygon.hxx"
+#include "accumulator.hxx"
+#include "threadpool.hxx"
+#include "array_vector.hxx"
+
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+namespace vigra
+{
+
+namespace detail {
+
+    // Find the first pixel (in scan order) of every label in a single raster scan.
+    // This pixel is always at the region border and serves as the anchor point
+    // for extractContour() (the same anchor is used by the RegionContour accumulator).
+    // The scan is split into horizontal stripes that are processed in parallel. Since
+    // the left and upper neighbors of an anchor must belong to another region, each
+    // stripe only reports these candidates, which are then merged in scan order.
+    // Returns the labels that occur in the image in order of appearance.
+template <class T, class S>
+std::vector<MultiArrayIndex>
+findRegionAnchors(MultiArrayView<2, T, S> const & labels,
+                  std::vector<MultiArrayIndex> & anchors,
+                  ThreadPool & pool)
+{
+    MultiArrayIndex w = labels.shape(0), h = labels.shape(1),
+                    stripes = std::min<MultiArrayIndex>(h, 4*std::max<MultiArrayIndex>(pool.nThreads(), 1));
+    std::vector<std::vector<MultiArrayIndex> > candidates(stripes);
+    parallel_foreach(pool, stripes,
+        [&](int /*thread*/, MultiArrayIndex k)
+        {
+            for(MultiArrayIndex y = k*h / stripes; y < (k+1)*h / stripes; ++y)
+            {
+                for(MultiArrayIndex x = 0; x < w; ++x)
+                {
+                    T label = labels(x, y);
+                    if((x > 0 && labels(x-1, y) == label) ||
+                       (y > 0 && labels(x, y-1) == label))
+                        continue;
+                    candidates[k].push_back(x + y*w);
+                }
+            }
+        });
+
+    anchors.clear();
+    std::vector<MultiArrayIndex> found;
+    for(MultiArrayIndex k = 0; k < stripes; ++k)
+    {
+        for(std::size_t i = 0; i < candidates[k].size(); ++i)
+        {
+            MultiArrayIndex index = candidates[k][i],
+                            l = (MultiArrayIndex)labels(index % w, index / w);
+            vigra_precondition(l >= 0,
+                "extractRegionContours(): labels must be non-negative.");
+            if(l >= (MultiArrayIndex)anchors.size())
+                anchors.resize(l + 1, -1);
+            if(anchors[l] < 0)
+            {
+                anchors[l] = index;
+                found.push_back(l);
+            }
+        }
+    }
+    return found;
+}
+
+    // Trace the contours of the given regions in parallel and call
+    // f(label, contour) for each, where f must be thread-safe for different labels.
+template <class Contour, class T, class S, class FUNCTOR>
+void
+forEachRegionContour(MultiArrayView<2, T, S> const & labels,
+                     std::vector<MultiArrayIndex> const & anchors,
+                     std::vector<MultiArrayIndex> const & regions,
+                     ThreadPool & pool,
+                     FUNCTOR const & f)
+{
+    MultiArrayIndex w = labels.shape(0);
+    parallel_foreach(pool, (MultiArrayIndex)regions.size(),
+        [&](int /*thread*/, MultiArrayIndex k)
+        {
+            MultiArrayIndex label = regions[k],
+                            anchor = anchors[label];
+            Contour contour;
+            extractContour(labels, Shape2(anchor % w, anchor / w), contour);
+            f(label, contour);
+        });
+}
+
+template <class ACCUMULATOR>
+inline void
+setRegionConvexHull(ACCUMULATOR &, MultiArrayIndex, VigraFalseType)
+{}
+
+template <class ACCUMULATOR>
+void
+setRegionConvexHull(ACCUMULATOR & a, MultiArrayIndex label, VigraTrueType)
+{
+    Polygon<TinyVector<double, 2> > hull;
+    detail::convexHullOfContour(acc::getAccumulator<acc::RegionContour>(a, label)(), hull);
+    hull.length();
+    hull.partialArea();
+    acc::getAccumulator<acc::RegionConvexHull>(a, label).setConvexHull(std::move(hull));
+}
+
+} // namespace detail
+
+/** \addtogroup FeatureAccumulators
+*/
+//@{
+
+    /** \brief Extract the contours of all regions in a 2D label image.
+
+        <b> Declarations:</b>
+
+        \code
+        namespace vigra {
+            template <class T, class S, class Point>
+            void
+            extractRegionContours(MultiArrayView<2, T, S> const & labels,
+                                  ArrayVector<Polygon<Point> > & contours,
+                                  ParallelOptions const & options = ParallelOptions());
+
+            template <class T, class S, class Point>
+            void
+            extractRegionContours(MultiArrayView<2, T, S> const & labels,
+                                  ArrayVector<Polygon<Point> > & contours,
+                                  ArrayVector<Polygon<Point> > & convex_hulls,
+                                  ParallelOptions const & options = ParallelOptions());
+        }
+        \endcode
+
+        This is the batched equivalent of calling \ref extractContour() (and \ref convexHull())
+        for every region: a single (parallel) raster scan over \a labels determines an anchor
+        point for all regions (namely their first pixel in scan order), and the contours are
+        then traced in parallel. Since tracing only visits the region boundary, the total
+        cost is proportional to the image size plus the sum of all perimeters, regardless
+        of how many regions there are. The second form additionally computes the convex
+        hull of each contour in the same parallel loop.
+
+        Each contour is traced by the same algorithm as in \ref extractContour(), so that
+        the single-threaded cost is unchanged compared to calling \ref extractContour()
+        for every region with a known anchor. The speed-up only comes from the parallel 
+        anchor scan and tracing.
+
+        The labels must be non-negative integers. Afterwards, <tt>contours[l]</tt> holds the
+        closed, counter-clockwise interpixel contour of label <tt>l</tt> (empty when the
+        label doesn't occur), and <tt>contours.size()</tt> equals the maximum label plus one.
+        Regions consisting of several connected components are represented by the
+        contour of their first component in scan order (as in \ref acc::RegionContour).
+
+        <b> Usage:</b>
+
+        <b>\#include</b> \<vigra/region_contours.hxx\><br/>
+        Namespace: vigra
+
+        \code
+        MultiArray<2, UInt32> labels(width, height);
+        ... // e.g. label connected components
+
+        ArrayVector<Polygon<TinyVector<double, 2> > > contours, hulls;
+        extractRegionContours(labels, contours, hulls, ParallelOptions().numThreads(4));
+
+        for(std::size_t l = 1; l < contours.size(); ++l)
+            std::cout << l << ": solidity " << contours[l].area() / hulls[l].area() << "\n";
+        \endcode
+
+        \see extractRegionContourFeatures()
+    */
+doxygen_overloaded_function(template <...> void extractRegionContours)
+
+template <class T, class S, class Point>
+void
+extractRegionContours(MultiArrayView<2, T, S> const & labels,
+                      ArrayVector<Polygon<Point> > & contours,
+                      ParallelOptions const & options = ParallelOptions())
+{
+    ThreadPool pool(options);
+    std::vector<MultiArrayIndex> anchors;
+    std::vector<MultiArrayIndex> regions = detail::findRegionAnchors(labels, anchors, pool);
+    contours.clear();
+    contours.resize(anchors.size());
+    detail::forEachRegionContour<Polygon<Point> >(labels, anchors, regions, pool,
+        [&](MultiArrayIndex label, Polygon<Point> & contour)
+        {
+            contours[label].swap(contour);
+        });
+}
+
+template <class T, class S, class Point>
+void
+extractRegionContours(MultiArrayView<2, T, S> const & labels,
+                      ArrayVector<Polygon<Point> > & contours,
+                      ArrayVector<Polygon<Point> > & convex_hulls,
+                      ParallelOptions const & options = ParallelOptions())
+{
+    ThreadPool pool(options);
+    std::vector<MultiArrayIndex> anchors;
+    std::vector<MultiArrayIndex> regions = detail::findRegionAnchors(labels, anchors, pool);
+    contours.clear();
+    contours.resize(anchors.size());
+    convex_hulls.clear();
+    convex_hulls.resize(anchors.size());
+    detail::forEachRegionContour<Polygon<Point> >(labels, anchors, regions, pool,
+        [&](MultiArrayIndex label, Polygon<Point> & contour)
+        {
+            detail::convexHullOfContour(contour, convex_hulls[label]);
+            contours[label].swap(contour);
+        });
+}
+
+    /** \brief Compute contour-based features of all regions in a 2D label image in parallel.
+
+        <b> Declaration:</b>
+
+        \code
+        namespace vigra {
+            template <class T, class S, class ACCUMULATOR>
+            void
+            extractRegionContourFeatures(MultiArrayView<2, T, S> const & labels,
+                                         ACCUMULATOR & a,
+                                         ParallelOptions const & options = ParallelOptions());
+        }
+        \endcode
+
+        \a a must be an \ref acc::AccumulatorChainArray over 2D arrays whose selected features
+        include \ref acc::RegionContour (directly or as a dependency, e.g. via
+        \ref acc::RegionPerimeter, \ref acc::RegionCircularity, \ref acc::RegionConvexHull,
+        or \ref acc::RegionConvexity). The function traces the contours of all regions
+        as described in \ref extractRegionContours() and stores them in the chain. When
+        \ref acc::RegionConvexHull is part of the chain, the hulls are computed in the same
+        parallel loop. The region count of \a a is set according to the maximum label,
+        and the chain's ignored label (see <tt>ignoreLabel()</tt>) is skipped.
+
+        The remaining (pixel-based) features of the chain must then be computed by
+        \ref extractFeatures() as usual, with the same label array. This will no longer
+        trace any contours, so that the serial part of feature extraction doesn't grow
+        with the number of regions' perimeters.
+
+        <b> Usage:</b>
+
+        <b>\#include</b> \<vigra/region_contours.hxx\><br/>
+        Namespace: vigra
+
+        \code
+        using namespace vigra::acc;
+
+        MultiArray<2, float>  data(width, height);
+        MultiArray<2, UInt32> labels(width, height);
+        ...
+
+        AccumulatorChainArray<CoupledArrays<2, float, UInt32>,
+                              Select<DataArg<1>, LabelArg<2>,
+                                     Mean, Count, RegionPerimeter, RegionConvexity> > a;
+        a.ignoreLabel(0);
+
+        extractRegionContourFeatures(labels, a, ParallelOptions().numThreads(4));
+        extractFeatures(data, labels, a);
+
+        double convexity = get<RegionConvexity>(a, 1);
+        \endcode
+    */
+template <class T, class S, class ACCUMULATOR>
+void
+extractRegionContourFeatures(MultiArrayView<2, T, S> const & labels,
+                             ACCUMULATOR & a,
+                             ParallelOptions const & options = ParallelOptions())
+{
+    typedef Polygon<TinyVector<double, 2> > Contour;
+    typedef typename Contains<typename ACCUMULATOR::RegionTags, acc::RegionConvexHull>::type HasConvexHull;
+
+    ThreadPool pool(options);
+    std::vector<MultiArrayIndex> anchors;
+    std::vector<MultiArrayIndex> regions = detail::findRegionAnchors(labels, anchors, pool);
+    if(a.ignoredLabel() >= 0)
+        regions.erase(std::remove(regions.begin(), regions.end(), a.ignoredLabel()), regions.end());
+    if(a.maxRegionLabel() < (MultiArrayIndex)anchors.size() - 1)
+        a.setMaxRegionLabel((unsigned)anchors.size() - 1);
+
+    detail::forEachRegionContour<Contour>(labels, anchors, regions, pool,
+        [&](MultiArrayIndex label, Contour & contour)
+        {
+            // evaluate the cached polygon properties while we are running in parallel
+            contour.length();
+            contour.partialArea();
+            acc::getAccumulator<acc::RegionContour>(a, label).setContour(std::move(contour));
+            detail::setRegionConvexHull(a, label, HasConvexHull());
+        });
+}
+
+//@}
+
+} // namespace vigra
+
+#endif // VIGRA_REGION_CONTOURS_HXX
@@ -47,6 +47,8 @@
 #include "multi_shape.hxx"
 #include "multi_pointoperators.hxx"
 #include "voxelneighborhood.hxx"
+#include "multi_array.hxx"
+#include "multi_gridgraph.hxx"
 
 namespace vigra {
 
@@ -161,6 +163,295 @@ public:
     };
 };
 
+    // Candidate of seededRegionGrowingMultiArray(), stored by value.
+    // Locations are scan-order indices into the padded label array.
+template <class COST>
+struct SeedRgCandidate
+{
+    MultiArrayIndex location_, nearest_, dist_, count_;
+    COST cost_;
+    int label_;
+
+    SeedRgCandidate()
+    {}
+
+    SeedRgCandidate(MultiArrayIndex location, MultiArrayIndex nearest,
+                    MultiArrayIndex dist, COST const & cost,
+                    MultiArrayIndex count, int label)
+    : location_(location), nearest_(nearest),
+      dist_(dist), count_(count),
+      cost_(cost), label_(label)
+    {}
+
+        // must implement > since the heap looks for the largest element
+    struct Compare
+    {
+        bool operator()(SeedRgCandidate const & l,
+                        SeedRgCandidate const & r) const
+        {
+            if(r.cost_ == l.cost_)
+            {
+                if(r.dist_ == l.dist_) return r.count_ < l.count_;
+
+                return r.dist_ < l.dist_;
+            }
+
+            return r.cost_ < l.cost_;
+        }
+    };
+
+        // tie-breaking within a bucket of equal cost
+    struct CompareDistance
+    {
+        bool operator()(SeedRgCandidate const & l,
+                        SeedRgCandidate const & r) const
+        {
+            if(r.dist_ == l.dist_) return r.count_ < l.count_;
+
+            return r.dist_ < l.dist_;
+        }
+    };
+};
+
+    // Binary heap of candidates in a flat array.
+template <class CANDIDATE>
+class SeedRgHeapQueue
+{
+  public:
+    typedef CANDIDATE value_type;
+
+    bool empty() const
+    {
+        return heap_.empty();
+    }
+
+    value_type const & top() const
+    {
+        return heap_.front();
+    }
+
+    void pop()
+    {
+        std::pop_heap(heap_.begin(), heap_.end(), typename CANDIDATE::Compare());
+        heap_.pop_back();
+    }
+
+    void push(value_type const & v)
+    {
+        heap_.push_back(v);
+        std::push_heap(heap_.begin(), heap_.end(), typename CANDIDATE::Compare());
+    }
+
+  private:
+    std::vector<value_type> heap_;
+};
+
+    // Bucket queue for integer costs in [minCost, maxCost]. Each bucket is
+    // a small heap ordered by distance and insertion order, so that the
+    // candidates are returned in the same order as by SeedRgHeapQueue.
+template <class CANDIDATE>
+class SeedRgBucketQueue
+{
+  public:
+    typedef CANDIDATE value_type;
+
+    SeedRgBucketQueue(double minCost, double maxCost)
+    : buckets_((std::size_t)(maxCost - minCost) + 1),
+      minCost_(minCost),
+      size_(0),
+      top_((std::ptrdiff_t)buckets_.size())
+    {}
+
+    bool empty() const
+    {
+        return size_ == 0;
+    }
+
+    value_type const & top() const
+    {
+        return buckets_[top_].front();
+    }
+
+    void pop()
+    {
+        std::vector<value_type> & bucket = buckets_[top_];
+        std::pop_heap(bucket.begin(), bucket.end(), typename CANDIDATE::CompareDistance());
+        bucket.pop_back();
+        --size_;
+        if(bucket.empty()) // release memory, the bucket may not be used again for a long time
+            std::vector<value_type>().swap(bucket);
+
+        while(top_ < (std::ptrdiff_t)buckets_.size() && buckets_[top_].empty())
+            ++top_;
+    }
+
+    void push(value_type const & v)
+    {
+        std::ptrdiff_t k = (std::ptrdiff_t)(v.cost_ - minCost_);
+        std::vector<value_type> & bucket = buckets_[k];
+        bucket.push_back(v);
+        std::push_heap(bucket.begin(), bucket.end(), typename CANDIDATE::CompareDistance());
+        ++size_;
+
+        if(k < top_)
+            top_ = k;
+    }
+
+  private:
+    ArrayVector<std::vector<value_type> > buckets_;
+    double minCost_;
+    std::size_t size_;
+    std::ptrdiff_t top_;
+};
+
+template <unsigned int N, class T1, class S1,
+          class RegionStatisticsArray, class QUEUE>
+void
+seededRegionGrowingMultiArrayImpl(MultiArrayView<N, T1, S1> const & src,
+                                  MultiArrayView<N, int> regions,
+                                  RegionStatisticsArray & stats,
+                                  SRGType srgType,
+                                  NeighborhoodType neighborhood,
+                                  double max_cost,
+                                  QUEUE & queue)
+{
+    typedef typename MultiArrayShape<N>::type       Shape;
+    typedef typename QUEUE::value_type              Candidate;
+
+    // 'regions' has a one-pixel border marked with SRGWatershedLabel,
+    // so that neighbors can be visited without bounds checks
+    GridGraph<N, undirected_tag> graph(src.shape(), neighborhood);
+    int degree = (int)graph.maxDegree();
+    ArrayVector<Shape>           neighborShape(degree);
+    ArrayVector<MultiArrayIndex> neighborOffset(degree), neighborDist(degree);
+    for(int k=0; k<degree; ++k)
+    {
+        neighborShape[k]  = graph.neighborOffset(k);
+        neighborOffset[k] = dot(neighborShape[k], regions.stride());
+        neighborDist[k]   = squaredNorm(neighborShape[k]);
+    }
+
+    int * labels = regions.data();
+    Shape paddedShape(regions.shape());
+    MultiArrayIndex count = 0;
+
+    // find candidate pixels for growing and fill queue
+    MultiCoordinateIterator<N> iter(src.shape()),
+                               end = iter.getEndIterator();
+    for(; iter != end; ++iter)
+    {
+        MultiArrayIndex location = dot(*iter + Shape(1), regions.stride());
+        if(labels[location] != 0)
+            continue;
+        for(int k=0; k<degree; ++k)
+        {
+            int neighbor = labels[location + neighborOffset[k]];
+            if(neighbor > 0)
+                queue.push(Candidate(location, location + neighborOffset[k], neighborDist[k],
+                                     stats[neighbor].cost(src[*iter]), count++, neighbor));
+        }
+    }
+
+    // perform region growing
+    Shape pos, nearest;
+    while(!queue.empty())
+    {
+        Candidate candidate = queue.top();
+        queue.pop();
+
+        if((srgType & StopAtThreshold) != 0 && candidate.cost_ > max_cost)
+            break;
+
+        MultiArrayIndex location = candidate.location_;
+        if(labels[location]) // already labelled region / watershed?
+            continue;
+
+        int lab = candidate.label_;
+        if((srgType & KeepContours) != 0)
+        {
+            for(int k=0; k<degree; ++k)
+            {
+                int neighbor = labels[location + neighborOffset[k]];
+                if(neighbor > 0 && neighbor != lab)
+                {
+                    lab = SRGWatershedLabel;
+                    break;
+                }
+            }
+        }
+
+        labels[location] = lab;
+
+        if((srgType & KeepContours) == 0 || lab > 0)
+        {
+            detail::ScanOrderToCoordinate<N>::exec(location, paddedShape, pos);
+            detail::ScanOrderToCoordinate<N>::exec(candidate.nearest_, paddedShape, nearest);
+            pos -= Shape(1);
+            nearest -= Shape(1);
+
+            // update statistics
+            stats[lab](src[pos]);
+
+            // search neighborhood for new candidate pixels
+            for(int k=0; k<degree; ++k)
+            {
+                if(labels[location + neighborOffset[k]] == 0)
+                {
+                    Shape target(pos + neighborShape[k]);
+                    queue.push(Candidate(location + neighborOffset[k], candidate.nearest_,
+                                         squaredNorm(target - nearest),
+                                         stats[lab].cost(src[target]), count++, lab));
+                }
+            }
+        }
+    }
+}
+
+template <unsigned int N, class T1, class S1,
+          class RegionStatisticsArray>
+void
+seededRegionGrowingMultiArray(MultiArrayView<N, T1, S1> const & src,
+                              MultiArrayView<N, int> regions,
+                              RegionStatisticsArray & stats,
+                              SRGType srgType,
+                              NeighborhoodType neighborhood,
+                              double max_cost,
+                              VigraFalseType /* general costs */)
+{
+    typedef typename RegionStatisticsArray::value_type RegionStatistics;
+    typedef typename PromoteTraits<typename RegionStatistics::cost_type, double>::Promote CostType;
+
+    SeedRgHeapQueue<SeedRgCandidate<CostType> > queue;
+    seededRegionGrowingMultiArrayImpl(src, regions, stats, srgType, neighborhood, max_cost, queue);
+}
+
+template <unsigned int N, class T1, class S1,
+          class RegionStatisticsArray>
+void
+seededRegionGrowingMultiArray(MultiArrayView<N, T1, S1> const & src,
+                              MultiArrayView<N, int> regions,
+                              RegionStatisticsArray & stats,
+                              SRGType srgType,
+                              NeighborhoodType neighborhood,
+                              double max_cost,
+                              VigraTrueType /* 8- or 16-bit integer costs */)
+{
+    typedef typename RegionStatisticsArray::value_type RegionStatistics;
+    typedef typename RegionStatistics::cost_type       StatisticsCostType;
+    typedef typename PromoteTraits<StatisticsCostType, double>::Promote CostType;
+
+    SeedRgBucketQueue<SeedRgCandidate<CostType> >
+        queue(NumericTraits<StatisticsCostType>::min(), NumericTraits<StatisticsCostType>::max());
+    seededRegionGrowingMultiArrayImpl(src, regions, stats, srgType, neighborhood, max_cost, queue);
+}
+
+template <class COST>
+struct SeedRgUseBuckets
+{
+    static const bool value = NumericTraits<COST>::isIntegral::value && sizeof(COST) <= 2;
+    typedef typename IfBool<value, VigraTrueType, VigraFalseType>::type type;
+};
+
 } // namespace detail
 
 /** \addtogroup Superpixels
@@ -662,6 +953,103 @@ seededRegionGrowing3D(MultiArrayView<3, T1, S1> const & img1,
                           stats);
 }
 
+/********************************************************/
+/*                                                      */
+/*             seededRegionGrowingMultiArray            */
+/*                                                      */
+/********************************************************/
+
+/** \brief Seeded Region Growing in arbitrary dimensions.
+
+    This function implements the same algorithm as \ref seededRegionGrowing() and
+    \ref seededRegionGrowing3D(), but works for arrays of arbitrary dimension and uses
+    the neighborhoods of \ref vigra::GridGraph: <tt>DirectNeighborhood</tt> (the default,
+    i.e. 4-neighborhood in 2D and 6-neighborhood in 3D) or <tt>IndirectNeighborhood</tt>
+    (8- and 26-neighborhood respectively). The meaning of the parameters <tt>srgType</tt>,
+    <tt>max_cost</tt>, and of the region statistics functor is the same as in
+    \ref seededRegionGrowing3D(). In particular, if a candidate could be merged into more
+    than one region with identical cost, the nearest region is favoured.
+
+    In contrast to the older functions, candidates are not allocated individually on the heap,
+    but stored by value in a flat priority queue. When the <tt>cost_type</tt> of the region
+    statistics is an 8- or 16-bit integer (e.g. for \ref SeedRgDirectValueFunctor on
+    <tt>UInt8</tt> data), a bucket queue with one bucket per cost value is used instead of
+    a binary heap. The result is the same in both cases. The arrays \a seeds and \a labels
+    may refer to the same memory.
+
+    <b> Declaration:</b>
+
+    \code
+    namespace vigra {
+        template <unsigned int N, class T1, class S1,
+                                  class TS, class AS,
+                                  class T2, class S2,
+                  class RegionStatisticsArray>
+        void
+        seededRegionGrowingMultiArray(MultiArrayView<N, T1, S1> const & src,
+                                      MultiArrayView<N, TS, AS> const & seeds,
+                                      MultiArrayView<N, T2, S2>         labels,
+                                      RegionStatisticsArray &           stats,
+                                      SRGType                           srgType = CompleteGrow,
+                                      NeighborhoodType                  neighborhood = DirectNeighborhood,
+                                      double                            max_cost = NumericTraits<double>::max());
+    }
+    \endcode
+
+    <b> Usage:</b>
+
+    <b>\#include</b> \<vigra/seededregiongrowing3d.hxx\><br>
+    Namespace: vigra
+
+    \code
+    MultiArray<3, UInt8>        gradient(shape);
+    MultiArray<3, unsigned int> labels(shape);
+    ... // compute boundary indicator and place seeds in 'labels'
+
+    unsigned int max_region_label = labels.max();
+    ArrayOfRegionStatistics<SeedRgDirectValueFunctor<UInt8> > stats(max_region_label);
+
+    // grow the seeds over the entire volume, using the 26-neighborhood
+    seededRegionGrowingMultiArray(gradient, labels, labels, stats,
+                                  CompleteGrow, IndirectNeighborhood);
+    \endcode
+*/
+doxygen_overloaded_function(template <...> void seededRegionGrowingMultiArray)
+
+template <unsigned int N, class T1, class S1,
+                          class TS, class AS,
+                          class T2, class S2,
+          class RegionStatisticsArray>
+void
+seededRegionGrowingMultiArray(MultiArrayView<N, T1, S1> const & src,
+                              MultiArrayView<N, TS, AS> const & seeds,
+                              MultiArrayView<N, T2, S2>         labels,
+                              RegionStatisticsArray &           stats,
+                              SRGType                           srgType = CompleteGrow,
+                              NeighborhoodType                  neighborhood = DirectNeighborhood,
+                              double                            max_cost = NumericTraits<double>::max())
+{
+    typedef typename MultiArrayShape<N>::type Shape;
+    typedef typename RegionStatisticsArray::value_type::cost_type CostType;
+
+    vigra_precondition(src.shape() == seeds.shape() && src.shape() == labels.shape(),
+        "seededRegionGrowingMultiArray(): shape mismatch between input and output.");
+
+    // copy seed image in an image with border
+    MultiArray<N, int> regions(src.shape() + Shape(2));
+    initMultiArrayBorder(regions, 1, SRGWatershedLabel);
+    MultiArrayView<N, int> interior(regions.subarray(Shape(1), src.shape() + Shape(1)));
+    interior = seeds;
+
+    detail::seededRegionGrowingMultiArray(src, regions, stats, srgType, neighborhood, max_cost,
+                                          typename detail::SeedRgUseBuckets<CostType>::type());
+
+    // write result
+    transformMultiArray(interior, labels, detail::UnlabelWatersheds());
+}
+
+//@}
+
 } // namespace vigra
 
 #endif // VIGRA_SEEDEDREGIONGROWING_HXX
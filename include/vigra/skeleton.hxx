@@ -43,6 +43,9 @@
 #include "iteratorfacade.hxx"
 #include "pixelneighborhood.hxx"
 #include "graph_algorithms.hxx"
+#include "multi_distance.hxx"
+#include "threadpool.hxx"
+#include "polygon.hxx"
 
 namespace vigra
 {
@@ -245,13 +248,279 @@ struct CheckForHole
     }
 };
 
+    // Lookup tables for topology tests in the 26-neighborhood of a voxel. A
+    // neighborhood configuration is a 26-bit mask whose bit k is set when the
+    // neighbor GridGraph<3>::neighborOffset(k) belongs to the object. For each
+    // neighbor, the tables hold the masks of its 26- and 6-adjacent neighbors
+    // within the 3x3x3 cube, such that connected components of a configuration
+    // are found by a few bit operations.
+class SkeletonNeighborhood3D
+{
+  public:
+    enum { Size = 26 };
+
+    SkeletonNeighborhood3D()
+    : n18_(0)
+    , faces_(0)
+    {
+        GridGraph<3> g(Shape3(3), IndirectNeighborhood);
+        for(int k = 0; k < Size; ++k)
+            offsets_[k] = g.neighborOffset(k);
+        for(int k = 0; k < Size; ++k)
+        {
+            MultiArrayIndex l1 = sum(abs(offsets_[k]));
+            if(l1 <= 2)
+                n18_ |= 1u << k;
+            if(l1 == 1)
+                faces_ |= 1u << k;
+            adjacent26_[k] = adjacent6_[k] = 0;
+            for(int j = 0; j < Size; ++j)
+            {
+                if(j == k)
+                    continue;
+                Shape3 d(abs(offsets_[k] - offsets_[j]));
+                if(max(d) == 1)
+                    adjacent26_[k] |= 1u << j;
+                if(sum(d) == 1)
+                    adjacent6_[k] |= 1u << j;
+            }
+        }
+    }
+
+    Shape3 const & offset(int k) const
+    {
+        return offsets_[k];
+    }
+
+        // configuration of the voxel at 'p', given the linear offsets of the neighbors
+    template <class T>
+    UInt32 configuration(T const * p, MultiArrayIndex const * strideOffsets) const
+    {
+        UInt32 v = 0;
+        for(int k = 0; k < Size; ++k)
+            if(p[strideOffsets[k]] != 0)
+                v |= 1u << k;
+        return v;
+    }
+
+        // number of 26-connected components of the neighbors in 'config'
+    int componentCount(UInt32 config) const
+    {
+        int count = 0;
+        while(config != 0)
+        {
+            config &= ~flood(config, config & (~config + 1), adjacent26_);
+            ++count;
+        }
+        return count;
+    }
+
+        // A voxel is simple (i.e. can be removed without changing the topology) iff its
+        // object neighbors form a single 26-connected component, and its background
+        // neighbors in the 18-neighborhood form a single 6-connected component that
+        // is 6-adjacent to the voxel (Bertrand and Malandain, 1994).
+    bool isSimple(UInt32 config) const
+    {
+        if(config == 0 || flood(config, config & (~config + 1), adjacent26_) != config)
+            return false;
+        UInt32 background = ~config & n18_,
+               faces = background & faces_;
+        if(faces == 0)
+            return false;
+        return (faces & ~flood(background, faces & (~faces + 1), adjacent6_)) == 0;
+    }
+
+  private:
+        // the component of 'set' containing 'seed' w.r.t. the given adjacency
+    static UInt32 flood(UInt32 set, UInt32 seed, UInt32 const * adjacent)
+    {
+        UInt32 component = seed, todo = seed;
+        while(todo != 0)
+        {
+            UInt32 bit = todo & (~todo + 1);
+            todo &= ~bit;
+            UInt32 added = adjacent[log2i(bit)] & set & ~component;
+            component |= added;
+            todo |= added;
+        }
+        return component;
+    }
+
+    Shape3 offsets_[Size];
+    UInt32 adjacent26_[Size], adjacent6_[Size];
+    UInt32 n18_, faces_;
+};
+
+inline SkeletonNeighborhood3D const &
+skeletonNeighborhood3D()
+{
+    static const SkeletonNeighborhood3D neighborhood;
+    return neighborhood;
+}
+
+    // Distance-ordered thinning of the object voxels (mask != 0) in a padded
+    // array, whose border voxels must be zero. Simple voxels are removed in order
+    // of increasing cost (ties in FIFO order), and end points (voxels with a single
+    // object neighbor) are preserved, which results in a curve skeleton.
+template <class Cost>
+void
+skeletonThinning3D(MultiArray<3, UInt8> & mask, MultiArray<3, Cost> const & cost)
+{
+    typedef std::pair<Cost, MultiArrayIndex>                  Priority;
+    typedef SkeletonSimplePoint<MultiArrayIndex, Priority>    SP;
+
+    SkeletonNeighborhood3D const & neighborhood = skeletonNeighborhood3D();
+    MultiArrayIndex offsets[SkeletonNeighborhood3D::Size];
+    for(int k = 0; k < SkeletonNeighborhood3D::Size; ++k)
+        offsets[k] = dot(neighborhood.offset(k), mask.stride());
+
+    UInt8 * m = mask.data();
+    auto isRemovable = [&](MultiArrayIndex i)
+    {
+        UInt32 config = neighborhood.configuration(m + i, offsets);
+        return (config & (config - 1)) != 0 && neighborhood.isSimple(config);
+    };
+
+    std::priority_queue<SP, std::vector<SP>, std::greater<SP> >  pqueue;
+    MultiArrayIndex order = 0;
+    for(MultiArrayIndex i = 0; i < mask.size(); ++i)
+        if(m[i] != 0 && isRemovable(i))
+            pqueue.push(SP(i, Priority(cost[i], order++)));
+
+    while(pqueue.size())
+    {
+        MultiArrayIndex i = pqueue.top().point;
+        pqueue.pop();
+
+        if(m[i] == 0 || !isRemovable(i))
+            continue; // voxel already deleted or no longer simple
+
+        m[i] = 0;
+        for(int k = 0; k < SkeletonNeighborhood3D::Size; ++k)
+        {
+            MultiArrayIndex j = i + offsets[k];
+            if(m[j] != 0 && isRemovable(j))
+                pqueue.push(SP(j, Priority(cost[j], order++)));
+        }
+    }
+}
+
+    // Iteratively remove the terminal branches of a curve skeleton in a padded
+    // array (see skeletonThinning3D()), smallest length or salience first.
+    // A terminal branch consists of the voxels reachable from an end point without
+    // passing a junction (a voxel whose neighbors form at least three components).
+    // Since branches only grow when a junction dissolves, their priorities are
+    // updated lazily. Curves without junctions and loops are never removed.
+template <class Cost>
+void
+skeletonPruning3D(MultiArray<3, UInt8> & mask, MultiArray<3, Cost> const & cost,
+                  bool useSalience, bool relative, double threshold)
+{
+    typedef SkeletonSimplePoint<MultiArrayIndex, double>    Branch;
+
+    SkeletonNeighborhood3D const & neighborhood = skeletonNeighborhood3D();
+    MultiArrayIndex offsets[SkeletonNeighborhood3D::Size];
+    double steps[SkeletonNeighborhood3D::Size];
+    for(int k = 0; k < SkeletonNeighborhood3D::Size; ++k)
+    {
+        offsets[k] = dot(neighborhood.offset(k), mask.stride());
+        steps[k] = norm(neighborhood.offset(k));
+    }
+
+    UInt8 * m = mask.data();
+    auto components = [&](MultiArrayIndex i)
+    {
+        return neighborhood.componentCount(neighborhood.configuration(m + i, offsets));
+    };
+
+    std::vector<UInt32> visited(mask.size(), 0);
+    UInt32 stamp = 0;
+    std::vector<MultiArrayIndex> voxels;
+    std::vector<double> lengths;
+
+    // collect the branch starting at end point 'e' in 'voxels' and return its
+    // length or salience, or -1 if it doesn't end at a junction
+    auto branch = [&](MultiArrayIndex e) -> double
+    {
+        ++stamp;
+        voxels.assign(1, e);
+        lengths.assign(1, 0.0);
+        visited[e] = stamp;
+        double length = -1.0;
+        MultiArrayIndex junction = 0;
+        for(std::size_t h = 0; h < voxels.size(); ++h)
+        {
+            for(int k = 0; k < SkeletonNeighborhood3D::Size; ++k)
+            {
+                MultiArrayIndex j = voxels[h] + offsets[k];
+                if(m[j] == 0 || visited[j] == stamp)
+                    continue;
+                visited[j] = stamp;
+                int c = components(j);
+                if(c == 1)
+                    return -1.0;  // another end point => not a terminal branch
+                if(c >= 3)
+                {
+                    if(length < 0.0 || lengths[h] + steps[k] < length)
+                    {
+                        length = lengths[h] + steps[k];
+                        junction = j;
+                    }
+                    continue;
+                }
+                voxels.push_back(j);
+                lengths.push_back(lengths[h] + steps[k]);
+            }
+        }
+        if(length < 0.0 || !useSalience)
+            return length;
+        return (length + 0.5) / std::max<double>(cost[junction], 0.5);
+    };
+
+    std::priority_queue<Branch, std::vector<Branch>, std::greater<Branch> >  pqueue;
+    double maxValue = 0.0;
+    for(MultiArrayIndex i = 0; i < mask.size(); ++i)
+    {
+        if(m[i] == 0 || components(i) != 1)
+            continue;
+        double value = branch(i);
+        if(value >= 0.0)
+        {
+            pqueue.push(Branch(i, value));
+            maxValue = std::max(maxValue, value);
+        }
+    }
+    if(relative)
+        threshold *= maxValue;
+
+    while(pqueue.size())
+    {
+        Branch b = pqueue.top();
+        pqueue.pop();
+        if(b.cost >= threshold)
+            break;
+        if(m[b.point] == 0)
+            continue;
+        double value = branch(b.point);
+        if(value < 0.0)
+            continue;
+        if(value > b.cost)
+        {
+            pqueue.push(Branch(b.point, value));  // the branch has grown
+            continue;
+        }
+        for(std::size_t h = 0; h < voxels.size(); ++h)
+            m[voxels[h]] = 0;
+    }
+}
+
 } // namespace detail
 
 /** \addtogroup DistanceTransform
 */
 //@{
 
-    /** \brief Option object for \ref skeletonizeImage()
+    /** \brief Option object for \ref skeletonizeImage() and \ref skeletonizeVolume()
     */
 struct SkeletonOptions
 {
@@ -272,14 +541,16 @@ struct SkeletonOptions
 
     SkeletonMode mode;
     double pruning_threshold;
+    int num_threads;
 
         /** \brief construct with default settings
 
-            (default: <tt>pruneSalienceRelative(0.2, true)</tt>)
+            (default: <tt>pruneSalienceRelative(0.2, true)</tt>, no threads)
         */
     SkeletonOptions()
     : mode(SkeletonMode(PruneSalienceRelative | PreserveTopology))
     , pruning_threshold(0.2)
+    , num_threads(ParallelOptions::NoThreads)
     {}
 
         /** \brief return the un-pruned skeletong
@@ -387,6 +658,19 @@ struct SkeletonOptions
             mode = Prune;
         return *this;
     }
+
+        /** \brief number of threads used by \ref skeletonizeVolume()
+
+            Regions are skeletonized independently, so that different regions can be
+            processed in parallel. The value is interpreted as in \ref ParallelOptions
+            (e.g. <tt>ParallelOptions::Auto</tt> uses all hardware threads).
+            Default: <tt>ParallelOptions::NoThreads</tt>, i.e. sequential processing.
+        */
+    SkeletonOptions & numThreads(int n)
+    {
+        num_threads = n;
+        return *this;
+    }
 };
 
 template <class T1, class S1,
@@ -955,6 +1239,177 @@ skeletonizeImage(MultiArrayView<2, T1, S1> const & labels,
     skeletonizeImageImpl(labels, dest, (ArrayVector<SkeletonFeatures>*)0, options);
 }
 
+/********************************************************/
+/*                                                      */
+/*                   skeletonizeVolume                  */
+/*                                                      */
+/********************************************************/
+
+    /** \brief Skeletonization of all regions in a labeled 3D volume.
+
+        <b> Declarations:</b>
+
+        \code
+        namespace vigra {
+            template <class T1, class S1,
+                      class T2, class S2>
+            void
+            skeletonizeVolume(MultiArrayView<3, T1, S1> const & labels,
+                              MultiArrayView<3, T2, S2> dest,
+                              SkeletonOptions const & options = SkeletonOptions());
+        }
+        \endcode
+
+        This function computes a curve skeleton for each region in the 3D label volume \a labels
+        and paints the results into the result volume \a dest. Input label <tt>0</tt> is
+        interpreted as background and always ignored. Skeletons will be marked with the same
+        label as the corresponding region, and non-skeleton voxels will receive label <tt>0</tt>.
+
+        For each region, the algorithm proceeds in the following steps:
+        <ol>
+        <li>Compute the Euclidean distance of each voxel to the region boundary
+            (see \ref boundaryMultiDistance(), the transform is computed once for all regions).</li>
+        <li>Topology-preserving thinning: repeatedly delete <i>simple</i> voxels (i.e. voxels whose
+            deletion doesn't change the number of components, holes, or cavities) in order of increasing
+            boundary distance, but keep end points (voxels with a single 26-neighbor in the
+            skeleton). Simple voxels are recognized from their 26-neighborhood configuration using
+            precomputed neighbor adjacency tables. The result is 26-connected, thin, and
+            homotopy equivalent to the region.</li>
+        <li>Distance-ordered pruning: terminal branches (i.e. skeleton parts between an end point
+            and a branching point) are deleted in order of increasing length or salience, as long
+            as this attribute is below the pruning threshold. The salience of a branch is its
+            length divided by the boundary distance of its branching point. Since only terminal
+            branches are pruned, the skeleton topology is always preserved.</li>
+        </ol>
+
+        Regions are processed independently of each other, and in parallel when
+        <tt>options.numThreads()</tt> requests more than one thread. The result does not depend
+        on the number of threads. The following pruning strategies are supported:
+        <tt>dontPrune()</tt>, <tt>pruneLength()</tt>, <tt>pruneLengthRelative()</tt>,
+        <tt>pruneSalience()</tt>, and <tt>pruneSalienceRelative()</tt> (the default), where
+        relative thresholds refer to the maximum initial attribute among the branches of each region.
+        The remaining options of \ref SkeletonOptions are specific to \ref skeletonizeImage().
+
+        <b> Usage:</b>
+
+        <b>\#include</b> \<vigra/skeleton.hxx\><br/>
+        Namespace: vigra
+
+        \code
+        Shape3 shape(width, height, depth);
+        MultiArray<3, UInt32> source(shape);
+        MultiArray<3, UInt32> dest(shape);
+        ...
+
+        // Skeletonize on all cores and remove branches shorter than 5 voxels.
+        skeletonizeVolume(source, dest,
+                          SkeletonOptions().pruneLength(5.0).numThreads(ParallelOptions::Auto));
+        \endcode
+
+        \see vigra::skeletonizeImage(), vigra::boundaryMultiDistance()
+    */
+doxygen_overloaded_function(template <...> void skeletonizeVolume)
+
+template <class T1, class S1,
+          class T2, class S2>
+void
+skeletonizeVolume(MultiArrayView<3, T1, S1> const & labels,
+                  MultiArrayView<3, T2, S2> dest,
+                  SkeletonOptions const & options = SkeletonOptions())
+{
+    vigra_precondition(labels.shape() == dest.shape(),
+        "skeletonizeVolume(): shape mismatch between input and output.");
+
+    int prune_mode = options.mode & ~SkeletonOptions::PreserveTopology;
+    vigra_precondition(prune_mode == SkeletonOptions::DontPrune ||
+                       prune_mode == SkeletonOptions::PruneLength ||
+                       prune_mode == SkeletonOptions::PruneLengthRelative ||
+                       prune_mode == SkeletonOptions::PruneSalience ||
+                       prune_mode == SkeletonOptions::PruneSalienceRelative,
+        "skeletonizeVolume(): pruning mode not supported in 3D.");
+
+    ParallelOptions parallel_options = ParallelOptions().numThreads(options.num_threads);
+
+    MultiArray<3, float> distance(labels.shape());
+    boundaryMultiDistance(labels, distance, true, InterpixelBoundary, parallel_options);
+
+    // bounding boxes of all regions
+    std::map<T1, std::pair<Shape3, Shape3> > boxes;
+    for(MultiCoordinateIterator<3> p(labels.shape()), end = p.getEndIterator(); p != end; ++p)
+    {
+        T1 label = labels[*p];
+        if(label == 0)
+            continue;
+        auto box = boxes.find(label);
+        if(box == boxes.end())
+            boxes[label] = std::make_pair(*p, *p + Shape3(1));
+        else
+        {
+            box->second.first = min(box->second.first, *p);
+            box->second.second = max(box->second.second, *p + Shape3(1));
+        }
+    }
+
+    // process large regions first for better load balancing
+    typedef std::pair<T1, std::pair<Shape3, Shape3> > Region;
+    std::vector<Region> regions(boxes.begin(), boxes.end());
+    std::stable_sort(regions.begin(), regions.end(),
+        [](Region const & a, Region const & b)
+        {
+            return prod(a.second.second - a.second.first) > prod(b.second.second - b.second.first);
+        });
+
+    dest.init(0);
+
+    auto skeletonizeRegion = [&](Region const & region)
+    {
+        T1 label = region.first;
+        Shape3 begin = region.second.first,
+               shape = region.second.second - begin;
+
+        // work on a copy with a one voxel zero border, so that neighbors are always valid
+        MultiArray<3, UInt8> mask(shape + Shape3(2));
+        MultiArray<3, float> cost(shape + Shape3(2));
+        for(MultiCoordinateIterator<3> p(shape), end = p.getEndIterator(); p != end; ++p)
+        {
+            if(labels[begin + *p] != label)
+                continue;
+            mask[*p + Shape3(1)] = 1;
+            cost[*p + Shape3(1)] = distance[begin + *p];
+        }
+
+        detail::skeletonThinning3D(mask, cost);
+
+        if(prune_mode != SkeletonOptions::DontPrune)
+            detail::skeletonPruning3D(mask, cost,
+                                      (options.mode & SkeletonOptions::Salience) != 0,
+                                      (options.mode & SkeletonOptions::Relative) != 0,
+                                      options.pruning_threshold);
+
+        // regions may overlap in their bounding boxes, but never in their voxels
+        for(MultiCoordinateIterator<3> p(shape), end = p.getEndIterator(); p != end; ++p)
+            if(mask[*p + Shape3(1)] != 0)
+                dest[begin + *p] = label;
+    };
+
+    if(parallel_options.getActualNumThreads() <= 1 || regions.size() <= 1)
+    {
+        for(std::size_t k = 0; k < regions.size(); ++k)
+            skeletonizeRegion(regions[k]);
+    }
+    else
+    {
+        ThreadPool pool(parallel_options);
+        threading::atomic_long next(0);
+        parallel_foreach(pool, pool.nThreads(),
+            [&](int /*thread*/, MultiArrayIndex /*k*/)
+            {
+                for(long k = next++; k < (long)regions.size(); k = next++)
+                    skeletonizeRegion(regions[k]);
+            });
+    }
+}
+
 template <class T, class S>
 void
 extractSkeletonFeatures(MultiArrayView<2, T, S> const & labels,
@@ -42,6 +42,7 @@
 #include "numerictraits.hxx"
 #include "accumulator.hxx"
 #include "array_vector.hxx"
+#include "threadpool.hxx"
 
 namespace vigra {
 
@@ -155,15 +156,20 @@ generateSlicSeeds(MultiArrayView<N, T, S1> const & boundaryIndicatorImage,
     see slicSuperpixels() for detailed examples.
 */
 struct SlicOptions
+: public ParallelOptions
 {
         /** \brief Create options object with default settings.
 
-            Defaults are: perform 10 iterations, determine a size limit for superpixels automatically.
+            Defaults are: perform 10 iterations, determine a size limit for superpixels automatically,
+            run sequentially.
         */
     SlicOptions()
-    : iter(10),
+    : ParallelOptions(),
+      iter(10),
       sizeLimit(0)
-    {}
+    {
+        ParallelOptions::numThreads(ParallelOptions::NoThreads);
+    }
 
         /** \brief Number of iterations.
 
@@ -187,6 +193,19 @@ struct SlicOptions
         return *this;
     }
 
+        /** \brief Number of threads (see \ref ParallelOptions).
+
+            The result only depends on the number of threads via the summation
+            order of the cluster means, i.e. up to floating-point round-off.
+
+            Default: <tt>ParallelOptions::NoThreads</tt> (sequential)
+        */
+    SlicOptions & numThreads(const int n)
+    {
+        ParallelOptions::numThreads(n);
+        return *this;
+    }
+
     unsigned int iter;
     unsigned int sizeLimit;
 };
@@ -215,22 +234,36 @@ class Slic
     unsigned int execute();
 
   private:
-    void updateAssigments();
-    unsigned int postProcessing();
+    typedef typename acc::AccumulatorResultTraits<T>::SumType   MeanType;
+    typedef TinyVector<double, N>                               CenterType;
 
-    typedef MultiArray<N,DistanceType>  DistanceImageType;
+        // per-region sums of one slab of the image
+    struct Sums
+    {
+        ArrayVector<double>     count;
+        ArrayVector<CenterType> coord;
+        ArrayVector<MeanType>   data;
+    };
+
+    void updateMeans(ThreadPool & pool);
+    void updateAssigments(ThreadPool & pool);
+    void updateTile(ShapeType const & tile,
+                    ArrayVector<MultiArrayIndex> const & binStart,
+                    ArrayVector<Label> const & binContents);
+    unsigned int postProcessing();
 
     ShapeType                       shape_;
     DataImageType                   dataImage_;
     LabelImageType                  labelImage_;
-    DistanceImageType               distance_;
     int                             max_radius_;
     DistanceType                    normalization_;
     SlicOptions                     options_;
 
-    typedef acc::Select<acc::DataArg<1>, acc::LabelArg<2>, acc::Mean, acc::RegionCenter> Statistics;
-    typedef acc::AccumulatorChainArray<CoupledArrays<N, T, Label>, Statistics> RegionFeatures;
-    RegionFeatures clusters_;
+    MultiArrayIndex                 maxLabel_;
+    ShapeType                       binShape_, tileBins_, tileShape_;
+    ArrayVector<double>             count_;
+    ArrayVector<CenterType>         center_;
+    ArrayVector<MeanType>           mean_;
 };
 
 
@@ -245,26 +278,47 @@ Slic<N, T, Label>::Slic(
 :   shape_(dataImage.shape()),
     dataImage_(dataImage),
     labelImage_(labelImage),
-    distance_(shape_),
     max_radius_(maxRadius),
     normalization_(sq(intensityScaling) / sq(max_radius_)),
-    options_(options)
+    options_(options),
+    maxLabel_(0)
 {
-    clusters_.ignoreLabel(0);
+    vigra_precondition(max_radius_ > 0,
+        "slicSuperpixels(): seedDistance must be positive.");
+
+    Label minLabel, maxLabel;
+    labelImage_.minmax(&minLabel, &maxLabel);
+    maxLabel_ = maxLabel;
+    // Cluster centers are sorted into bins of size 'max_radius_', so that a
+    // pixel only has to consider the clusters in the 3^N bins around it.
+    // The assignment step is parallelized over tiles of bins, which are
+    // elongated along the first axis to get long contiguous rows.
+    for(unsigned int d=0; d<N; ++d)
+    {
+        binShape_[d]  = (shape_[d] + max_radius_ - 1) / max_radius_;
+        tileBins_[d]  = d == 0
+                            ? std::max(1, 64 / max_radius_)
+                            : 1;
+        tileShape_[d] = (binShape_[d] + tileBins_[d] - 1) / tileBins_[d];
+    }
+    count_.resize(maxLabel_+1);
+    center_.resize(maxLabel_+1);
+    mean_.resize(maxLabel_+1);
 }
 
 template <unsigned int N, class T, class Label>
 unsigned int Slic<N, T, Label>::execute()
 {
+    ThreadPool pool(options_);
+
     // Do SLIC
     for(size_t i=0; i<options_.iter; ++i)
     {
         // update mean for each cluster
-        clusters_.reset();
-        extractFeatures(dataImage_, labelImage_, clusters_);
+        updateMeans(pool);
 
         // update which pixels get assigned to which cluster
-        updateAssigments();
+        updateAssigments(pool);
     }
 
     return postProcessing();
@@ -272,42 +326,177 @@ unsigned int Slic<N, T, Label>::execute()
 
 template <unsigned int N, class T, class Label>
 void
-Slic<N, T, Label>::updateAssigments()
+Slic<N, T, Label>::updateMeans(ThreadPool & pool)
 {
-    using namespace acc;
-    distance_.init(NumericTraits<DistanceType>::max());
-    for(unsigned int c=1; c<=clusters_.maxRegionLabel(); ++c)
+    // Split the image into one slab per thread along the last axis and
+    // accumulate each slab separately. The slabs are merged in fixed order,
+    // so that the result is independent of thread scheduling.
+    MultiArrayIndex nSlabs = std::min<MultiArrayIndex>(options_.getActualNumThreads(), shape_[N-1]);
+    ArrayVector<Sums> sums(nSlabs);
+
+    parallel_foreach(pool, nSlabs,
+        [&](int /* thread_id */, MultiArrayIndex k)
+        {
+            Sums & s = sums[k];
+            s.count.resize(maxLabel_+1, 0.0);
+            s.coord.resize(maxLabel_+1, CenterType());
+            s.data.resize(maxLabel_+1, MeanType());
+
+            ShapeType start, stop(shape_);
+            start[N-1] = k*shape_[N-1] / nSlabs;
+            stop[N-1]  = (k+1)*shape_[N-1] / nSlabs;
+
+            typedef typename CoupledArrays<N, T, Label>::IteratorType Iterator;
+            Iterator iter = createCoupledIterator(dataImage_, labelImage_).
+                                restrictToSubarray(start, stop),
+                     end = iter.getEndIterator();
+            for(; iter != end; ++iter)
+            {
+                Label c = iter.template get<2>();
+                if(c == 0)
+                    continue;
+                s.count[c] += 1.0;
+                s.coord[c] += iter.point() + start;
+                s.data[c]  += iter.template get<1>();
+            }
+        }
+    );
+
+    for(MultiArrayIndex c=1; c<=maxLabel_; ++c)
     {
-        if(get<Count>(clusters_, c) == 0) // label doesn't exist
+        double count = 0.0;
+        CenterType coord;
+        MeanType data = MeanType();
+        for(MultiArrayIndex k=0; k<nSlabs; ++k)
+        {
+            count += sums[k].count[c];
+            coord += sums[k].coord[c];
+            data  += sums[k].data[c];
+        }
+        count_[c] = count;
+        if(count > 0.0)
+        {
+            center_[c] = coord / count;
+            mean_[c]   = data / count;
+        }
+    }
+}
+
+template <unsigned int N, class T, class Label>
+void
+Slic<N, T, Label>::updateAssigments(ThreadPool & pool)
+{
+    // sort the clusters into the tiles containing their rounded centers
+    MultiArrayIndex nBins = prod(binShape_);
+    ArrayVector<MultiArrayIndex> binStart(nBins+1, 0), binOf(maxLabel_+1, -1);
+    for(MultiArrayIndex c=1; c<=maxLabel_; ++c)
+    {
+        if(count_[c] == 0.0) // label doesn't exist
             continue;
+        ShapeType bin(round(center_[c]));
+        for(unsigned int d=0; d<N; ++d)
+            bin[d] = std::min(std::max<MultiArrayIndex>(bin[d], 0) / max_radius_, binShape_[d] - 1);
+        binOf[c] = detail::CoordinateToScanOrder<N>::exec(binShape_, bin);
+        ++binStart[binOf[c]+1];
+    }
+    for(MultiArrayIndex k=0; k<nBins; ++k)
+        binStart[k+1] += binStart[k];
+
+    ArrayVector<Label> binContents(binStart[nBins]);
+    {
+        ArrayVector<MultiArrayIndex> fill(binStart.begin(), binStart.end()-1);
+        for(MultiArrayIndex c=1; c<=maxLabel_; ++c)
+            if(binOf[c] >= 0)
+                binContents[fill[binOf[c]]++] = static_cast<Label>(c);
+    }
+
+    // every tile is processed by exactly one thread, which owns its pixels
+    parallel_foreach(pool, prod(tileShape_),
+        [&](int /* thread_id */, MultiArrayIndex k)
+        {
+            ShapeType tile;
+            detail::ScanOrderToCoordinate<N>::exec(k, tileShape_, tile);
+            updateTile(tile, binStart, binContents);
+        }
+    );
+}
 
-        typedef typename LookupTag<RegionCenter, RegionFeatures>::value_type CenterType;
-        CenterType center = get<RegionCenter>(clusters_, c);
+template <unsigned int N, class T, class Label>
+void
+Slic<N, T, Label>::updateTile(ShapeType const & tile,
+                              ArrayVector<MultiArrayIndex> const & binStart,
+                              ArrayVector<Label> const & binContents)
+{
+    ShapeType tileBegin(tile*tileBins_),
+              tileEnd(min(binShape_, tileBegin + tileBins_)),
+              tileStart(tileBegin*max_radius_),
+              tileStop(min(shape_, tileEnd*max_radius_));
+
+    // only clusters in the tile's bins and their direct neighbors can reach
+    // the tile's pixels; visiting them in ascending order preserves the
+    // tie-breaking of the sequential algorithm (the smallest label wins)
+    ArrayVector<Label> candidates;
+    ShapeType binsBegin(max(ShapeType(0), tileBegin - ShapeType(1))),
+              binsEnd(min(binShape_, tileEnd + ShapeType(1)));
+    MultiCoordinateIterator<N> bin(binsEnd - binsBegin),
+                               binEnd = bin.getEndIterator();
+    for(; bin != binEnd; ++bin)
+    {
+        MultiArrayIndex b = detail::CoordinateToScanOrder<N>::exec(binShape_, *bin + binsBegin);
+        candidates.insert(candidates.end(), binContents.begin() + binStart[b],
+                                            binContents.begin() + binStart[b+1]);
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    MultiArray<N, DistanceType> distance(tileStop - tileStart, NumericTraits<DistanceType>::max());
+    DistanceType rowDist[N];
+    MultiArrayIndex dataStride  = dataImage_.stride(0),
+                    labelStride = labelImage_.stride(0);
 
-        // get ROI limits around region center
+    for(unsigned int i=0; i<candidates.size(); ++i)
+    {
+        Label c = candidates[i];
+        CenterType const & center = center_[c];
+        MeanType const & mean = mean_[c];
+
+        // intersect the cluster's ROI with the tile
         ShapeType pixelCenter(round(center)),
-                  startCoord(max(ShapeType(0), pixelCenter - ShapeType(max_radius_))),
-                  endCoord(min(shape_, pixelCenter + ShapeType(max_radius_+1)));
-        center -= startCoord; // need center relative to ROI
-
-        // setup iterators for ROI
-        typedef typename CoupledArrays<N, T, Label, DistanceType>::IteratorType Iterator;
-        Iterator iter = createCoupledIterator(dataImage_, labelImage_, distance_).
-                            restrictToSubarray(startCoord, endCoord),
-                 end = iter.getEndIterator();
-
-        // only pixels within the ROI can be assigned to a cluster
-        for(; iter != end; ++iter)
+                  startCoord(max(tileStart, pixelCenter - ShapeType(max_radius_))),
+                  endCoord(min(tileStop, pixelCenter + ShapeType(max_radius_+1)));
+        if(!allLess(startCoord, endCoord))
+            continue;
+
+        // traverse the ROI row by row, so that the inner loop only
+        // advances pointers along dimension 0
+        ShapeType rowsShape(endCoord - startCoord);
+        MultiArrayIndex rowLength = rowsShape[0];
+        rowsShape[0] = 1;
+        MultiCoordinateIterator<N> row(rowsShape),
+                                   rowEnd = row.getEndIterator();
+        for(; row != rowEnd; ++row)
         {
-            // compute distance between cluster center and pixel
-            DistanceType spatialDist   = squaredNorm(center-iter.point());
-            DistanceType colorDist     = squaredNorm(get<Mean>(clusters_, c)-iter.template get<1>());
-            DistanceType dist =  colorDist + normalization_*spatialDist;
-            // update label?
-            if(dist < iter.template get<3>())
+            ShapeType p(*row + startCoord);
+            for(unsigned int d=1; d<N; ++d)
+                rowDist[d] = sq(center[d] - p[d]);
+
+            T const * data = &dataImage_[p];
+            Label * label = &labelImage_[p];
+            DistanceType * dist = &distance[p - tileStart];
+            for(MultiArrayIndex x=0; x<rowLength; ++x,
+                    data += dataStride, label += labelStride, ++dist)
             {
-                iter.template get<2>() = static_cast<Label>(c);
-                iter.template get<3>() = dist;
+                // compute distance between cluster center and pixel
+                DistanceType spatialDist = sq(center[0] - (p[0] + x));
+                for(unsigned int d=1; d<N; ++d)
+                    spatialDist += rowDist[d];
+                DistanceType colorDist = squaredNorm(mean - *data);
+                DistanceType newDist = colorDist + normalization_*spatialDist;
+                // update label?
+                if(newDist < *dist)
+                {
+                    *label = static_cast<Label>(c);
+                    *dist = newDist;
+                }
             }
         }
     }
@@ -412,6 +601,12 @@ Slic<N, T, Label>::postProcessing()
     and an explicit minimal superpixel size (<tt>SlicOptions::minSize()</tt>). By default, the algorithm
     merges all regions that are smaller than 1/4 of the average superpixel size.
 
+    By default, the algorithm runs sequentially. When <tt>SlicOptions::numThreads()</tt> is set,
+    the iterations run in parallel with the given number of threads. The cluster means
+    are accumulated in per-thread slabs and merged afterwards, and the assignment step is split into
+    tiles that are owned by a single thread and only consider the cluster centers in their neighborhood.
+    Ties are resolved as in the sequential algorithm (the smallest cluster label wins).
+
     The function returns the number of superpixels, which equals the largest label
     because labeling starts at 1.
 
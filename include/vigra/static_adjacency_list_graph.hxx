@@ -0,0 +1,621 @@
+/************************************************************************/
+/*                                                                      */
+/*                Copyright 2026 by the VIGRA developers                */
+/*                                                                      */
+/*    This file is part of the VIGRA computer vision library.           */
+/*    The VIGRA Website is                                              */
+/*        http://hci.iwr.uni-heidelberg.de/vigra/                       */
+/*    Please direct questions, bug reports, and contributions to        */
+/*        ullrich.koethe@iwr.uni-heidelberg.de    or                    */
+/*        vigra@informatik.uni-hamburg.de                               */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+
+
+#ifndef VIGRA_STATIC_ADJACENCY_LIST_GRAPH_HXX
+#define VIGRA_STATIC_ADJACENCY_LIST_GRAPH_HXX
+
+/*std*/
+#include <vector>
+#include <algorithm>
+#include <utility>
+#include <numeric>
+
+/*vigra*/
+#include "graphs.hxx"
+#include "graph_maps.hxx"
+#include "iteratorfacade.hxx"
+#include "graph_item_impl.hxx"
+#include "adjacency_list_graph.hxx"
+
+
+namespace vigra{
+
+/** \addtogroup GraphDataStructures
+*/
+//@{
+
+    namespace detail_static_adjacency_list_graph{
+
+        // iterator over the adjacency range of a single node
+        template<class GRAPH,class FILTER>
+        class IncItemIt
+        : public ForwardIteratorFacade<
+            IncItemIt<GRAPH,FILTER>,
+            typename FILTER::ResultType,true
+        >
+        {
+        public:
+            typedef GRAPH Graph;
+            typedef typename Graph::index_type index_type;
+            typedef typename Graph::Node Node;
+            typedef typename Graph::NodeIt NodeIt;
+            typedef typename FILTER::ResultType ResultItem;
+            typedef typename FILTER::AdjacencyElement AdjacencyElement;
+
+            IncItemIt(const lemon::Invalid & /*invalid*/ = lemon::INVALID)
+            :   graph_(NULL),
+                ownNodeId_(-1),
+                iter_(NULL),
+                end_(NULL),
+                resultItem_(lemon::INVALID){
+            }
+
+            IncItemIt(const Graph & g, const NodeIt & nodeIt)
+            :   graph_(&g),
+                ownNodeId_(g.id(*nodeIt)),
+                iter_(g.adjacencyBegin(ownNodeId_)),
+                end_(g.adjacencyEnd(ownNodeId_)),
+                resultItem_(lemon::INVALID){
+                skipInvalid();
+            }
+
+            IncItemIt(const Graph & g, const Node & node)
+            :   graph_(&g),
+                ownNodeId_(g.id(node)),
+                iter_(g.adjacencyBegin(ownNodeId_)),
+                end_(g.adjacencyEnd(ownNodeId_)),
+                resultItem_(lemon::INVALID){
+                skipInvalid();
+            }
+
+            // the node whose incident items are visited
+            Node ownNode()const{
+                return Node(ownNodeId_);
+            }
+
+        private:
+            friend class vigra::IteratorFacadeCoreAccess;
+
+            void skipInvalid(){
+                if(FILTER::IsFilter){
+                    while(iter_!=end_ && !FILTER::valid(*graph_,*iter_,ownNodeId_))
+                        ++iter_;
+                }
+            }
+            bool isEnd()const{
+                return graph_==NULL || iter_==end_;
+            }
+            bool isBegin()const{
+                return graph_!=NULL && iter_==graph_->adjacencyBegin(ownNodeId_);
+            }
+            bool equal(const IncItemIt & other)const{
+                if(isEnd() && other.isEnd())
+                    return true;
+                else if(isEnd() != other.isEnd())
+                    return false;
+                else
+                    return iter_==other.iter_;
+            }
+            void increment(){
+                ++iter_;
+                skipInvalid();
+            }
+            const ResultItem & dereference()const{
+                resultItem_ = FILTER::transform(*graph_,*iter_,ownNodeId_);
+                return resultItem_;
+            }
+
+            const GRAPH * graph_;
+            index_type ownNodeId_;
+            const AdjacencyElement * iter_;
+            const AdjacencyElement * end_;
+            mutable ResultItem resultItem_;
+        };
+
+    } // namespace detail_static_adjacency_list_graph
+
+
+    /** \brief immutable undirected graph in compressed sparse row format (LEMON API)
+
+        The graph has the same interface as \ref AdjacencyListGraph, but can not 
+        be modified after construction. The adjacencies of all nodes are stored 
+        in a single array which is sorted by node and neighbor id, so that 
+        traversal touches contiguous memory and <tt>findEdge()</tt> is a binary search.
+        This is the preferred representation for graphs which are built once and then
+        only queried, e.g. region adjacency graphs passed to shortest path, watershed
+        or clustering algorithms.
+
+        Node and edge ids are taken from the input, and node ids need not be contiguous.
+
+        <b>\#include</b> \<vigra/static_adjacency_list_graph.hxx\><br>
+        Namespace: vigra
+    */
+    class StaticAdjacencyListGraph
+    {
+    public:
+        typedef Int64                                                      index_type;
+    private:
+        typedef StaticAdjacencyListGraph                                   GraphType;
+
+        struct NodeStorage{
+            typedef detail::Adjacency<index_type> AdjacencyElement;
+        };
+        typedef NodeStorage::AdjacencyElement                              AdjacencyElement;
+
+        typedef detail::NeighborNodeFilter<GraphType>                      NnFilter;
+        typedef detail::IncEdgeFilter<GraphType>                           IncFilter;
+        typedef detail::IsInFilter<GraphType>                              InFlter;
+        typedef detail::IsOutFilter<GraphType>                             OutFilter;
+        typedef detail::IsBackOutFilter<GraphType>                         BackOutFilter;
+    public:
+        // LEMON API TYPEDEFS (and a few more(NeighborNodeIt))
+
+        /// node descriptor
+        typedef detail::GenericNode<index_type>                            Node;
+        /// edge descriptor
+        typedef detail::GenericEdge<index_type>                            Edge;
+        /// arc descriptor
+        typedef detail::GenericArc<index_type>                             Arc;
+        /// edge iterator
+        typedef detail_adjacency_list_graph::ItemIter<GraphType,Edge>      EdgeIt;
+        /// node iterator
+        typedef detail_adjacency_list_graph::ItemIter<GraphType,Node>      NodeIt;
+        /// arc iterator
+        typedef detail_adjacency_list_graph::ArcIt<GraphType>              ArcIt;
+
+        /// incident edge iterator
+        typedef detail_static_adjacency_list_graph::IncItemIt<GraphType,IncFilter>     IncEdgeIt;
+        /// incoming arc iterator
+        typedef detail_static_adjacency_list_graph::IncItemIt<GraphType,InFlter>       InArcIt;
+        /// outgoing arc iterator
+        typedef detail_static_adjacency_list_graph::IncItemIt<GraphType,OutFilter>     OutArcIt;
+        /// neighbor node iterator
+        typedef detail_static_adjacency_list_graph::IncItemIt<GraphType,NnFilter>      NeighborNodeIt;
+        /// outgoing back arc iterator
+        typedef detail_static_adjacency_list_graph::IncItemIt<GraphType,BackOutFilter> OutBackArcIt;
+
+        // BOOST GRAPH API TYPEDEFS
+        // - categories (not complete yet)
+        typedef directed_tag            directed_category;
+        // iterators
+        typedef NeighborNodeIt          adjacency_iterator;
+        typedef EdgeIt                  edge_iterator;
+        typedef NodeIt                  vertex_iterator;
+        typedef IncEdgeIt               in_edge_iterator;
+        typedef IncEdgeIt               out_edge_iterator;
+
+        // size types
+        typedef size_t                  degree_size_type;
+        typedef size_t                  edge_size_type;
+        typedef size_t                  vertex_size_type;
+        // item descriptors
+        typedef Edge                    edge_descriptor;
+        typedef Node                    vertex_descriptor;
+
+        /// default edge map
+        template<class T>
+        struct EdgeMap : DenseEdgeReferenceMap<GraphType,T> {
+            EdgeMap(): DenseEdgeReferenceMap<GraphType,T>(){
+            }
+            EdgeMap(const GraphType & g)
+            : DenseEdgeReferenceMap<GraphType,T>(g){
+            }
+            EdgeMap(const GraphType & g,const T & val)
+            : DenseEdgeReferenceMap<GraphType,T>(g,val){
+            }
+        };
+
+        /// default node map
+        template<class T>
+        struct NodeMap : DenseNodeReferenceMap<GraphType,T> {
+            NodeMap(): DenseNodeReferenceMap<GraphType,T>(){
+            }
+            NodeMap(const GraphType & g)
+            : DenseNodeReferenceMap<GraphType,T>(g){
+            }
+            NodeMap(const GraphType & g,const T & val)
+            : DenseNodeReferenceMap<GraphType,T>(g,val){
+            }
+        };
+
+        /// default arc map
+        template<class T>
+        struct ArcMap : DenseArcReferenceMap<GraphType,T> {
+            ArcMap(): DenseArcReferenceMap<GraphType,T>(){
+            }
+            ArcMap(const GraphType & g)
+            : DenseArcReferenceMap<GraphType,T>(g){
+            }
+            ArcMap(const GraphType & g,const T & val)
+            : DenseArcReferenceMap<GraphType,T>(g,val){
+            }
+        };
+
+        /** \brief Construct an empty graph.
+        */
+        StaticAdjacencyListGraph()
+        :   nodeNum_(0),
+            edgeNum_(0)
+        {
+            nodeOffsets_.push_back(0);
+        }
+
+        /** \brief Construct a graph from node ids and edges.
+
+            @param nodeIds : ids of the nodes (any order, duplicates are ignored)
+            @param uvIds   : end nodes of the edges, the id of an edge is its index.
+                             Pairs of <tt>-1</tt> mark unused edge ids. There must be
+                             at most one edge between any two nodes.
+        */
+        template<class NODE_ID_ITER>
+        StaticAdjacencyListGraph(NODE_ID_ITER nodeIdsBegin, NODE_ID_ITER nodeIdsEnd,
+                                 const std::vector<std::pair<index_type, index_type> > & uvIds)
+        {
+            assign(nodeIdsBegin, nodeIdsEnd, uvIds);
+        }
+
+        /** \brief Copy the structure of another undirected graph (e.g. \ref AdjacencyListGraph).
+
+            Node and edge ids of \a g are preserved.
+        */
+        template<class GRAPH>
+        explicit StaticAdjacencyListGraph(const GRAPH & g)
+        {
+            std::vector<index_type> nodeIds;
+            nodeIds.reserve(g.nodeNum());
+            for(typename GRAPH::NodeIt n(g); n!=lemon::INVALID; ++n)
+                nodeIds.push_back(g.id(*n));
+            std::vector<std::pair<index_type, index_type> > uvIds(g.edgeNum() > 0 ? g.maxEdgeId()+1 : 0,
+                                                                  std::make_pair(index_type(-1), index_type(-1)));
+            for(typename GRAPH::EdgeIt e(g); e!=lemon::INVALID; ++e)
+                uvIds[g.id(*e)] = std::make_pair(index_type(g.id(g.u(*e))), index_type(g.id(g.v(*e))));
+            assign(nodeIds.begin(), nodeIds.end(), uvIds);
+        }
+
+        /** \brief Replace the graph by the given nodes and edges 
+            (see the corresponding constructor).
+        */
+        template<class NODE_ID_ITER>
+        void assign(NODE_ID_ITER nodeIdsBegin, NODE_ID_ITER nodeIdsEnd,
+                    const std::vector<std::pair<index_type, index_type> > & uvIds);
+
+        /** \brief Get the number of edges in this graph (API: LEMON).
+        */
+        index_type edgeNum()const{
+            return edgeNum_;
+        }
+        /** \brief Get the number of nodes in this graph (API: LEMON).
+        */
+        index_type nodeNum()const{
+            return nodeNum_;
+        }
+        /** \brief Get the number of arcs in this graph (API: LEMON).
+        */
+        index_type arcNum()const{
+            return edgeNum()*2;
+        }
+
+        /** \brief Get the maximum ID of any edge in this graph (API: LEMON).
+        */
+        index_type maxEdgeId()const{
+            return static_cast<index_type>(edges_.size()) - 1;
+        }
+        /** \brief Get the maximum ID of any node in this graph (API: LEMON).
+        */
+        index_type maxNodeId()const{
+            return static_cast<index_type>(nodeOffsets_.size()) - 2;
+        }
+        /** \brief Get the maximum ID of any edge in arc graph (API: LEMON).
+        */
+        index_type maxArcId()const{
+            return maxEdgeId()*2+1;
+        }
+
+        /** \brief Create an arc for the given edge \a e, oriented along the 
+            edge's natural (<tt>forward = true</tt>) or reversed 
+            (<tt>forward = false</tt>) direction (API: LEMON).
+        */
+        Arc direct(const Edge & edge,const bool forward)const{
+            if(edge!=lemon::INVALID){
+                if(forward)
+                    return Arc(id(edge),id(edge));
+                else
+                    return Arc(id(edge)+maxEdgeId()+1,id(edge));
+            }
+            else
+                return Arc(lemon::INVALID);
+        }
+
+        /** \brief Create an arc for the given edge \a e oriented
+            so that node \a n is the starting node of the arc (API: LEMON), or
+            return <tt>lemon::INVALID</tt> if the edge is not incident to this node.
+        */
+        Arc direct(const Edge & edge,const Node & node)const{
+            if(u(edge)==node)
+                return Arc(id(edge),id(edge));
+            else if(v(edge)==node)
+                return Arc(id(edge)+maxEdgeId()+1,id(edge));
+            else
+                return Arc(lemon::INVALID);
+        }
+
+        /** \brief Return <tt>true</tt> when the arc is looking on the underlying
+            edge in its natural (i.e. forward) direction, <tt>false</tt> otherwise (API: LEMON).
+        */
+        bool direction(const Arc & arc)const{
+            return id(arc)<=maxEdgeId();
+        }
+
+        /** \brief Get the start node of the given edge \a e (API: LEMON).
+        */
+        Node u(const Edge & edge)const{
+            return Node(edges_[id(edge)].first);
+        }
+        /** \brief Get the end node of the given edge \a e (API: LEMON).
+        */
+        Node v(const Edge & edge)const{
+            return Node(edges_[id(edge)].second);
+        }
+        /** \brief Get the start node of the given arc \a a (API: LEMON).
+        */
+        Node source(const Arc & arc)const{
+            return direction(arc) ? u(Edge(arc.edgeId())) : v(Edge(arc.edgeId()));
+        }
+        /** \brief Get the end node of the given arc \a a (API: LEMON).
+        */
+        Node target(const Arc & arc)const{
+            return direction(arc) ? v(Edge(arc.edgeId())) : u(Edge(arc.edgeId()));
+        }
+        /** \brief Return the opposite node of the given node \a n
+            along edge \a e (API: LEMON), or return <tt>lemon::INVALID</tt>
+            if the edge is not incident to this node.
+        */
+        Node oppositeNode(Node const & n, const Edge & e)const{
+            const Node uNode = u(e);
+            const Node vNode = v(e);
+            if(uNode==n)
+                return vNode;
+            else if(vNode==n)
+                return uNode;
+            else
+                return Node(lemon::INVALID);
+        }
+
+        /** \brief Return the node the given iterator is attached to (API: LEMON).
+        */
+        Node baseNode(const IncEdgeIt & iter)const{
+            return iter.ownNode();
+        }
+        /** \brief Return the start node of the arc the given iterator is referring to (API: LEMON).
+        */
+        Node baseNode(const OutArcIt & iter)const{
+            return source(*iter);
+        }
+        /** \brief Return the opposite node of the edge the given iterator is referring to (API: LEMON).
+        */
+        Node runningNode(const IncEdgeIt & iter)const{
+            return oppositeNode(iter.ownNode(), *iter);
+        }
+        /** \brief Return the end node of the arc the given iterator is referring to (API: LEMON).
+        */
+        Node runningNode(const OutArcIt & iter)const{
+            return target(*iter);
+        }
+
+        /** \brief Get the ID  for node desciptor \a v (API: LEMON).
+        */
+        index_type id(const Node & node)const{
+            return node.id();
+        }
+        /** \brief Get the ID  for edge desciptor \a v (API: LEMON).
+        */
+        index_type id(const Edge & edge)const{
+            return edge.id();
+        }
+        /** \brief Get the ID  for arc desciptor \a v (API: LEMON).
+        */
+        index_type id(const Arc & arc)const{
+            return arc.id();
+        }
+
+        /** \brief Get edge descriptor for given edge ID \a i (API: LEMON).
+            Return <tt>Edge(lemon::INVALID)</tt> when the ID does not exist in this graph.
+        */
+        Edge edgeFromId(const index_type id)const{
+            if(id >= 0 && id <= maxEdgeId() && edges_[id].first != -1)
+                return Edge(id);
+            else
+                return Edge(lemon::INVALID);
+        }
+        /** \brief Get node descriptor for given node ID \a i (API: LEMON).
+            Return <tt>Node(lemon::INVALID)</tt> when the ID does not exist in this graph.
+        */
+        Node nodeFromId(const index_type id)const{
+            if(id >= 0 && id <= maxNodeId() && nodeExists_[id])
+                return Node(id);
+            else
+                return Node(lemon::INVALID);
+        }
+        /** \brief Get arc descriptor for given arc ID \a i (API: LEMON).
+            Return <tt>Arc(lemon::INVALID)</tt> when the ID does not exist in this graph.
+        */
+        Arc arcFromId(const index_type id)const{
+            const index_type edgeId = id <= maxEdgeId() ? id : id - (maxEdgeId() + 1);
+            if(edgeFromId(edgeId)==lemon::INVALID)
+                return Arc(lemon::INVALID);
+            else
+                return Arc(id, edgeId);
+        }
+
+        /** \brief Get a descriptor for the edge connecting vertices \a u and \a v,<br/>
+            or <tt>lemon::INVALID</tt> if no such edge exists (API: LEMON).
+
+            This is a binary search in the adjacency range of the node with smaller degree.
+        */
+        Edge findEdge(const Node & a,const Node & b)const{
+            if(a==lemon::INVALID || b==lemon::INVALID || a==b)
+                return Edge(lemon::INVALID);
+            index_type aId = id(a), bId = id(b);
+            if(degree(a) > degree(b))
+                std::swap(aId, bId);
+            const AdjacencyElement * end  = adjacencyEnd(aId);
+            const AdjacencyElement * iter = std::lower_bound(adjacencyBegin(aId), end,
+                                                             AdjacencyElement(bId, 0));
+            if(iter!=end && iter->nodeId()==bId)
+                return Edge(iter->edgeId());
+            return Edge(lemon::INVALID);
+        }
+        /** \brief Get a descriptor for the arc connecting vertices \a u and \a v,<br/>
+            or <tt>lemon::INVALID</tt> if no such edge exists (API: LEMON).
+        */
+        Arc findArc(const Node & uNode,const Node & vNode)const{
+            const Edge e = findEdge(uNode,vNode);
+            if(e==lemon::INVALID)
+                return Arc(lemon::INVALID);
+            else
+                return direct(e, u(e)==uNode);
+        }
+
+        /** \brief Get the number of edges incident to node \a node.
+        */
+        degree_size_type degree(const vertex_descriptor & node)const{
+            return nodeOffsets_[id(node)+1] - nodeOffsets_[id(node)];
+        }
+
+        size_t maxDegree()const{
+            size_t md = 0;
+            for(index_type n=0; n<=maxNodeId(); ++n)
+                md = std::max(md, size_t(nodeOffsets_[n+1] - nodeOffsets_[n]));
+            return md;
+        }
+
+        static const bool is_directed = false;
+
+    private:
+        template<class G,class FILT>
+        friend class detail_static_adjacency_list_graph::IncItemIt;
+
+        template<class G>
+        friend struct detail::NeighborNodeFilter;
+        template<class G>
+        friend struct detail::IncEdgeFilter;
+        template<class G>
+        friend struct detail::BackEdgeFilter;
+        template<class G>
+        friend struct detail::IsOutFilter;
+        template<class G>
+        friend struct detail::IsBackOutFilter;
+        template<class G>
+        friend struct detail::IsInFilter;
+
+        const AdjacencyElement * adjacencyBegin(const index_type nodeId)const{
+            return adjacency_.data() + nodeOffsets_[nodeId];
+        }
+        const AdjacencyElement * adjacencyEnd(const index_type nodeId)const{
+            return adjacency_.data() + nodeOffsets_[nodeId+1];
+        }
+
+        // adjacency of node n is adjacency_[nodeOffsets_[n]], ..., adjacency_[nodeOffsets_[n+1]-1],
+        // sorted by neighbor id
+        std::vector<index_type>                            nodeOffsets_;
+        std::vector<AdjacencyElement>                      adjacency_;
+        std::vector<bool>                                  nodeExists_;
+        std::vector<std::pair<index_type, index_type> >    edges_;
+        index_type nodeNum_;
+        index_type edgeNum_;
+    };
+
+#ifndef DOXYGEN  // doxygen doesn't like out-of-line definitions
+
+    template<class NODE_ID_ITER>
+    void
+    StaticAdjacencyListGraph::assign(
+        NODE_ID_ITER nodeIdsBegin, NODE_ID_ITER nodeIdsEnd,
+        const std::vector<std::pair<index_type, index_type> > & uvIds
+    ){
+        index_type maxId = -1;
+        for(NODE_ID_ITER n = nodeIdsBegin; n != nodeIdsEnd; ++n){
+            vigra_precondition(*n >= 0,
+                "StaticAdjacencyListGraph::assign(): node ids must be non-negative.");
+            maxId = std::max<index_type>(maxId, *n);
+        }
+        nodeExists_.assign(maxId+1, false);
+        nodeNum_ = 0;
+        for(NODE_ID_ITER n = nodeIdsBegin; n != nodeIdsEnd; ++n){
+            if(!nodeExists_[*n]){
+                nodeExists_[*n] = true;
+                ++nodeNum_;
+            }
+        }
+
+        // count the degrees
+        edges_ = uvIds;
+        edgeNum_ = 0;
+        nodeOffsets_.assign(maxId+2, 0);
+        for(size_t e = 0; e < edges_.size(); ++e){
+            const index_type u = edges_[e].first, v = edges_[e].second;
+            if(u == -1 && v == -1)
+                continue;
+            vigra_precondition(nodeFromId(u) != lemon::INVALID && nodeFromId(v) != lemon::INVALID && u != v,
+                "StaticAdjacencyListGraph::assign(): edges must connect two distinct existing nodes.");
+            ++nodeOffsets_[u+1];
+            ++nodeOffsets_[v+1];
+            ++edgeNum_;
+        }
+        std::partial_sum(nodeOffsets_.begin(), nodeOffsets_.end(), nodeOffsets_.begin());
+
+        // fill and sort the adjacency ranges
+        adjacency_.assign(nodeOffsets_.back(), AdjacencyElement(-1, -1));
+        std::vector<index_type> insertPos(nodeOffsets_.begin(), nodeOffsets_.end()-1);
+        for(size_t e = 0; e < edges_.size(); ++e){
+            const index_type u = edges_[e].first, v = edges_[e].second;
+            if(u == -1 && v == -1)
+                continue;
+            adjacency_[insertPos[u]++] = AdjacencyElement(v, e);
+            adjacency_[insertPos[v]++] = AdjacencyElement(u, e);
+        }
+        for(index_type n = 0; n <= maxId; ++n)
+            std::sort(adjacency_.begin()+nodeOffsets_[n], adjacency_.begin()+nodeOffsets_[n+1]);
+    }
+
+#endif //DOXYGEN
+
+//@}
+
+} // namespace vigra
+
+#endif // VIGRA_STATIC_ADJACENCY_LIST_GRAPH_HXX
@@ -0,0 +1,422 @@
+/************************************************************************/
+/*                                                                      */
+/*                Copyright 2026 by the VIGRA developers                */
+/*                                                                      */
+/*    This file is part of the VIGRA computer vision library.           */
+/*    The VIGRA Website is                                              */
+/*        http://hci.iwr.uni-heidelberg.de/vigra/                       */
+/*    Please direct questions, bug reports, and contributions to        */
+/*        ullrich.koethe@iwr.uni-heidelberg.de    or                    */
+/*        vigra@informatik.uni-hamburg.de                               */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+
+
+#ifndef VIGRA_STREAMING_LABELING_HXX
+#define VIGRA_STREAMING_LABELING_HXX
+
+#include <functional>
+
+#include "multi_array.hxx"
+#include "multi_labeling.hxx"
+#include "union_find.hxx"
+#include "array_vector.hxx"
+
+namespace vigra
+{
+
+/** \addtogroup Labeling
+*/
+//@{
+
+/********************************************************/
+/*                                                      */
+/*                  StreamingTileLabeling               */
+/*                                                      */
+/********************************************************/
+
+/** \brief Connected components of a 2D image that is only available tile by tile.
+
+    In contrast to \ref labelMultiArrayBlockwise(), this class never needs access to
+    the entire image (neither as a \ref vigra::MultiArrayView nor as a
+    \ref vigra::ChunkedArray), so that it can label arbitrarily large mosaics.
+    The image is split into tiles of the given shape (tiles in the last row and column
+    may be smaller). Labeling proceeds in two passes:
+
+    <ol>
+    <li> Pass 1: The tiles are passed to <tt>addTile()</tt> in raster order (tile by tile
+         along the x-axis, then row by row). Each tile is labeled by \ref labelMultiArray(),
+         and labels touching along the seams to the left and upper neighbors are merged
+         in a union-find array. Only the last pixel line of the previous tile row and the last
+         pixel column of the previous tile are kept in memory.
+    <li> <tt>finalize()</tt> makes the labels contiguous and returns the number of regions.
+    <li> Pass 2: Each tile is passed to <tt>relabelTile()</tt> (in any order) and receives its
+         final labels.
+    </ol>
+
+    Memory consumption is thus bounded by one tile plus one image line, plus the
+    union-find array whose size is the total number of tile-local regions.
+    Since the local labeling is recomputed in pass 2, the tile data must be identical
+    in both passes. The options (neighborhood, background value) and the equality
+    functor have the same meaning as in \ref labelMultiArray(). The function
+    \ref labelTilesStreaming() drives both passes with user-provided callbacks.
+
+    <b>\#include</b> \<vigra/streaming_labeling.hxx\><br>
+    Namespace: vigra
+*/
+template <class T, class Label = UInt32, class Equal = std::equal_to<T> >
+class StreamingTileLabeling
+{
+  public:
+    typedef MultiArrayShape<2>::type    Shape;
+    typedef T                           value_type;
+    typedef Label                       label_type;
+
+        /** \brief Prepare labeling of an image of shape \a imageShape,
+            divided into tiles of shape \a tileShape.
+        */
+    StreamingTileLabeling(Shape const & imageShape, Shape const & tileShape,
+                          LabelOptions const & options = LabelOptions(),
+                          Equal equal = Equal())
+    : image_shape_(imageShape),
+      tile_shape_(tileShape),
+      tile_count_(),
+      options_(options),
+      equal_(equal),
+      next_tile_(0),
+      finalized_(false),
+      max_label_(0),
+      previous_line_(imageShape[0]),
+      previous_line_labels_(imageShape[0]),
+      current_line_(imageShape[0]),
+      current_line_labels_(imageShape[0]),
+      left_column_(tileShape[1]),
+      left_column_labels_(tileShape[1])
+    {
+        vigra_precondition(allGreater(imageShape, Shape(0)) && allGreater(tileShape, Shape(0)),
+            "StreamingTileLabeling(): image and tile shape must be positive.");
+        for(int d=0; d<2; ++d)
+            tile_count_[d] = (imageShape[d] + tileShape[d] - 1) / tileShape[d];
+        offsets_.resize(prod(tile_count_));
+    }
+
+        /** \brief Number of tiles along each axis.
+        */
+    Shape tileCount() const
+    {
+        return tile_count_;
+    }
+
+        /** \brief First pixel of the given tile.
+        */
+    Shape tileBegin(Shape const & tile) const
+    {
+        return tile*tile_shape_;
+    }
+
+        /** \brief End (past-the-last pixel) of the given tile.
+        */
+    Shape tileEnd(Shape const & tile) const
+    {
+        return min(image_shape_, (tile + Shape(1))*tile_shape_);
+    }
+
+        /** \brief Index of the tile expected by the next call to <tt>addTile()</tt>.
+        */
+    Shape nextTile() const
+    {
+        return Shape(next_tile_ % tile_count_[0], next_tile_ / tile_count_[0]);
+    }
+
+        /** \brief Pass 1: label the next tile in raster order and merge it with its
+            left and upper neighbors.
+
+            The shape of \a data must be <tt>tileEnd(nextTile()) - tileBegin(nextTile())</tt>.
+        */
+    template <class S>
+    void addTile(MultiArrayView<2, T, S> const & data)
+    {
+        vigra_precondition(!finalized_ && next_tile_ < prod(tile_count_),
+            "StreamingTileLabeling::addTile(): all tiles have already been added.");
+        Shape tile = nextTile(),
+              begin = tileBegin(tile),
+              shape = tileEnd(tile) - begin;
+        vigra_precondition(data.shape() == shape,
+            "StreamingTileLabeling::addTile(): tile has wrong shape.");
+
+        if(tile[0] == 0 && tile[1] > 0)
+        {
+            // a new row of tiles starts
+            previous_line_.swap(current_line_);
+            previous_line_labels_.swap(current_line_labels_);
+        }
+
+        MultiArray<2, Label> labels(shape);
+        Label count = localLabels(data, labels);
+
+        // provisional global labels are 'offset + local label', background stays 0
+        Label offset = (Label)(unions_.nextFreeIndex() - 1);
+        offsets_[next_tile_] = offset;
+        for(Label k=0; k<count; ++k)
+            unions_.makeNewIndex();
+        for(typename MultiArray<2, Label>::iterator i = labels.begin(); i != labels.end(); ++i)
+            if(*i != 0)
+                *i += offset;
+
+        bool indirect = options_.getNeighborhood() == IndirectNeighborhood;
+
+        // merge along the seam to the upper tile row (including diagonal
+        // neighbors in the upper left and upper right tiles)
+        if(tile[1] > 0)
+        {
+            for(MultiArrayIndex x=0; x<shape[0]; ++x)
+            {
+                MultiArrayIndex gx = begin[0] + x;
+                for(MultiArrayIndex dx = indirect ? -1 : 0; dx <= (indirect ? 1 : 0); ++dx)
+                {
+                    if(gx + dx < 0 || gx + dx >= image_shape_[0])
+                        continue;
+                    merge(data(x, 0), labels(x, 0),
+                          previous_line_[gx+dx], previous_line_labels_[gx+dx], Shape(dx, -1));
+                }
+            }
+        }
+
+        // merge along the seam to the left tile
+        if(tile[0] > 0)
+        {
+            for(MultiArrayIndex y=0; y<shape[1]; ++y)
+            {
+                for(MultiArrayIndex dy = indirect ? -1 : 0; dy <= (indirect ? 1 : 0); ++dy)
+                {
+                    if(y + dy < 0 || y + dy >= shape[1])
+                        continue;
+                    merge(data(0, y), labels(0, y),
+                          left_column_[y+dy], left_column_labels_[y+dy], Shape(-1, dy));
+                }
+            }
+        }
+
+        // remember the borders needed by subsequent tiles
+        for(MultiArrayIndex y=0; y<shape[1]; ++y)
+        {
+            left_column_[y] = data(shape[0]-1, y);
+            left_column_labels_[y] = labels(shape[0]-1, y);
+        }
+        for(MultiArrayIndex x=0; x<shape[0]; ++x)
+        {
+            current_line_[begin[0] + x] = data(x, shape[1]-1);
+            current_line_labels_[begin[0] + x] = labels(x, shape[1]-1);
+        }
+
+        ++next_tile_;
+    }
+
+        /** \brief End of pass 1: make labels contiguous.
+
+            Returns the number of regions (= largest final label).
+            All tiles must have been added before.
+        */
+    Label finalize()
+    {
+        vigra_precondition(!finalized_ && next_tile_ == prod(tile_count_),
+            "StreamingTileLabeling::finalize(): not all tiles have been added.");
+        finalized_ = true;
+        // release pass 1 buffers
+        ArrayVector<T>().swap(previous_line_);
+        ArrayVector<T>().swap(current_line_);
+        ArrayVector<T>().swap(left_column_);
+        ArrayVector<Label>().swap(previous_line_labels_);
+        ArrayVector<Label>().swap(current_line_labels_);
+        ArrayVector<Label>().swap(left_column_labels_);
+        max_label_ = (Label)unions_.makeContiguous();
+        return max_label_;
+    }
+
+        /** \brief Pass 2: compute the final labels of the given tile.
+
+            \a data must be identical to the data passed to <tt>addTile()</tt> for this tile.
+        */
+    template <class S1, class S2>
+    void relabelTile(Shape const & tile,
+                     MultiArrayView<2, T, S1> const & data,
+                     MultiArrayView<2, Label, S2> labels) const
+    {
+        vigra_precondition(finalized_,
+            "StreamingTileLabeling::relabelTile(): finalize() must be called first.");
+        vigra_precondition(allLess(tile, tile_count_) && allGreaterEqual(tile, Shape(0)),
+            "StreamingTileLabeling::relabelTile(): tile index out of range.");
+        vigra_precondition(data.shape() == tileEnd(tile) - tileBegin(tile) && labels.shape() == data.shape(),
+            "StreamingTileLabeling::relabelTile(): tile has wrong shape.");
+
+        localLabels(data, labels);
+        Label offset = offsets_[tile[0] + tile[1]*tile_count_[0]];
+        typename MultiArrayView<2, Label, S2>::iterator i = labels.begin(), end = labels.end();
+        for(; i != end; ++i)
+            if(*i != 0)
+                *i = unions_.findLabel(*i + offset);
+    }
+
+  private:
+    template <class S1, class S2>
+    Label localLabels(MultiArrayView<2, T, S1> const & data,
+                      MultiArrayView<2, Label, S2> labels) const
+    {
+        return labelMultiArray(data, labels, options_, equal_);
+    }
+
+    void merge(T const & u_data, Label u_label, T const & v_data, Label v_label, Shape const & diff)
+    {
+        if(u_label != 0 && v_label != 0 &&
+           labeling_equality::callEqual(equal_, u_data, v_data, diff))
+        {
+            unions_.makeUnion(u_label, v_label);
+        }
+    }
+
+    Shape image_shape_, tile_shape_, tile_count_;
+    LabelOptions options_;
+    mutable Equal equal_;
+    UnionFindArray<Label> unions_;
+    ArrayVector<Label> offsets_;
+    MultiArrayIndex next_tile_;
+    bool finalized_;
+    Label max_label_;
+
+    ArrayVector<T>     previous_line_;
+    ArrayVector<Label> previous_line_labels_;
+    ArrayVector<T>     current_line_;
+    ArrayVector<Label> current_line_labels_;
+    ArrayVector<T>     left_column_;
+    ArrayVector<Label> left_column_labels_;
+};
+
+/********************************************************/
+/*                                                      */
+/*                  labelTilesStreaming                 */
+/*                                                      */
+/********************************************************/
+
+/** \brief Label the connected components of a tiled 2D image with bounded memory.
+
+    This function drives the two passes of \ref vigra::StreamingTileLabeling.
+    The callback \a source is invoked twice for every tile, once in each pass. It
+    must fill the given array view with the data of the given tile:
+
+    \code
+    void source(Shape2 const & tile, MultiArrayView<2, T> data);
+    \endcode
+
+    The view's shape equals the tile shape (smaller for tiles at the right and bottom
+    image border). After pass 1, the callback \a sink receives the final labels of each tile
+    in raster order:
+
+    \code
+    void sink(Shape2 const & tile, MultiArrayView<2, Label> const & labels);
+    \endcode
+
+    The return value is the number of regions (= largest label). Options and the
+    optional equality functor are interpreted as in \ref labelMultiArray().
+
+    <b> Usage:</b>
+
+    <b>\#include</b> \<vigra/streaming_labeling.hxx\><br>
+    Namespace: vigra
+
+    \code
+    Shape2 shape(200000, 200000), tile_shape(4096, 4096);
+
+    UInt32 count = labelTilesStreaming<UInt8, UInt32>(shape, tile_shape,
+        [&](Shape2 const & tile, MultiArrayView<2, UInt8> data)
+        {
+            ... // read the tile's segmentation from disk
+        },
+        [&](Shape2 const & tile, MultiArrayView<2, UInt32> const & labels)
+        {
+            ... // write the tile's labels to disk
+        },
+        LabelOptions().neighborhood(IndirectNeighborhood).ignoreBackgroundValue(0));
+    \endcode
+*/
+doxygen_overloaded_function(template <...> Label labelTilesStreaming)
+
+template <class T, class Label, class Source, class Sink, class Equal>
+Label
+labelTilesStreaming(MultiArrayShape<2>::type const & imageShape,
+                    MultiArrayShape<2>::type const & tileShape,
+                    Source source, Sink sink,
+                    LabelOptions const & options,
+                    Equal equal)
+{
+    typedef MultiArrayShape<2>::type Shape;
+
+    StreamingTileLabeling<T, Label, Equal> labeling(imageShape, tileShape, options, equal);
+    Shape tiles = labeling.tileCount(), tile;
+
+    MultiArray<2, T>     data;
+    MultiArray<2, Label> labels;
+    for(tile[1]=0; tile[1]<tiles[1]; ++tile[1])
+    {
+        for(tile[0]=0; tile[0]<tiles[0]; ++tile[0])
+        {
+            data.reshape(labeling.tileEnd(tile) - labeling.tileBegin(tile));
+            source(tile, data);
+            labeling.addTile(data);
+        }
+    }
+
+    Label count = labeling.finalize();
+
+    for(tile[1]=0; tile[1]<tiles[1]; ++tile[1])
+    {
+        for(tile[0]=0; tile[0]<tiles[0]; ++tile[0])
+        {
+            data.reshape(labeling.tileEnd(tile) - labeling.tileBegin(tile));
+            labels.reshape(data.shape());
+            source(tile, data);
+            labeling.relabelTile(tile, data, labels);
+            sink(tile, labels);
+        }
+    }
+    return count;
+}
+
+template <class T, class Label, class Source, class Sink>
+inline Label
+labelTilesStreaming(MultiArrayShape<2>::type const & imageShape,
+                    MultiArrayShape<2>::type const & tileShape,
+                    Source source, Sink sink,
+                    LabelOptions const & options = LabelOptions())
+{
+    return labelTilesStreaming<T, Label>(imageShape, tileShape, source, sink,
+                                         options, std::equal_to<T>());
+}
+
+//@}
+
+} // namespace vigra
+
+#endif // VIGRA_STREAMING_LABELING_HXX
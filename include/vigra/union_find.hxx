@@ -39,12 +39,14 @@
 
 /*std*/
 #include <map>
+#include <vector>
 
 /*vigra*/
 #include "config.hxx"
 #include "error.hxx"
 #include "array_vector.hxx"
 #include "iteratoradapter.hxx"
+#include "threading.hxx"
 
 namespace vigra {
 
@@ -321,6 +323,120 @@ class UnionFindArray
     }
 };
 
+#ifdef VIGRA_HAS_ATOMIC
+
+/** \brief Union-find array that can be modified concurrently by several threads.
+
+    In contrast to \ref UnionFindArray, the set of indices is fixed at construction
+    (indices <tt>0 ... size()-1</tt>), and all indices start as separate sets.
+    <tt>findIndex()</tt> is wait-free and compresses paths by path halving,
+    <tt>makeUnion()</tt> is lock-free and always links the root with the larger
+    index below the root with the smaller index (union by index), so that the
+    representative of a set is its smallest member. Both functions may be called
+    simultaneously from any number of threads.
+
+    After all unions have been performed, <tt>makeContiguous()</tt> (which must
+    not run concurrently with other member functions) replaces the tree structure
+    with consecutive labels in the order of the representatives. Afterwards,
+    <tt>findLabel()</tt> returns the final label of an index.
+
+    <b>\#include</b> \<vigra/union_find.hxx\><br>
+    Namespace: vigra
+*/
+template <class T>
+class ConcurrentUnionFindArray
+{
+    typedef threading::atomic<T>                    Slot;
+    typedef std::ptrdiff_t                          IndexType;
+
+    mutable std::vector<Slot> parents_;
+    bool contiguous_;
+
+  public:
+    ConcurrentUnionFindArray(T size = 0)
+    : parents_((std::size_t)size)
+    , contiguous_(false)
+    {
+        for(IndexType k=0; k < (IndexType)size; ++k)
+            parents_[k].store((T)k, threading::memory_order_relaxed);
+    }
+
+    T size() const
+    {
+        return (T)parents_.size();
+    }
+
+    T findIndex(T index) const
+    {
+        vigra_precondition(!contiguous_,
+            "ConcurrentUnionFindArray::findIndex(): array has already been made contiguous.");
+        for(;;)
+        {
+            T parent = parents_[(IndexType)index].load(threading::memory_order_relaxed);
+            if(parent == index)
+                return index;
+            T grandparent = parents_[(IndexType)parent].load(threading::memory_order_relaxed);
+            if(parent != grandparent)
+            {
+                // path halving: a failed exchange only means that another
+                // thread has already shortened the path
+                parents_[(IndexType)index].compare_exchange_weak(parent, grandparent,
+                                                               threading::memory_order_relaxed);
+            }
+            index = grandparent;
+        }
+    }
+
+    T makeUnion(T l1, T l2)
+    {
+        for(;;)
+        {
+            l1 = findIndex(l1);
+            l2 = findIndex(l2);
+            if(l1 == l2)
+                return l1;
+            if(l1 < l2)
+                std::swap(l1, l2);
+            // l1 is the larger root => attach it to l2, but only if
+            // no other thread has attached it elsewhere in the meantime
+            T expected = l1;
+            if(parents_[(IndexType)l1].compare_exchange_strong(expected, l2,
+                                                              threading::memory_order_acq_rel))
+                return l2;
+        }
+    }
+
+    T findLabel(T index) const
+    {
+        vigra_precondition(contiguous_,
+            "ConcurrentUnionFindArray::findLabel(): call makeContiguous() first.");
+        return parents_[(IndexType)index].load(threading::memory_order_relaxed);
+    }
+
+    T makeContiguous()
+    {
+        vigra_precondition(!contiguous_,
+            "ConcurrentUnionFindArray::makeContiguous(): must only be called once.");
+        // Since parents always have smaller indices than their children,
+        // a single ascending pass suffices: when index k is reached, its parent
+        // already holds the final label of k's set.
+        T count = 0;
+        for(IndexType k=0; k < (IndexType)parents_.size(); ++k)
+        {
+            T parent = parents_[k].load(threading::memory_order_relaxed);
+            if(parent == (T)k)
+                parents_[k].store(count++, threading::memory_order_relaxed);
+            else
+                parents_[k].store(parents_[(IndexType)parent].load(threading::memory_order_relaxed),
+                                  threading::memory_order_relaxed);
+        }
+        contiguous_ = true;
+        return count - 1;
+    }
+};
+
+#endif // VIGRA_HAS_ATOMIC
+
 } // namespace vigra
 
 #endif // VIGRA_UNION_FIND_HXX
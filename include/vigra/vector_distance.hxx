@@ -335,6 +335,16 @@ struct Error_output_pixel_type_must_be_TinyVector_of_appropriate_length
                                     MultiArrayView<N, T2, S2> dest,
                                     bool background,
                                     Array const & pixelPitch=TinyVector<double, N>(1));
+
+            // parallel version
+            template <unsigned int N, class T1, class S1,
+                      class T2, class S2, class Array>
+            void
+            separableVectorDistance(MultiArrayView<N, T1, S1> const & source,
+                                    MultiArrayView<N, T2, S2> dest,
+                                    bool background,
+                                    Array const & pixelPitch,
+                                    ParallelOptions const & options);
         }
         \endcode
 
@@ -367,11 +377,10 @@ void
 separableVectorDistance(MultiArrayView<N, T1, S1> const & source,
                         MultiArrayView<N, T2, S2> dest,
                         bool background,
-                        Array const & pixelPitch)
+                        Array const & pixelPitch,
+                        ParallelOptions const & options)
 {
     using namespace vigra::functor;
-    typedef typename MultiArrayView<N, T2, S2>::traverser Traverser;
-    typedef MultiArrayNavigator<Traverser, N> Navigator;
 
     VIGRA_STATIC_ASSERT((Error_output_pixel_type_must_be_TinyVector_of_appropriate_length<N == T2::static_size>));
     vigra_precondition(source.shape() == dest.shape(),
@@ -387,16 +396,31 @@ separableVectorDistance(MultiArrayView<N, T1, S1> const & source,
         transformMultiArray( source, dest,
                                 ifThenElse( Arg1() != Param(0), Param(maxDist), Param(rzero) ));
 
+    ThreadPool pool(options);
     for(unsigned d = 0; d < N; ++d )
     {
-        Navigator nav( dest.traverser_begin(), dest.shape(), d);
-        for( ; nav.hasMore(); nav++ )
-        {
-             detail::vectorialDistParabola(d, nav.begin(), nav.end(), pixelPitch);
-        }
+        detail::parallelForeachLine(pool, dest.shape(), d,
+            [&](const int /*threadId*/, typename MultiArrayShape<N>::type const & start)
+            {
+                MultiArrayView<1, T2, StridedArrayTag> line = detail::lineView(dest, start, d);
+                detail::vectorialDistParabola(d, line.begin(), line.end(), pixelPitch);
+            }
+        );
     }
 }
 
+template <unsigned int N, class T1, class S1,
+          class T2, class S2, class Array>
+inline void
+separableVectorDistance(MultiArrayView<N, T1, S1> const & source,
+                        MultiArrayView<N, T2, S2> dest,
+                        bool background,
+                        Array const & pixelPitch)
+{
+    separableVectorDistance(source, dest, background, pixelPitch,
+                            ParallelOptions().numThreads(ParallelOptions::NoThreads));
+}
+
 template <unsigned int N, class T1, class S1,
           class T2, class S2>
 inline void
@@ -425,6 +449,18 @@ separableVectorDistance(MultiArrayView<N, T1, S1> const & source,
                                    bool array_border_is_active=false,
                                    BoundaryDistanceTag boundary=OuterBoundary,
                                    Array const & pixelPitch=TinyVector<double, N>(1));
+
+            // parallel version
+            template <unsigned int N, class T1, class S1,
+                                      class T2, class S2,
+                      class Array>
+            void
+            boundaryVectorDistance(MultiArrayView<N, T1, S1> const & labels,
+                                   MultiArrayView<N, T2, S2> dest,
+                                   bool array_border_is_active,
+                                   BoundaryDistanceTag boundary,
+                                   Array const & pixelPitch,
+                                   ParallelOptions const & options);
         }
         \endcode
 
@@ -462,7 +498,8 @@ boundaryVectorDistance(MultiArrayView<N, T1, S1> const & labels,
                        MultiArrayView<N, T2, S2> dest,
                        bool array_border_is_active,
                        BoundaryDistanceTag boundary,
-                       Array const & pixelPitch)
+                       Array const & pixelPitch,
+                       ParallelOptions const & options)
 {
     VIGRA_STATIC_ASSERT((Error_output_pixel_type_must_be_TinyVector_of_appropriate_length<N == T2::static_size>));
     vigra_precondition(labels.shape() == dest.shape(),
@@ -479,7 +516,7 @@ boundaryVectorDistance(MultiArrayView<N, T1, S1> const & labels,
         markRegionBoundaries(labels, boundaries, IndirectNeighborhood);
         if(array_border_is_active)
             initMultiArrayBorder(boundaries, 1, 1);
-        separableVectorDistance(boundaries, dest, true, pixelPitch);
+        separableVectorDistance(boundaries, dest, true, pixelPitch, options);
     }
     else
     {
@@ -489,23 +526,20 @@ boundaryVectorDistance(MultiArrayView<N, T1, S1> const & labels,
                 "boundaryVectorDistance(..., InterpixelBoundary): output pixel type must be float or double.");
         }
 
-        typedef typename MultiArrayView<N, T1, S1>::const_traverser LabelIterator;
-        typedef typename MultiArrayView<N, T2, S2>::traverser DestIterator;
-        typedef MultiArrayNavigator<LabelIterator, N> LabelNavigator;
-        typedef MultiArrayNavigator<DestIterator, N> DNavigator;
-
         T2 maxDist(2*sum(labels.shape()*pixelPitch));
         dest = maxDist;
+        ThreadPool pool(options);
         for( unsigned d = 0; d < N; ++d )
         {
-            LabelNavigator lnav( labels.traverser_begin(), labels.shape(), d );
-            DNavigator dnav( dest.traverser_begin(), dest.shape(), d );
-
-            for( ; dnav.hasMore(); dnav++, lnav++ )
-            {
-                detail::boundaryVectorDistParabola(d, dnav.begin(), dnav.end(), lnav.begin(),
-                                                   pixelPitch, maxDist, array_border_is_active);
-            }
+            detail::parallelForeachLine(pool, labels.shape(), d,
+                [&](const int /*threadId*/, typename MultiArrayShape<N>::type const & start)
+                {
+                    MultiArrayView<1, T1, StridedArrayTag> label_line = detail::lineView(labels, start, d);
+                    MultiArrayView<1, T2, StridedArrayTag> line = detail::lineView(dest, start, d);
+                    detail::boundaryVectorDistParabola(d, line.begin(), line.end(), label_line.begin(),
+                                                       pixelPitch, maxDist, array_border_is_active);
+                }
+            );
         }
 
         if(boundary == InterpixelBoundary)
@@ -515,6 +549,20 @@ boundaryVectorDistance(MultiArrayView<N, T1, S1> const & labels,
     }
 }
 
+template <unsigned int N, class T1, class S1,
+                          class T2, class S2,
+          class Array>
+inline void
+boundaryVectorDistance(MultiArrayView<N, T1, S1> const & labels,
+                       MultiArrayView<N, T2, S2> dest,
+                       bool array_border_is_active,
+                       BoundaryDistanceTag boundary,
+                       Array const & pixelPitch)
+{
+    boundaryVectorDistance(labels, dest, array_border_is_active, boundary, pixelPitch,
+                           ParallelOptions().numThreads(ParallelOptions::NoThreads));
+}
+
 template <unsigned int N, class T1, class S1,
                           class T2, class S2>
 void
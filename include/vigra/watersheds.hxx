@@ -333,6 +333,7 @@ public:
 
     double thresh;
     DetectMinima mini;
+    int num_threads;
 
         /**\brief Construct default options object.
          *
@@ -340,7 +341,8 @@ public:
          */
     SeedOptions()
     : thresh(NumericTraits<double>::max()),
-      mini(Minima)
+      mini(Minima),
+      num_threads(0)
     {}
 
         /** Generate seeds at minima.
@@ -398,6 +400,18 @@ public:
         return *this;
     }
 
+        /** Use the given number of threads to find the minima.
+
+            Only effective for arrays (see \ref LocalMinmaxOptions::numThreads()).
+            <tt>ParallelOptions::Auto</tt> (-1) selects the number of hardware threads.<br>
+            Default: 0 (run in the calling thread)
+         */
+    SeedOptions & numThreads(int n)
+    {
+        num_threads = n;
+        return *this;
+    }
+
         // check whether the threshold has been set for the target type T
     template <class T>
     bool thresholdIsValid() const
@@ -779,8 +793,12 @@ class WatershedOptions
     double max_cost, bias;
     SRGType terminate;
     Method method;
-    unsigned int biased_label, bucket_count;
+    unsigned int biased_label, bucket_count, quantized_levels;
+    bool radix_queue;
     SeedOptions seed_options;
+    double compactness_weight;
+    MultiArrayIndex max_region_size;
+    int num_threads;
 
 
 
@@ -797,7 +815,12 @@ class WatershedOptions
       method(RegionGrowing),
       biased_label(0),
       bucket_count(0),
-      seed_options(SeedOptions().unspecified())
+      quantized_levels(0),
+      radix_queue(false),
+      seed_options(SeedOptions().unspecified()),
+      compactness_weight(0.0),
+      max_region_size(0),
+      num_threads(0)
     {}
 
         /** \brief Perform complete grow.
@@ -857,6 +880,13 @@ class WatershedOptions
             these boundary indicators are typically represented as
             UInt8 images, the default <tt>bucket_count</tt> is 256.
 
+            In watershedsMultiArray() and watershedsGraph(), the option only has 
+            an effect when the costs are integers whose range is smaller than 
+            <tt>bucket_count</tt>. The region growing then uses a \ref HierarchicalQueue, 
+            which processes pixels with equal cost in first-in first-out order. 
+            Otherwise, the option is ignored. Use quantizedQueue() to 
+            approximate arbitrary costs by a fixed number of levels.
+
             Default: don't use the turbo algorithm
         */
     WatershedOptions & turboAlgorithm(unsigned int bucket_count = 256)
@@ -866,6 +896,110 @@ class WatershedOptions
         return *this;
     }
 
+        /** \brief Use a radix heap in region growing.
+
+            Only supported by watershedsMultiArray() and watershedsGraph(). 
+            The \ref MonotoneRadixQueue processes pixels in exact cost order 
+            for arbitrary integer and floating point costs. Pixels with equal cost 
+            are processed in first-in first-out order. It is usually faster than 
+            the default binary heap. quantizedQueue() and an applicable 
+            turboAlgorithm() take precedence.
+
+            Default: don't use the radix heap
+        */
+    WatershedOptions & radixQueue(bool use = true)
+    {
+        radix_queue = use;
+        method = RegionGrowing;
+        return *this;
+    }
+
+        /** \brief Use a quantized queue in region growing.
+
+            Only supported by watershedsMultiArray() and watershedsGraph(). 
+            The \ref HierarchicalQueue maps the cost range of the data linearly 
+            onto <tt>levels</tt> levels and processes the pixels within the 
+            same level in first-in first-out order. This is faster than 
+            the binary heap, but only approximates the watersheds of the 
+            original costs, unless they are integers whose range is smaller 
+            than <tt>levels</tt>. A value of zero switches the option off.
+
+            Default: 0 (don't use the quantized queue)
+        */
+    WatershedOptions & quantizedQueue(unsigned int levels = 256)
+    {
+        quantized_levels = levels;
+        method = RegionGrowing;
+        return *this;
+    }
+
+        /** \brief Grow compact regions.
+
+            Only supported by watershedsMultiArray() and watershedsGraph() on a 
+            \ref GridGraph. The priority of a pixel becomes 
+            <tt>cost + weight * distance</tt>, where <tt>distance</tt> is the Euclidean 
+            distance between the pixel and the center of the seed of the region 
+            that claims it. Larger weights produce more regular regions, similar 
+            to the superpixels of slicSuperpixels(), at the price of a weaker 
+            adherence to the boundary indicator. A weight of zero switches the 
+            option off.
+
+            Default: 0.0 (ordinary watersheds)
+        */
+    WatershedOptions & compactness(double weight)
+    {
+        vigra_precondition(weight >= 0.0,
+            "WatershedOptions::compactness(): weight must not be negative.");
+        compactness_weight = weight;
+        method = RegionGrowing;
+        return *this;
+    }
+
+        /** \brief Limit the number of pixels per region.
+
+            Only supported by watershedsMultiArray() and watershedsGraph() on a 
+            \ref GridGraph. A region stops claiming pixels as soon as it contains 
+            <tt>size</tt> pixels (seed pixels included), so that the flooding 
+            continues in its neighbors. Pixels that no region can claim any more keep 
+            label 0. When combined with stopAtThreshold(), pixels above the threshold 
+            (which are labeled, but never expanded) do not count towards the size.
+            A size of zero switches the option off.
+
+            Default: 0 (no size limit)
+        */
+    WatershedOptions & maxRegionSize(MultiArrayIndex size)
+    {
+        vigra_precondition(size >= 0,
+            "WatershedOptions::maxRegionSize(): size must not be negative.");
+        max_region_size = size;
+        method = RegionGrowing;
+        return *this;
+    }
+
+        /** \brief Flood independent parts of the image in parallel.
+
+            Only supported by watershedsMultiArray() and watershedsGraph() on a 
+            \ref GridGraph, and only effective in combination with stopAtThreshold().
+            Pixels whose cost does not exceed the threshold form connected components 
+            which the flooding cannot cross. The seeds of different components 
+            are therefore grown independently, using <tt>n</tt> threads (or 
+            <tt>ParallelOptions::Auto</tt>). Pixels above the threshold that are 
+            claimed by regions from several components are assigned to the region 
+            that reached them at the lowest cost, and to the smaller label in case of 
+            a tie. The result is identical to the sequential algorithm up to the 
+            tie breaking at these pixels. Without stopAtThreshold(), or in combination 
+            with keepContours(), the flooding always runs sequentially, and the
+            threads are only used for the automatic seed generation (which uses the 
+            same number of threads, unless seedOptions() specify their own).
+
+            Default: 0 (sequential)
+        */
+    WatershedOptions & numThreads(int n)
+    {
+        num_threads = n;
+        return *this;
+    }
+
         /** \brief Specify seed options.
 
             In this case, watershedsRegionGrowing() assumes that the destination
@@ -36,6 +36,7 @@
 #define VIGRA_CHECK_BOUNDS
 
 #include <vigra/blockwise_labeling.hxx>
+#include <vigra/streaming_labeling.hxx>
 
 #include <vigra/multi_array.hxx>
 #include <vigra/multi_array_chunked.hxx>
@@ -267,6 +268,101 @@ struct BlockwiseLabelingTest
                                      oldschool_label_array.begin(), oldschool_label_array.end()), true);
     }
 
+#ifdef VIGRA_HAS_ATOMIC
+    void concurrentUnionFindTest()
+    {
+        typedef unsigned int Label;
+        const Label size = 10000;
+        const int pair_count = 8000;
+
+        std::vector<std::pair<Label, Label> > pairs;
+        srand(42);
+        for(int k = 0; k != pair_count; ++k)
+            pairs.push_back(std::make_pair(Label(rand() % size), Label(rand() % size)));
+
+        UnionFindArray<Label> serial_unions(size);
+        for(int k = 0; k != pair_count; ++k)
+            serial_unions.makeUnion(pairs[k].first, pairs[k].second);
+        Label serial_count = serial_unions.makeContiguous();
+
+        ConcurrentUnionFindArray<Label> concurrent_unions(size);
+        parallel_foreach(4, pair_count,
+            [&](const int /*threadId*/, const int k){
+                concurrent_unions.makeUnion(pairs[k].first, pairs[k].second);
+            }
+        );
+        for(int k = 0; k != pair_count; ++k)
+            shouldEqual(concurrent_unions.findIndex(pairs[k].first),
+                        concurrent_unions.findIndex(pairs[k].second));
+        Label concurrent_count = concurrent_unions.makeContiguous();
+
+        shouldEqual(serial_count, concurrent_count);
+        // both implementations order the sets by their smallest member
+        for(Label k = 0; k != size; ++k)
+            shouldEqual(serial_unions.findLabel(k), concurrent_unions.findLabel(k));
+    }
+#endif
+
+    void streamingTileLabelingTest()
+    {
+        vector<Array2> arrays(array_twos);
+        arrays.push_back(Array2(Shape2(57,43)));
+        fillRandom(arrays.back().begin(), arrays.back().end(), 2);
+        vector<Shape2> tile_shapes(shape_twos);
+        tile_shapes.push_back(Shape2(3,7));
+        tile_shapes.push_back(Shape2(16,1));
+
+        for(unsigned int i = 0; i != arrays.size(); ++i)
+        {
+            Array2 const & data = arrays[i];
+            for(unsigned int j = 0; j != tile_shapes.size(); ++j)
+            {
+                Shape2 tile_shape = min(tile_shapes[j], data.shape());
+                for(int n = 0; n != 2; ++n)
+                {
+                    NeighborhoodType neighborhood = n == 0 ? DirectNeighborhood : IndirectNeighborhood;
+                    for(int with_background = 0; with_background != 2; ++with_background)
+                    {
+                        Array2 correct_labels(data.shape()), tested_labels(data.shape());
+                        LabelOptions options;
+                        options.neighborhood(neighborhood);
+                        unsigned int correct_label_number;
+                        if(with_background)
+                        {
+                            correct_label_number = labelMultiArrayWithBackground(data, correct_labels, neighborhood, 1u);
+                            options.ignoreBackgroundValue(1u);
+                        }
+                        else
+                        {
+                            correct_label_number = labelMultiArray(data, correct_labels, neighborhood);
+                        }
+
+                        int sink_calls = 0;
+                        unsigned int tested_label_number = labelTilesStreaming<unsigned int, unsigned int>(
+                            data.shape(), tile_shape,
+                            [&](Shape2 const & tile, MultiArrayView<2, unsigned int> tile_data)
+                            {
+                                tile_data = data.subarray(tile*tile_shape, tile*tile_shape + tile_data.shape());
+                            },
+                            [&](Shape2 const & tile, MultiArrayView<2, unsigned int> const & labels)
+                            {
+                                tested_labels.subarray(tile*tile_shape, tile*tile_shape + labels.shape()) = labels;
+                                ++sink_calls;
+                            },
+                            options);
+
+                        int tile_count = ((data.shape(0) + tile_shape[0] - 1) / tile_shape[0]) *
+                                         ((data.shape(1) + tile_shape[1] - 1) / tile_shape[1]);
+                        shouldEqual(sink_calls, tile_count);
+                        shouldEqual(correct_label_number, tested_label_number);
+                        should(equivalentLabels(correct_labels.begin(), correct_labels.end(),
+                                                tested_labels.begin(), tested_labels.end()));
+                    }
+                }
+            }
+        }
+    }
+
     void fiveDimensionalRandomTest()
     {
         testOnData(array_fives.begin(), array_fives.end(),
@@ -295,6 +391,10 @@ struct BlockwiseLabelingTestSuite
         add(testCase(&BlockwiseLabelingTest::fiveDimensionalRandomTest));
         add(testCase(&BlockwiseLabelingTest::debugTest));
         add(testCase(&BlockwiseLabelingTest::chunkedArrayTest));
+#ifdef VIGRA_HAS_ATOMIC
+        add(testCase(&BlockwiseLabelingTest::concurrentUnionFindTest));
+#endif
+        add(testCase(&BlockwiseLabelingTest::streamingTileLabelingTest));
     }
 };
 
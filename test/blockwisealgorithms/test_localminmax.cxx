@@ -0,0 +1,151 @@
+/************************************************************************/
+/*                                                                      */
+/*                Copyright 2026 by the VIGRA developers                */
+/*                                                                      */
+/*    This file is part of the VIGRA computer vision library.           */
+/*    The VIGRA Website is                                              */
+/*        http://hci.iwr.uni-heidelberg.de/vigra/                       */
+/*    Please direct questions, bug reports, and contributions to        */
+/*        ullrich.koethe@iwr.uni-heidelberg.de    or                    */
+/*        vigra@informatik.uni-hamburg.de                               */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+#define VIGRA_CHECK_BOUNDS
+
+#include <vigra/blockwise_localminmax.hxx>
+
+#include <vigra/multi_array.hxx>
+#include <vigra/multi_array_chunked.hxx>
+#include <vigra/multi_localminmax.hxx>
+#include <vigra/unittest.hxx>
+
+#include <iostream>
+
+#include "utils.hxx"
+
+using namespace std;
+using namespace vigra;
+
+struct BlockwiseLocalMinMaxTest
+{
+    template <unsigned int N>
+    void testArrays(typename MultiArrayShape<N>::type const & shape, 
+                    typename MultiArrayShape<N>::type const & block_shape)
+    {
+        typedef typename MultiArrayShape<N>::type Shape;
+
+        MultiArray<N, int> data(shape);
+        fillRandom(data.begin(), data.end(), 50);
+
+        for(int k = 0; k < 8; ++k)
+        {
+            BlockwiseLocalMinmaxOptions options;
+            options.neighborhood((k & 1) ? IndirectNeighborhood : DirectNeighborhood)
+                   .allowAtBorder((k & 2) != 0)
+                   .markWith(3)
+                   .blockShape(block_shape)
+                   .numThreads(4);
+            if(k & 4)
+                options.threshold(20);
+
+            // values of non-extrema are preserved
+            MultiArray<N, UInt8> minima(shape, 1), maxima(shape, 1);
+            unsigned int minima_count = localMinima(data, minima, options),
+                         maxima_count = localMaxima(data, maxima, options);
+
+            MultiArray<N, UInt8> result(shape, 1);
+            shouldEqual(localMinimaBlockwise(data, result, options), minima_count);
+            should(result == minima);
+            result.init(1);
+            shouldEqual(localMaximaBlockwise(data, result, options), maxima_count);
+            should(result == maxima);
+
+            // ChunkedArray uses the chunk shape as block shape
+            ChunkedArrayLazy<N, int> chunked_data(shape, block_shape);
+            ChunkedArrayLazy<N, UInt8> chunked_result(shape, block_shape);
+            chunked_data.commitSubarray(Shape(0), data);
+            result.init(1);
+            chunked_result.commitSubarray(Shape(0), result);
+            options.blockShape(BlockwiseOptions::Shape());
+            shouldEqual(localMinimaBlockwise(chunked_data, chunked_result, options), minima_count);
+            chunked_result.checkoutSubarray(Shape(0), result);
+            should(result == minima);
+        }
+    }
+
+    void oneDimensionalTest()
+    {
+        testArrays<1>(Shape1(1), Shape1(4));
+        testArrays<1>(Shape1(997), Shape1(64));
+    }
+
+    void threeDimensionalTest()
+    {
+        testArrays<3>(Shape3(40, 31, 17), Shape3(8, 16, 4));
+        testArrays<3>(Shape3(2, 30, 9), Shape3(1, 8, 4));
+    }
+
+    void plateausTest()
+    {
+        MultiArray<2, int> data(Shape2(10, 10));
+        BlockwiseLocalMinmaxOptions options;
+        options.allowPlateaus();
+        try
+        {
+            MultiArray<2, UInt8> result(data.shape());
+            localMinimaBlockwise(data, result, options);
+            failTest("no exception thrown");
+        }
+        catch(PreconditionViolation & e)
+        {
+            std::string expected("\nPrecondition violation!\nlocalMinimaBlockwise(), localMaximaBlockwise(): allowPlateaus() is not supported."),
+                        actual(e.what());
+            shouldEqual(actual.substr(0, expected.size()), expected);
+        }
+    }
+};
+
+struct BlockwiseLocalMinMaxTestSuite
+  : public test_suite
+{
+    BlockwiseLocalMinMaxTestSuite()
+      : test_suite("blockwise local minima and maxima test")
+    {
+        add(testCase(&BlockwiseLocalMinMaxTest::oneDimensionalTest));
+        add(testCase(&BlockwiseLocalMinMaxTest::threeDimensionalTest));
+        add(testCase(&BlockwiseLocalMinMaxTest::plateausTest));
+    }
+};
+
+int main(int argc, char** argv)
+{
+    BlockwiseLocalMinMaxTestSuite test;
+    int failed = test.run(testsToBeExecuted(argc, argv));
+
+    cout << test.report() << endl;
+
+    return failed != 0;
+}
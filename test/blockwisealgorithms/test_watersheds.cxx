@@ -202,6 +202,137 @@ struct BlockwiseWatershedTest
                                      correct_labels.begin(), correct_labels.end()),
                     true);
     }
+
+    // random data without repeated values, so that the flooding order is unique
+    template <class Array>
+    static void fillDistinct(Array & data)
+    {
+        std::vector<int> values(data.size());
+        for(int i = 0; i != (int)values.size(); ++i)
+            values[i] = 2*i + 1;
+        for(int i = (int)values.size() - 1; i > 0; --i)
+            std::swap(values[i], values[rand() % (i + 1)]);
+        for(int i = 0; i != (int)values.size(); ++i)
+            data[i] = values[i];
+    }
+
+    void seededTest()
+    {
+        typedef MultiArray<3, double> Array;
+        typedef MultiArray<3, unsigned int> LabelArray;
+        typedef Array::difference_type Shape;
+
+        Shape shape(20, 15, 10);
+        Array data(shape);
+        fillDistinct(data);
+        LabelArray seeds(shape);
+        for(int k = 1; k <= 30; ++k)
+            seeds[rand() % seeds.size()] = k;
+
+        vector<Shape> block_shapes;
+        block_shapes.push_back(Shape(1));
+        block_shapes.push_back(Shape(3));
+        block_shapes.push_back(Shape(7, 4, 5));
+        block_shapes.push_back(Shape(100));
+
+        vector<WatershedOptions> options;
+        options.push_back(WatershedOptions());
+        options.push_back(WatershedOptions().stopAtThreshold(2000.0));
+
+        for(int n = 0; n != 2; ++n)
+        {
+            NeighborhoodType neighborhood = n == 0 ? DirectNeighborhood : IndirectNeighborhood;
+            for(decltype(options.size()) i = 0; i != options.size(); ++i)
+            {
+                LabelArray correct_labels(seeds);
+                unsigned int correct_label_number = watershedsMultiArray(data, correct_labels, neighborhood, options[i]);
+                for(decltype(block_shapes.size()) j = 0; j != block_shapes.size(); ++j)
+                {
+                    LabelArray tested_labels(seeds);
+                    unsigned int tested_label_number = 
+                        seededWatershedsBlockwise(data, tested_labels, 
+                                                  BlockwiseLabelOptions().neighborhood(neighborhood)
+                                                                         .blockShape(block_shapes[j]),
+                                                  options[i]);
+                    shouldEqual(tested_label_number, correct_label_number);
+                    if(tested_labels != correct_labels)
+                    {
+                        ostringstream oss;
+                        oss << "labeling not equal" << endl;
+                        oss << "block shape: " << block_shapes[j] << endl;
+                        oss << "neighborhood: " << neighborhood << endl;
+                        oss << "options: " << i << endl;
+                        failTest(oss.str().c_str());
+                    }
+                }
+            }
+        }
+
+        // seeds at the local minima
+        LabelArray correct_labels(shape), tested_labels(shape);
+        size_t correct_label_number = watershedsMultiArray(data, correct_labels, IndirectNeighborhood);
+        size_t tested_label_number = 
+            seededWatershedsBlockwise(data, tested_labels, BlockwiseLabelOptions().neighborhood(IndirectNeighborhood)
+                                                                                  .blockShape(Shape(6)));
+        shouldEqual(correct_label_number, tested_label_number);
+        should(equivalentLabels(tested_labels.begin(), tested_labels.end(),
+                                correct_labels.begin(), correct_labels.end()));
+    }
+
+    void seededChunkedTest()
+    {
+        typedef MultiArray<3, float> OldschoolArray;
+        typedef MultiArray<3, UInt32> OldschoolLabelArray;
+        typedef OldschoolArray::difference_type Shape;
+
+        Shape shape(30, 25, 20);
+        Shape chunk_shape(8);
+        NeighborhoodType neighborhood = IndirectNeighborhood;
+
+        OldschoolArray oldschool_data(shape);
+        fillDistinct(oldschool_data);
+        OldschoolLabelArray seeds(shape);
+        for(int k = 1; k <= 50; ++k)
+            seeds[rand() % seeds.size()] = k;
+
+        OldschoolLabelArray correct_labels(seeds);
+        UInt32 correct_label_number = watershedsMultiArray(oldschool_data, correct_labels, neighborhood);
+
+        ChunkedArrayLazy<3, float> data(shape, chunk_shape);
+        data.commitSubarray(Shape(0), oldschool_data);
+        ChunkedArrayLazy<3, UInt32> tested_labels(shape, chunk_shape);
+        tested_labels.commitSubarray(Shape(0), seeds);
+        UInt32 tested_label_number = seededWatershedsBlockwise(data, tested_labels, 
+                                                               BlockwiseLabelOptions().neighborhood(neighborhood));
+        shouldEqual(correct_label_number, tested_label_number);
+        OldschoolLabelArray result(shape);
+        tested_labels.checkoutSubarray(Shape(0), result);
+        should(result == correct_labels);
+
+        // explicit temporary storage
+        ChunkedArrayLazy<3, float> costs(shape, chunk_shape);
+        ChunkedArrayLazy<3, unsigned short> directions(shape, chunk_shape);
+        tested_labels.commitSubarray(Shape(0), seeds);
+        seededWatershedsBlockwise(data, tested_labels, BlockwiseLabelOptions().neighborhood(neighborhood),
+                                  WatershedOptions(), costs, directions);
+        tested_labels.checkoutSubarray(Shape(0), result);
+        should(result == correct_labels);
+
+        // the temporary costs must be chunked like the data
+        ChunkedArrayLazy<3, float> bad_costs(shape, Shape(16));
+        try
+        {
+            seededWatershedsBlockwise(data, tested_labels, BlockwiseLabelOptions(),
+                                      WatershedOptions(), bad_costs, directions);
+            failTest("no exception thrown");
+        }
+        catch(PreconditionViolation & c)
+        {
+            std::string expected("\nPrecondition violation!\nseededWatershedsBlockwise(): shape or chunk shape of temporary_costs");
+            std::string message(c.what());
+            should(0 == expected.compare(message.substr(0,expected.size())));
+        }
+    }
 };
 
 struct BlockwiseWatershedTestSuite
@@ -213,6 +344,8 @@ struct BlockwiseWatershedTestSuite
         add(testCase(&BlockwiseWatershedTest::fourDimensionalRandomTest));
         add(testCase(&BlockwiseWatershedTest::oneDimensionalTest));
         add(testCase(&BlockwiseWatershedTest::chunkedTest));
+        add(testCase(&BlockwiseWatershedTest::seededTest));
+        add(testCase(&BlockwiseWatershedTest::seededChunkedTest));
     }
 };
 
@@ -0,0 +1,135 @@
+/************************************************************************/
+/*                                                                      */
+/*                Copyright 2026 by the VIGRA developers                */
+/*                                                                      */
+/*    This file is part of the VIGRA computer vision library.           */
+/*    The VIGRA Website is                                              */
+/*        http://hci.iwr.uni-heidelberg.de/vigra/                       */
+/*    Please direct questions, bug reports, and contributions to        */
+/*        ullrich.koethe@iwr.uni-heidelberg.de    or                    */
+/*        vigra@informatik.uni-hamburg.de                               */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+
+
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+
+#include <vigra/unittest.hxx>
+#include <vigra/multi_array.hxx>
+#include <vigra/graph_algorithms.hxx>
+#include <vigra/random.hxx>
+
+namespace chrono = std::chrono;
+
+namespace vigra
+{
+
+    // Compares ShortestPathDijkstra with ShortestPathDeltaStepping on a 3D grid
+    // whose edge weights are computed on the fly from random node weights.
+    // The default size of 512^3 needs about 12 GB of memory; pass a smaller
+    // edge length as the environment variable VIGRA_BENCHMARK_SIZE if necessary.
+struct ShortestPathBenchmark
+{
+    typedef chrono::steady_clock                                         clock_type;
+    typedef GridGraph<3, boost_graph::undirected_tag>                    Graph;
+    typedef Graph::NodeMap<float>                                        NodeMap;
+    typedef OnTheFlyEdgeMap2<Graph, NodeMap, MeanFunctor<float>, float>  ImplicitEdgeMap;
+
+    int size;
+
+    ShortestPathBenchmark()
+    : size(512)
+    {
+        if(std::getenv("VIGRA_BENCHMARK_SIZE"))
+            size = std::atoi(std::getenv("VIGRA_BENCHMARK_SIZE"));
+    }
+
+    static double seconds(clock_type::time_point start)
+    {
+        return chrono::duration_cast<chrono::milliseconds>(clock_type::now() - start).count() / 1000.0;
+    }
+
+    void testGridGraph()
+    {
+        Graph g(Shape3(size), DirectNeighborhood);
+        NodeMap nodeWeights(g);
+        RandomMT19937 random(42);
+        for(NodeMap::iterator i = nodeWeights.begin(); i != nodeWeights.end(); ++i)
+            *i = random.uniform(0.1, 10.0);
+        ImplicitEdgeMap weights(g, nodeWeights, MeanFunctor<float>());
+        Graph::Node source(Shape3(size / 2));
+
+        std::cout << "# shortest paths on " << size << "^3 grid, times in s" << std::endl;
+
+        MultiArray<3, float> reference(g.shape());
+        {
+            ShortestPathDijkstra<Graph, float, ChangeableRadixHeap<float> > pf(g);
+            clock_type::time_point start = clock_type::now();
+            pf.run(weights, source);
+            std::cout << "Dijkstra (radix heap):   " << seconds(start) << std::endl;
+            reference = pf.distances();
+        }
+        {
+            ShortestPathDijkstra<Graph, float> pf(g);
+            clock_type::time_point start = clock_type::now();
+            pf.run(weights, source);
+            std::cout << "Dijkstra (binary heap):  " << seconds(start) << std::endl;
+        }
+        for(int threads = 1; threads <= 64; threads *= 2)
+        {
+            ShortestPathDeltaStepping<Graph, float> pf(g, ParallelOptions().numThreads(threads));
+            clock_type::time_point start = clock_type::now();
+            pf.run(weights, source);
+            std::cout << "delta-stepping, " << threads << " threads: " << seconds(start)
+                      << " (delta = " << pf.delta() << ")" << std::endl;
+            shouldEqualSequence(reference.begin(), reference.end(), pf.distances().begin());
+            if(threads >= (int)std::thread::hardware_concurrency())
+                break;
+        }
+    }
+};
+
+struct ShortestPathBenchmarkSuite : public test_suite
+{
+    ShortestPathBenchmarkSuite()
+    : test_suite("ShortestPathBenchmarkSuite")
+    {
+        add(testCase(&ShortestPathBenchmark::testGridGraph));
+    }
+};
+
+} // namespace vigra
+
+int main(int argc, char** argv)
+{
+    vigra::ShortestPathBenchmarkSuite benchmark;
+    const int failed = benchmark.run(vigra::testsToBeExecuted(argc, argv));
+    std::cout << benchmark.report() << std::endl;
+
+    return failed != 0;
+}
@@ -38,8 +38,11 @@
 #include "vigra/stdimage.hxx"
 #include "vigra/multi_array.hxx"
 #include "vigra/adjacency_list_graph.hxx"
+#include "vigra/static_adjacency_list_graph.hxx"
 #include "vigra/graph_algorithms.hxx"
 #include "vigra/multi_resize.hxx"
+#include "vigra/hierarchical_clustering.hxx"
+#include "vigra/random.hxx"
 
 using namespace vigra;
 
@@ -371,6 +374,7 @@ struct GraphAlgorithmTest{
         g.addEdge(n3,n4);
 
         testShortestPathImpl(g);
+        testShortestPathImpl(StaticAdjacencyListGraph(g));
     }
 
     void testShortestPathGridGraph()
@@ -381,6 +385,157 @@ struct GraphAlgorithmTest{
         testShortestPathWithROIImpl(g);
     }
 
+    template <class QUEUE, class WEIGHT_MAP>
+    void testShortestPathQueueImpl(GridGraph<3, boost_graph::undirected_tag> const & g, 
+                                   WEIGHT_MAP const & weights)
+    {
+        typedef GridGraph<3, boost_graph::undirected_tag> Graph;
+        typedef typename WEIGHT_MAP::Value WeightType;
+        typedef Graph::Node Node;
+
+        ShortestPathDijkstra<Graph, WeightType> reference(g);
+        ShortestPathDijkstra<Graph, WeightType, QUEUE> pf(g);
+
+        Node source(3, 4, 5), target(9, 1, 7);
+        reference.run(weights, source);
+        pf.run(weights, source);
+        shouldEqual(pf.discoveryOrder().size(), reference.discoveryOrder().size());
+        for(Graph::NodeIt n(g); n != lemon::INVALID; ++n)
+        {
+            shouldEqual(pf.distances()[*n], reference.distances()[*n]);
+            // predecessors may differ, but must be on a shortest path
+            if(*n != source)
+            {
+                const Node p = pf.predecessors()[*n];
+                shouldEqual(pf.distances()[p] + weights[g.findEdge(p, *n)], pf.distances()[*n]);
+            }
+        }
+
+        pf.reRun(weights, source, target);
+        shouldEqual(pf.target(), target);
+        shouldEqual(pf.distance(target), reference.distance(target));
+
+        // stop as soon as all targets are reached
+        std::vector<Node> targets;
+        targets.push_back(Node(4, 4, 5));
+        targets.push_back(target);
+        targets.push_back(Node(0, 0, 0));
+        pf.reRunMultiTarget(weights, source, targets.begin(), targets.end());
+        for(std::size_t k = 0; k < targets.size(); ++k)
+            shouldEqual(pf.distance(targets[k]), reference.distance(targets[k]));
+        should(pf.target() != lemon::INVALID);
+        should(pf.discoveryOrder().size() < reference.discoveryOrder().size());
+        shouldEqual(pf.distance(pf.target()), pf.distance(pf.discoveryOrder().back()));
+
+        // an unreachable target
+        pf.runMultiTarget(weights, source, targets.begin(), targets.end(), 
+                          (WeightType)(reference.distance(targets[0])));
+        should(pf.target() == lemon::INVALID);
+    }
+
+    void testShortestPathQueues()
+    {
+        typedef GridGraph<3, boost_graph::undirected_tag> Graph;
+        Graph g(Shape3(12, 10, 8), IndirectNeighborhood);
+        Graph::EdgeMap<UInt32> intWeights(g);
+        Graph::EdgeMap<float>  floatWeights(g);
+        srand(42);
+        for(Graph::EdgeIt e(g); e != lemon::INVALID; ++e)
+        {
+            intWeights[*e]   = 1 + rand() % 255;
+            floatWeights[*e] = 0.25f * (1 + rand() % 1000);
+        }
+        testShortestPathQueueImpl<ChangeableBucketQueue<UInt32> >(g, intWeights);
+        testShortestPathQueueImpl<ChangeableRadixHeap<UInt32> >(g, intWeights);
+        testShortestPathQueueImpl<ChangeableRadixHeap<float> >(g, floatWeights);
+    }
+
+    template <class Graph, class WEIGHTS>
+    void testDeltaSteppingImpl(Graph const & g, WEIGHTS const & weights, float delta, float maxDistance)
+    {
+        typedef typename Graph::Node Node;
+        typedef typename Graph::NodeIt NodeIt;
+
+        Node source(g.nodeFromId(g.maxNodeId() / 3));
+        ShortestPathDijkstra<Graph, float> dijkstra(g);
+        dijkstra.run(weights, source, lemon::INVALID, maxDistance);
+
+        for(int threads = 0; threads <= 4; threads += 4)
+        {
+            ShortestPathDeltaStepping<Graph, float> pf(g, ParallelOptions().numThreads(threads));
+            pf.setDelta(delta);
+            pf.run(weights, source, maxDistance);
+            should(pf.source() == source);
+            should(pf.delta() > 0.0f);
+            for(NodeIt n(g); n != lemon::INVALID; ++n)
+            {
+                should(pf.predecessors()[*n] == dijkstra.predecessors()[*n]);
+                if(pf.predecessors()[*n] != lemon::INVALID)
+                    shouldEqual(pf.distance(*n), dijkstra.distance(*n));
+            }
+        }
+    }
+
+    void testShortestPathDeltaStepping()
+    {
+        typedef GridGraph<3, boost_graph::undirected_tag> Graph;
+        typedef Graph::NodeMap<float> NodeMap;
+        typedef OnTheFlyEdgeMap2<Graph, NodeMap, MeanFunctor<float>, float> ImplicitEdgeMap;
+
+        Graph g(Shape3(20, 18, 16), IndirectNeighborhood);
+        NodeMap nodeWeights(g);
+        RandomMT19937 random(42);
+        for(Graph::NodeIt n(g); n != lemon::INVALID; ++n)
+            nodeWeights[*n] = random.uniform(0.1, 10.0);
+        ImplicitEdgeMap weights(g, nodeWeights, MeanFunctor<float>());
+
+        float infinity = NumericTraits<float>::max();
+        testDeltaSteppingImpl(g, weights, 0.0f, infinity);
+        testDeltaSteppingImpl(g, weights, 0.5f, infinity);
+        testDeltaSteppingImpl(g, weights, 100.0f, infinity);
+        testDeltaSteppingImpl(g, weights, 0.0f, 40.0f);
+
+        StaticAdjacencyListGraph sg(g);
+        StaticAdjacencyListGraph::EdgeMap<float> staticWeights(sg);
+        for(Graph::EdgeIt e(g); e != lemon::INVALID; ++e)
+            staticWeights[sg.edgeFromId(g.id(*e))] = weights[*e];
+        testDeltaSteppingImpl(sg, staticWeights, 0.0f, infinity);
+
+        // integer weights produce many ties: distances must still agree, and
+        // predecessors must lie on a shortest path
+        Graph::EdgeMap<UInt32> intWeights(g);
+        for(Graph::EdgeIt e(g); e != lemon::INVALID; ++e)
+            intWeights[*e] = 1 + random.uniformInt(4);
+        Graph::Node source(3, 4, 5);
+        ShortestPathDijkstra<Graph, UInt32> dijkstra(g);
+        dijkstra.run(intWeights, source);
+        ShortestPathDeltaStepping<Graph, UInt32> pf(g, ParallelOptions().numThreads(4));
+        pf.run(intWeights, source);
+        for(Graph::NodeIt n(g); n != lemon::INVALID; ++n)
+        {
+            shouldEqual(pf.distance(*n), dijkstra.distance(*n));
+            if(*n == source)
+            {
+                should(pf.predecessors()[*n] == source);
+                continue;
+            }
+            Graph::Node p = pf.predecessors()[*n];
+            shouldEqual(pf.distance(*n), pf.distance(p) + intWeights[g.findEdge(p, *n)]);
+        }
+
+        // parallel seeded segmentation
+        Graph::NodeMap<UInt32> seeds(g), parallelSeeds(g);
+        seeds[Graph::Node(1, 1, 1)] = 1;
+        seeds[Graph::Node(18, 2, 7)] = 2;
+        seeds[Graph::Node(9, 16, 14)] = 3;
+        parallelSeeds = seeds;
+        shortestPathSegmentation<Graph, ImplicitEdgeMap, NodeMap, Graph::NodeMap<UInt32>, float>(
+                                 g, weights, nodeWeights, seeds);
+        shortestPathSegmentation<Graph, ImplicitEdgeMap, NodeMap, Graph::NodeMap<UInt32>, float>(
+                                 g, weights, nodeWeights, parallelSeeds, ParallelOptions().numThreads(4));
+        shouldEqualSequence(seeds.begin(), seeds.end(), parallelSeeds.begin());
+    }
+
     void testRegionAdjacencyGraph(){
         {
             GraphType g(0,0);
@@ -453,6 +608,314 @@ struct GraphAlgorithmTest{
     }
 
 
+    void testRegionAdjacencyGraphParallel(){
+        typedef GridGraph<3, boost_graph::undirected_tag> GridGraph3d;
+        typedef GridGraph3d::Edge GridEdge;
+        typedef TinyVector<MultiArrayIndex, 3> Shape3;
+
+        MultiArray<3, UInt32> labels(Shape3(20, 17, 11));
+        for(auto i = labels.begin(); i != labels.end(); ++i){
+            Shape3 p = i.point();
+            *i = (p[0]/4) + 5*(p[1]/5) + 20*(p[2]/3) + (p[0]*p[1] % 7 == 0 ? 100 : 0);
+        }
+
+        for(int nb = 0; nb < 2; ++nb){
+            GridGraph3d g(labels.shape(), nb == 0 ? DirectNeighborhood : IndirectNeighborhood);
+            for(Int64 ignoreLabel = -1; ignoreLabel < 1; ++ignoreLabel){
+                GraphType rag, rrag;
+                GraphType::EdgeMap< std::vector<GridEdge> > affEdges;
+                GridGraph3d::NodeMap<UInt32> labelMap(g);
+                labelMap = labels;
+                makeRegionAdjacencyGraph(g, labelMap, rrag, affEdges, ignoreLabel);
+
+                std::vector<Int64> offsets, ids;
+                makeRegionAdjacencyGraph(g, labels, rag, offsets, ids, ignoreLabel,
+                                         ParallelOptions().numThreads(4));
+
+                shouldEqual(rag.nodeNum(), rrag.nodeNum());
+                shouldEqual(rag.edgeNum(), rrag.edgeNum());
+                shouldEqual(offsets.size(), rag.edgeNum()+1);
+                shouldEqual((size_t)offsets.back(), ids.size());
+                for(NodeIt n(rrag); n != lemon::INVALID; ++n)
+                    should(rag.nodeFromId(rrag.id(*n)) != lemon::INVALID);
+
+                Int64 previous = -1;
+                for(EdgeIt e(rag); e != lemon::INVALID; ++e){
+                    // edges are sorted by label pair
+                    Int64 u = rag.id(rag.u(*e)), v = rag.id(rag.v(*e));
+                    should(u < v);
+                    should(u*1000 + v > previous);
+                    previous = u*1000 + v;
+
+                    Edge re = rrag.findEdge(rrag.nodeFromId(u), rrag.nodeFromId(v));
+                    should(re != lemon::INVALID);
+                    std::vector<Int64> rids;
+                    for(size_t k = 0; k < affEdges[re].size(); ++k)
+                        rids.push_back(g.id(affEdges[re][k]));
+                    std::sort(rids.begin(), rids.end());
+                    Int64 begin = offsets[rag.id(*e)], end = offsets[rag.id(*e)+1];
+                    shouldEqual((size_t)(end - begin), rids.size());
+                    shouldEqualSequence(ids.begin()+begin, ids.begin()+end, rids.begin());
+                }
+            }
+        }
+    }
+
+    void testStaticAdjacencyListGraph(){
+        typedef GridGraph<2, boost_graph::undirected_tag> GridGraph2d;
+        typedef StaticAdjacencyListGraph SGraph;
+
+        MultiArray<2, UInt32> labels(Shape2(40, 33));
+        for(auto i = labels.begin(); i != labels.end(); ++i){
+            Shape2 p = i.point();
+            *i = 1 + (p[0]/5) + 8*(p[1]/4) + (p[0]*p[1] % 11 == 0 ? 100 : 0);
+        }
+        GridGraph2d g(labels.shape(), IndirectNeighborhood);
+
+        GraphType rag;
+        SGraph srag;
+        std::vector<Int64> offsets, ids, soffsets, sids;
+        makeRegionAdjacencyGraph(g, labels, rag, offsets, ids);
+        makeRegionAdjacencyGraph(g, labels, srag, soffsets, sids);
+        SGraph crag(rag);
+
+        shouldEqual(srag.nodeNum(), rag.nodeNum());
+        shouldEqual(srag.edgeNum(), rag.edgeNum());
+        shouldEqual(srag.maxNodeId(), rag.maxNodeId());
+        shouldEqual(srag.maxEdgeId(), rag.maxEdgeId());
+        shouldEqualSequence(soffsets.begin(), soffsets.end(), offsets.begin());
+        shouldEqualSequence(sids.begin(), sids.end(), ids.begin());
+        shouldEqual(crag.nodeNum(), rag.nodeNum());
+        shouldEqual(crag.edgeNum(), rag.edgeNum());
+
+        // structure and iteration
+        MultiArrayIndex count = 0;
+        for(SGraph::NodeIt n(srag); n != lemon::INVALID; ++n, ++count){
+            const Node rn = rag.nodeFromId(srag.id(*n));
+            should(rn != lemon::INVALID);
+            should(crag.nodeFromId(srag.id(*n)) != lemon::INVALID);
+            shouldEqual(srag.degree(*n), rag.degree(rn));
+
+            Int64 previous = -1;
+            std::size_t degree = 0;
+            for(SGraph::IncEdgeIt e(srag, *n); e != lemon::INVALID; ++e, ++degree){
+                should(srag.baseNode(e) == *n);
+                const SGraph::Node other = srag.runningNode(e);
+                should(srag.id(other) > previous);
+                previous = srag.id(other);
+                should(srag.findEdge(*n, other) == *e);
+                should(srag.findEdge(other, *n) == *e);
+                const Edge re = rag.findEdge(rn, rag.nodeFromId(srag.id(other)));
+                shouldEqual(rag.id(re), srag.id(*e));
+                should(crag.findEdge(crag.nodeFromId(srag.id(*n)), crag.nodeFromId(srag.id(other))) != lemon::INVALID);
+            }
+            shouldEqual(degree, srag.degree(*n));
+
+            std::size_t outArcs = 0;
+            for(SGraph::OutArcIt a(srag, *n); a != lemon::INVALID; ++a, ++outArcs)
+                should(srag.source(*a) == *n);
+            shouldEqual(outArcs, degree);
+        }
+        shouldEqual(count, srag.nodeNum());
+        should(srag.findEdge(srag.nodeFromId(1), srag.nodeFromId(srag.maxNodeId())) == lemon::INVALID);
+        should(srag.nodeFromId(0) == lemon::INVALID);
+
+        count = 0;
+        for(SGraph::EdgeIt e(srag); e != lemon::INVALID; ++e, ++count){
+            const Edge re = rag.edgeFromId(srag.id(*e));
+            shouldEqual(srag.id(srag.u(*e)), rag.id(rag.u(re)));
+            shouldEqual(srag.id(srag.v(*e)), rag.id(rag.v(re)));
+        }
+        shouldEqual(count, srag.edgeNum());
+
+        // algorithms give identical results on both graph types
+        GraphType::EdgeMap<float> weights(rag);
+        SGraph::EdgeMap<float> sweights(srag);
+        GraphType::NodeMap<float> sizes(rag, 1.0f);
+        SGraph::NodeMap<float> ssizes(srag, 1.0f);
+        GraphType::NodeMap<UInt32> seeds(rag, 0u), wsLabels(rag), fzLabels(rag);
+        SGraph::NodeMap<UInt32> sseeds(srag, 0u), swsLabels(srag), sfzLabels(srag);
+        for(EdgeIt e(rag); e != lemon::INVALID; ++e){
+            const Int64 u = rag.id(rag.u(*e)), v = rag.id(rag.v(*e));
+            weights[*e] = sweights[srag.edgeFromId(rag.id(*e))] = float((u*37 + v*101) % 53);
+        }
+        for(Int64 k = 0, seed = 1; k <= rag.maxNodeId(); k += 9, ++seed){
+            if(rag.nodeFromId(k) == lemon::INVALID)
+                continue;
+            seeds[rag.nodeFromId(k)] = seed;
+            sseeds[srag.nodeFromId(k)] = seed;
+        }
+
+        ShortestPathDijkstra<GraphType, float> sp(rag);
+        ShortestPathDijkstra<SGraph, float> ssp(srag);
+        sp.run(weights, rag.nodeFromId(1));
+        ssp.run(sweights, srag.nodeFromId(1));
+
+        edgeWeightedWatershedsSegmentation(rag, weights, seeds, wsLabels);
+        edgeWeightedWatershedsSegmentation(srag, sweights, sseeds, swsLabels);
+        felzenszwalbSegmentation(rag, weights, sizes, 20.0f, fzLabels);
+        felzenszwalbSegmentation(srag, sweights, ssizes, 20.0f, sfzLabels);
+
+        for(NodeIt n(rag); n != lemon::INVALID; ++n){
+            const SGraph::Node sn = srag.nodeFromId(rag.id(*n));
+            shouldEqual(ssp.distances()[sn], sp.distances()[*n]);
+            shouldEqual(swsLabels[sn], wsLabels[*n]);
+            shouldEqual(sfzLabels[sn], fzLabels[*n]);
+        }
+    }
+
+    template <class LABELS>
+    void checkSamePartition(GraphType const & g, LABELS const & a, LABELS const & b)
+    {
+        std::map<UInt32, UInt32> ab, ba;
+        for(NodeIt n(g); n != lemon::INVALID; ++n)
+        {
+            if(ab.find(a[*n]) == ab.end())
+                ab[a[*n]] = b[*n];
+            if(ba.find(b[*n]) == ba.end())
+                ba[b[*n]] = a[*n];
+            shouldEqual(ab[a[*n]], b[*n]);
+            shouldEqual(ba[b[*n]], a[*n]);
+        }
+    }
+
+    void testFastHierarchicalClustering(){
+        MultiArray<2, UInt32> labels(Shape2(60, 51));
+        for(auto i = labels.begin(); i != labels.end(); ++i)
+            *i = (i.point()[0]/3) + 20*(i.point()[1]/3);
+        GridGraph<2, boost_graph::undirected_tag> g(labels.shape());
+        GraphType rag;
+        std::vector<Int64> offsets, ids;
+        makeRegionAdjacencyGraph(g, labels, rag, offsets, ids);
+
+        RandomMT19937 random(42);
+        GraphType::EdgeMap<float> weights(rag), lengths(rag);
+        GraphType::NodeMap<TinyVector<float, 3> > features(rag);
+        GraphType::NodeMap<float> sizes(rag);
+        for(EdgeIt e(rag); e != lemon::INVALID; ++e)
+        {
+            weights[*e] = random.uniform();
+            lengths[*e] = 1.0f + random.uniformInt(5);
+        }
+        for(NodeIt n(rag); n != lemon::INVALID; ++n)
+        {
+            features[*n] = TinyVector<float, 3>(random.uniform(), random.uniform(), random.uniform());
+            sizes[*n] = 1.0f + random.uniformInt(10);
+        }
+
+        ClusteringOptions options[] = {
+            ClusteringOptions().minRegionCount(10).nodeFeatureImportance(0.0).sizeImportance(0.0),
+            ClusteringOptions().minRegionCount(1).nodeFeatureImportance(0.0).sizeImportance(0.0)
+                               .maxMergeDistance(0.45),
+            ClusteringOptions().minRegionCount(25).nodeFeatureImportance(0.5).sizeImportance(1.0),
+            ClusteringOptions().minRegionCount(5).nodeFeatureImportance(0.3).sizeImportance(0.5)
+                               .nodeFeatureMetric(metrics::L2Norm)
+        };
+        for(int k = 0; k < 4; ++k)
+        {
+            // hierarchicalClustering() updates the maps in place
+            GraphType::EdgeMap<float> w(rag), l(rag);
+            GraphType::NodeMap<TinyVector<float, 3> > f(rag);
+            GraphType::NodeMap<float> s(rag);
+            w = weights; l = lengths; f = features; s = sizes;
+            GraphType::NodeMap<UInt32> reference(rag), result(rag);
+            hierarchicalClustering(rag, w, l, f, s, reference, options[k]);
+
+            FastHierarchicalClustering<GraphType> clustering(rag, options[k]);
+            clustering.cluster(weights, lengths, features, sizes);
+            for(NodeIt n(rag); n != lemon::INVALID; ++n)
+                result[*n] = clustering.reprNodeId(rag.id(*n));
+
+            checkSamePartition(rag, reference, result);
+
+            fastHierarchicalClustering(rag, weights, lengths, features, sizes, reference, options[k]);
+            checkSamePartition(rag, reference, result);
+
+            if(k < 2)
+            {
+                // average linkage: every merge is cheaper than all remaining boundaries
+                GraphType::EdgeMap<float> ucm(rag);
+                clustering.ucmTransform(ucm);
+                float maxInside = 0.0f, minBoundary = NumericTraits<float>::max();
+                for(EdgeIt e(rag); e != lemon::INVALID; ++e)
+                {
+                    if(result[rag.u(*e)] == result[rag.v(*e)])
+                        maxInside = std::max(maxInside, ucm[*e]);
+                    else
+                        minBoundary = std::min(minBoundary, ucm[*e]);
+                }
+                should(maxInside <= minBoundary);
+                if(k == 1)
+                    should(minBoundary >= 0.45f);
+            }
+        }
+    }
+
+    void testFastHierarchicalClusteringParallel(){
+        MultiArray<2, UInt32> labels(Shape2(90, 75));
+        for(auto i = labels.begin(); i != labels.end(); ++i)
+            *i = (i.point()[0]/3) + 30*(i.point()[1]/3);
+        GridGraph<2, boost_graph::undirected_tag> g(labels.shape());
+        GraphType rag;
+        std::vector<Int64> offsets, ids;
+        makeRegionAdjacencyGraph(g, labels, rag, offsets, ids);
+
+        RandomMT19937 random(7);
+        GraphType::EdgeMap<float> weights(rag), lengths(rag);
+        GraphType::NodeMap<float> features(rag), sizes(rag);
+        for(EdgeIt e(rag); e != lemon::INVALID; ++e)
+        {
+            weights[*e] = random.uniform();
+            lengths[*e] = 1.0f + random.uniformInt(5);
+        }
+        for(NodeIt n(rag); n != lemon::INVALID; ++n)
+        {
+            features[*n] = random.uniform();
+            sizes[*n] = 1.0f + random.uniformInt(10);
+        }
+
+        ClusteringOptions options[] = {
+            ClusteringOptions().minRegionCount(40).nodeFeatureImportance(0.0).sizeImportance(0.0),
+            ClusteringOptions().minRegionCount(1).nodeFeatureImportance(0.0).sizeImportance(0.0)
+                               .maxMergeDistance(0.5),
+            ClusteringOptions().minRegionCount(30).nodeFeatureImportance(0.0).sizeImportance(0.0)
+                               .maxMergeDistance(0.5),
+            ClusteringOptions().minRegionCount(40).nodeFeatureImportance(0.5).sizeImportance(1.0)
+        };
+        for(int k = 0; k < 4; ++k)
+        {
+            GraphType::NodeMap<UInt32> reference(rag);
+            fastHierarchicalClustering(rag, weights, lengths, features, sizes, reference, options[k]);
+            std::set<UInt32> referenceClusters;
+            for(NodeIt n(rag); n != lemon::INVALID; ++n)
+                referenceClusters.insert(reference[*n]);
+
+            for(int threads = 1; threads <= 4; threads += 3)
+            {
+                FastHierarchicalClustering<GraphType> clustering(rag, options[k]);
+                clustering.cluster(weights, lengths, features, sizes, 
+                                   ParallelOptions().numThreads(threads));
+                GraphType::NodeMap<UInt32> result(rag);
+                std::set<UInt32> clusters;
+                for(NodeIt n(rag); n != lemon::INVALID; ++n)
+                {
+                    result[*n] = clustering.reprNodeId(rag.id(*n));
+                    clusters.insert(result[*n]);
+                }
+                shouldEqual((MultiArrayIndex)clusters.size(), clustering.nodeNum());
+                if(k < 3)
+                {
+                    // reducible distance: same result as the serial algorithm
+                    checkSamePartition(rag, reference, result);
+                }
+                else
+                {
+                    shouldEqual(clusters.size(), referenceClusters.size());
+                }
+            }
+        }
+    }
+
     void testEdgeSort(){
         {
             GraphType g(0,0);
@@ -543,6 +1006,217 @@ struct GraphAlgorithmTest{
         shouldEqualSequence(edgeMap1.begin(), edgeMap1.end(), ref2);
         shouldEqualSequence(edgeMap2.begin(), edgeMap2.end(), ref2);
     }
+
+    void testImplicitEdgeMaps()
+    {
+        typedef GridGraph<3, boost_graph::undirected_tag> Graph;
+        typedef Graph::Node Node;
+
+        {
+            MultiArray<2, double> nodeMap(Shape2(3,2), LinearSequence);
+            MultiArray<2, double> interpolated(Shape2(5,3));
+            resizeImageLinearInterpolation(nodeMap, interpolated);
+
+            GridGraph<2> g(nodeMap.shape(), IndirectNeighborhood);
+            GridGraph<2>::EdgeMap<double> edgeMap1(g), edgeMap2(g);
+            for(int euclidean = 0; euclidean < 2; ++euclidean)
+            {
+                edgeWeightsFromNodeWeights(g, nodeMap, edgeMap1, euclidean == 1);
+                edgeWeightsFromInterpolatedImage(g, interpolated, edgeMap2, euclidean == 1);
+                auto implicit1 = implicitEdgeWeightsFromNodeWeights(g, nodeMap, euclidean == 1);
+                auto implicit2 = implicitEdgeWeightsFromInterpolatedImage(g, interpolated, euclidean == 1);
+                for(GridGraph<2>::EdgeIt e(g); e != lemon::INVALID; ++e)
+                {
+                    shouldEqual(implicit1[*e], edgeMap1[*e]);
+                    shouldEqual(implicit2[*e], edgeMap2[*e]);
+                }
+            }
+        }
+
+        MultiArray<3, float> volume(Shape3(16, 14, 12));
+        RandomMT19937 random(7);
+        for(auto i = volume.begin(); i != volume.end(); ++i)
+            *i = random.uniform(0.0, 100.0);
+
+        Graph g(volume.shape(), IndirectNeighborhood);
+        Graph::EdgeMap<float> explicitWeights(g);
+        edgeWeightsFromNodeWeights(g, volume, explicitWeights, true);
+        auto implicitWeights = implicitEdgeWeightsFromNodeWeights(g, volume, true);
+        shouldEqual(implicitWeights[*Graph::EdgeIt(g)], explicitWeights[*Graph::EdgeIt(g)]);
+
+        // shortest paths
+        {
+            Node source(3, 5, 7);
+            ShortestPathDijkstra<Graph, float> pf1(g), pf2(g);
+            pf1.run(explicitWeights, source);
+            pf2.run(implicitWeights, source);
+            shouldEqualSequence(pf1.distances().begin(), pf1.distances().end(), pf2.distances().begin());
+        }
+
+        // seeded watersheds
+        {
+            Graph::NodeMap<UInt32> seeds(g), labels1(g), labels2(g);
+            seeds[Node(0, 0, 0)] = 1;
+            seeds[Node(15, 13, 11)] = 2;
+            seeds[Node(8, 2, 9)] = 3;
+            edgeWeightedWatershedsSegmentation(g, explicitWeights, seeds, labels1);
+            edgeWeightedWatershedsSegmentation(g, implicitWeights, seeds, labels2);
+            shouldEqualSequence(labels1.begin(), labels1.end(), labels2.begin());
+        }
+
+        // Felzenszwalb
+        Graph::NodeMap<UInt32> labels(g);
+        {
+            Graph::NodeMap<float> nodeSizes(g, 1.0f);
+            Graph::NodeMap<UInt32> labels2(g);
+            felzenszwalbSegmentation(g, explicitWeights, nodeSizes, 200.0f, labels);
+            felzenszwalbSegmentation(g, implicitWeights, nodeSizes, 200.0f, labels2);
+            shouldEqualSequence(labels.begin(), labels.end(), labels2.begin());
+        }
+
+        // RAG features from a lambda
+        {
+            auto contrast = makeImplicitEdgeMap(g,
+                [&volume](Node const & u, Node const & v)
+                {
+                    return std::abs(volume[u] - volume[v]);
+                });
+
+            GraphType rag, rrag;
+            GraphType::EdgeMap< std::vector<Graph::Edge> > affEdges;
+            makeRegionAdjacencyGraph(g, labels, rrag, affEdges);
+            std::vector<Int64> offsets, ids;
+            makeRegionAdjacencyGraph(g, labels, rag, offsets, ids, -1, ParallelOptions().numThreads(4));
+            should(rag.edgeNum() > 10);
+
+            Graph::EdgeMap<float> explicitContrast(g);
+            for(Graph::EdgeIt e(g); e != lemon::INVALID; ++e)
+                explicitContrast[*e] = std::abs(volume[g.u(*e)] - volume[g.v(*e)]);
+
+            RagEdgeAccumulator accumulators[] = { RagEdgeMean, RagEdgeSum, RagEdgeMin, RagEdgeMax };
+            for(int a = 0; a < 4; ++a)
+            {
+                GraphType::EdgeMap<float> f1(rrag), f2(rrag), f3(rag);
+                ragEdgeFeatures(rrag, g, affEdges, explicitContrast, accumulators[a], f1);
+                ragEdgeFeatures(rrag, g, affEdges, contrast, accumulators[a], f2);
+                ragEdgeFeatures(rag, g, offsets, ids, contrast, accumulators[a], f3, 
+                                ParallelOptions().numThreads(4));
+                for(EdgeIt e(rrag); e != lemon::INVALID; ++e)
+                {
+                    shouldEqual(f1[*e], f2[*e]);
+                    Edge e3 = rag.findEdge(rag.nodeFromId(rrag.id(rrag.u(*e))), rag.nodeFromId(rrag.id(rrag.v(*e))));
+                    shouldEqualTolerance(f1[*e], f3[e3], 1e-5f);
+                }
+            }
+        }
+    }
+
+    void testFelzenszwalbParallel()
+    {
+        // region adjacency graph
+        {
+            MultiArray<2, UInt32> labels(Shape2(60, 51));
+            for(auto i = labels.begin(); i != labels.end(); ++i)
+                *i = (i.point()[0]/3) + 20*(i.point()[1]/3);
+            GridGraph<2, boost_graph::undirected_tag> g(labels.shape());
+            GraphType rag;
+            std::vector<Int64> offsets, ids;
+            makeRegionAdjacencyGraph(g, labels, rag, offsets, ids);
+
+            RandomMT19937 random(42);
+            GraphType::EdgeMap<double> weights(rag);
+            GraphType::NodeMap<double> sizes(rag);
+            for(EdgeIt e(rag); e != lemon::INVALID; ++e)
+                weights[*e] = random.uniform() - 0.5;
+            for(NodeIt n(rag); n != lemon::INVALID; ++n)
+                sizes[*n] = 1.0 + random.uniformInt(5);
+
+            for(int stopCond = -1; stopCond <= 50; stopCond += 51)
+            {
+                GraphType::NodeMap<UInt32> ref(rag), l0(rag), l4(rag);
+                felzenszwalbSegmentation(rag, weights, sizes, 1.0f, ref, stopCond);
+                felzenszwalbSegmentation(rag, weights, sizes, 1.0f, l0, 
+                                         FelzenszwalbOptions().numThreads(0).nodeNumStopCond(stopCond));
+                felzenszwalbSegmentation(rag, weights, sizes, 1.0f, l4, 
+                                         FelzenszwalbOptions().numThreads(4).nodeNumStopCond(stopCond));
+                shouldEqualSequence(ref.begin(), ref.end(), l0.begin());
+                shouldEqualSequence(ref.begin(), ref.end(), l4.begin());
+                if(stopCond == 50)
+                    shouldEqual(*std::max_element(ref.begin(), ref.end()), 49u);
+            }
+
+            // long double weights have no radix sort key and are sorted by comparison
+            {
+                GraphType::EdgeMap<long double> longWeights(rag);
+                GraphType::NodeMap<long double> longSizes(rag);
+                for(EdgeIt e(rag); e != lemon::INVALID; ++e)
+                    longWeights[*e] = weights[*e];
+                for(NodeIt n(rag); n != lemon::INVALID; ++n)
+                    longSizes[*n] = sizes[*n];
+                GraphType::NodeMap<UInt32> ref(rag), l4(rag);
+                felzenszwalbSegmentation(rag, weights, sizes, 1.0f, ref);
+                felzenszwalbSegmentation(rag, longWeights, longSizes, 1.0f, l4, 
+                                         FelzenszwalbOptions().numThreads(4));
+                shouldEqualSequence(ref.begin(), ref.end(), l4.begin());
+            }
+            try
+            {
+                GraphType::NodeMap<UInt32> l(rag);
+                felzenszwalbSegmentation(rag, weights, sizes, 1.0f, l, FelzenszwalbOptions().blockShape(10));
+                failTest("felzenszwalbSegmentation() failed to throw exception.");
+            }
+            catch(PreconditionViolation & c)
+            {
+                std::string expected("\nPrecondition violation!\nfelzenszwalbSegmentation(): the block-parallel approximation requires a GridGraph.");
+                std::string message(c.what());
+                should(0 == expected.compare(message.substr(0,expected.size())));
+            }
+        }
+
+        // grid graph
+        {
+            typedef GridGraph<3, boost_graph::undirected_tag> Graph;
+            Graph g(Shape3(40, 35, 30), IndirectNeighborhood);
+            RandomMT19937 random(42);
+            Graph::EdgeMap<float> weights(g);
+            Graph::EdgeMap<UInt16> intWeights(g);
+            Graph::NodeMap<float> sizes(g, 1.0f);
+            for(Graph::EdgeIt e(g); e != lemon::INVALID; ++e)
+            {
+                weights[*e] = random.uniform() - 0.25f;
+                intWeights[*e] = random.uniformInt(1000);
+            }
+
+            Graph::NodeMap<UInt32> ref(g), l0(g), l4(g);
+            felzenszwalbSegmentation(g, weights, sizes, 0.5f, ref);
+            felzenszwalbSegmentation(g, weights, sizes, 0.5f, l0, FelzenszwalbOptions().numThreads(0));
+            felzenszwalbSegmentation(g, weights, sizes, 0.5f, l4, FelzenszwalbOptions().numThreads(4));
+            shouldEqualSequence(ref.begin(), ref.end(), l0.begin());
+            shouldEqualSequence(ref.begin(), ref.end(), l4.begin());
+            UInt32 regionCount = *std::max_element(ref.begin(), ref.end()) + 1;
+            should(regionCount > 10 && regionCount < g.nodeNum() / 4);
+
+            // a single block is the exact algorithm
+            felzenszwalbSegmentation(g, weights, sizes, 0.5f, l4, 
+                                     FelzenszwalbOptions().numThreads(4).blockShape(g.shape()));
+            shouldEqualSequence(ref.begin(), ref.end(), l4.begin());
+
+            // smaller blocks give a similar number of regions
+            felzenszwalbSegmentation(g, weights, sizes, 0.5f, l0, 
+                                     FelzenszwalbOptions().numThreads(0).blockShape(Shape3(16, 16, 8)));
+            felzenszwalbSegmentation(g, weights, sizes, 0.5f, l4, 
+                                     FelzenszwalbOptions().numThreads(4).blockShape(Shape3(16, 16, 8)));
+            shouldEqualSequence(l0.begin(), l0.end(), l4.begin());
+            UInt32 blockRegionCount = *std::max_element(l4.begin(), l4.end()) + 1;
+            should(blockRegionCount > regionCount / 2 && blockRegionCount < 2 * regionCount);
+
+            // integer weights have ties, which are ordered by edge ID independent of the thread count
+            felzenszwalbSegmentation(g, intWeights, sizes, 500.0f, l0, FelzenszwalbOptions().numThreads(0));
+            felzenszwalbSegmentation(g, intWeights, sizes, 500.0f, l4, FelzenszwalbOptions().numThreads(4));
+            shouldEqualSequence(l0.begin(), l0.end(), l4.begin());
+            should(*std::max_element(l4.begin(), l4.end()) > 0);
+        }
+    }
 };
 
 
@@ -555,9 +1229,17 @@ struct GraphAlgorithmTestSuite
     {   
         add( testCase( &GraphAlgorithmTest::testShortestPathAdjacencyListGraph));
         add( testCase( &GraphAlgorithmTest::testShortestPathGridGraph));
+        add( testCase( &GraphAlgorithmTest::testShortestPathQueues));
+        add( testCase( &GraphAlgorithmTest::testShortestPathDeltaStepping));
         add( testCase( &GraphAlgorithmTest::testRegionAdjacencyGraph));
+        add( testCase( &GraphAlgorithmTest::testRegionAdjacencyGraphParallel));
+        add( testCase( &GraphAlgorithmTest::testStaticAdjacencyListGraph));
+        add( testCase( &GraphAlgorithmTest::testFastHierarchicalClustering));
+        add( testCase( &GraphAlgorithmTest::testFastHierarchicalClusteringParallel));
         add( testCase( &GraphAlgorithmTest::testEdgeSort));
         add( testCase( &GraphAlgorithmTest::testEdgeWeightComputation));
+        add( testCase( &GraphAlgorithmTest::testImplicitEdgeMaps));
+        add( testCase( &GraphAlgorithmTest::testFelzenszwalbParallel));
         add( testCase( &GraphAlgorithmTest::testShortestPathGridGraph2));
     }
 };
@@ -0,0 +1,159 @@
+/************************************************************************/
+/*                                                                      */
+/*                Copyright 2026 by the VIGRA developers                */
+/*                                                                      */
+/*    This file is part of the VIGRA computer vision library.           */
+/*    The VIGRA Website is                                              */
+/*        http://hci.iwr.uni-heidelberg.de/vigra/                       */
+/*    Please direct questions, bug reports, and contributions to        */
+/*        ullrich.koethe@iwr.uni-heidelberg.de    or                    */
+/*        vigra@informatik.uni-hamburg.de                               */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+
+
+
+
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+
+#include <vigra/unittest.hxx>
+#include <vigra/multi_array.hxx>
+#include <vigra/multi_labeling.hxx>
+#include <vigra/multi_watersheds.hxx>
+#include <vigra/graph_algorithms.hxx>
+#include <vigra/random.hxx>
+
+namespace chrono = std::chrono;
+
+namespace vigra
+{
+
+    // Times the GridGraph algorithms that traverse interior nodes with
+    // precomputed neighbor offsets on a 3D grid with 26-neighborhood. 
+    // The default size is 256^3; pass a different edge length as the 
+    // environment variable VIGRA_BENCHMARK_SIZE.
+struct GridGraphBenchmark
+{
+    typedef chrono::steady_clock                         clock_type;
+    typedef GridGraph<3, boost_graph::undirected_tag>    Graph;
+
+    int size;
+    MultiArray<3, float> data;
+
+    GridGraphBenchmark()
+    : size(256)
+    {
+        if(std::getenv("VIGRA_BENCHMARK_SIZE"))
+            size = std::atoi(std::getenv("VIGRA_BENCHMARK_SIZE"));
+        data.reshape(Shape3(size));
+        RandomMT19937 random(42);
+        for(auto i = data.begin(); i != data.end(); ++i)
+            *i = random.uniform();
+    }
+
+    static double seconds(clock_type::time_point start)
+    {
+        return chrono::duration_cast<chrono::milliseconds>(clock_type::now() - start).count() / 1000.0;
+    }
+
+    void testLabeling()
+    {
+        MultiArray<3, UInt8> classes(data.shape());
+        for(MultiArrayIndex k = 0; k < data.size(); ++k)
+            classes[k] = data[k] < 0.6f;
+        MultiArray<3, UInt32> labels(data.shape());
+
+        clock_type::time_point start = clock_type::now();
+        UInt32 count = labelMultiArray(classes, labels, IndirectNeighborhood);
+        std::cout << "labelMultiArray:              " << seconds(start) << " s (" << count << " regions)" << std::endl;
+
+        start = clock_type::now();
+        count = labelMultiArrayWithBackground(classes, labels, IndirectNeighborhood);
+        std::cout << "labelMultiArrayWithBackground: " << seconds(start) << " s (" << count << " regions)" << std::endl;
+    }
+
+    void testWatersheds()
+    {
+        MultiArray<3, UInt32> labels(data.shape());
+
+        clock_type::time_point start = clock_type::now();
+        UInt32 count = watershedsMultiArray(data, labels, IndirectNeighborhood, 
+                                            WatershedOptions().unionFind());
+        std::cout << "union-find watersheds:        " << seconds(start) << " s (" << count << " regions)" << std::endl;
+
+        const char * names[] = { "seeded watersheds (heap):     ",
+                                 "seeded watersheds (radix):    ",
+                                 "seeded watersheds (quantized):" };
+        WatershedOptions options[] = { WatershedOptions().regionGrowing(),
+                                       WatershedOptions().radixQueue(),
+                                       WatershedOptions().quantizedQueue(256) };
+        for(int o = 0; o < 3; ++o)
+        {
+            labels.init(0);
+            for(MultiArrayIndex k = 0; k < labels.size(); k += 1000)
+                labels[k] = k / 1000 + 1;
+            start = clock_type::now();
+            watershedsMultiArray(data, labels, IndirectNeighborhood, options[o]);
+            std::cout << names[o] << seconds(start) << " s" << std::endl;
+        }
+    }
+
+    void testShortestPath()
+    {
+        Graph g(data.shape(), IndirectNeighborhood);
+        Graph::EdgeMap<float> weights(g);
+        edgeWeightsFromNodeWeights(g, data, weights);
+
+        ShortestPathDijkstra<Graph, float> pf(g);
+        clock_type::time_point start = clock_type::now();
+        pf.run(weights, Graph::Node(Shape3(size / 2)));
+        std::cout << "Dijkstra:                     " << seconds(start) << " s" << std::endl;
+    }
+};
+
+struct GridGraphBenchmarkSuite : public test_suite
+{
+    GridGraphBenchmarkSuite()
+    : test_suite("GridGraphBenchmarkSuite")
+    {
+        add(testCase(&GridGraphBenchmark::testLabeling));
+        add(testCase(&GridGraphBenchmark::testWatersheds));
+        add(testCase(&GridGraphBenchmark::testShortestPath));
+    }
+};
+
+} // namespace vigra
+
+int main(int argc, char** argv)
+{
+    vigra::GridGraphBenchmarkSuite benchmark;
+    const int failed = benchmark.run(vigra::testsToBeExecuted(argc, argv));
+    std::cout << benchmark.report() << std::endl;
+
+    return failed != 0;
+}
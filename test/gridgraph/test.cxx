@@ -1188,6 +1188,84 @@ struct GridGraphTests
             }
         }
     }
+
+    template <class DirectedTag, NeighborhoodType NType>
+    void testScanlineTraversal()
+    {
+        typedef GridGraph<N, DirectedTag> Graph;
+        typedef typename Graph::Node Node;
+        typedef typename Graph::Edge Edge;
+        typedef typename Graph::OutArcIt OutArcIt;
+
+        MultiCoordinateIterator<N> i(Shape(4)), iend = i.getEndIterator();
+        for(; i != iend; ++i)
+        {
+            // create all possible array shapes from 1**N to 4**N
+            Shape s = *i + Shape(1);
+            Graph g(s, NType);
+            ArrayVector<MultiArrayIndex> idOffsets(g.neighborStrideOffsets());
+            OutArcVisitor<Graph> visitNeighbors(g);
+
+            MultiArrayIndex nextId = 0;
+            scanlineTraversal(g, [&](Shape const & start, MultiArrayIndex length, bool interior)
+            {
+                should(length > 0);
+                shouldEqual(g.id(start), nextId);
+                Node node(start);
+                for(MultiArrayIndex x = 0; x < length; ++x, ++node[0], ++nextId)
+                {
+                    shouldEqual(interior, g.get_border_type(node) == 0);
+                    if(interior)
+                    {
+                        for(unsigned int k = 0; k < g.maxDegree(); ++k)
+                            shouldEqual(nextId + idOffsets[k], g.id(g.neighbor(node, k)));
+                    }
+
+                    // the visitor yields the same arcs as OutArcIt
+                    ArrayVector<Node> targets;
+                    ArrayVector<MultiArrayIndex> ids;
+                    ArrayVector<Edge> edges;
+                    visitNeighbors(node, nextId, [&](Node const & t, MultiArrayIndex id, Edge const & e)
+                    {
+                        targets.push_back(t);
+                        ids.push_back(id);
+                        edges.push_back(e);
+                    });
+                    unsigned int count = 0;
+                    for(OutArcIt a(g, node); a != lemon::INVALID; ++a, ++count)
+                    {
+                        should(count < targets.size());
+                        shouldEqual(targets[count], g.target(*a));
+                        shouldEqual(ids[count], g.id(g.target(*a)));
+                        shouldEqual(edges[count], Edge(*a));
+                    }
+                    shouldEqual(count, targets.size());
+                }
+            });
+            shouldEqual(nextId, g.nodeNum());
+
+            // a box visits its nodes in scan order and classifies them as above
+            Shape roiBegin, roiEnd;
+            for(unsigned int d = 0; d < N; ++d)
+            {
+                roiBegin[d] = s[d] / 3;
+                roiEnd[d] = s[d] - s[d] / 4;
+            }
+            MultiCoordinateIterator<N> j(roiEnd - roiBegin), jend = j.getEndIterator();
+            scanlineTraversal(g, roiBegin, roiEnd, [&](Shape const & start, MultiArrayIndex length, bool interior)
+            {
+                should(length > 0);
+                Node node(start);
+                for(MultiArrayIndex x = 0; x < length; ++x, ++node[0], ++j)
+                {
+                    should(j != jend);
+                    shouldEqual(node, roiBegin + *j);
+                    shouldEqual(interior, g.get_border_type(node) == 0);
+                }
+            });
+            should(j == jend);
+        }
+    }
 };
 
 template <unsigned int N>
@@ -1274,6 +1352,11 @@ struct GridgraphTestSuiteN
         add(testCase((&GridGraphTests<N>::template testArcIterator<directed_tag, DirectNeighborhood>)));
         add(testCase((&GridGraphTests<N>::template testArcIterator<undirected_tag, DirectNeighborhood>)));
         
+        add(testCase((&GridGraphTests<N>::template testScanlineTraversal<directed_tag, IndirectNeighborhood>)));
+        add(testCase((&GridGraphTests<N>::template testScanlineTraversal<undirected_tag, IndirectNeighborhood>)));
+        add(testCase((&GridGraphTests<N>::template testScanlineTraversal<directed_tag, DirectNeighborhood>)));
+        add(testCase((&GridGraphTests<N>::template testScanlineTraversal<undirected_tag, DirectNeighborhood>)));
+        
         add(testCase((&GridGraphAlgorithmTests<N>::template testLocalMinMax<undirected_tag, DirectNeighborhood>)));
     }
 };
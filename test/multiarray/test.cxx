@@ -43,6 +43,7 @@
 #include "vigra/multi_pointoperators.hxx"
 #include "vigra/tensorutilities.hxx"
 #include "vigra/multi_tensorutilities.hxx"
+#include "vigra/linear_algebra.hxx"
 #include "vigra/functorexpression.hxx"
 #include "vigra/multi_math.hxx"
 #include "vigra/algorithm.hxx"
@@ -2456,6 +2457,81 @@ struct MultiArrayPointoperatorsTest
         tensorEigenvaluesMultiArray(tensor1, vector);
         shouldEqualSequenceTolerance(vector.begin(), vector.end(), rtensor.begin(), (TinyVector<double, 2>(1e-14)));
     }
+
+    void testTensorEigensystem()
+    {
+        using namespace vigra::linalg;
+
+        Shape3 shape(70, 5, 4);
+        MultiArray<3, TinyVector<double, 6> > tensor(shape);
+        MultiArray<3, TinyVector<double, 3> > ew(shape), rew(shape);
+        MultiArray<3, TinyVector<double, 9> > ev(shape);
+
+        for(auto & t : tensor)
+            for(int l=0; l<6; ++l)
+                t[l] = randomMT19937().uniform() - 0.5;
+        // degenerate eigenvalues
+        double degenerate[3][6] = { { 2.0, 0.0, 0.0, 2.0, 0.0, 2.0 },
+                                    { 1.0, 0.0, 0.0, 3.0, 0.0, 3.0 },
+                                    { 1.0, 1.0, 1.0, 1.0, 1.0, 1.0 } };
+        for(int k=0; k<3; ++k)
+            tensor[Shape3(k,0,0)] = TinyVector<double, 6>(degenerate[k]);
+        tensor[Shape3(3,0,0)] = TinyVector<double, 6>();
+
+        tensorEigenvaluesMultiArray(srcMultiArrayRange(tensor), destMultiArray(rew));
+        tensorEigenvaluesMultiArray(tensor, ew, ParallelOptions().numThreads(4));
+        shouldEqualSequenceTolerance(ew.begin(), ew.end(), rew.begin(), (TinyVector<double, 3>(1e-12)));
+
+        ew = TinyVector<double, 3>();
+        tensorEigensystemMultiArray(tensor, ew, ev, ParallelOptions().numThreads(4));
+        shouldEqualSequenceTolerance(ew.begin(), ew.end(), rew.begin(), (TinyVector<double, 3>(1e-12)));
+
+        for(auto i = createCoupledIterator(tensor, ew, ev), end = i.getEndIterator(); i != end; ++i)
+        {
+            TinyVector<double, 6> const & t = i.get<1>();
+            Matrix<double> a(3, 3), v(3, 3);
+            a(0,0) = t[0]; a(0,1) = a(1,0) = t[1]; a(0,2) = a(2,0) = t[2];
+            a(1,1) = t[3]; a(1,2) = a(2,1) = t[4]; a(2,2) = t[5];
+            for(int k=0; k<3; ++k)
+                for(int l=0; l<3; ++l)
+                    v(l, k) = i.get<3>()[3*k+l];
+            // orthonormal, right-handed, and A v = lambda v
+            shouldEqualTolerance(determinant(v), 1.0, 1e-12);
+            Matrix<double> vtv = transpose(v)*v;
+            for(int k=0; k<3; ++k)
+                for(int l=0; l<3; ++l)
+                    shouldEqualTolerance(vtv(k,l), k == l ? 1.0 : 0.0, 1e-12);
+            Matrix<double> av = a*v;
+            for(int k=0; k<3; ++k)
+                for(int l=0; l<3; ++l)
+                    should(std::abs(av(l,k) - i.get<2>()[k]*v(l,k)) < 1e-10);
+        }
+
+        MultiArray<2, TinyVector<float, 3> > tensor2(Shape2(100, 3));
+        MultiArray<2, TinyVector<float, 2> > ew2(tensor2.shape()), rew2(tensor2.shape());
+        MultiArray<2, TinyVector<float, 4> > ev2(tensor2.shape());
+        for(auto & t : tensor2)
+            for(int l=0; l<3; ++l)
+                t[l] = randomMT19937().uniform() - 0.5;
+        tensor2[Shape2(0,0)] = TinyVector<float, 3>(1.0f, 0.0f, 1.0f);
+
+        tensorEigenvaluesMultiArray(srcMultiArrayRange(tensor2), destMultiArray(rew2));
+        tensorEigensystemMultiArray(tensor2, ew2, ev2, ParallelOptions().numThreads(4));
+        // single precision: the small eigenvalue is only accurate in absolute terms
+        for(int k=0; k<ew2.size(); ++k)
+            should(max(abs(ew2[k] - rew2[k])) < 1e-6f);
+        for(auto i = createCoupledIterator(tensor2, ew2, ev2), end = i.getEndIterator(); i != end; ++i)
+        {
+            TinyVector<float, 3> const & t = i.get<1>();
+            TinyVector<float, 4> const & v = i.get<3>();
+            for(int k=0; k<2; ++k)
+            {
+                shouldEqualTolerance(norm(TinyVector<float, 2>(v[2*k], v[2*k+1])), 1.0f, 1e-6f);
+                should(std::abs(t[0]*v[2*k] + t[1]*v[2*k+1] - i.get<2>()[k]*v[2*k]) < 1e-5f);
+                should(std::abs(t[1]*v[2*k] + t[2]*v[2*k+1] - i.get<2>()[k]*v[2*k+1]) < 1e-5f);
+            }
+        }
+    }
 };
 
 class MultiMathTest
@@ -3154,6 +3230,7 @@ struct MultiArrayPointOperatorsTestSuite
         add( testCase( &MultiArrayPointoperatorsTest::testInitMultiArrayBorder ) );
         add( testCase( &MultiArrayPointoperatorsTest::testInspect ) );
         add( testCase( &MultiArrayPointoperatorsTest::testTensorUtilities ) );
+        add( testCase( &MultiArrayPointoperatorsTest::testTensorEigensystem ) );
 
         add( testCase( &MultiMathTest::testSpeed ) );
         add( testCase( &MultiMathTest::testBasicArithmetic ) );
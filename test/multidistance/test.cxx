@@ -45,6 +45,7 @@
 #include <vigra/impex.hxx>
 #include <vigra/vector_distance.hxx>
 #include <vigra/skeleton.hxx>
+#include <vigra/multi_labeling.hxx>
 #include <vigra/timing.hxx>
 
 
@@ -362,6 +363,90 @@ struct MultiDistanceTest
         separableMultiDistance(img2, res, true);
         shouldEqualSequence(res.begin(), res.end(), desired);
     }
+
+    void testDistanceParallel()
+    {
+        Shape3 shape(31, 27, 23);
+        TinyVector<double, 3> pixelPitch(1.2, 1.0, 2.4);
+        MultiArray<3, UInt8> mask(shape);
+        for(int k=0; k<40; ++k)
+            mask[Shape3(rand() % shape[0], rand() % shape[1], rand() % shape[2])] = 1;
+
+        ParallelOptions options;
+        options.numThreads(4);
+
+        {
+            IntVolume serial(shape), parallel(shape);
+            separableMultiDistSquared(mask, serial, true);
+            separableMultiDistSquared(mask, parallel, true, options);
+            shouldEqualSequence(parallel.begin(), parallel.end(), serial.begin());
+        }
+        {
+            DoubleVolume serial(shape), parallel(shape);
+            separableMultiDistance(mask, serial, false, pixelPitch);
+            separableMultiDistance(mask, parallel, false, pixelPitch, options);
+            shouldEqualSequenceTolerance(parallel.begin(), parallel.end(), serial.begin(), 1e-14);
+        }
+        {
+            DoubleVecVolume serial(shape), parallel(shape);
+            separableVectorDistance(mask, serial, true, pixelPitch);
+            separableVectorDistance(mask, parallel, true, pixelPitch, options);
+            shouldEqualSequence(parallel.begin(), parallel.end(), serial.begin());
+        }
+        {
+            // chunk shape doesn't divide the array shape
+            ChunkedArrayLazy<3, UInt8> chunked_mask(shape, Shape3(8));
+            chunked_mask.commitSubarray(Shape3(0), mask);
+            ChunkedArrayLazy<3, float> chunked_dist(shape, Shape3(8));
+
+            DoubleVolume serial(shape);
+            MultiArray<3, float> result(shape);
+
+            separableMultiDistSquared(mask, serial, true, pixelPitch);
+            separableMultiDistSquared(chunked_mask, chunked_dist, true, pixelPitch, options);
+            chunked_dist.checkoutSubarray(Shape3(0), result);
+            shouldEqualSequenceTolerance(result.begin(), result.end(), serial.begin(), 1e-4);
+
+            separableMultiDistance(mask, serial, true);
+            separableMultiDistance(chunked_mask, chunked_dist, true);
+            chunked_dist.checkoutSubarray(Shape3(0), result);
+            shouldEqualSequenceTolerance(result.begin(), result.end(), serial.begin(), 1e-5);
+        }
+    }
+
+    void testDistanceFloat()
+    {
+        Shape3 shape(31, 27, 23);
+        TinyVector<double, 3> pixelPitch(1.2, 1.0, 2.4);
+        MultiArray<3, UInt8> mask(shape);
+        for(int k=0; k<40; ++k)
+            mask[Shape3(rand() % shape[0], rand() % shape[1], rand() % shape[2])] = 1;
+
+        ParallelOptions options;
+        options.numThreads(4);
+
+        {
+            // isotropic squared distances are integers and exactly representable
+            IntVolume ref(shape);
+            MultiArray<3, float> res(shape);
+            separableMultiDistSquared(mask, ref, true);
+            separableMultiDistSquared(mask, res, true);
+            shouldEqualSequence(res.begin(), res.end(), ref.begin());
+            separableMultiDistSquared(mask, res, true, options);
+            shouldEqualSequence(res.begin(), res.end(), ref.begin());
+        }
+        {
+            // anisotropic distances are computed in place in single precision
+            DoubleVolume ref(shape);
+            MultiArray<3, float> res(shape);
+            separableMultiDistSquared(mask, ref, false, pixelPitch);
+            separableMultiDistSquared(mask, res, false, pixelPitch);
+            shouldEqualSequenceTolerance(res.begin(), res.end(), ref.begin(), 1e-3);
+            separableMultiDistance(mask, ref, false, pixelPitch);
+            separableMultiDistance(mask, res, false, pixelPitch, options);
+            shouldEqualSequenceTolerance(res.begin(), res.end(), ref.begin(), 1e-4);
+        }
+    }
 };
 
 struct BoundaryMultiDistanceTest
@@ -498,6 +583,9 @@ struct BoundaryMultiDistanceTest
         boundaryMultiDistance(vol, res, true);
         shouldEqualSequenceTolerance(res.begin(), res.end(), bndMltDstArrayBorder_ref, 1e-6);
 
+        boundaryMultiDistance(vol, res, true, InterpixelBoundary, ParallelOptions().numThreads(4));
+        shouldEqualSequenceTolerance(res.begin(), res.end(), bndMltDstArrayBorder_ref, 1e-6);
+
         
         MultiArray<2, double> res2(vol.shape());
         MultiArray<2, TinyVector<double, 2> > res_vec(vol.shape());
@@ -526,6 +614,11 @@ struct BoundaryMultiDistanceTest
         boundaryVectorDistance(vol, res_vec, true, OuterBoundary);
         res2 = norm(res_vec);
         shouldEqualSequenceTolerance(res.begin(), res.end(), res2.begin(), 1e-15);
+
+        boundaryVectorDistance(vol, res_vec, true, OuterBoundary, TinyVector<double, 2>(1.0),
+                               ParallelOptions().numThreads(4));
+        res2 = norm(res_vec);
+        shouldEqualSequenceTolerance(res.begin(), res.end(), res2.begin(), 1e-15);
             
         boundaryMultiDistance(vol, res, true, InnerBoundary);
         boundaryVectorDistance(vol, res_vec, true, InnerBoundary);
@@ -746,6 +839,29 @@ struct EccentricityTest
             shouldEqualSequenceTolerance(distances.begin(), distances.end(), eccTrafo_volume_ref, 1e-5f);
         }
     }
+
+    void testEccentricityParallel()
+    {
+        typedef Shape3 Point3;
+
+        MultiArrayView<3, unsigned int> labels(Shape3(40, 40, 40), eccTrafo_volume);
+
+        ArrayVector<Point3> centers, serialCenters, onlyCenters;
+        MultiArray<3, float> distances(labels.shape()), serialDistances(labels.shape());
+        eccentricityTransformOnLabels(labels, serialDistances, serialCenters, ParallelOptions().numThreads(0));
+        eccentricityTransformOnLabels(labels, distances, centers, ParallelOptions().numThreads(4));
+        eccentricityCenters(labels, onlyCenters, ParallelOptions().numThreads(3));
+
+        shouldEqual(centers.size(), 221);
+        shouldEqualSequence(centers.begin(), centers.end(), serialCenters.begin());
+        shouldEqualSequence(onlyCenters.begin(), onlyCenters.end(), serialCenters.begin());
+        shouldEqualSequence(distances.begin(), distances.end(), serialDistances.begin());
+        shouldEqualSequenceTolerance(distances.begin(), distances.end(), eccTrafo_volume_ref, 1e-5f);
+
+        MultiArray<3, float> noCenters(labels.shape());
+        eccentricityTransformOnLabels(labels, noCenters, ParallelOptions().numThreads(2));
+        shouldEqualSequence(noCenters.begin(), noCenters.end(), serialDistances.begin());
+    }
 };
 
 
@@ -848,6 +964,134 @@ struct SkeletonTest
             shouldEqual(features[label].terminal2, Shape2(378, 34));
         }
     }
+
+    // number of 26-neighbors of each skeleton voxel, -1 for background
+    static MultiArray<3, int> skeletonNeighborCount(MultiArray<3, UInt32> const & skel)
+    {
+        MultiArray<3, int> count(skel.shape(), -1);
+        GridGraph<3> g(skel.shape(), IndirectNeighborhood);
+        for(GridGraph<3>::NodeIt n(g); n != lemon::INVALID; ++n)
+        {
+            if(skel[*n] == 0)
+                continue;
+            count[*n] = 0;
+            for(GridGraph<3>::OutArcIt a(g, *n); a != lemon::INVALID; ++a)
+                if(skel[g.target(*a)] == skel[*n])
+                    ++count[*n];
+        }
+        return count;
+    }
+
+    void testSkeletonVolume()
+    {
+        Shape3 shape(60, 40, 30);
+        MultiArray<3, UInt32> data(shape);
+
+        // label 1: a bar along the x-axis with a bump
+        data.subarray(Shape3(5, 5, 5), Shape3(50, 15, 15)) = 1;
+        data.subarray(Shape3(25, 15, 8), Shape3(29, 18, 12)) = 1;
+        // label 2: a torus
+        Shape3 center(30, 28, 22);
+        for(MultiCoordinateIterator<3> p(shape), end = p.getEndIterator(); p != end; ++p)
+        {
+            TinyVector<double, 3> d = *p - center;
+            double r = std::sqrt(sq(d[0]) + sq(d[1]));
+            if(sq(r - 9.0) + sq(d[2]) <= sq(3.5))
+                data[*p] = 2;
+        }
+
+        MultiArray<3, UInt32> skel(shape), pruned(shape), relative(shape), parallel(shape);
+
+        skeletonizeVolume(data, skel, SkeletonOptions().dontPrune());
+        skeletonizeVolume(data, pruned, SkeletonOptions().pruneLength(1000.0));
+
+        MultiArray<3, int> skelCount = skeletonNeighborCount(skel),
+                           prunedCount = skeletonNeighborCount(pruned);
+        int endPoints[3] = { 0, 0, 0 };
+        for(MultiArrayIndex k = 0; k < skel.size(); ++k)
+        {
+            // skeleton voxels lie inside the region with the same label
+            if(skel[k] != 0)
+                shouldEqual(skel[k], data[k]);
+            // pruning only deletes voxels
+            if(pruned[k] != 0)
+                shouldEqual(pruned[k], skel[k]);
+            if(prunedCount[k] == 1)
+                ++endPoints[pruned[k]];
+            // no isolated points
+            should(skelCount[k] != 0 && prunedCount[k] != 0);
+        }
+
+        // the skeleton is thin: no 2x2x2 block is completely filled
+        for(MultiCoordinateIterator<3> p(shape - Shape3(1)), end = p.getEndIterator(); p != end; ++p)
+        {
+            should(!skel.subarray(*p, *p + Shape3(2)).all());
+        }
+
+        // each skeleton is 26-connected (i.e. topology of the regions is preserved)
+        MultiArray<3, UInt32> components(shape);
+        shouldEqual(labelMultiArrayWithBackground(skel, components, IndirectNeighborhood), 2);
+        shouldEqual(labelMultiArrayWithBackground(pruned, components, IndirectNeighborhood), 2);
+
+        // after exhaustive pruning, the bar is reduced to a simple curve along its axis,
+        // and the torus to a closed loop
+        shouldEqual(endPoints[1], 2);
+        shouldEqual(endPoints[2], 0);
+        Shape3 first(shape), last(0);
+        for(MultiCoordinateIterator<3> p(shape), end = p.getEndIterator(); p != end; ++p)
+        {
+            if(pruned[*p] != 1)
+                continue;
+            first = min(first, *p);
+            last = max(last, *p);
+        }
+        should(last[0] - first[0] >= 30);
+        for(MultiArrayIndex x = 15; x < 40; ++x)
+        {
+            // away from the bar's ends, the curve runs along the axis
+            MultiArrayView<2, UInt32, StridedArrayTag> slice =
+                pruned.bindInner(x).subarray(Shape2(5, 5), Shape2(15, 15));
+            int count = 0;
+            for(MultiCoordinateIterator<2> p(slice.shape()), end = p.getEndIterator(); p != end; ++p)
+            {
+                if(slice[*p] == 0)
+                    continue;
+                ++count;
+                should(std::abs(2*(*p)[0] - 9) <= 3 && std::abs(2*(*p)[1] - 9) <= 3);
+            }
+            should(count >= 1 && count <= 2);
+        }
+        should(pruned[Shape3(30, 19, 22)] == 2 && pruned[Shape3(39, 28, 22)] == 2);
+
+        // relative pruning removes spurs, but keeps the main branches
+        skeletonizeVolume(data, relative, SkeletonOptions().pruneLengthRelative(0.5));
+        int remaining = 0;
+        for(MultiArrayIndex k = 0; k < skel.size(); ++k)
+        {
+            if(relative[k] != 0)
+                shouldEqual(relative[k], skel[k]);
+            if(relative[k] == 1)
+                ++remaining;
+        }
+        should(remaining >= last[0] - first[0] + 1);
+
+        // results are independent of the number of threads
+        skeletonizeVolume(data, pruned, SkeletonOptions());
+        skeletonizeVolume(data, parallel, SkeletonOptions().numThreads(4));
+        should(pruned == parallel);
+
+        try
+        {
+            skeletonizeVolume(data, skel, SkeletonOptions().pruneCenterLine());
+            failTest("skeletonizeVolume() failed to throw exception.");
+        }
+        catch(PreconditionViolation & e)
+        {
+            std::string expected("\nPrecondition violation!\nskeletonizeVolume(): pruning mode not supported in 3D."),
+                        actual(e.what());
+            shouldEqual(actual.substr(0, expected.size()), expected);
+        }
+    }
 };
 
 
@@ -863,12 +1107,16 @@ struct DistanceTransformTestSuite
         add( testCase( &MultiDistanceTest::testDistanceVolumesAnisotropic));
         add( testCase( &MultiDistanceTest::distanceTransform2DCompare));
         add( testCase( &MultiDistanceTest::distanceTest1D));
+        add( testCase( &MultiDistanceTest::testDistanceParallel));
+        add( testCase( &MultiDistanceTest::testDistanceFloat));
         add( testCase( &BoundaryMultiDistanceTest::distanceTest1D));
         add( testCase( &BoundaryMultiDistanceTest::testDistanceVolumes));
         add( testCase( &BoundaryMultiDistanceTest::vectorDistanceTest1D));
         add( testCase( &EccentricityTest::testEccentricityCenters));
+        add( testCase( &EccentricityTest::testEccentricityParallel));
         add( testCase( &SkeletonTest::testSkeleton));
         add( testCase( &SkeletonTest::testSkeletonFeatures));
+        add( testCase( &SkeletonTest::testSkeletonVolume));
     }
 };
 
@@ -41,6 +41,7 @@
 #include <vigra/unittest.hxx>
 #include <vigra/multi_array.hxx>
 #include <vigra/accumulator.hxx>
+#include <vigra/region_contours.hxx>
 
 namespace std {
 
@@ -1490,6 +1491,96 @@ struct AccumulatorTest
             shouldEqual(W(3, 0, 1), get<AutoRangeHistogram<3> >(c,3));
         }
     }
+
+    void testRegionContours()
+    {
+        using namespace vigra::acc;
+
+        typedef Polygon<TinyVector<double, 2> > Contour;
+
+        MultiArray<2, int> labels(Shape2(60, 40));
+        // label 1: rectangle, label 2: L-shape, label 3: two components,
+        // labels 4..: many small squares, label 0: background
+        labels.subarray(Shape2(2, 2), Shape2(12, 8)) = 1;
+        labels.subarray(Shape2(20, 2), Shape2(24, 20)) = 2;
+        labels.subarray(Shape2(20, 16), Shape2(40, 20)) = 2;
+        labels.subarray(Shape2(45, 2), Shape2(50, 6)) = 3;
+        labels.subarray(Shape2(52, 30), Shape2(60, 40)) = 3;
+        int label = 4;
+        for(int y = 24; y < 38; y += 3)
+            for(int x = 1 + y % 2; x < 48; x += 3, ++label)
+                labels.subarray(Shape2(x, y), Shape2(x+2, y+1+(x%2))) = label;
+        // a ragged region with diagonal connections
+        for(int y = 8; y < 22; ++y)
+            for(int x = 50; x < 60; ++x)
+                if((x*7 + y*y*3) % 5 < 3)
+                    labels(x, y) = label;
+        int maxLabel = label;
+
+        // reference: contours and hulls computed one region at a time during extractFeatures()
+        typedef AccumulatorChainArray<CoupledArrays<2, int>,
+                                      Select<LabelArg<1>, Count, RegionPerimeter,
+                                             RegionCircularity, RegionConvexHull, RegionConvexity> > A;
+        A reference;
+        reference.ignoreLabel(0);
+        extractFeatures(labels, reference);
+        shouldEqual(reference.maxRegionLabel(), maxLabel);
+
+        ArrayVector<Contour> contours, hulls;
+        extractRegionContours(labels, contours, hulls, ParallelOptions().numThreads(4));
+        shouldEqual((int)contours.size(), maxLabel + 1);
+        shouldEqual((int)hulls.size(), maxLabel + 1);
+        for(int k = 1; k <= maxLabel; ++k)
+        {
+            should(contours[k] == get<RegionContour>(reference, k));
+            should(hulls[k] == get<RegionConvexHull>(reference, k));
+            Contour hull;
+            convexHull(contours[k], hull);
+            should(hulls[k] == hull);
+        }
+        should(contours[0].size() > 0);
+
+        extractRegionContours(labels, contours);
+        for(int k = 1; k <= maxLabel; ++k)
+            should(contours[k] == get<RegionContour>(reference, k));
+
+        shouldEqualTolerance(get<RegionConvexity>(reference, 1), 1.0, 1e-15);
+        should(get<RegionConvexity>(reference, 2) > 0.5 && get<RegionConvexity>(reference, 2) < 0.6);
+        shouldEqual(get<RegionConvexHull>(reference, 1).size(), 9); // octagon with cut corners
+
+        // batched computation within the accumulator chain
+        for(int threads = 0; threads <= 4; threads += 4)
+        {
+            A a;
+            a.ignoreLabel(0);
+            extractRegionContourFeatures(labels, a, ParallelOptions().numThreads(threads));
+            shouldEqual(a.maxRegionLabel(), maxLabel);
+            shouldEqual(get<RegionContour>(a, 0).size(), 0);
+            should(get<RegionContour>(a, 1) == get<RegionContour>(reference, 1));
+
+            extractFeatures(labels, a);
+            shouldEqual(a.maxRegionLabel(), maxLabel);
+            for(int k = 1; k <= maxLabel; ++k)
+            {
+                shouldEqual(get<Count>(a, k), get<Count>(reference, k));
+                should(get<RegionContour>(a, k) == get<RegionContour>(reference, k));
+                should(get<RegionConvexHull>(a, k) == get<RegionConvexHull>(reference, k));
+                shouldEqual(get<RegionPerimeter>(a, k), get<RegionPerimeter>(reference, k));
+                shouldEqual(get<RegionCircularity>(a, k), get<RegionCircularity>(reference, k));
+                shouldEqual(get<RegionConvexity>(a, k), get<RegionConvexity>(reference, k));
+            }
+        }
+
+        // chains without RegionConvexHull only receive the contours
+        {
+            AccumulatorChainArray<CoupledArrays<2, int>,
+                                  Select<LabelArg<1>, RegionPerimeter> > a;
+            extractRegionContourFeatures(labels, a);
+            extractFeatures(labels, a);
+            for(int k = 0; k <= maxLabel; ++k)
+                shouldEqual(get<RegionPerimeter>(a, k), contours[k].length());
+        }
+    }
 };
 
 struct FeaturesTestSuite : public vigra::test_suite
@@ -1506,6 +1597,7 @@ struct FeaturesTestSuite : public vigra::test_suite
         add(testCase(&AccumulatorTest::testHistogram));
         add(testCase(&AccumulatorTest::testRegionAccumulators));
         add(testCase(&AccumulatorTest::testIndexSpecifiers));
+        add(testCase(&AccumulatorTest::testRegionContours));
     }
 };
 
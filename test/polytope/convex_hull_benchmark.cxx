@@ -40,6 +40,7 @@
 #include <vigra/multi_array.hxx>
 #include <vigra/polytope.hxx>
 #include <vigra/accumulator.hxx>
+#include <vigra/region_contours.hxx>
 
 namespace chrono = std::chrono;
 
@@ -189,6 +190,92 @@ struct ConvexHullBenchmark
     }
 };
 
+struct RegionConvexHullBenchmark
+{
+
+    typedef chrono::steady_clock   clock_type;
+
+    typedef AccumulatorChainArray<
+            CoupledArrays<2, UInt32>,
+            Select<LabelArg<1>, Count, RegionPerimeter, RegionConvexHull, RegionConvexity> >
+        chain_type;
+
+    void testBatched()
+    {
+        std::cout << "# Benchmark for contours and convex hulls of many labelled 2D regions. ";
+        std::cout << "All time measures in ms." << std::endl;
+        std::cout << "# regions, per region, batched (1 thread), batched (all threads), "
+                  << "extractRegionContours (all threads)" << std::endl;
+        for (int size = 256; size <= 4096; size *= 2)
+        {
+            MultiArray<2, UInt32> labels = createLabels(size, 8);
+
+            chain_type reference;
+            reference.ignoreLabel(0);
+            clock_type::time_point start = clock_type::now();
+            extractFeatures(labels, reference);
+            double time_per_region = elapsed(start);
+
+            chain_type serial;
+            serial.ignoreLabel(0);
+            start = clock_type::now();
+            extractRegionContourFeatures(labels, serial, ParallelOptions().numThreads(ParallelOptions::NoThreads));
+            extractFeatures(labels, serial);
+            double time_serial = elapsed(start);
+
+            chain_type parallel;
+            parallel.ignoreLabel(0);
+            start = clock_type::now();
+            extractRegionContourFeatures(labels, parallel, ParallelOptions());
+            extractFeatures(labels, parallel);
+            double time_parallel = elapsed(start);
+
+            ArrayVector<Polygon<TinyVector<double, 2> > > contours, hulls;
+            start = clock_type::now();
+            extractRegionContours(labels, contours, hulls, ParallelOptions());
+            double time_polygons = elapsed(start);
+
+            for (MultiArrayIndex k = 1; k <= reference.maxRegionLabel(); k++)
+            {
+                shouldEqual(get<RegionConvexity>(parallel, k), get<RegionConvexity>(reference, k));
+                shouldEqual(get<RegionPerimeter>(serial, k), get<RegionPerimeter>(reference, k));
+                should(hulls[k] == get<RegionConvexHull>(reference, k));
+            }
+
+            std::cout
+                    << reference.maxRegionLabel() << ", "
+                    << time_per_region << ", "
+                    << time_serial << ", "
+                    << time_parallel << ", "
+                    << time_polygons << std::endl;
+        }
+    }
+
+    // One random blob per cell of size 'spacing' x 'spacing': a rectangle
+    // with a notch, such that most regions are not convex.
+    MultiArray<2, UInt32> createLabels(int size, int spacing) const
+    {
+        MultiArray<2, UInt32> labels(Shape2(size, size));
+        UInt32 label = 0;
+        for (int y = 0; y + spacing <= size; y += spacing)
+        {
+            for (int x = 0; x + spacing <= size; x += spacing)
+            {
+                Shape2 begin(x + 1 + rand() % 2, y + 1 + rand() % 2),
+                       end(x + spacing - rand() % 2, y + spacing - rand() % 2);
+                labels.subarray(begin, end) = ++label;
+                labels(begin[0] + rand() % (end[0] - begin[0]), begin[1]) = 0;
+            }
+        }
+        return labels;
+    }
+
+    double elapsed(clock_type::time_point start) const
+    {
+        return chrono::duration_cast<chrono::microseconds>(clock_type::now() - start).count() / 1000.0;
+    }
+};
+
 struct ConvexHullBenchmarkSuite : public test_suite
 {
     ConvexHullBenchmarkSuite()
@@ -200,6 +287,7 @@ struct ConvexHullBenchmarkSuite : public test_suite
         add(testCase(&ConvexHullBenchmark::testWorst<2>));
         add(testCase(&ConvexHullBenchmark::testWorst<3>));
         add(testCase(&ConvexHullBenchmark::testWorst<4>));
+        add(testCase(&RegionConvexHullBenchmark::testBatched));
     }
 };
 
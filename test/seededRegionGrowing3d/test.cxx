@@ -287,6 +287,83 @@ struct SeededRegionGrowing3DTest
         shouldEqualSequence(res.begin(), res.end(), vol3.begin());
     }
     
+    void multiArrayTest()
+    {
+        // must agree with seededRegionGrowing3D() on the test volumes
+        {
+            DoubleVolume res(vol2), ref(vol2);
+            vigra::ArrayOfRegionStatistics<DirectCostFunctor> cost(2);
+            seededRegionGrowing3D(distvol2, vol2, ref, cost, CompleteGrow);
+            seededRegionGrowingMultiArray(distvol2, vol2, res, cost);
+            shouldEqualSequence(res.begin(), res.end(), ref.begin());
+        }
+        {
+            IntVolume res(vol1.shape()), ref(vol1.shape());
+            vigra::ArrayOfRegionStatistics<DirectCostFunctor> cost(2);
+            seededRegionGrowing3D(srcMultiArrayRange(distvol1), srcMultiArray(vol1),
+                                  destMultiArray(ref), cost, KeepContours);
+            seededRegionGrowingMultiArray(distvol1, vol1, res, cost, KeepContours);
+            shouldEqualSequence(res.begin(), res.end(), ref.begin());
+        }
+        {
+            // seeds and labels may be the same array
+            IntVolume res(vol3);
+            vigra::ArrayOfRegionStatistics<DirectCostFunctor> cost(4);
+            seededRegionGrowingMultiArray(vol3, res, res, cost, CompleteGrow, IndirectNeighborhood);
+            shouldEqualSequence(res.begin(), res.end(), vol3.begin());
+        }
+        {
+            // threshold
+            IntVolume res(vol1.shape());
+            vigra::ArrayOfRegionStatistics<DirectCostFunctor> cost(2);
+            seededRegionGrowingMultiArray(distvol1, vol1, res, cost, StopAtThreshold,
+                                          DirectNeighborhood, 1.0);
+            for(int z=0; z<5; ++z)
+                for(int y=0; y<5; ++y)
+                    for(int x=0; x<5; ++x)
+                    {
+                        int desired = distvol1(x,y,z) > 1.0
+                                          ? 0
+                                          : z < 2 ? 1 : 2;
+                        shouldEqual(res(x,y,z), desired);
+                    }
+        }
+    }
+
+    void bucketQueueTest()
+    {
+        // 8-bit costs use the bucket queue, which must give the same result as the heap
+        typedef vigra::MultiArray<3, vigra::UInt8> ByteVolume;
+        vigra::Shape3 shape(30, 25, 20);
+        ByteVolume data(shape);
+        IntVolume seeds(shape), res8(shape), res32(shape);
+        vigra::MultiArray<3, int> data32(shape);
+        for(int k=0; k<data.size(); ++k)
+        {
+            data[k] = (vigra::UInt8)((k*37) % 11 + (k / 1000) % 7);
+            data32[k] = data[k];
+        }
+        seeds(3,4,5) = 1;
+        seeds(20,20,10) = 2;
+        seeds(25,3,17) = 3;
+        seeds(10,15,18) = 4;
+
+        for(int neighborhood=0; neighborhood<2; ++neighborhood)
+        {
+            vigra::ArrayOfRegionStatistics<vigra::SeedRgDirectValueFunctor<vigra::UInt8> > stats8(4);
+            vigra::ArrayOfRegionStatistics<vigra::SeedRgDirectValueFunctor<int> > stats32(4);
+            seededRegionGrowingMultiArray(data, seeds, res8, stats8,
+                                          CompleteGrow, (vigra::NeighborhoodType)neighborhood);
+            seededRegionGrowingMultiArray(data32, seeds, res32, stats32,
+                                          CompleteGrow, (vigra::NeighborhoodType)neighborhood);
+            shouldEqualSequence(res8.begin(), res8.end(), res32.begin());
+            int minLabel, maxLabel;
+            res8.minmax(&minLabel, &maxLabel);
+            shouldEqual(minLabel, 1);
+            shouldEqual(maxLabel, 4);
+        }
+    }
+
     IntVolume    vol1;
     DoubleVolume vol2;
     IntVolume    vol3;
@@ -305,6 +382,8 @@ struct SeededRegionGrowing3DTestSuite
         add( testCase( &SeededRegionGrowing3DTest::voronoiTest));
         add( testCase( &SeededRegionGrowing3DTest::voronoiTestWithBorder));
         add( testCase( &SeededRegionGrowing3DTest::simpleTest));
+        add( testCase( &SeededRegionGrowing3DTest::multiArrayTest));
+        add( testCase( &SeededRegionGrowing3DTest::bucketQueueTest));
     }
 };
 
@@ -53,6 +53,7 @@
 #include "vigra/affinegeometry.hxx"
 #include "vigra/affine_registration.hxx"
 #include "vigra/impex.hxx"
+#include "vigra/random.hxx"
 
 #ifdef HasFFTW3
 # include "vigra/slanted_edge_mtf.hxx"
@@ -1507,6 +1508,63 @@ struct LocalMinMaxTest
         shouldEqualSequence(res.begin(), res.end(), desired);
     }
 
+    void parallelLocalMinMaxTest()
+    {
+        // quantized random data contain many plateaus
+        typedef GridGraph<3, undirected_tag> Graph;
+        MultiArray<3, int> data(Shape3(31, 20, 17));
+        MersenneTwister random;
+        for(MultiArray<3, int>::iterator i = data.begin(); i != data.end(); ++i)
+            *i = random.uniformInt(6);
+
+        for(int k = 0; k < 16; ++k)
+        {
+            const bool indirect = (k & 1) != 0, atBorder = (k & 2) != 0, 
+                       plateaus = (k & 4) != 0, thresholded = (k & 8) != 0;
+            LocalMinmaxOptions options = LocalMinmaxOptions().neighborhood(indirect ? 1 : 0)
+                                             .allowAtBorder(atBorder).allowPlateaus(plateaus).markWith(2);
+            if(thresholded)
+                options.threshold(3);
+
+            // the sequential graph algorithms serve as reference
+            Graph graph(data.shape(), indirect ? IndirectNeighborhood : DirectNeighborhood);
+            MultiArray<3, UInt8> minima(data.shape()), maxima(data.shape());
+            unsigned int minimaCount, maximaCount;
+            if(plateaus)
+            {
+                minimaCount = lemon_graph::extendedLocalMinMaxGraph(graph, data, minima, UInt8(2), thresholded ? 3 : NumericTraits<int>::max(),
+                                                                    std::less<int>(), std::equal_to<int>(), atBorder);
+                maximaCount = lemon_graph::extendedLocalMinMaxGraph(graph, data, maxima, UInt8(2), thresholded ? 3 : NumericTraits<int>::min(),
+                                                                    std::greater<int>(), std::equal_to<int>(), atBorder);
+            }
+            else
+            {
+                minimaCount = lemon_graph::localMinMaxGraph(graph, data, minima, UInt8(2), thresholded ? 3 : NumericTraits<int>::max(),
+                                                            std::less<int>(), atBorder);
+                maximaCount = lemon_graph::localMinMaxGraph(graph, data, maxima, UInt8(2), thresholded ? 3 : NumericTraits<int>::min(),
+                                                            std::greater<int>(), atBorder);
+            }
+            should(minimaCount > 0 && maximaCount > 0);
+
+            for(int threads = 0; threads <= 4; threads += 4)
+            {
+                options.numThreads(threads);
+                MultiArray<3, UInt8> res(data.shape());
+                shouldEqual(localMinima(data, res, options), minimaCount);
+                should(res == minima);
+
+                res.init(0);
+                shouldEqual(localMaxima(data, res, options), maximaCount);
+                should(res == maxima);
+
+                // strided views
+                res.init(0);
+                shouldEqual(localMinima(data.transpose(), res.transpose(), options), minimaCount);
+                should(res == minima);
+            }
+        }
+    }
+
     Image img;
     Volume vol;
 };
@@ -2486,6 +2544,7 @@ struct SimpleAnalysisTestSuite
         add( testCase( &LocalMinMaxTest::localMinimum3DTest));
 
         add( testCase( &LocalMinMaxTest::plateauWithHolesTest));
+        add( testCase( &LocalMinMaxTest::parallelLocalMinMaxTest));
         add( testCase( &WatershedsTest::watershedsTest));
         add( testCase( &WatershedsTest::watersheds4Test));
         add( testCase( &RegionGrowingTest::voronoiTest));
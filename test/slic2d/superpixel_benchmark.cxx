@@ -0,0 +1,175 @@
+/************************************************************************/
+/*                                                                      */
+/*                Copyright 2026 by the VIGRA developers                */
+/*                                                                      */
+/*    This file is part of the VIGRA computer vision library.           */
+/*    The VIGRA Website is                                              */
+/*        http://hci.iwr.uni-heidelberg.de/vigra/                       */
+/*    Please direct questions, bug reports, and contributions to        */
+/*        ullrich.koethe@iwr.uni-heidelberg.de    or                    */
+/*        vigra@informatik.uni-hamburg.de                               */
+/*                                                                      */
+/*    Permission is hereby granted, free of charge, to any person       */
+/*    obtaining a copy of this software and associated documentation    */
+/*    files (the "Software"), to deal in the Software without           */
+/*    restriction, including without limitation the rights to use,      */
+/*    copy, modify, merge, publish, distribute, sublicense, and/or      */
+/*    sell copies of the Software, and to permit persons to whom the    */
+/*    Software is furnished to do so, subject to the following          */
+/*    conditions:                                                       */
+/*                                                                      */
+/*    The above copyright notice and this permission notice shall be    */
+/*    included in all copies or substantial portions of the             */
+/*    Software.                                                         */
+/*                                                                      */
+/*    THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND    */
+/*    EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES   */
+/*    OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND          */
+/*    NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT       */
+/*    HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY,      */
+/*    WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING      */
+/*    FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR     */
+/*    OTHER DEALINGS IN THE SOFTWARE.                                   */
+/*                                                                      */
+/************************************************************************/
+
+
+
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+
+#include <vigra/unittest.hxx>
+#include <vigra/multi_array.hxx>
+#include <vigra/multi_convolution.hxx>
+#include <vigra/multi_watersheds.hxx>
+#include <vigra/slic.hxx>
+#include <vigra/random.hxx>
+
+namespace chrono = std::chrono;
+
+namespace vigra
+{
+
+    // Compares the superpixels of slicSuperpixels() with compact watersheds
+    // on the same smoothed random image, using the same seed distance. 
+    // The default size is 2048^2; pass a different edge length as the 
+    // environment variable VIGRA_BENCHMARK_SIZE.
+struct SuperpixelBenchmark
+{
+    typedef chrono::steady_clock  clock_type;
+
+    int size, seedDistance;
+    MultiArray<2, float> image, gradient;
+
+    SuperpixelBenchmark()
+    : size(2048),
+      seedDistance(16)
+    {
+        if(std::getenv("VIGRA_BENCHMARK_SIZE"))
+            size = std::atoi(std::getenv("VIGRA_BENCHMARK_SIZE"));
+        MultiArray<2, float> noise(Shape2(size, size));
+        RandomMT19937 random(42);
+        for(auto i = noise.begin(); i != noise.end(); ++i)
+            *i = 255.0f * random.uniform();
+        image.reshape(noise.shape());
+        gradient.reshape(noise.shape());
+        gaussianSmoothMultiArray(noise, image, 3.0);
+        gaussianGradientMagnitude(image, gradient, 1.0);
+    }
+
+    static double seconds(clock_type::time_point start)
+    {
+        return chrono::duration_cast<chrono::milliseconds>(clock_type::now() - start).count() / 1000.0;
+    }
+
+        // one seed at the center of each grid cell, as in SLIC
+    MultiArrayIndex gridSeeds(MultiArray<2, UInt32> & labels) const
+    {
+        labels.init(0);
+        UInt32 label = 0;
+        for(int y = seedDistance / 2; y < size; y += seedDistance)
+            for(int x = seedDistance / 2; x < size; x += seedDistance)
+                labels(x, y) = ++label;
+        return label;
+    }
+
+    void testSlic()
+    {
+        MultiArray<2, UInt32> labels(image.shape());
+        for(int threads = 0; threads <= 4; threads += 4)
+        {
+            labels.init(0);
+            clock_type::time_point start = clock_type::now();
+            UInt32 count = slicSuperpixels(image, labels, 10.0, seedDistance, 
+                                           SlicOptions().iterations(10).numThreads(threads));
+            std::cout << "SLIC (10 iterations, " << threads << " threads): " << seconds(start) 
+                      << " s (" << count << " regions)" << std::endl;
+        }
+    }
+
+    void testCompactWatersheds()
+    {
+        MultiArray<2, UInt32> labels(image.shape());
+        const char * names[] = { "compact watersheds (heap):     ",
+                                 "compact watersheds (radix):    ",
+                                 "compact watersheds (quantized):" };
+        WatershedOptions options[] = { WatershedOptions().compactness(1.0 / seedDistance),
+                                       WatershedOptions().compactness(1.0 / seedDistance).radixQueue(),
+                                       WatershedOptions().compactness(1.0 / seedDistance).quantizedQueue(4096) };
+        for(int o = 0; o < 3; ++o)
+        {
+            gridSeeds(labels);
+            clock_type::time_point start = clock_type::now();
+            UInt32 count = watershedsMultiArray(gradient, labels, DirectNeighborhood, options[o]);
+            std::cout << names[o] << seconds(start) << " s (" << count << " regions)" << std::endl;
+        }
+
+        gridSeeds(labels);
+        clock_type::time_point start = clock_type::now();
+        watershedsMultiArray(gradient, labels, DirectNeighborhood, 
+                             WatershedOptions().radixQueue().maxRegionSize(seedDistance*seedDistance));
+        std::cout << "size-constrained watersheds:   " << seconds(start) << " s" << std::endl;
+    }
+
+    void testParallelWatersheds()
+    {
+        // the threshold splits the image into many independent components
+        float threshold = 0.0f, m, M;
+        gradient.minmax(&m, &M);
+        threshold = m + 0.2f * (M - m);
+        MultiArray<2, UInt32> labels(image.shape());
+        for(int threads = 0; threads <= 4; threads += 4)
+        {
+            gridSeeds(labels);
+            clock_type::time_point start = clock_type::now();
+            watershedsMultiArray(gradient, labels, DirectNeighborhood, 
+                                 WatershedOptions().radixQueue().compactness(1.0 / seedDistance)
+                                                   .stopAtThreshold(threshold).numThreads(threads));
+            std::cout << "compact watersheds with threshold (" << threads << " threads): " 
+                      << seconds(start) << " s" << std::endl;
+        }
+    }
+};
+
+struct SuperpixelBenchmarkSuite : public test_suite
+{
+    SuperpixelBenchmarkSuite()
+    : test_suite("SuperpixelBenchmarkSuite")
+    {
+        add(testCase(&SuperpixelBenchmark::testSlic));
+        add(testCase(&SuperpixelBenchmark::testCompactWatersheds));
+        add(testCase(&SuperpixelBenchmark::testParallelWatersheds));
+    }
+};
+
+} // namespace vigra
+
+int main(int argc, char** argv)
+{
+    vigra::SuperpixelBenchmarkSuite benchmark;
+    const int failed = benchmark.run(vigra::testsToBeExecuted(argc, argv));
+    std::cout << benchmark.report() << std::endl;
+
+    return failed != 0;
+}
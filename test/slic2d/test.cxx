@@ -120,6 +120,47 @@ struct SlicTest
 
         should(labels == labels_ref);
     }
+
+    void test_slic_threads()
+    {
+        IArray labels(lennaImage.shape()), labels_ref(lennaImage.shape());
+
+        int seedDistance = 8;
+        int maxlabel = slicSuperpixels(lennaImage, labels, 20.0, seedDistance,
+                                       SlicOptions().minSize(0).iterations(40).numThreads(4));
+        shouldEqual(maxlabel, 245);
+        importImage(ImageImportInfo("slic.xv"), destImage(labels_ref));
+        should(labels == labels_ref);
+
+        // 3D supervoxels: the tiled parallel version must agree with the sequential one
+        MultiArray<3, float> volume(Shape3(30, 25, 20));
+        for(int k=0; k<volume.size(); ++k)
+            volume[k] = (float)((k*37) % 11);
+        MultiArray<3, unsigned int> seq(volume.shape()), par(volume.shape());
+        int seqMax = slicSuperpixels(volume, seq, 10.0, 6, SlicOptions().numThreads(0));
+        int parMax = slicSuperpixels(volume, par, 10.0, 6, SlicOptions().numThreads(4));
+        shouldEqual(seqMax, parMax);
+        should(seq == par);
+    }
+
+    void test_slic_strided()
+    {
+        // a transposed view must give the same result as a contiguous copy
+        FRGBArray transposed(lennaImage.transpose());
+        IArray labels(transposed.shape()), labels_ref(transposed.shape());
+
+        int maxlabel_ref = slicSuperpixels(transposed, labels_ref, 20.0, 8, SlicOptions().minSize(0));
+
+        int maxlabel = slicSuperpixels(lennaImage.transpose(), labels, 20.0, 8, SlicOptions().minSize(0));
+        shouldEqual(maxlabel, maxlabel_ref);
+        should(labels == labels_ref);
+
+        IArray labelsT(lennaImage.shape());
+        maxlabel = slicSuperpixels(lennaImage.transpose(), labelsT.transpose(), 20.0, 8,
+                                   SlicOptions().minSize(0).numThreads(4));
+        shouldEqual(maxlabel, maxlabel_ref);
+        should(labelsT.transpose() == labels_ref);
+    }
 };
 
 
@@ -131,6 +172,8 @@ struct Slic2dTestSuite
     {
         add( testCase( &SlicTest<2>::test_seeding));
         add( testCase( &SlicTest<2>::test_slic));
+        add( testCase( &SlicTest<2>::test_slic_threads));
+        add( testCase( &SlicTest<2>::test_slic_strided));
     }
 };
 
@@ -669,6 +669,221 @@ struct ChangeablePriorityQueueTest
 
     }
 
+    template <class QUEUE, class T>
+    void testMonotoneQueueImpl(T scale)
+    {
+        // simulate a Dijkstra-like access pattern: pushed priorities are never 
+        // smaller than the current top, and priorities of queued items change
+        const int size = 500;
+        ChangeablePriorityQueue<T> reference(size);
+        QUEUE q(size);
+        std::vector<bool> done(size, false);
+        srand(17);
+
+        T current = 0;
+        reference.push(0, current);
+        q.push(0, current);
+        int popped = 0;
+        while(!reference.empty())
+        {
+            shouldEqual(q.size(), reference.size());
+            shouldEqual(q.topPriority(), reference.topPriority());
+            current = q.topPriority();
+            const int top = q.top();
+            should(q.contains(top));
+            shouldEqual(q.priority(top), current);
+            q.pop();
+            reference.deleteItem(top);
+            should(!q.contains(top));
+            done[top] = true;
+            ++popped;
+
+            for(int k = 0; k < 4; ++k)
+            {
+                const int i = rand() % size;
+                if(done[i])
+                    continue;
+                const T p = current + static_cast<T>(rand() % 20) * scale;
+                if(reference.contains(i) && reference.priority(i) <= p)
+                    continue;
+                reference.push(i, p);
+                q.push(i, p);
+            }
+        }
+        should(q.empty());
+        should(popped > 100);
+
+        q.push(3, current);
+        q.push(4, current + 1);
+        should(q.contains(3) && q.contains(4));
+        q.clear();
+        should(q.empty());
+        should(!q.contains(3) && !q.contains(4));
+    }
+
+    void testMonotoneQueues()
+    {
+        testMonotoneQueueImpl<ChangeableBucketQueue<int> >(1);
+        testMonotoneQueueImpl<ChangeableBucketQueue<UInt32> >(1000u);
+        testMonotoneQueueImpl<ChangeableRadixHeap<UInt32> >(7u);
+        testMonotoneQueueImpl<ChangeableRadixHeap<float> >(0.37f);
+        testMonotoneQueueImpl<ChangeableRadixHeap<double> >(1e-3);
+
+        // reuse the heap after draining it: outdated entries of the
+        // first run must not come back to life
+        ChangeableRadixHeap<UInt32> q(8);
+        q.push(5, 27);
+        q.pop();
+        q.push(3, 4);
+        q.push(6, 15);
+        q.push(3, 14);
+        q.push(6, 21);
+        shouldEqual(q.top(), 3);
+        q.pop();
+        q.push(6, 21);
+        shouldEqual(q.top(), 6);
+        q.pop();
+        should(q.empty());
+
+        q.push(7, 2);
+        q.push(6, 21);
+        q.push(1, 27);
+        q.push(7, 9);
+        shouldEqual(q.size(), 3);
+        shouldEqual(q.top(), 7);
+        shouldEqual(q.topPriority(), 9u);
+        q.pop();
+        q.push(3, 14);
+        shouldEqual(q.top(), 3);
+        q.pop();
+        shouldEqual(q.top(), 6);
+        q.pop();
+        shouldEqual(q.top(), 1);
+        q.pop();
+        should(q.empty());
+
+        // -0.0 equals +0.0 and may be pushed after +0.0 has been popped
+        ChangeableRadixHeap<double> z(4);
+        z.push(0, 0.0);
+        z.push(2, 1.0);
+        z.pop();
+        z.push(1, -0.0);
+        z.push(3, 0.0);
+        shouldEqual(z.size(), 3);
+        shouldEqual(z.topPriority(), 0.0);
+        should(z.top() == 1 || z.top() == 3);
+        z.pop();
+        shouldEqual(z.topPriority(), 0.0);
+        should(z.top() == 1 || z.top() == 3);
+        z.pop();
+        shouldEqual(z.top(), 2);
+        z.pop();
+        should(z.empty());
+    }
+
+    template <class QUEUE, class T>
+    void testFifoQueueImpl(QUEUE & q, T start, T scale)
+    {
+        // monotone access pattern as in seeded region growing: elements with
+        // equal priority must be returned in insertion order
+        std::set<std::pair<T, int> > reference;
+        srand(23);
+
+        int count = 0;
+        for(int k = 0; k < 10; ++k, ++count)
+        {
+            T p = start + static_cast<T>(rand() % 5) * scale;
+            reference.insert(std::make_pair(p, count));
+            q.push(count, p);
+        }
+        while(!reference.empty())
+        {
+            shouldEqual(q.size(), reference.size());
+            shouldEqual(q.topPriority(), reference.begin()->first);
+            shouldEqual(q.top(), reference.begin()->second);
+            T current = q.topPriority();
+            q.pop();
+            reference.erase(reference.begin());
+
+            for(int k = 0; k < 3 && count < 2000; ++k, ++count)
+            {
+                T p = current + static_cast<T>(rand() % 5) * scale;
+                reference.insert(std::make_pair(p, count));
+                q.push(count, p);
+            }
+        }
+        should(q.empty());
+    }
+
+    void testFifoQueues()
+    {
+        {
+            MonotoneRadixQueue<int, int> q;
+            testFifoQueueImpl(q, -1000, 3);
+        }
+        {
+            MonotoneRadixQueue<int, UInt16> q;
+            testFifoQueueImpl(q, (UInt16)0, (UInt16)1);
+        }
+        {
+            MonotoneRadixQueue<int, float> q;
+            testFifoQueueImpl(q, -100.0f, 0.37f);
+        }
+        {
+            MonotoneRadixQueue<int, double> q;
+            testFifoQueueImpl(q, -1.0, 1e-3);
+        }
+        {
+            // exact when the integer range fits into the levels
+            HierarchicalQueue<int, int> q(8192, -10, 8000);
+            testFifoQueueImpl(q, -10, 1);
+        }
+        {
+            HierarchicalQueue<int, int> q(16384, 0, 16000);
+            testFifoQueueImpl(q, 0, 2);
+        }
+
+        // quantized priorities: elements within a level are returned in FIFO order,
+        // priorities below the current level are clamped
+        HierarchicalQueue<int, double> q(10, 0.0, 1.0);
+        q.push(0, 0.55);
+        q.push(1, 0.51);
+        q.push(2, 0.95);
+        q.push(3, 0.05);
+        shouldEqual(q.top(), 3);
+        shouldEqual(q.topPriority(), 0.05);
+        q.pop();
+        shouldEqual(q.top(), 0);
+        q.pop();
+        q.push(4, 0.0);
+        q.push(5, 0.52);
+        shouldEqual(q.size(), 4u);
+        shouldEqual(q.top(), 1);
+        q.pop();
+        shouldEqual(q.top(), 4);
+        shouldEqual(q.topPriority(), 0.0);
+        q.pop();
+        shouldEqual(q.top(), 5);
+        q.pop();
+        shouldEqual(q.top(), 2);
+        q.pop();
+        should(q.empty());
+        q.push(6, 0.2);
+        shouldEqual(q.top(), 6);
+
+        MonotoneRadixQueue<int, int> r;
+        r.push(0, 5);
+        r.push(1, 7);
+        r.pop();
+        try
+        {
+            r.push(2, 3);
+            failTest("no exception thrown");
+        }
+        catch(PreconditionViolation &)
+        {}
+    }
+
     void testMaxQueue(){
         const float tol=0.001f;
         {
@@ -1536,6 +1751,8 @@ struct UtilitiesTestSuite
         add( testCase( &BucketQueueTest::testAscendingMapped));
         add( testCase( &ChangeablePriorityQueueTest::testMinQueue));
         add( testCase( &ChangeablePriorityQueueTest::testMaxQueue));
+        add( testCase( &ChangeablePriorityQueueTest::testMonotoneQueues));
+        add( testCase( &ChangeablePriorityQueueTest::testFifoQueues));
         add( testCase( &SizedIntTest::testSizedInt));
         add( testCase( &MetaprogrammingTest::testInt));
         add( testCase( &MetaprogrammingTest::testLogic));
@@ -40,6 +40,10 @@
 
 #include "vigra/labelvolume.hxx"
 #include "vigra/multi_labeling.hxx"
+#include "vigra/multi_runlength.hxx"
+#include "vigra/incremental_segmentation.hxx"
+#include "vigra/graph_algorithms.hxx"
+#include "vigra/random.hxx"
 
 using namespace vigra;
 
@@ -457,6 +461,200 @@ struct VolumeLabelingTest
         shouldEqualSequence(res.begin(), res.end(), out6);
     }
 
+    void runLengthTest()
+    {
+        IntVolume labels(vol3.shape());
+        int max_label = labelMultiArrayWithBackground(vol3, labels, DirectNeighborhood);
+
+        RunLengthArray<3, int> rle(labels);
+        should(rle.runCount() < labels.size());
+        shouldEqual(rle.shape(), labels.shape());
+        shouldEqual(rle.maxValue(), max_label);
+
+        IntVolume expanded(labels.shape());
+        rle.copyTo(expanded);
+        shouldEqualSequence(expanded.begin(), expanded.end(), labels.begin());
+
+        for(IntVolume::iterator i = labels.begin(); i != labels.end(); ++i)
+            shouldEqual(rle[i.point()], *i);
+
+        // geometry of all regions
+        ArrayVector<RunLengthRegionGeometry<3> > regions;
+        runLengthRegionGeometry(rle, regions);
+        shouldEqual((int)regions.size(), max_label + 1);
+
+        ArrayVector<RunLengthRegionGeometry<3> > desired(max_label + 1);
+        for(IntVolume::iterator i = labels.begin(); i != labels.end(); ++i)
+        {
+            RunLengthRegionGeometry<3> & r = desired[*i];
+            r.count += 1;
+            r.coordMin = min(r.coordMin, i.point());
+            r.coordMax = max(r.coordMax, i.point());
+            r.coordSum += i.point();
+        }
+        for(int k=0; k <= max_label; ++k)
+        {
+            shouldEqual(regions[k].count, desired[k].count);
+            shouldEqual(regions[k].coordMin, desired[k].coordMin);
+            shouldEqual(regions[k].coordMax, desired[k].coordMax);
+            shouldEqualSequenceTolerance(regions[k].coordSum.begin(), regions[k].coordSum.end(),
+                                         desired[k].coordSum.begin(), 1e-12);
+        }
+
+        // region adjacency, compared with the RAG of the expanded array
+        std::vector<std::pair<Int64, Int64> > uvIds;
+        runLengthRegionAdjacency(rle, uvIds);
+
+        GridGraph<3, boost_graph::undirected_tag> graph(labels.shape(), DirectNeighborhood);
+        AdjacencyListGraph rag;
+        std::vector<Int64> affiliatedEdgeOffsets, affiliatedEdgeIds;
+        makeRegionAdjacencyGraph(graph, labels, rag, affiliatedEdgeOffsets, affiliatedEdgeIds);
+        shouldEqual((int)uvIds.size(), rag.edgeNum());
+        for(unsigned int e=0; e < uvIds.size(); ++e)
+            should(rag.findEdge(rag.nodeFromId(uvIds[e].first),
+                                rag.nodeFromId(uvIds[e].second)) != lemon::INVALID);
+
+        // merge all foreground regions
+        ArrayVector<int> mapping(max_label + 1, 1);
+        mapping[0] = 0;
+        rle.relabel(mapping);
+        shouldEqual(rle.maxValue(), 1);
+        rle.copyTo(expanded);
+        for(IntVolume::iterator i = labels.begin(), j = expanded.begin(); i != labels.end(); ++i, ++j)
+            shouldEqual(*j, mapping[*i]);
+        should(rle == (RunLengthArray<3, int>(expanded)));
+
+        runLengthRegionAdjacency(rle, uvIds);
+        shouldEqual(uvIds.size(), 1u);
+        shouldEqual(uvIds[0], std::make_pair(Int64(0), Int64(1)));
+
+        // many short runs: blocks of 4^3 voxels, each holding two random labels
+        IntVolume blocks(IntVolume::difference_type(21, 13, 10));
+        RandomMT19937 random(42);
+        for(IntVolume::iterator i = blocks.begin(); i != blocks.end(); ++i)
+        {
+            IntVolume::difference_type b = i.point() / 4;
+            *i = 2*(b[0] + 6*b[1] + 24*b[2]) + random.uniformInt(2);
+        }
+        runLengthRegionAdjacency(RunLengthArray<3, int>(blocks), uvIds);
+        GridGraph<3, boost_graph::undirected_tag> blockGraph(blocks.shape(), DirectNeighborhood);
+        makeRegionAdjacencyGraph(blockGraph, blocks, rag, affiliatedEdgeOffsets, affiliatedEdgeIds);
+        shouldEqual((int)uvIds.size(), rag.edgeNum());
+        for(unsigned int e=0; e < uvIds.size(); ++e)
+            should(rag.findEdge(rag.nodeFromId(uvIds[e].first),
+                                rag.nodeFromId(uvIds[e].second)) != lemon::INVALID);
+    }
+
+    void labelingStridedTest()
+    {
+        // interior nodes are labeled via linear offsets, check with strided views
+        typedef MultiArray<3, UInt8> ClassVolume;
+        typedef MultiArray<3, UInt32> LabelVolume;
+        ClassVolume classes(Shape3(34, 26, 22));
+        for(ClassVolume::iterator i = classes.begin(); i != classes.end(); ++i)
+            *i = (UInt8)((i.point()[0]*7 + i.point()[1]*11 + i.point()[2]*13 + i.point()[0]*i.point()[1]) % 5 < 2);
+        MultiArrayView<3, UInt8, StridedArrayTag> stridedClasses = classes.stridearray(Shape3(2, 1, 2));
+        ClassVolume contiguousClasses(stridedClasses);
+        LabelVolume labels(classes.shape()), reference(contiguousClasses.shape());
+        MultiArrayView<3, UInt32, StridedArrayTag> stridedLabels = labels.stridearray(Shape3(2, 1, 2));
+
+        unsigned int count = labelVolume(contiguousClasses, reference, NeighborCode3DTwentySix());
+        shouldEqual(labelMultiArray(stridedClasses, stridedLabels, IndirectNeighborhood), count);
+        shouldEqualSequence(reference.begin(), reference.end(), stridedLabels.begin());
+
+        count = labelVolumeSix(contiguousClasses, reference);
+        shouldEqual(labelMultiArray(stridedClasses, stridedLabels, DirectNeighborhood), count);
+        shouldEqualSequence(reference.begin(), reference.end(), stridedLabels.begin());
+
+        count = labelVolumeWithBackground(contiguousClasses, reference, NeighborCode3DTwentySix(), 0);
+        shouldEqual(labelMultiArrayWithBackground(stridedClasses, stridedLabels, IndirectNeighborhood), count);
+        shouldEqualSequence(reference.begin(), reference.end(), stridedLabels.begin());
+    }
+
+    void labelingIncrementalTest()
+    {
+        typedef MultiArray<3, UInt8> ClassVolume;
+        typedef MultiArray<3, UInt32> LabelVolume;
+        typedef GridGraph<3, undirected_tag> Graph;
+
+        Shape3 shape(30, 25, 20);
+        Shape3 roiBegin[] = { Shape3(5, 5, 5), Shape3(0, 0, 0), Shape3(27, 20, 18), Shape3(10, 3, 12) },
+               roiEnd[]   = { Shape3(9, 8, 7), Shape3(3, 25, 2), Shape3(30, 25, 20), Shape3(11, 4, 13) };
+
+        for(int k = 0; k < 4; ++k)
+        {
+            NeighborhoodType neighborhood = (k & 1) ? IndirectNeighborhood : DirectNeighborhood;
+            LabelOptions options;
+            options.neighborhood(neighborhood);
+            Int64 ignoreLabel = -1;
+            if(k & 2)
+            {
+                options.ignoreBackgroundValue(UInt8(0));
+                ignoreLabel = 0;
+            }
+
+            RandomMT19937 random(k);
+            ClassVolume classes(shape);
+            for(auto & v : classes)
+                v = (UInt8)random.uniformInt(3);
+            Graph graph(shape, neighborhood);
+            LabelVolume labels(shape), reference(shape);
+            UInt32 maxLabel = labelMultiArray(classes, labels, options);
+            AdjacencyListGraph rag;
+            std::vector<Int64> offsets, ids;
+            makeRegionAdjacencyGraph(graph, labels, rag, offsets, ids, ignoreLabel);
+
+            for(int r = 0; r < 4; ++r)
+            {
+                // the labels occurring in the box and at its border are affected
+                LabelVolume before(labels);
+                std::vector<bool> affected(maxLabel + 1, false);
+                for(auto i = createCoupledIterator(labels); i != i.getEndIterator(); ++i)
+                    if(allLessEqual(roiBegin[r] - Shape3(1), i.point()) && allLess(i.point(), roiEnd[r] + Shape3(1)))
+                        affected[get<1>(*i)] = true;
+
+                MultiArrayView<3, UInt8> roi = classes.subarray(roiBegin[r], roiEnd[r]);
+                for(auto & v : roi)
+                    v = (UInt8)random.uniformInt(3);
+                maxLabel = labelMultiArrayIncremental(classes, labels, roiBegin[r], roiEnd[r], 
+                                                      maxLabel, rag, options, ignoreLabel);
+
+                // same components as a complete labeling, with the unaffected labels preserved
+                labelMultiArray(classes, reference, options);
+                std::map<UInt32, UInt32> forward, backward;
+                for(auto i = createCoupledIterator(labels, reference, before); i != i.getEndIterator(); ++i)
+                {
+                    UInt32 l = get<1>(*i), ref = get<2>(*i), old = get<3>(*i);
+                    should(l <= maxLabel);
+                    should((l == 0) == (ref == 0));
+                    should(forward.insert(std::make_pair(l, ref)).first->second == ref);
+                    should(backward.insert(std::make_pair(ref, l)).first->second == l);
+                    if(!affected[old] && 
+                       !(allLessEqual(roiBegin[r], i.point()) && allLess(i.point(), roiEnd[r])))
+                        shouldEqual(l, old);
+                }
+
+                // the updated RAG equals the RAG of the new labeling
+                AdjacencyListGraph referenceRag;
+                makeRegionAdjacencyGraph(graph, labels, referenceRag, offsets, ids, ignoreLabel);
+                shouldEqual(rag.nodeNum(), referenceRag.nodeNum());
+                shouldEqual(rag.edgeNum(), referenceRag.edgeNum());
+                for(AdjacencyListGraph::NodeIt n(referenceRag); n != lemon::INVALID; ++n)
+                    should(rag.nodeFromId(referenceRag.id(*n)) != lemon::INVALID);
+                for(AdjacencyListGraph::EdgeIt e(referenceRag); e != lemon::INVALID; ++e)
+                    should(rag.findEdge(rag.nodeFromId(referenceRag.id(referenceRag.u(*e))),
+                                        rag.nodeFromId(referenceRag.id(referenceRag.v(*e)))) != lemon::INVALID);
+            }
+        }
+
+        // an empty box changes nothing
+        ClassVolume classes(shape);
+        LabelVolume labels(shape);
+        UInt32 maxLabel = labelMultiArray(classes, labels);
+        shouldEqual(labelMultiArrayIncremental(classes, labels, Shape3(3), Shape3(3), maxLabel), maxLabel);
+        shouldEqual(labels[Shape3(3)], 1u);
+    }
+
     IntVolume vol1, vol2, vol3;
     DoubleVolume vol4, vol5, vol6;
 };
@@ -479,6 +677,9 @@ struct VolumeLabelingTestSuite
         add( testCase( &VolumeLabelingTest::labelingTwentySixTest3));
         add( testCase( &VolumeLabelingTest::labelingTwentySixWithBackgroundTest1));
         add( testCase( &VolumeLabelingTest::labelingAllTest));
+        add( testCase( &VolumeLabelingTest::runLengthTest));
+        add( testCase( &VolumeLabelingTest::labelingStridedTest));
+        add( testCase( &VolumeLabelingTest::labelingIncrementalTest));
     }
 };
 
@@ -41,7 +41,12 @@
 #include "vigra/watersheds3d.hxx"
 #include "vigra/multi_array.hxx"
 #include "vigra/multi_watersheds.hxx"
+#include "vigra/adjacency_list_graph.hxx"
+#include "vigra/incremental_segmentation.hxx"
+#include "vigra/graph_algorithms.hxx"
+#include "vigra/random.hxx"
 #include "list"
+#include <set>
 
 #include <stdlib.h>
 #include <time.h>
@@ -557,6 +562,433 @@ struct Watersheds3dTest
         shouldEqual(8, max_region_label);
         should(labelVolume == labelVolume2);
     }
+
+    void testWatersheds3dManyRegions()
+    {
+        // every node with even coordinates is a minimum, and the region count
+        // exceeds the range of the neighbor index type
+        int w=100,h=100,d=60;
+        IntVolume vol(Shape3(w,h,d)), labels(Shape3(w,h,d)), labels2(Shape3(w,h,d));
+        for(IntVolume::iterator i = vol.begin(); i != vol.end(); ++i)
+            *i = i.point()[0] % 2 + i.point()[1] % 2 + i.point()[2] % 2;
+
+        shouldEqual(75000, watershedsMultiArray(vol, labels, DirectNeighborhood, WatershedOptions().unionFind()));
+        for(IntVolume::iterator i = labels.begin(); i != labels.end(); ++i)
+        {
+            IntVec p = i.point();
+            shouldEqual(*i, 1 + p[0]/2 + (w/2)*(p[1]/2) + (w/2)*(h/2)*(p[2]/2));
+        }
+
+        // the same on a strided view
+        IntVolume big(Shape3(w,2*h,d)), bigLabels(Shape3(w,2*h,d));
+        big.stridearray(Shape3(1,2,1)) = vol;
+        shouldEqual(75000, watershedsMultiArray(big.stridearray(Shape3(1,2,1)), bigLabels.stridearray(Shape3(1,2,1)), 
+                                                DirectNeighborhood, WatershedOptions().unionFind()));
+        should(bigLabels.stridearray(Shape3(1,2,1)) == labels);
+    }
+
+    void testWatershedQueues()
+    {
+        int w=40,h=30,d=20;
+        IntVolume ivol(Shape3(w,h,d));
+        DVolume dvol(Shape3(w,h,d));
+        srand(11);
+        for(int k = 0; k < ivol.size(); ++k)
+        {
+            ivol[k] = rand() % 200;
+            dvol[k] = ivol[k] / 10.0 - 5.0;
+        }
+
+        WatershedOptions options[] = { 
+            WatershedOptions(), 
+            WatershedOptions().radixQueue(), 
+            WatershedOptions().turboAlgorithm(256),
+            WatershedOptions().radixQueue().keepContours(),
+            WatershedOptions().turboAlgorithm(256).keepContours(),
+            WatershedOptions().radixQueue().biasLabel(1, 0.8),
+            WatershedOptions().turboAlgorithm(16).stopAtThreshold(100.0),
+            WatershedOptions().quantizedQueue(16).stopAtThreshold(100.0)
+        };
+        const int optionCount = sizeof(options) / sizeof(WatershedOptions);
+
+        // the linear implementation (unstrided arrays) must give the same 
+        // result as the generic implementation (strided views)
+        IntVolume big(Shape3(w,2*h,d)), bigLabels(Shape3(w,2*h,d));
+        big.stridearray(Shape3(1,2,1)) = ivol;
+        for(int k = 0; k < optionCount; ++k)
+        {
+            for(int n = 0; n < 2; ++n)
+            {
+                NeighborhoodType neighborhood = n == 0 ? DirectNeighborhood : IndirectNeighborhood;
+                IntVolume labels(ivol.shape());
+                bigLabels.init(0);
+                int count = watershedsMultiArray(ivol, labels, neighborhood, options[k]);
+                shouldEqual(count, watershedsMultiArray(big.stridearray(Shape3(1,2,1)), bigLabels.stridearray(Shape3(1,2,1)), 
+                                                        neighborhood, options[k]));
+                should(bigLabels.stridearray(Shape3(1,2,1)) == labels);
+            }
+        }
+
+        // with integer costs in the range of the hierarchical queue, the
+        // turbo algorithm is exact and equals the radix queue (both process 
+        // equal costs in FIFO order)
+        IntVolume radixLabels(ivol.shape()), turboLabels(ivol.shape());
+        int count = watershedsMultiArray(ivol, radixLabels, DirectNeighborhood, WatershedOptions().radixQueue().keepContours());
+        shouldEqual(count, watershedsMultiArray(ivol, turboLabels, DirectNeighborhood, 
+                                                WatershedOptions().turboAlgorithm(200).keepContours()));
+        should(radixLabels == turboLabels);
+
+        // negative floating point costs: the radix queue and the quantized
+        // queue with enough levels give the same result
+        IntVolume floatLabels(ivol.shape());
+        shouldEqual(count, watershedsMultiArray(dvol, floatLabels, DirectNeighborhood, WatershedOptions().radixQueue().keepContours()));
+        should(radixLabels == floatLabels);
+        floatLabels.init(0);
+        shouldEqual(count, watershedsMultiArray(dvol, floatLabels, DirectNeighborhood, WatershedOptions().quantizedQueue(1000).keepContours()));
+        should(radixLabels == floatLabels);
+
+        // turboAlgorithm() is ignored for floating point costs and for integer 
+        // costs outside its range, so that the result equals the default heap
+        IntVolume defaultLabels(ivol.shape()), ignoredLabels(ivol.shape());
+        watershedsMultiArray(dvol, defaultLabels, DirectNeighborhood, WatershedOptions().keepContours());
+        watershedsMultiArray(dvol, ignoredLabels, DirectNeighborhood, WatershedOptions().turboAlgorithm(1000).keepContours());
+        should(defaultLabels == ignoredLabels);
+        defaultLabels.init(0);
+        ignoredLabels.init(0);
+        watershedsMultiArray(ivol, defaultLabels, DirectNeighborhood, WatershedOptions().keepContours());
+        watershedsMultiArray(ivol, ignoredLabels, DirectNeighborhood, WatershedOptions().turboAlgorithm(16).keepContours());
+        should(defaultLabels == ignoredLabels);
+
+        // -0.0 and +0.0 are equal costs: they must not trip the monotonicity 
+        // check of the radix queue, and ties are processed in FIFO order
+        {
+            DVolume zeros(Shape3(5,1,1));
+            zeros[0] = 0.0; zeros[1] = 0.0; zeros[2] = -0.0; zeros[3] = -0.0; zeros[4] = 1.0;
+            IntVolume zeroLabels(zeros.shape());
+            zeroLabels[0] = 1;
+            zeroLabels[4] = 2;
+            shouldEqual(2, watershedsMultiArray(zeros, zeroLabels, DirectNeighborhood, WatershedOptions().radixQueue()));
+            int desired[] = { 1, 1, 1, 1, 2 };
+            shouldEqualSequence(zeroLabels.begin(), zeroLabels.end(), desired);
+        }
+
+        // the default heap finds the same regions, but may assign ties differently
+        IntVolume heapLabels(ivol.shape());
+        shouldEqual(count, watershedsMultiArray(dvol, heapLabels, DirectNeighborhood));
+        for(int k = 0; k < ivol.size(); ++k)
+            should(heapLabels[k] > 0 && heapLabels[k] <= count);
+    }
+
+    void testWatershedCompactAndSizeConstrained()
+    {
+        int w=60,h=50,d=10;
+        DVolume flat(Shape3(w,h,d));
+        IntVolume seeds(flat.shape());
+        for(int z = 5; z < d; z += 10)
+            for(int y = 5; y < h; y += 10)
+                for(int x = 5; x < w; x += 10)
+                    seeds(x,y,z) = 1 + x/10 + (w/10)*(y/10);
+
+        // compact watersheds on flat data assign every pixel to the nearest seed
+        // (up to ties), regardless of the queue
+        WatershedOptions compactOptions[] = { 
+            WatershedOptions().compactness(1.0), 
+            WatershedOptions().compactness(1.0).radixQueue(), 
+            WatershedOptions().compactness(1.0).quantizedQueue(1000) 
+        };
+        IntVolume labels(seeds);
+        for(int k = 0; k < 3; ++k)
+        {
+            labels = seeds;
+            shouldEqual(30, watershedsMultiArray(flat, labels, DirectNeighborhood, compactOptions[k]));
+            for(IntVolume::iterator i = labels.begin(); i != labels.end(); ++i)
+            {
+                int label = *i - 1;
+                IntVec center(5 + 10*(label % (w/10)), 5 + 10*(label / (w/10)), 5),
+                       nearest(5 + 10*(i.point()[0] / 10), 5 + 10*(i.point()[1] / 10), 5);
+                shouldEqualTolerance(norm(i.point() - center), norm(i.point() - nearest), 1e-10);
+            }
+        }
+
+        // the same on strided views (the compact mode copies the arrays)
+        DVolume big(Shape3(w,2*h,d));
+        IntVolume bigLabels(Shape3(w,2*h,d));
+        bigLabels.stridearray(Shape3(1,2,1)) = seeds;
+        shouldEqual(30, watershedsMultiArray(big.stridearray(Shape3(1,2,1)), bigLabels.stridearray(Shape3(1,2,1)), 
+                                             DirectNeighborhood, compactOptions[2]));
+        should(bigLabels.stridearray(Shape3(1,2,1)) == labels);
+
+        // size-constrained flooding: every region gets exactly 'size' pixels
+        // because there is enough room, the remaining pixels stay unlabeled
+        int size = 50;
+        labels = seeds;
+        shouldEqual(30, watershedsMultiArray(flat, labels, DirectNeighborhood, 
+                                             WatershedOptions().maxRegionSize(size).radixQueue()));
+        ArrayVector<int> sizes(31, 0);
+        for(IntVolume::iterator i = labels.begin(); i != labels.end(); ++i)
+            ++sizes[*i];
+        shouldEqual(sizes[0], w*h*d - 30*size);
+        for(int k = 1; k <= 30; ++k)
+            shouldEqual(sizes[k], size);
+
+        // a limit larger than the regions has no effect
+        IntVolume unlimited(seeds);
+        labels = seeds;
+        watershedsMultiArray(flat, unlimited, IndirectNeighborhood, WatershedOptions());
+        watershedsMultiArray(flat, labels, IndirectNeighborhood, WatershedOptions().maxRegionSize(w*h*d));
+        should(labels == unlimited);
+
+        // the new modes are only supported on GridGraphs
+        try
+        {
+            AdjacencyListGraph graph;
+            graph.addNode(0);
+            AdjacencyListGraph::NodeMap<double> data(graph);
+            AdjacencyListGraph::NodeMap<int> graphLabels(graph);
+            lemon_graph::watershedsGraph(graph, data, graphLabels, WatershedOptions().compactness(1.0));
+            failTest("no exception thrown");
+        }
+        catch(PreconditionViolation & c)
+        {
+            std::string expected("\nPrecondition violation!\nwatershedsGraph(): compactness() and maxRegionSize() are only supported on a GridGraph.");
+            std::string message(c.what());
+            should(0 == expected.compare(message.substr(0,expected.size())));
+        }
+    }
+
+    void testWatershedParallel()
+    {
+        int w=60,h=50,d=40;
+        DVolume vol(Shape3(w,h,d));
+        RandomMT19937 random(3);
+        for(int k = 0; k < vol.size(); ++k)
+            vol[k] = random.uniform();
+        IntVolume seeds(vol.shape());
+        int seedCount = generateWatershedSeeds(vol, seeds, DirectNeighborhood, 
+                                               SeedOptions().minima().threshold(0.2));
+        should(seedCount > 100);
+
+        // with distinct costs, the parallel flooding of the components below
+        // the threshold is identical to the sequential flooding
+        WatershedOptions options[] = { 
+            WatershedOptions().stopAtThreshold(0.3), 
+            WatershedOptions().stopAtThreshold(0.3).radixQueue(), 
+            WatershedOptions().stopAtThreshold(0.5).radixQueue(), 
+            WatershedOptions().stopAtThreshold(0.3).biasLabel(1, 0.5), 
+            WatershedOptions().stopAtThreshold(0.3).compactness(0.01), 
+            WatershedOptions().stopAtThreshold(0.3).maxRegionSize(5), 
+            WatershedOptions().stopAtThreshold(0.3).maxRegionSize(5).compactness(0.01)
+        };
+        const int optionCount = sizeof(options) / sizeof(WatershedOptions);
+        for(int k = 0; k < optionCount; ++k)
+        {
+            for(int n = 0; n < 2; ++n)
+            {
+                NeighborhoodType neighborhood = n == 0 ? DirectNeighborhood : IndirectNeighborhood;
+                IntVolume sequential(seeds), parallel(seeds);
+                int count = watershedsMultiArray(vol, sequential, neighborhood, options[k]);
+                shouldEqual(count, watershedsMultiArray(vol, parallel, neighborhood, 
+                                                        WatershedOptions(options[k]).numThreads(4)));
+                should(parallel == sequential);
+            }
+        }
+
+        // without stopAtThreshold(), the flooding runs sequentially, also on strided views
+        {
+            IntVolume sequential(seeds);
+            watershedsMultiArray(vol, sequential, DirectNeighborhood, WatershedOptions());
+            DVolume big(Shape3(w,2*h,d));
+            IntVolume bigLabels(Shape3(w,2*h,d));
+            big.stridearray(Shape3(1,2,1)) = vol;
+            bigLabels.stridearray(Shape3(1,2,1)) = seeds;
+            watershedsMultiArray(big.stridearray(Shape3(1,2,1)), bigLabels.stridearray(Shape3(1,2,1)), 
+                                 DirectNeighborhood, WatershedOptions().numThreads(4));
+            should(bigLabels.stridearray(Shape3(1,2,1)) == sequential);
+        }
+
+        // the size limit holds in parallel mode: only the pixels below the threshold
+        // count, the pixels above it are labeled but never expanded
+        int maxSize = 3;
+        IntVolume sequential(seeds), parallel(seeds);
+        WatershedOptions sizeOptions = WatershedOptions().stopAtThreshold(0.3).maxRegionSize(maxSize);
+        watershedsMultiArray(vol, sequential, DirectNeighborhood, sizeOptions);
+        watershedsMultiArray(vol, parallel, DirectNeighborhood, 
+                             WatershedOptions(sizeOptions).numThreads(4));
+        should(parallel == sequential);
+        ArrayVector<int> sizes(seedCount + 1, 0);
+        int limited = 0, barrier = 0;
+        for(int k = 0; k < vol.size(); ++k)
+        {
+            if(parallel[k] == 0)
+                continue;
+            if(vol[k] <= 0.3)
+                ++sizes[parallel[k]];
+            else
+                ++barrier;
+        }
+        for(int k = 1; k <= seedCount; ++k)
+        {
+            should(sizes[k] <= maxSize);
+            if(sizes[k] == maxSize)
+                ++limited;
+        }
+        should(limited > 0);
+        should(barrier > 0);
+    }
+
+    void testWatershedIncremental()
+    {
+        typedef GridGraph<3, undirected_tag> Graph;
+
+        Shape3 shape(40, 35, 30);
+        DVolume vol(shape);
+        RandomMT19937 random(5);
+        for(auto i = createCoupledIterator(vol); i != i.getEndIterator(); ++i)
+        {
+            Shape3 p = i.point();
+            get<1>(*i) = std::sin(0.4*p[0])*std::cos(0.3*p[1]) + std::sin(0.5*p[2]) + 0.01*random.uniform();
+        }
+        IntVolume seeds(shape);
+        generateWatershedSeeds(vol, seeds, DirectNeighborhood, SeedOptions().minima());
+
+        WatershedOptions options[] = { 
+            WatershedOptions(), 
+            WatershedOptions().keepContours(), 
+            WatershedOptions().stopAtThreshold(0.5).radixQueue()
+        };
+        for(int k = 0; k < 6; ++k)
+        {
+            NeighborhoodType neighborhood = (k & 1) ? IndirectNeighborhood : DirectNeighborhood;
+            WatershedOptions const & opt = options[k / 2];
+            bool keepContours = k / 2 == 1;
+            Graph graph(shape, neighborhood);
+            IntVolume labels(seeds), editedSeeds(seeds);
+            DVolume editedVol(vol);
+            int maxLabel = watershedsMultiArray(vol, labels, neighborhood, opt);
+            AdjacencyListGraph rag;
+            std::vector<Int64> offsets, ids;
+            makeRegionAdjacencyGraph(graph, labels, rag, offsets, ids, 0);
+
+            for(int r = 0; r < 3; ++r)
+            {
+                Shape3 roiBegin, roiEnd;
+                if(r == 0)
+                {
+                    // split a region by a new seed
+                    roiBegin = Shape3(20, 17, 15);
+                    roiEnd = roiBegin + Shape3(1);
+                    editedSeeds[roiBegin] = maxLabel + 1;
+                }
+                else if(r == 1)
+                {
+                    // remove the seed of a region
+                    int label = 0;
+                    for(auto i = editedSeeds.begin(); label == 0; ++i)
+                        if(i.point()[2] >= 10)
+                            label = *i;
+                    roiBegin = shape;
+                    for(auto i = createCoupledIterator(editedSeeds); i != i.getEndIterator(); ++i)
+                    {
+                        if(get<1>(*i) != label)
+                            continue;
+                        get<1>(*i) = 0;
+                        roiBegin = min(roiBegin, i.point());
+                        roiEnd = max(roiEnd, i.point() + Shape3(1));
+                    }
+                }
+                else
+                {
+                    // lower a box of the boundary indicator
+                    roiBegin = Shape3(30, 5, 3);
+                    roiEnd = Shape3(36, 12, 9);
+                    editedVol.subarray(roiBegin, roiEnd) *= 0.5;
+                }
+
+                // the reference floods the edited data from the edited seeds
+                IntVolume reference(editedSeeds);
+                watershedsMultiArray(editedVol, reference, neighborhood, opt);
+
+                int newMaxLabel = watershedsMultiArrayIncremental(editedVol, labels, editedSeeds, roiBegin, roiEnd,
+                                                                  maxLabel, rag, neighborhood, opt, 0);
+                shouldEqual(newMaxLabel, std::max(maxLabel, *std::max_element(reference.begin(), reference.end())));
+                if(r == 0 && !keepContours)
+                    shouldEqual(newMaxLabel, maxLabel + 1);
+                maxLabel = newMaxLabel;
+                should(labels == reference);
+
+                // the updated RAG equals the RAG of the new segmentation
+                AdjacencyListGraph referenceRag;
+                makeRegionAdjacencyGraph(graph, labels, referenceRag, offsets, ids, 0);
+                shouldEqual(rag.nodeNum(), referenceRag.nodeNum());
+                shouldEqual(rag.edgeNum(), referenceRag.edgeNum());
+                for(AdjacencyListGraph::NodeIt n(referenceRag); n != lemon::INVALID; ++n)
+                    should(rag.nodeFromId(referenceRag.id(*n)) != lemon::INVALID);
+                for(AdjacencyListGraph::EdgeIt e(referenceRag); e != lemon::INVALID; ++e)
+                    should(rag.findEdge(rag.nodeFromId(referenceRag.id(referenceRag.u(*e))),
+                                        rag.nodeFromId(referenceRag.id(referenceRag.v(*e)))) != lemon::INVALID);
+            }
+        }
+
+        // on noise with scattered seeds, new seeds also take over pixels of regions 
+        // that are not adjacent to the edit, and the fixed labels around the 
+        // re-flooded region must enter at their original flooding levels
+        DVolume noise(Shape3(30, 25, 20));
+        for(auto i = noise.begin(); i != noise.end(); ++i)
+            *i = random.uniform();
+        IntVolume noiseSeeds(noise.shape());
+        int noiseMaxLabel = 0;
+        for(int k = 0; k < 60; ++k)
+        {
+            Shape3 p(random.uniformInt(30), random.uniformInt(25), random.uniformInt(20));
+            if(noiseSeeds[p] == 0)
+                noiseSeeds[p] = ++noiseMaxLabel;
+        }
+        for(int k = 0; k < 6; ++k)
+        {
+            NeighborhoodType neighborhood = (k & 1) ? IndirectNeighborhood : DirectNeighborhood;
+            WatershedOptions const & opt = options[k / 2];
+            IntVolume labels(noiseSeeds), editedSeeds(noiseSeeds);
+            DVolume editedNoise(noise);
+            int maxLabel = watershedsMultiArray(noise, labels, neighborhood, opt);
+            for(int r = 0; r < 4; ++r)
+            {
+                Shape3 roiBegin(random.uniformInt(28), random.uniformInt(23), random.uniformInt(18)),
+                       roiEnd(roiBegin + Shape3(1));
+                if(r % 2 == 0)
+                {
+                    // a new seed at a low level
+                    editedSeeds[roiBegin] = maxLabel + 1;
+                    editedNoise[roiBegin] = 0.01*random.uniform();
+                }
+                else
+                {
+                    roiEnd = roiBegin + Shape3(3);
+                    editedNoise.subarray(roiBegin, roiEnd) *= 0.3;
+                }
+                IntVolume reference(editedSeeds);
+                watershedsMultiArray(editedNoise, reference, neighborhood, opt);
+                int newMaxLabel = watershedsMultiArrayIncremental(editedNoise, labels, editedSeeds, roiBegin, roiEnd,
+                                                                  maxLabel, neighborhood, opt);
+                shouldEqual(newMaxLabel, std::max(maxLabel, *std::max_element(reference.begin(), reference.end())));
+                maxLabel = newMaxLabel;
+                should(labels == reference);
+            }
+        }
+
+        IntVolume labels(seeds);
+        try
+        {
+            watershedsMultiArrayIncremental(vol, labels, seeds, Shape3(0), Shape3(1), 0,
+                                            DirectNeighborhood, WatershedOptions().unionFind());
+            failTest("no exception thrown");
+        }
+        catch(PreconditionViolation & c)
+        {
+            std::string expected("\nPrecondition violation!\nwatershedsMultiArrayIncremental(): only the region growing method");
+            std::string message(c.what());
+            should(0 == expected.compare(message.substr(0,expected.size())));
+        }
+    }
 };
 
 
@@ -572,6 +1004,11 @@ struct Watershed3DTestSuite
         add( testCase( &Watersheds3dTest::testWatersheds3dSix2));
         add( testCase( &Watersheds3dTest::testWatersheds3dGradient1));
         add( testCase( &Watersheds3dTest::testWatersheds3dGradient2));
+        add( testCase( &Watersheds3dTest::testWatersheds3dManyRegions));
+        add( testCase( &Watersheds3dTest::testWatershedQueues));
+        add( testCase( &Watersheds3dTest::testWatershedCompactAndSizeConstrained));
+        add( testCase( &Watersheds3dTest::testWatershedParallel));
+        add( testCase( &Watersheds3dTest::testWatershedIncremental));
     }
 };
 